@@ -12,7 +12,8 @@
  * 		- 'Lotus Seven' logo [Compressed].\n
  * 		- Clock [Raw]\n
  * 		- Check [Raw]\n
- * 		- Cross [Raw]
+ * 		- Cross [Raw]\n
+ * The pictures are constant and stay in flash, they are generated by 'tools/img2c.py'.
  *
  */
 
@@ -23,25 +24,26 @@
  * Pictures data
  *****************/
 // Data of compressed Seven logo
-uint8_t IMG_sevenLogoData_c[452] = {0x18,0xFF,0x06,0x7F,0x42,0x3F,0x06,0x7F,0x24,0xFF,0x01,0x7F,0x01,0x3F,0x01,0x1F,0x02,0x0F,0x01,0x07,0x02,0x83,0x01,0xC1,0x02,0xE1,0x01,0xE0,0x04,0xF0,0x06,0xF8,0x0C,0xFC,0x03,0x7C,0x03,0x3C,0x01,0x1C,0x04,0x9C,0x01,0x8C,0x07,0xCC,0x01,0x00,0x07,0xCC,0x01,0x8C,0x04,0x9C,0x01,0x1C,0x03,0x3C,0x03,0x7C,0x0D,0xFC,0x06,0xF8,0x04,0xF0,0x02,0xE1,0x01,0xC1,0x01,0xC3,0x01,0x83,0x01,0x07,0x02,0x0F,0x01,0x1F,0x01,0x3F,0x13,0xFF,0x01,0x1F,0x01,0x07,0x01,0x01,0x02,0x00,0x01,0x90,0x01,0x9C,0x01,0x9E,0x1A,0x9F,0x01,0x87,0x01,0x01,0x01,0x18,0x01,0x9C,0x03,0x9E,0x02,0x03,0x02,0xF3,0x01,0xF1,0x03,0xF9,0x07,0x79,0x01,0x78,0x09,0x79,0x02,0xF9,0x03,0xF3,0x01,0x03,0x01,0x02,0x02,0x9E,0x01,0x9C,0x01,0x18,0x01,0x01,0x01,0x87,0x1A,0x9F,0x01,0x9E,0x01,0x9C,0x01,0x90,0x01,0x80,0x01,0x00,0x01,0x01,0x01,0x07,0x10,0xFF,0x04,0x00,0x01,0xFE,0x1E,0xFF,0x01,0xFE,0x01,0xF8,0x01,0xE1,0x01,0x83,0x01,0x0F,0x01,0x3F,0x02,0xF0,0x06,0xF3,0x02,0xF0,0x04,0xFE,0x01,0x7E,0x01,0x3E,0x01,0x1E,0x01,0x8E,0x01,0xC6,0x01,0xE6,0x01,0xF2,0x01,0xF0,0x02,0xF8,0x01,0x7C,0x01,0x3F,0x01,0x1F,0x01,0x8F,0x01,0xC7,0x01,0xE3,0x01,0xF0,0x01,0x38,0x01,0x0F,0x01,0x87,0x01,0xE1,0x01,0xF8,0x01,0xFE,0x1F,0xFF,0x04,0x00,0x0F,0xFF,0x01,0xE0,0x04,0x00,0x24,0xFC,0x01,0xF0,0x01,0xC3,0x01,0x07,0x01,0x1F,0x01,0x7F,0x05,0xFF,0x01,0x7F,0x01,0x0F,0x01,0x03,0x01,0xE1,0x01,0xF8,0x01,0xFE,0x03,0xFF,0x01,0x7F,0x01,0x1F,0x01,0x07,0x01,0xE1,0x01,0xF0,0x01,0xFC,0x01,0xFE,0x01,0x7F,0x01,0x1F,0x01,0x07,0x01,0xC3,0x01,0xF0,0x24,0xFC,0x01,0x0C,0x03,0x00,0x01,0xF8,0x10,0xFF,0x01,0xFC,0x01,0x80,0x02,0x00,0x01,0x01,0x01,0x27,0x25,0xE7,0x01,0xE6,0x02,0xE0,0x01,0x83,0x01,0x0F,0x01,0x3F,0x01,0x7F,0x02,0x80,0x03,0x9F,0x01,0x1F,0x03,0x9F,0x02,0x80,0x01,0x7F,0x01,0x3F,0x01,0x0F,0x01,0x83,0x01,0xE1,0x01,0xE0,0x01,0xE6,0x25,0xE7,0x01,0x27,0x01,0x03,0x02,0x00,0x01,0xC0,0x01,0xFE,0x13,0xFF,0x01,0xFE,0x01,0xF8,0x01,0xF0,0x01,0xE0,0x01,0xC0,0x01,0x81,0x01,0x83,0x01,0x07,0x03,0x0F,0x02,0x1F,0x09,0x3F,0x13,0x7F,0x05,0x3F,0x01,0x3E,0x01,0x38,0x01,0x39,0x01,0x31,0x02,0x73,0x01,0x67,0x01,0x00,0x01,0x67,0x02,0x73,0x01,0x31,0x01,0x39,0x01,0x38,0x01,0x3E,0x04,0x3F,0x17,0x7F,0x06,0x3F,0x03,0x1F,0x02,0x0F,0x01,0x07,0x01,0x83,0x01,0xC1,0x01,0xC0,0x01,0xE0,0x01,0xF0,0x01,0xFC,0x01,0xFE,0x1E,0xFF,0x03,0xFE,0x52,0xFC,0x03,0xFE,0x15,0xFF};
+const uint8_t IMG_sevenLogoData_c[452] = {0x18,0xFF,0x06,0x7F,0x42,0x3F,0x06,0x7F,0x24,0xFF,0x01,0x7F,0x01,0x3F,0x01,0x1F,0x02,0x0F,0x01,0x07,0x02,0x83,0x01,0xC1,0x02,0xE1,0x01,0xE0,0x04,0xF0,0x06,0xF8,0x0C,0xFC,0x03,0x7C,0x03,0x3C,0x01,0x1C,0x04,0x9C,0x01,0x8C,0x07,0xCC,0x01,0x00,0x07,0xCC,0x01,0x8C,0x04,0x9C,0x01,0x1C,0x03,0x3C,0x03,0x7C,0x0D,0xFC,0x06,0xF8,0x04,0xF0,0x02,0xE1,0x01,0xC1,0x01,0xC3,0x01,0x83,0x01,0x07,0x02,0x0F,0x01,0x1F,0x01,0x3F,0x13,0xFF,0x01,0x1F,0x01,0x07,0x01,0x01,0x02,0x00,0x01,0x90,0x01,0x9C,0x01,0x9E,0x1A,0x9F,0x01,0x87,0x01,0x01,0x01,0x18,0x01,0x9C,0x03,0x9E,0x02,0x03,0x02,0xF3,0x01,0xF1,0x03,0xF9,0x07,0x79,0x01,0x78,0x09,0x79,0x02,0xF9,0x03,0xF3,0x01,0x03,0x01,0x02,0x02,0x9E,0x01,0x9C,0x01,0x18,0x01,0x01,0x01,0x87,0x1A,0x9F,0x01,0x9E,0x01,0x9C,0x01,0x90,0x01,0x80,0x01,0x00,0x01,0x01,0x01,0x07,0x10,0xFF,0x04,0x00,0x01,0xFE,0x1E,0xFF,0x01,0xFE,0x01,0xF8,0x01,0xE1,0x01,0x83,0x01,0x0F,0x01,0x3F,0x02,0xF0,0x06,0xF3,0x02,0xF0,0x04,0xFE,0x01,0x7E,0x01,0x3E,0x01,0x1E,0x01,0x8E,0x01,0xC6,0x01,0xE6,0x01,0xF2,0x01,0xF0,0x02,0xF8,0x01,0x7C,0x01,0x3F,0x01,0x1F,0x01,0x8F,0x01,0xC7,0x01,0xE3,0x01,0xF0,0x01,0x38,0x01,0x0F,0x01,0x87,0x01,0xE1,0x01,0xF8,0x01,0xFE,0x1F,0xFF,0x04,0x00,0x0F,0xFF,0x01,0xE0,0x04,0x00,0x24,0xFC,0x01,0xF0,0x01,0xC3,0x01,0x07,0x01,0x1F,0x01,0x7F,0x05,0xFF,0x01,0x7F,0x01,0x0F,0x01,0x03,0x01,0xE1,0x01,0xF8,0x01,0xFE,0x03,0xFF,0x01,0x7F,0x01,0x1F,0x01,0x07,0x01,0xE1,0x01,0xF0,0x01,0xFC,0x01,0xFE,0x01,0x7F,0x01,0x1F,0x01,0x07,0x01,0xC3,0x01,0xF0,0x24,0xFC,0x01,0x0C,0x03,0x00,0x01,0xF8,0x10,0xFF,0x01,0xFC,0x01,0x80,0x02,0x00,0x01,0x01,0x01,0x27,0x25,0xE7,0x01,0xE6,0x02,0xE0,0x01,0x83,0x01,0x0F,0x01,0x3F,0x01,0x7F,0x02,0x80,0x03,0x9F,0x01,0x1F,0x03,0x9F,0x02,0x80,0x01,0x7F,0x01,0x3F,0x01,0x0F,0x01,0x83,0x01,0xE1,0x01,0xE0,0x01,0xE6,0x25,0xE7,0x01,0x27,0x01,0x03,0x02,0x00,0x01,0xC0,0x01,0xFE,0x13,0xFF,0x01,0xFE,0x01,0xF8,0x01,0xF0,0x01,0xE0,0x01,0xC0,0x01,0x81,0x01,0x83,0x01,0x07,0x03,0x0F,0x02,0x1F,0x09,0x3F,0x13,0x7F,0x05,0x3F,0x01,0x3E,0x01,0x38,0x01,0x39,0x01,0x31,0x02,0x73,0x01,0x67,0x01,0x00,0x01,0x67,0x02,0x73,0x01,0x31,0x01,0x39,0x01,0x38,0x01,0x3E,0x04,0x3F,0x17,0x7F,0x06,0x3F,0x03,0x1F,0x02,0x0F,0x01,0x07,0x01,0x83,0x01,0xC1,0x01,0xC0,0x01,0xE0,0x01,0xF0,0x01,0xFC,0x01,0xFE,0x1E,0xFF,0x03,0xFE,0x52,0xFC,0x03,0xFE,0x15,0xFF};
 
 // Data of the clock picture
-uint8_t IMG_clockData[48] = { 0x00, 0x00, 0x00, 0xC0, 0xE0, 0x60, 0x30, 0x30, 0x90, 0x10, 0x30, 0x30, 0x60, 0xE0, 0xC0, 0x00, 0x00, 0x00, 0x3F, 0xF3, 0xC0, 0x80, 0x00, 0x00, 0x0F, 0x08, 0x08, 0x08, 0x80, 0xC0, 0xF3, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x03, 0x03, 0x02, 0x03, 0x03, 0x03, 0x01, 0x01, 0x00, 0x00 };
+const uint8_t IMG_clockData[48] = { 0x00, 0x00, 0x00, 0xC0, 0xE0, 0x60, 0x30, 0x30, 0x90, 0x10, 0x30, 0x30, 0x60, 0xE0, 0xC0, 0x00, 0x00, 0x00, 0x3F, 0xF3, 0xC0, 0x80, 0x00, 0x00, 0x0F, 0x08, 0x08, 0x08, 0x80, 0xC0, 0xF3, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x03, 0x03, 0x02, 0x03, 0x03, 0x03, 0x01, 0x01, 0x00, 0x00 };
 // Data pf the check picture
-uint8_t IMG_checkData[42] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xE0, 0xE0, 0x00, 0x00, 0x08, 0x38, 0xF8, 0xF0, 0xE0, 0xF0, 0xFC, 0x3F, 0x0F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
+const uint8_t IMG_checkData[42] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xE0, 0xE0, 0x00, 0x00, 0x08, 0x38, 0xF8, 0xF0, 0xE0, 0xF0, 0xFC, 0x3F, 0x0F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
 // Data of the cross picture
-uint8_t IMG_crossData[48] = { 0x00, 0x00, 0x70, 0xF0, 0xF0, 0xE0, 0xC0, 0x80, 0x00, 0x00, 0x80, 0xC0 ,0xE0, 0xF0, 0xF0, 0x70, 0x00, 0x00, 0x80, 0xC0, 0xE1, 0xF3, 0xFF, 0x7F, 0x3F, 0x3F, 0x7F, 0xFF, 0xF3, 0xE1, 0xC0, 0x80, 0x00, 0x00, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03 };
+const uint8_t IMG_crossData[48] = { 0x00, 0x00, 0x70, 0xF0, 0xF0, 0xE0, 0xC0, 0x80, 0x00, 0x00, 0x80, 0xC0 ,0xE0, 0xF0, 0xF0, 0x70, 0x00, 0x00, 0x80, 0xC0, 0xE1, 0xF3, 0xFF, 0x7F, 0x3F, 0x3F, 0x7F, 0xFF, 0xF3, 0xE1, 0xC0, 0x80, 0x00, 0x00, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03 };
 
 /***********************
  * Pictures Structures *
  ***********************/
+// The pictures and their descriptors are constant, they stay in flash
 // T_picture for compressed seven Logo
-T_picture IMG_sevenLogo_c = {.HEIGHT = 8, .WIDTH = 128, .DATA = IMG_sevenLogoData_c, .DATA_LENGTH = 452};
+const T_picture IMG_sevenLogo_c = {.HEIGHT = 8, .WIDTH = 128, .DATA = IMG_sevenLogoData_c, .DATA_LENGTH = 452};
 
 // T_picture for pictures (not compressed data)
-T_picture IMG_clock = {.HEIGHT = 3, .WIDTH = 16, .DATA = IMG_clockData, .DATA_LENGTH = 0};
-T_picture IMG_check = {.HEIGHT = 3, .WIDTH = 13, .DATA = IMG_checkData, .DATA_LENGTH = 0};
-T_picture IMG_cross = {.HEIGHT = 3, .WIDTH = 16, .DATA = IMG_crossData, .DATA_LENGTH = 0};
+const T_picture IMG_clock = {.HEIGHT = 3, .WIDTH = 16, .DATA = IMG_clockData, .DATA_LENGTH = 0};
+const T_picture IMG_check = {.HEIGHT = 3, .WIDTH = 13, .DATA = IMG_checkData, .DATA_LENGTH = 0};
+const T_picture IMG_cross = {.HEIGHT = 3, .WIDTH = 16, .DATA = IMG_crossData, .DATA_LENGTH = 0};
 
 // Font data.
 const unsigned char Font_TAB[] =
@@ -12,7 +12,8 @@
  * 		- 'Lotus Seven' logo [Compressed].\n
  * 		- Clock [Raw]\n
  * 		- Check [Raw]\n
- * 		- Cross [Raw]
+ * 		- Cross [Raw]\n
+ * The pictures are constant and stay in flash, they are generated by 'tools/img2c.py'.
  *
  */
 
@@ -26,17 +27,17 @@ typedef struct
 {
 	uint8_t HEIGHT;			///< Height of the image [page].
 	uint8_t WIDTH;			///< Width of the image [px].
-	uint8_t *DATA;			///< Array where data are stored.
+	const uint8_t *DATA;	///< Array where data are stored, in flash.
 
 	int DATA_LENGTH;		///< In case of compressed data, used to provide the compressed array size.
 
 }T_picture;
 
-extern T_picture IMG_sevenLogo_c;		///< Type that contains the Seven logo data.
+extern const T_picture IMG_sevenLogo_c;		///< Type that contains the Seven logo data.
 
-extern T_picture IMG_clock;		///< Type that contains a clock picture.
-extern T_picture IMG_check;		///< Type that contains a check print picture.
-extern T_picture IMG_cross;		///< Type that contains a cross print picture.
+extern const T_picture IMG_clock;		///< Type that contains a clock picture.
+extern const T_picture IMG_check;		///< Type that contains a check print picture.
+extern const T_picture IMG_cross;		///< Type that contains a cross print picture.
 
 /**
  * @brief Array that contains the MAJ BOLD font data.
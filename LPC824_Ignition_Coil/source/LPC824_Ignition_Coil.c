@@ -15,13 +15,62 @@
 #include "fsl_sctimer.h"
 #include "fsl_pint.h"
 #include "fsl_syscon.h"
+#include "fsl_swm.h"
 
 #include "ignition_pulse.h"
 #include "SysTick.h"
 #include "led.h"
 #include "lcd.h"
-
-#define SCTIMER_CLK_FREQ CLOCK_GetFreq(kCLOCK_Irc)	//! Get the clock frequency.
+#include "telemetry.h"
+#include "crash.h"
+#include "settings.h"
+#include "boot.h"
+#include "timing.h"
+#include "trigger_wheel.h"
+#include "maps.h"
+#include "verify.h"
+#include "safety.h"
+#include "overcurrent.h"
+#include "playback.h"
+#include "jitter.h"
+#include "ui.h"
+#include "stack.h"
+#include "isr_stats.h"
+
+#define SCTIMER_CLK_FREQ CLOCK_GetFreq(kCLOCK_CoreSysClk)	//! Get the clock frequency.
+
+#define SCT_RESOLUTION_NS 100		///< Required SCT tick period [ns].
+#define PULSE_DITHERING 1			///< Dither the pulse period for an exact average frequency.
+#define USE_MAPS 1					///< Take the dwell and the crank trigger advance from the maps.
+#define SUPPLY_VOLTAGE_MV 12000		///< Coil supply voltage used as the maps load [mV].
+#define MULTI_SPARK_STRIKES 1		///< Number of strikes per period at boot, '1' for a single pulse, '0' for the crank trigger mode.
+#define MULTI_SPARK_GAP_US 300		///< Time between the strikes of a multi-spark pulse [us].
+#define MAX_DWELL_US 5000			///< Hardware limit of the coil dwell, single pulse and multi-spark modes [us].
+#define MIN_DWELL_US 100			///< Shortest dwell taken from the map [us].
+#define WDT_TIMEOUT_MS 250			///< Main loop stall after which the output is cut and the chip reset [ms].
+
+#ifndef CRANK_INPUT_PIN
+#define CRANK_INPUT_PIN SWM_PIN_NONE		///< Pin of the crank sensor signal. None on this board, all the package pins are used: the crank trigger mode is refused and counted in the answer of the 'K' command.
+#endif
+#define CRANK_SCT_INPUT kSCTIMER_Input_0	///< SCTimer input of the crank signal.
+#define CRANK_TRIGGER_ANGLE_CDEG 6000		///< Angle of the crank edge before the top dead center [1/100 degree].
+#define CRANK_ADVANCE_CDEG 1000				///< Spark advance before the top dead center [1/100 degree].
+#define CRANK_MIN_ADVANCE_CDEG (-2000)		///< Lowest advance taken from the map, after the top dead center [1/100 degree].
+#define CRANK_MAX_ADVANCE_CDEG (CRANK_TRIGGER_ANGLE_CDEG - 100)	///< Highest advance taken from the map, after the crank edge [1/100 degree].
+
+#define WHEEL_OUTPUT kSCTIMER_Out_1			///< SCT timer output of the trigger wheel signal.
+#ifndef WHEEL_OUTPUT_PIN
+#define WHEEL_OUTPUT_PIN SWM_PIN_NONE		///< Pin of the trigger wheel signal. None on this board, all the package pins are used: the generator is refused and counted in the answer of the 'W' command.
+#endif
+#define WHEEL_SPARK_TOOTH 0					///< Tooth on which the coil pulse starts, '0' is the first tooth after the gap.
+
+#define VERIFY_INPUT_PIN kSWM_PortPin_P0_13	///< Coil output pin, read back by the SCTimer.
+#define VERIFY_SCT_INPUT kSCTIMER_Input_1	///< SCTimer input of the coil output read back.
+
+#define OCP_SCT_INPUT kSCTIMER_Input_2		///< SCTimer input of the analog comparator output.
+#define OCP_THRESHOLD_MV 1500				///< Current sense voltage ending the pulse [mV].
+
+#define SWM_PIN_NONE ((swm_port_pin_type_t)0xFFU)	///< Value of a movable function not assigned to a pin.
 
 
 #define CMD_OUTPUT kSCTIMER_Out_0 ///< SCT timer output 0
@@ -47,25 +96,14 @@
 
 #define STATE_STACK_COUNT 8	///< State stack size
 
-#define SCREEN_RMP_OFFSET 48
-#define SCREEN_MATCH_OFFSET 0
-#define SCREEN_RUN_OFFSET 76
-
 enum STATE {
 	NONE = 0,         //!< NONE
 	ADD_TR,           //!< ADD_TR
 	REM_TR,           //!< REM_TR
 	ENABLE_PULSES,    //!< ENABLE_PULSES
 	UPDATE_PULSES,    //!< UPDATE_PULSES
-	UPDATE_PULSE_WIDTH//!< CHANGE_PULSE_WIDTH
-};
-
-enum SCREEN_LINE{
-	MSG_S_RPM =1,
-	S_RPM,
-	MSG_R_RPM,
-	R_RPM,
-	STATUS = 6
+	UPDATE_PULSE_WIDTH,//!< CHANGE_PULSE_WIDTH
+	UPDATE_MODE       //!< UPDATE_MODE
 };
 
 volatile uint32_t _switchOn = 0;
@@ -77,6 +115,14 @@ volatile uint8_t _state = NONE;
 
 volatile uint32_t _event;
 volatile uint32_t _sctimerClock;
+volatile uint32_t _strikes = MULTI_SPARK_STRIKES;
+volatile uint32_t _crankRpm = 0;
+volatile int32_t _crankAdvance = CRANK_ADVANCE_CDEG;
+volatile uint32_t _wheelTeeth = 0;
+volatile uint32_t _wheelMissing = 0;
+volatile uint32_t _playback = PLAYBACK_OFF;
+volatile uint32_t _modeRefusals = 0;		///< Pulse modes refused for lack of pin or resources.
+jitter_config_t _jitter = {JITTER_OFF, 0, 0, 1};
 
 volatile uint32_t _nextAllowedInter = 0;
 volatile uint32_t _rpmInq = 10;
@@ -89,6 +135,17 @@ void UpdateNextAllowedInter(void);
 
 void PushState(uint32_t state);
 void UpdateState(void);
+void DisplayMainScreen(uint32_t cmdRpm, uint32_t currentRpm, uint8_t pwmEnable);
+status_t SetupPulses(uint32_t rpm, uint32_t pulseWidth, uint32_t strikes);
+uint32_t GetDwell(uint32_t rpm, uint32_t pulseWidth);
+void ReleasePulses(void);
+void RefuseMode(uint32_t teeth, uint32_t strikes);
+void SetStrikes_command(const char *args);
+void SetWheel_command(const char *args);
+void UpdateCrank(void);
+void PrintCrank_command(const char *args);
+void SetPlayback_command(const char *args);
+void SetJitter_command(const char *args);
 
 //void CoderA_callback(void);
 void CoderB_callback(void);
@@ -97,26 +154,61 @@ void Switch_callback(void);
 
 /**
  * Initialize the board and chip.
+ * The pulse engine is configured first, then the inputs and the telemetry. The LCD power-up
+ * sequence is only started, it runs in background from the main loop with 'LCD_InitProcess()'.
+ * @param rpm			RPM to set.
+ * @param pulseWidth	User pulse width [us], replaced by the dwell map when it is valid.
+ * @param enable		Start the pulses immediately.
+ * @return '1' on success, '0' if the pulse engine can't be configured.
  */
-int init(void) {
+int init(uint32_t rpm, uint32_t pulseWidth, uint8_t enable) {
 
 	int res = 1;
+	sctimer_config_t sctimerInfo;		// SC timer information.
+	timing_plan_t plan;					// Clock and SCT prescaler configuration.
 
 	PINT_Init(PINT);
 	BOARD_InitPins();
-	BOARD_BootClockIRC12M();
+
+	// Run as fast as possible for the finest pulse resolution, from the IRC if no clock meets it
+	TIMING_Plan(MIN_FREQ_mHZ, SCT_RESOLUTION_NS, &plan);
+	TIMING_Apply(&plan);
 	BOARD_InitSWD_DEBUGPins();
 
+	// The interrupt instrumentation counter runs before the first Systick interrupt
+	ISRSTATS_Init();
 	SYSTICK_Init_ms(1);
-
-	LED_SetLed(LED_RED_LED, 1);
-	LCD_Init();
-	LED_SetLed(LED_RED_LED, 0);
+	BOOT_Mark(BOOT_CLOCK);
 
 	/* Enable clock of sct. */
 	CLOCK_EnableClock(kCLOCK_Sct);
 
-	LED_SetLed(LED_GREEN_LED, 1);
+	_sctimerClock = SCTIMER_CLK_FREQ;
+
+	SCTIMER_GetDefaultConfig(&sctimerInfo);
+	sctimerInfo.prescale_l = plan.sctPrescaler;
+	SCTIMER_Init(SCT0, &sctimerInfo);
+	SCTMGR_Init(SCT0);
+	MAP_Init();
+
+	// Cut the output if the main loop stalls
+	SAFETY_Init(WDT_TIMEOUT_MS);
+
+	// Read the coil output back on an SCTimer input
+	CLOCK_EnableClock(kCLOCK_Swm);
+	SWM_SetMovablePinSelect(SWM0, kSWM_SCT_PIN1, VERIFY_INPUT_PIN);
+	CLOCK_DisableClock(kCLOCK_Swm);
+	INPUTMUX->SCT0_INMUX[VERIFY_SCT_INPUT] = INPUTMUX_SCT0_INMUX_INP_N(1);
+
+	// Overcurrent comparator, started with the pulses
+	OCP_Init(OCP_SCT_INPUT, OCP_THRESHOLD_MV);
+
+	if (SetupPulses(rpm, GetDwell(rpm, pulseWidth), _strikes) != kStatus_Success)
+	{
+		return 0;
+	}
+	IPULSE_EnablePulse(SCT0, CMD_OUTPUT, enable);
+	BOOT_Mark(BOOT_PULSE_READY);
 
 	// Set interruptions
 	//SYSCON_AttachSignal(SYSCON, kPINT_PinInt0, PINT_COD_CHA_INT0_SRC);
@@ -138,6 +230,31 @@ int init(void) {
 	PINT_EnableCallbackByIndex(PINT, kPINT_PinInt1);
 	PINT_EnableCallbackByIndex(PINT, kPINT_PinInt2);
 	PINT_EnableCallbackByIndex(PINT, kPINT_PinInt3);
+	BOOT_Mark(BOOT_INPUTS_READY);
+
+	TELEMETRY_Init(CLOCK_GetFreq(kCLOCK_CoreSysClk));
+	TELEMETRY_RegisterCommand('F', CRASH_PrintSnapshot);
+	TELEMETRY_RegisterCommand('S', SETTINGS_PrintStatus);
+	TELEMETRY_RegisterCommand('B', BOOT_PrintReport);
+	TELEMETRY_RegisterCommand('C', TIMING_PrintPlan);
+	TELEMETRY_RegisterCommand('M', SCTMGR_Dump);
+	TELEMETRY_RegisterCommand('K', SetStrikes_command);
+	TELEMETRY_RegisterCommand('R', PrintCrank_command);
+	TELEMETRY_RegisterCommand('W', SetWheel_command);
+	TELEMETRY_RegisterCommand('T', MAP_WriteCommand);
+	TELEMETRY_RegisterCommand('Q', MAP_EvaluateCommand);
+	TELEMETRY_RegisterCommand('V', VERIFY_PrintStats);
+	TELEMETRY_RegisterCommand('O', OCP_Command);
+	TELEMETRY_RegisterCommand('P', SetPlayback_command);
+	TELEMETRY_RegisterCommand('D', PLAYBACK_DataCommand);
+	TELEMETRY_RegisterCommand('J', SetJitter_command);
+	TELEMETRY_RegisterCommand('H', STACK_PrintReport);
+	TELEMETRY_RegisterCommand('I', ISRSTATS_Command);
+	BOOT_Mark(BOOT_TELEMETRY_READY);
+
+	// The power-up sequence and the splash screen hold run from the main loop
+	LCD_InitStart();
+	BOOT_Mark(BOOT_LCD_STARTED);
 
 	return res;
 }
@@ -149,49 +266,98 @@ int main(void) {
 
 	//uint8_t temp = 0;						// Temporary variable to use if needed
 	uint8_t pwmEnable = 0;					// Does the PWM is enabled.
+	uint8_t lcdReady = 0;					// Does the LCD initialization is done.
+	uint32_t trips = 0;						// Logged overcurrent trip count.
 
 	uint32_t cmdRpm = DEFAULT_TR_MIN;		// Command RPM.
 	uint32_t currentRpm = DEFAULT_TR_MIN;	// Current (running) RPM.
-	uint32_t pulseWidth = DEFAULT_PULSE_WIDTH;	// Pulse width [us].
+	uint32_t pulseWidth = DEFAULT_PULSE_WIDTH;	// User pulse width, saved in the settings [us].
+	uint32_t dwell;							// Applied pulse width, from the dwell map when it is valid [us].
+	uint32_t width;							// Pulse width computed for the current RPM [us].
+
+	crash_pulse_config_t restored;		// Pulse configuration restored after a fault.
+	settings_t settings;				// Persisted settings.
+	ui_model_t *ui = UI_GetModel();		// Displayed values, rendered by 'UI_Process()'.
+
+	// Mark the free stack before anything runs on it
+	STACK_Paint();
+
+	// Restore the last saved settings, the pulses stay disabled
+	if(SETTINGS_Init(&settings) && settings.rpm >= MIN_TR_MIN && settings.rpm <= MAX_TR_MIN){
+		cmdRpm = settings.rpm;
+		currentRpm = settings.rpm;
+		pulseWidth = settings.pulseWidth_us;
+	}
 
-	sctimer_config_t sctimerInfo;		// SC timer information.
-	char sRpm[10];						// Characters array used to display integers.
+	// Restore the running configuration when restarting after a fault
+	CRASH_Init();
+	if(CRASH_GetPulseConfig(&restored)){
+		cmdRpm = restored.rpm;
+		currentRpm = restored.rpm;
+		pulseWidth = restored.pulseWidth_us;
+		pwmEnable = restored.enabled;
+	}
 
+	if(!init(cmdRpm, pulseWidth, pwmEnable)){	// Initialize the board and fixtures.
+		return -1;
+	}
+	dwell = GetDwell(currentRpm, pulseWidth);
 
-	init();		// Initialize the board and fixtures.
+	CRASH_SetPulseConfig(currentRpm, pulseWidth, pwmEnable);
 
 	LED_SetAll();
 
 	_stateStack[0] = _state;
-	_sctimerClock = SCTIMER_CLK_FREQ;
 
-	SCTIMER_GetDefaultConfig(&sctimerInfo);
-    SCTIMER_Init(SCT0, &sctimerInfo);
+    /* Enter an infinite loop, just incrementing a counter. */
+    while(1) {
 
-    if (IPULSE_SetupPulse(SCT0, DEFAULT_PULSE_WIDTH, _sctimerClock, trToHz(cmdRpm), CMD_OUTPUT, &_event) !=
-    		kStatus_Success)
-	{
-		return -1;
-	}
+    	BOOT_Mark(BOOT_MAIN_LOOP);
+    	SAFETY_Feed();
 
+    	TELEMETRY_Process();
+    	CRASH_Process();
+    	SETTINGS_Process(pwmEnable || TWHEEL_IsActive());
+    	PLAYBACK_Process();
 
-    LCD_DisplayClear(0x00,0x00);
+    	if(_strikes == 0){
+    		UpdateCrank();
+    	}
 
-    sprintf(sRpm, "%d", cmdRpm);
-    LCD_DisplayString(MSG_S_RPM,4,"Set RPM:");
-    LCD_DisplayString(S_RPM,SCREEN_RMP_OFFSET,sRpm);
+    	if(VERIFY_GetAlarm()){
+    		CRASH_LogEvent(CRASH_EVT_TIMING, currentRpm);
+    	}
 
-    LCD_DisplayString(MSG_R_RPM,4,"Running RPM:");
-	LCD_DisplayString(R_RPM,SCREEN_RMP_OFFSET,sRpm);
+    	// The user requests are kept in the state stack until the screen is ready
+    	if(!lcdReady){
+    		lcdReady = LCD_InitProcess();
+    		if(LCD_IsOn()){
+    			BOOT_Mark(BOOT_LCD_ON);
+    		}
+    		if(lcdReady){
+    			DisplayMainScreen(cmdRpm, currentRpm, pwmEnable);
+    			BOOT_Mark(BOOT_SPLASH_DONE);
+    		}
+    		continue;
+    	}
 
-	LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: YES");
-    LCD_DisplayString(STATUS,SCREEN_RUN_OFFSET,"State: OFF");
+    	if(_state != NONE){
+    		CRASH_LogEvent(CRASH_EVT_STATE, _state);
+    	}
 
+    	if(OCP_GetTrips() != trips){
+    		trips = OCP_GetTrips();
+    		CRASH_LogEvent(CRASH_EVT_OVERCURRENT, trips);
+    		ui->trips = trips;
+    	}
 
-    LED_ResetAll();
+    	// In crank trigger mode the running RPM is the measured one
+    	if(_strikes == 0){
+    		ui->runningRpm = _crankRpm;
+    	}
+    	ui->strikes = _strikes;
 
-    /* Enter an infinite loop, just incrementing a counter. */
-    while(1) {
+    	UI_Process();
 
     	switch(_state){
 
@@ -208,18 +374,9 @@ int main(void) {
 				cmdRpm += _rpmInq;
 			}
 
-			sprintf(sRpm, "%d", cmdRpm);
-			LCD_DisplayString(S_RPM,SCREEN_RMP_OFFSET,sRpm);
-
-			if(cmdRpm != currentRpm){
-				LED_SetLed(LED_RED_LED, 1);
-				LCD_DisplayRectangle(56, STATUS, 16, 1 , 0x00);
-				LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: NO");
-			}
-			else{
-				LED_SetLed(LED_RED_LED, 0);
-				LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: YES");
-			}
+			ui->cmdRpm = cmdRpm;
+			ui->match = cmdRpm == currentRpm;
+			LED_SetLed(LED_RED_LED, !ui->match);
 
 			UpdateState();
     		break;
@@ -233,18 +390,9 @@ int main(void) {
 				cmdRpm -= _rpmInq;
 			}
 
-			sprintf(sRpm, "%d", cmdRpm);
-			LCD_DisplayString(S_RPM,SCREEN_RMP_OFFSET,sRpm);
-
-			if(cmdRpm != currentRpm){
-				LED_SetLed(LED_RED_LED, 1);
-				LCD_DisplayRectangle(56, STATUS, 16, 1 , 0x00);
-				LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: NO");
-			}
-			else{
-				LED_SetLed(LED_RED_LED, 0);
-				LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: YES");
-			}
+			ui->cmdRpm = cmdRpm;
+			ui->match = cmdRpm == currentRpm;
+			LED_SetLed(LED_RED_LED, !ui->match);
 
 			UpdateState();
     		break;
@@ -256,16 +404,12 @@ int main(void) {
 			pwmEnable = !pwmEnable;
 
 			IPULSE_EnablePulse(SCT0, CMD_OUTPUT, pwmEnable);
+			CRASH_SetPulseConfig(currentRpm, pulseWidth, pwmEnable);
+			CRASH_LogEvent(CRASH_EVT_ENABLE, pwmEnable);
 			LED_SetLed(LED_GREEN_LED, pwmEnable);
 			UpdateState();
 
-			if(pwmEnable){
-				LCD_DisplayRectangle(117, STATUS, 10, 1 , 0x00);
-				LCD_DisplayString(STATUS,SCREEN_RUN_OFFSET,"State: ON");
-			}
-			else{
-				LCD_DisplayString(STATUS,SCREEN_RUN_OFFSET,"State: OFF");
-			}
+			ui->enabled = pwmEnable;
 			PushState(UPDATE_PULSES);
 
     		break;
@@ -278,22 +422,68 @@ int main(void) {
 				cmdRpm = MIN_TR_MIN;
 			}
 
-			IPULSE_UpdatePulseFrequency(SCT0,CMD_OUTPUT, _sctimerClock, trToHz(cmdRpm), _event);
+			if(TWHEEL_IsActive()){
+				TWHEEL_UpdateFrequency(SCT0, _sctimerClock, trToHz(cmdRpm), _event);
+			}
+			else if(!PLAYBACK_IsActive()){
+				IPULSE_UpdatePulseFrequency(SCT0,CMD_OUTPUT, _sctimerClock, trToHz(cmdRpm), _event);
+				VERIFY_SetCommand(_sctimerClock, trToHz(cmdRpm), dwell);
+				JITTER_SetFrequency(_sctimerClock, trToHz(cmdRpm));
+			}
 			IPULSE_EnablePulse(SCT0, CMD_OUTPUT, pwmEnable);
 
 			currentRpm = cmdRpm;
+			CRASH_SetPulseConfig(currentRpm, pulseWidth, pwmEnable);
+			CRASH_LogEvent(CRASH_EVT_RPM, currentRpm);
+
+			settings.rpm = currentRpm;
+			settings.pulseWidth_us = pulseWidth;
+			settings.flags = 0;
+			SETTINGS_Set(&settings);
 
-			sprintf(sRpm, "%d", currentRpm);
-			LCD_DisplayString(R_RPM,SCREEN_RMP_OFFSET,sRpm);
-			LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: YES");
+			if(_strikes != 0){
+				ui->runningRpm = currentRpm;
+			}
+			ui->cmdRpm = cmdRpm;
+			ui->match = 1;
 			LED_SetLed(LED_RED_LED, 0);
 
 			UpdateState();
+
+			// The dwell follows the RPM, the user pulse width is kept in the settings
+			width = GetDwell(currentRpm, pulseWidth);
+			if(width != dwell){
+				dwell = width;
+				PushState(UPDATE_PULSE_WIDTH);
+			}
     		break;
 
     	case UPDATE_PULSE_WIDTH:
 
-			IPULSE_UpdatePulseWidth(SCT0,CMD_OUTPUT, _sctimerClock, pulseWidth, _event);
+			// Only the applied dwell changes, the settings are kept
+			if(TWHEEL_IsActive()){
+				TWHEEL_UpdatePulseWidth(SCT0, _sctimerClock, dwell, _event);
+			}
+			else if(!PLAYBACK_IsActive()){
+				IPULSE_UpdatePulseWidth(SCT0,CMD_OUTPUT, _sctimerClock, dwell, _event);
+				VERIFY_SetCommand(_sctimerClock, trToHz(currentRpm), dwell);
+				JITTER_SetFrequency(_sctimerClock, trToHz(currentRpm));
+			}
+			CRASH_LogEvent(CRASH_EVT_WIDTH, dwell);
+			UpdateState();
+    		break;
+
+    	case UPDATE_MODE:
+
+    		// The resources are released at the end of a pulse then the new mode is configured
+			ReleasePulses();
+			if(SetupPulses(currentRpm, dwell, _strikes) != kStatus_Success){
+				RefuseMode(_wheelTeeth, _strikes);
+				_wheelTeeth = 0;
+				_strikes = 1;
+				SetupPulses(currentRpm, dwell, _strikes);
+			}
+			IPULSE_EnablePulse(SCT0, CMD_OUTPUT, pwmEnable);
 			UpdateState();
     		break;
 
@@ -306,6 +496,28 @@ int main(void) {
     return 0 ;
 }
 
+/**
+ * @brief Display the main screen.
+ * @param cmdRpm Command RPM.
+ * @param currentRpm Running RPM.
+ * @param pwmEnable Pulse output enabled.
+ */
+void DisplayMainScreen(uint32_t cmdRpm, uint32_t currentRpm, uint8_t pwmEnable){
+
+	ui_model_t model;					// Initial values of the screen.
+
+	model.cmdRpm = cmdRpm;
+	model.runningRpm = currentRpm;
+	model.trips = OCP_GetTrips();
+	model.strikes = _strikes;
+	model.match = 1;
+	model.enabled = pwmEnable;
+	UI_Init(&model, MIN_TR_MIN, MAX_TR_MIN);
+
+    LED_ResetAll();
+    LED_SetLed(LED_GREEN_LED, pwmEnable);
+}
+
 /**
  *
  * @param trMin
@@ -328,6 +540,268 @@ uint32_t trToHz(uint32_t trMin){
 	return freq;
 }
 
+/**
+ * @brief Configure the pulse engine: trigger wheel generator when '_wheelTeeth' is set, otherwise
+ * crank trigger, single pulse or multi-spark mode.
+ * The counter must be halted, the pulses are started by 'IPULSE_EnablePulse()'.
+ * @param rpm			RPM to set.
+ * @param pulseWidth	Pulse (or strike) width to set [us].
+ * @param strikes		Number of strikes per period, '1' for a single pulse, '0' for the crank trigger mode.
+ * @return 'kStatus_Success' on success.
+ */
+status_t SetupPulses(uint32_t rpm, uint32_t pulseWidth, uint32_t strikes){
+
+	status_t res;
+
+	if(_wheelTeeth){
+		if(WHEEL_OUTPUT_PIN == SWM_PIN_NONE){
+			return kStatus_Fail;
+		}
+
+		// Route the wheel signal to its pin
+		CLOCK_EnableClock(kCLOCK_Swm);
+		SWM_SetMovablePinSelect(SWM0, kSWM_SCT_OUT1, WHEEL_OUTPUT_PIN);
+		CLOCK_DisableClock(kCLOCK_Swm);
+
+		return TWHEEL_Setup(SCT0, _wheelTeeth, _wheelMissing, WHEEL_SPARK_TOOTH, pulseWidth, _sctimerClock, trToHz(rpm),
+				CMD_OUTPUT, WHEEL_OUTPUT, (uint32_t *)&_event);
+	}
+
+	if(strikes == 0){
+		if(CRANK_INPUT_PIN == SWM_PIN_NONE){
+			return kStatus_Fail;
+		}
+
+		// Route the crank signal to the SCTimer input
+		CLOCK_EnableClock(kCLOCK_Swm);
+		SWM_SetMovablePinSelect(SWM0, kSWM_SCT_PIN0, CRANK_INPUT_PIN);
+		CLOCK_DisableClock(kCLOCK_Swm);
+		INPUTMUX->SCT0_INMUX[CRANK_SCT_INPUT] = INPUTMUX_SCT0_INMUX_INP_N(0);
+
+		_crankRpm = 0;
+		return IPULSE_SetupCrankTrigger(SCT0, pulseWidth, _sctimerClock, CRANK_SCT_INPUT, CMD_OUTPUT, (uint32_t *)&_event);
+	}
+
+	if(strikes > 1){
+		res = IPULSE_SetupMultiSpark(SCT0, pulseWidth, MULTI_SPARK_GAP_US, strikes, _sctimerClock, trToHz(rpm), CMD_OUTPUT, (uint32_t *)&_event);
+		if(res == kStatus_Success){
+			SAFETY_SetMaxDwell(SCT0, CMD_OUTPUT, _sctimerClock, MAX_DWELL_US);
+			OCP_Start(SCT0, CMD_OUTPUT);
+		}
+		return res;
+	}
+
+	res = IPULSE_SetupPulse(SCT0, pulseWidth, _sctimerClock, trToHz(rpm), CMD_OUTPUT, (uint32_t *)&_event);
+	if(res == kStatus_Success){
+		SAFETY_SetMaxDwell(SCT0, CMD_OUTPUT, _sctimerClock, MAX_DWELL_US);
+		OCP_Start(SCT0, CMD_OUTPUT);
+		IPULSE_EnableDithering(SCT0, _sctimerClock, trToHz(rpm), _event,
+				PULSE_DITHERING && !_playback && _jitter.distribution == JITTER_OFF);
+
+		// The played trace replaces the command, only the unperturbed single pulse is verified
+		if(_playback){
+			PLAYBACK_Start(SCT0, _sctimerClock, _event, _playback);
+		}
+		else if(_jitter.distribution != JITTER_OFF){
+			JITTER_Start(SCT0, _sctimerClock, trToHz(rpm), _event, &_jitter);
+		}
+		else{
+			VERIFY_Start(SCT0, VERIFY_SCT_INPUT, _event);
+			VERIFY_SetCommand(_sctimerClock, trToHz(rpm), pulseWidth);
+		}
+	}
+	return res;
+}
+
+/**
+ * @brief Release the resources of the running pulse mode.
+ */
+void ReleasePulses(void){
+
+	VERIFY_Stop(SCT0);
+	PLAYBACK_Stop();
+	JITTER_Stop();
+
+	if(TWHEEL_IsActive()){
+		TWHEEL_Release(SCT0, _event);
+
+		// Release the pin of the wheel signal
+		CLOCK_EnableClock(kCLOCK_Swm);
+		SWM_SetMovablePinSelect(SWM0, kSWM_SCT_OUT1, SWM_PIN_NONE);
+		CLOCK_DisableClock(kCLOCK_Swm);
+	}
+	else{
+		IPULSE_ReleasePulse(SCT0, CMD_OUTPUT, _event);
+	}
+	SAFETY_ReleaseMaxDwell(SCT0);
+	OCP_Stop(SCT0);
+}
+
+/**
+ * @brief Count a refused pulse mode and log it, the count is in the answer of the 'K' and 'W' commands.
+ * @param teeth Wheel teeth of the refused mode, '0' if it isn't the trigger wheel generator.
+ * @param strikes Strikes of the refused mode, '0' for the crank trigger mode.
+ */
+void RefuseMode(uint32_t teeth, uint32_t strikes){
+
+	_modeRefusals++;
+	CRASH_LogEvent(CRASH_EVT_MODE_REFUSED, teeth ? teeth : strikes);
+}
+
+/**
+ * @brief Telemetry command setting the trigger wheel generator.
+ * @param args Number of teeth including the missing ones and number of missing teeth ("60 2", "36 1"), '0' to stop it.
+ * The generator is refused without wheel output pin, the answer has the refused modes count.
+ */
+void SetWheel_command(const char *args){
+
+	uint32_t teeth, missing = 0;
+
+	if(TELEMETRY_ParseDec(&args, &teeth)){
+		TELEMETRY_ParseDec(&args, &missing);
+		if(teeth && missing < teeth && WHEEL_OUTPUT_PIN == SWM_PIN_NONE){
+			RefuseMode(teeth, 0);
+		}
+		else if(teeth == 0 || missing < teeth){
+			_wheelTeeth = teeth;
+			_wheelMissing = missing;
+			PushState(UPDATE_MODE);
+		}
+	}
+
+	TELEMETRY_WriteString("W");
+	TELEMETRY_WriteField("teeth", _wheelTeeth);
+	TELEMETRY_WriteField("missing", _wheelMissing);
+	TELEMETRY_WriteField("refused", _modeRefusals);
+	TELEMETRY_WriteEnd();
+}
+
+/**
+ * @brief Telemetry command setting the number of strikes per period.
+ * @param args Number of strikes, '1' for a single pulse, '0' for the crank trigger mode (refused without crank input pin).
+ * The answer has the refused modes count.
+ */
+void SetStrikes_command(const char *args){
+
+	uint32_t strikes;
+
+	if(TELEMETRY_ParseDec(&args, &strikes) && strikes <= FSL_FEATURE_SCT_NUMBER_OF_STATES){
+		if(strikes == 0 && CRANK_INPUT_PIN == SWM_PIN_NONE){
+			RefuseMode(0, strikes);
+		}
+		else{
+			_strikes = strikes;
+			PushState(UPDATE_MODE);
+		}
+	}
+
+	TELEMETRY_WriteString("K");
+	TELEMETRY_WriteField("strikes", _strikes);
+	TELEMETRY_WriteField("refused", _modeRefusals);
+	TELEMETRY_WriteEnd();
+}
+
+/**
+ * @brief Telemetry command setting the playback source.
+ * @param args Source (PLAYBACK_SOURCE), '0' to stop. Only the single pulse mode is played.
+ */
+void SetPlayback_command(const char *args){
+
+	uint32_t source;
+
+	if(TELEMETRY_ParseDec(&args, &source) && source <= PLAYBACK_STREAM){
+		_playback = source;
+		PushState(UPDATE_MODE);
+	}
+
+	PLAYBACK_PrintStats(args);
+}
+
+/**
+ * @brief Telemetry command setting the random perturbation of the period.
+ * @param args Distribution (JITTER_DISTRIBUTION), amplitude [us], filter shift and seed ("2 500 2 1234"),
+ * '0' to stop. Only the single pulse mode is perturbed.
+ */
+void SetJitter_command(const char *args){
+
+	jitter_config_t config = _jitter;
+
+	if(TELEMETRY_ParseDec(&args, &config.distribution) && config.distribution < JITTER_DISTRIBUTION_COUNT){
+		TELEMETRY_ParseDec(&args, &config.amplitude_us);
+		TELEMETRY_ParseDec(&args, &config.shift);
+		TELEMETRY_ParseDec(&args, &config.seed);
+		if(config.shift <= JITTER_MAX_SHIFT && config.seed != 0){
+			_jitter = config;
+			PushState(UPDATE_MODE);
+		}
+	}
+
+	JITTER_PrintStats(args);
+}
+
+/**
+ * @brief Pulse width applied at an RPM: the dwell map when it is valid, else the user pulse width.
+ * The map value is limited to the dwell range of the coil.
+ * @param rpm			RPM.
+ * @param pulseWidth	User pulse width [us].
+ * @return The pulse width to apply [us].
+ */
+uint32_t GetDwell(uint32_t rpm, uint32_t pulseWidth){
+
+	int32_t dwell;
+
+	if(!USE_MAPS || !MAP_IsValid(MAP_DWELL)){
+		return pulseWidth;
+	}
+
+	dwell = MAP_Evaluate(MAP_DWELL, rpm, SUPPLY_VOLTAGE_MV);
+	if(dwell < MIN_DWELL_US){
+		return MIN_DWELL_US;
+	}
+	if(dwell > MAX_DWELL_US){
+		return MAX_DWELL_US;
+	}
+	return dwell;
+}
+
+/**
+ * @brief Publish the measured crank RPM and follow it with the spark delay.
+ * Called from the main loop in crank trigger mode. The map advance is limited so the pulse is
+ * scheduled after the crank edge.
+ */
+void UpdateCrank(void){
+
+	uint32_t period_us = IPULSE_GetCrankPeriod_us(SCT0, _sctimerClock, _event);
+	int32_t advance;
+
+	_crankRpm = period_us ? 60000000U / period_us : 0;
+	if(USE_MAPS && MAP_IsValid(MAP_ADVANCE)){
+		advance = MAP_Evaluate(MAP_ADVANCE, _crankRpm, SUPPLY_VOLTAGE_MV);
+		if(advance < CRANK_MIN_ADVANCE_CDEG){
+			advance = CRANK_MIN_ADVANCE_CDEG;
+		}
+		else if(advance > CRANK_MAX_ADVANCE_CDEG){
+			advance = CRANK_MAX_ADVANCE_CDEG;
+		}
+		_crankAdvance = advance;
+	}
+	IPULSE_UpdateCrankAdvance(SCT0, _event, CRANK_TRIGGER_ANGLE_CDEG, _crankAdvance);
+}
+
+/**
+ * @brief Telemetry command printing the measured crank period.
+ * The advance is printed in two's complement.
+ * @param args Unused.
+ */
+void PrintCrank_command(const char *args){
+
+	TELEMETRY_WriteString("R");
+	TELEMETRY_WriteField("period", IPULSE_GetCrankPeriod_us(SCT0, _sctimerClock, _event));
+	TELEMETRY_WriteField("rpm", _crankRpm);
+	TELEMETRY_WriteField("advance", (uint32_t)_crankAdvance);
+	TELEMETRY_WriteEnd();
+}
+
 /**
  *
  */
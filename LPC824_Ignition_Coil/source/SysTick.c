@@ -8,8 +8,10 @@
 
 
 #include "SysTick.h"
+#include "isr_stats.h"
 
 volatile uint32_t _ticks = 0;
+static uint32_t s_tickPeriod_us = 1000;	///< Systick period [us].
 
 /**
  * @brief Initialize the Systick interruption to the provide [ms].
@@ -17,11 +19,12 @@ volatile uint32_t _ticks = 0;
  */
 void SYSTICK_Init_ms(uint32_t ms)
 {
-	assert(CLOCK_GetFreq(kCLOCK_MainClk) > 1000);
+	assert(CLOCK_GetFreq(kCLOCK_CoreSysClk) > 1000);
 	if(ms <1)
 		ms= 1;
 
-	SysTick_Config(ms * CLOCK_GetFreq(kCLOCK_MainClk)/1000);
+	s_tickPeriod_us = ms * 1000;
+	SysTick_Config(ms * CLOCK_GetFreq(kCLOCK_CoreSysClk)/1000);
 }
 
 /**
@@ -30,10 +33,11 @@ void SYSTICK_Init_ms(uint32_t ms)
  */
 void SYSTICK_Init_us(uint32_t us)
 {
-	assert(CLOCK_GetFreq(kCLOCK_MainClk) > 1000000);
+	assert(CLOCK_GetFreq(kCLOCK_CoreSysClk) > 1000000);
 	if(us <1)
 		us= 1;
-	SysTick_Config(us * CLOCK_GetFreq(kCLOCK_MainClk)/1000000);
+	s_tickPeriod_us = us;
+	SysTick_Config(us * CLOCK_GetFreq(kCLOCK_CoreSysClk)/1000000);
 }
 
 /**
@@ -41,8 +45,12 @@ void SYSTICK_Init_us(uint32_t us)
  *
  * Add one tick every time it's called.
  */
-SysTick_Handler(void){
+void SysTick_Handler(void){
+
+	// The counter is reloaded at the tick event, the counted down value is the latency
+	ISRSTATS_ENTER(ISRSTATS_SYSTICK, SysTick->LOAD - SysTick->VAL);
 	_ticks++;
+	ISRSTATS_EXIT(ISRSTATS_SYSTICK);
 }
 
 /**
@@ -52,3 +60,22 @@ SysTick_Handler(void){
 uint32_t SYSTICK_GetTicks(void){
 	return _ticks;
 }
+
+/**
+ * @brief Get the time elapsed since the Systick initialization.
+ * The sub-tick part is read from the Systick counter.
+ * @return Elapsed time [us].
+ */
+uint32_t SYSTICK_GetTime_us(void){
+
+	uint32_t ticks, count;
+	uint32_t reload = SysTick->LOAD + 1;
+
+	// Read again if the tick changed while reading the counter
+	do{
+		ticks = _ticks;
+		count = SysTick->VAL;
+	}while(ticks != _ticks);
+
+	return ticks * s_tickPeriod_us + (uint64_t)(reload - count) * s_tickPeriod_us / reload;
+}
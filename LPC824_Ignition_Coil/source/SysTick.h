@@ -26,7 +26,7 @@ void SYSTICK_Init_us(uint32_t us);
  * @brief Handler of the systick event.
  * Add one tick.
  */
-SysTick_Handler(void);
+void SysTick_Handler(void);
 
 /**
  * @brief Get the current ticks.
@@ -34,4 +34,11 @@ SysTick_Handler(void);
  */
 uint32_t SYSTICK_GetTicks(void);
 
+/**
+ * @brief Get the time elapsed since the Systick initialization.
+ * The sub-tick part is read from the Systick counter.
+ * @return Elapsed time [us].
+ */
+uint32_t SYSTICK_GetTime_us(void);
+
 #endif /* SYSTICK_H_ */
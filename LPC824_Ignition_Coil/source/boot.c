@@ -0,0 +1,62 @@
+/**
+ * @file boot.c
+ *
+ * @brief Boot milestones instrumentation.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each milestone stores the time elapsed since the Systick initialization when it is first
+ * reached. The report is printed on the telemetry link.
+ */
+
+#include "boot.h"
+#include "SysTick.h"
+#include "telemetry.h"
+
+static uint32_t s_time_us[BOOT_MILESTONE_COUNT];	///< Time of each milestone [us].
+static uint8_t s_reached[BOOT_MILESTONE_COUNT];		///< Milestone reached flags.
+
+/**
+ * @brief Names printed in the report.
+ */
+static const char *const s_names[BOOT_MILESTONE_COUNT] = {
+		"clock",
+		"pulse",
+		"inputs",
+		"telemetry",
+		"lcdStart",
+		"loop",
+		"lcdOn",
+		"splash"
+};
+
+/**
+ * @brief Record a milestone. Only the first call for each milestone is recorded.
+ * @param milestone Milestone reached (BOOT_MILESTONE).
+ */
+void BOOT_Mark(uint8_t milestone){
+
+	if(milestone >= BOOT_MILESTONE_COUNT || s_reached[milestone]){
+		return;
+	}
+
+	s_time_us[milestone] = SYSTICK_GetTime_us();
+	s_reached[milestone] = 1;
+}
+
+/**
+ * @brief Telemetry command printing the milestones time.
+ * @param args Unused.
+ */
+void BOOT_PrintReport(const char *args){
+
+	uint8_t i;
+
+	TELEMETRY_WriteString("B");
+	for(i = 0; i < BOOT_MILESTONE_COUNT; i++){
+		if(s_reached[i]){
+			TELEMETRY_WriteField(s_names[i], s_time_us[i]);
+		}
+	}
+	TELEMETRY_WriteEnd();
+}
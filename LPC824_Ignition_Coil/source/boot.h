@@ -0,0 +1,45 @@
+/**
+ * @file boot.h
+ *
+ * @brief Boot milestones instrumentation.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each milestone stores the time elapsed since the Systick initialization when it is first
+ * reached. The report is printed on the telemetry link.
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include "board.h"
+
+/**
+ * @brief Boot milestones, in their expected order.
+ */
+enum BOOT_MILESTONE
+{
+	BOOT_CLOCK = 0,			///< Clocks and Systick configured (time origin).
+	BOOT_PULSE_READY,		///< Pulse engine configured, and started on warm restart.
+	BOOT_INPUTS_READY,		///< Coder and switch interrupts enabled.
+	BOOT_TELEMETRY_READY,	///< Telemetry link initialized.
+	BOOT_LCD_STARTED,		///< LCD power-up sequence started.
+	BOOT_MAIN_LOOP,			///< First main loop iteration.
+	BOOT_LCD_ON,			///< LCD display enabled, splash screen displayed.
+	BOOT_SPLASH_DONE,		///< Splash screen hold elapsed, main screen displayed.
+	BOOT_MILESTONE_COUNT	///< Number of milestones.
+};
+
+/**
+ * @brief Record a milestone. Only the first call for each milestone is recorded.
+ * @param milestone Milestone reached (BOOT_MILESTONE).
+ */
+void BOOT_Mark(uint8_t milestone);
+
+/**
+ * @brief Telemetry command printing the milestones time.
+ * @param args Unused.
+ */
+void BOOT_PrintReport(const char *args);
+
+#endif /* BOOT_H_ */
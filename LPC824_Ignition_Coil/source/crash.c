@@ -0,0 +1,291 @@
+/**
+ * @file crash.c
+ *
+ * @brief Crash snapshot kept in no-init RAM and warm restart of the pulse engine.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The running pulse configuration and the last events are continuously stored in a RAM
+ * region that is not initialized by the startup code. On a hard fault the coil output is
+ * forced to its inactive state, the core registers are captured with the last events and
+ * the pulse configuration, then the chip is reset.\n
+ * At the next boot 'CRASH_Init()' reports the warm restart so the previous RPM and pulse
+ * width can be restored before anything slow is initialized.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <cr_section_macros.h>
+
+#include "crash.h"
+#include "SysTick.h"
+#include "telemetry.h"
+
+#define CRASH_LIVE_MAGIC		0x4C495645U		///< Magic of the live record ("LIVE").
+#define CRASH_SNAPSHOT_MAGIC	0x43524153U		///< Magic of the snapshot ("CRAS").
+
+#define CRASH_RAM_START		0x10000000U		///< Start of the SRAM.
+#define CRASH_RAM_END		0x10002000U		///< End of the SRAM.
+
+/**
+ * @brief Record continuously updated by the application.
+ */
+typedef struct
+{
+	uint32_t magic;				///< Set to 'CRASH_LIVE_MAGIC' once initialized.
+	uint32_t faultCount;		///< Number of consecutive faults.
+	uint32_t faultPending;		///< A fault has been captured and not yet reported.
+	uint32_t eventIndex;		///< Next entry to write in the event log.
+	crash_pulse_config_t pulse;					///< Running pulse configuration.
+	crash_event_t events[CRASH_EVENT_COUNT];	///< Event log.
+}crash_live_t;
+
+__NOINIT_DEF static crash_live_t s_live;			///< Live record, kept across resets.
+__NOINIT_DEF static crash_snapshot_t s_snapshot;	///< Last snapshot, kept across resets.
+
+static uint8_t s_restore;		///< The pulse configuration has to be restored.
+
+/**
+ * @brief Compute the checksum of a snapshot.
+ * @param snapshot Snapshot to check.
+ * @return The checksum.
+ */
+static uint32_t CRASH_Checksum(const crash_snapshot_t *snapshot){
+
+	const uint32_t *word = (const uint32_t *)snapshot;
+	uint32_t sum = 0;
+	uint32_t i;
+
+	for(i = 0; i < offsetof(crash_snapshot_t, checksum) / sizeof(uint32_t); i++){
+		sum = ((sum << 1) | (sum >> 31)) ^ word[i];
+	}
+	return ~sum;
+}
+
+/**
+ * @brief Validate the no-init RAM region.
+ * Must be called before any other function of this module.
+ * @return '1' if the previous run ended with a captured fault, '0' otherwise.
+ */
+uint8_t CRASH_Init(void){
+
+	uint8_t warm = 0;
+	uint32_t resetStatus = SYSCON->SYSRSTSTAT;
+
+	// Reset status bits are sticky, clear them for the next reset
+	SYSCON->SYSRSTSTAT = resetStatus;
+
+	// After a power-on reset the RAM content is random
+	if(s_live.magic != CRASH_LIVE_MAGIC || (resetStatus & SYSCON_SYSRSTSTAT_POR_MASK)){
+		memset(&s_live, 0, sizeof(s_live));
+		memset(&s_snapshot, 0, sizeof(s_snapshot));
+		s_live.magic = CRASH_LIVE_MAGIC;
+	}
+	else if(s_live.faultPending){
+		warm = 1;
+		s_live.faultPending = 0;
+	}
+
+	s_live.eventIndex &= CRASH_EVENT_COUNT - 1;
+	s_restore = warm && s_live.pulse.rpm && s_live.faultCount < CRASH_MAX_WARM_RESTARTS;
+
+	CRASH_LogEvent(CRASH_EVT_BOOT, s_live.faultCount);
+
+	return warm;
+}
+
+/**
+ * @brief Get the pulse configuration to restore after a warm restart.
+ * @param config Pointer where the configuration is stored.
+ * @return '1' if the configuration must be restored, '0' on cold boot or if too many faults occurred.
+ */
+uint8_t CRASH_GetPulseConfig(crash_pulse_config_t *config){
+
+	if(!s_restore){
+		return 0;
+	}
+
+	*config = s_live.pulse;
+	return 1;
+}
+
+/**
+ * @brief Store the running pulse configuration.
+ * @param rpm Running RPM.
+ * @param pulseWidth_us Pulse width [us].
+ * @param enabled Pulse output enabled.
+ */
+void CRASH_SetPulseConfig(uint32_t rpm, uint32_t pulseWidth_us, uint8_t enabled){
+
+	s_live.pulse.rpm = rpm;
+	s_live.pulse.pulseWidth_us = pulseWidth_us;
+	s_live.pulse.enabled = enabled;
+}
+
+/**
+ * @brief Add an event to the event log.
+ * @param code Event code (CRASH_EVENT).
+ * @param arg Event argument.
+ */
+void CRASH_LogEvent(uint16_t code, uint16_t arg){
+
+	uint32_t primask = DisableGlobalIRQ();
+	crash_event_t *event = &s_live.events[s_live.eventIndex];
+
+	event->tick = SYSTICK_GetTicks();
+	event->code = code;
+	event->arg = arg;
+	s_live.eventIndex = (s_live.eventIndex + 1) & (CRASH_EVENT_COUNT - 1);
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Clear the fault counter once the application ran long enough without fault.
+ * Must be called from the main loop.
+ */
+void CRASH_Process(void){
+
+	if(s_live.faultCount && SYSTICK_GetTicks() > CRASH_STABLE_TIME_MS){
+		s_live.faultCount = 0;
+	}
+}
+
+/**
+ * @brief Get the last captured snapshot.
+ * @return The snapshot or 'NULL' if none is valid.
+ */
+const crash_snapshot_t *CRASH_GetSnapshot(void){
+
+	if(s_snapshot.magic != CRASH_SNAPSHOT_MAGIC || s_snapshot.checksum != CRASH_Checksum(&s_snapshot)){
+		return NULL;
+	}
+	return &s_snapshot;
+}
+
+/**
+ * @brief Telemetry command printing the last snapshot.
+ * @param args "0" clears the snapshot after printing it.
+ */
+void CRASH_PrintSnapshot(const char *args){
+
+	const crash_snapshot_t *snapshot = CRASH_GetSnapshot();
+	uint32_t i;
+
+	TELEMETRY_WriteString("F");
+	if(snapshot == NULL){
+		TELEMETRY_WriteString(" none");
+		TELEMETRY_WriteEnd();
+		return;
+	}
+
+	TELEMETRY_WriteHexField("pc", snapshot->pc);
+	TELEMETRY_WriteHexField("lr", snapshot->lr);
+	TELEMETRY_WriteHexField("xpsr", snapshot->xpsr);
+	TELEMETRY_WriteHexField("sp", snapshot->sp);
+	TELEMETRY_WriteHexField("exc", snapshot->excReturn);
+	TELEMETRY_WriteField("tick", snapshot->tick);
+	TELEMETRY_WriteEnd();
+
+	TELEMETRY_WriteString("F");
+	for(i = 0; i < 8; i++){
+		char name[] = {'r', '0' + i, '\0'};
+		TELEMETRY_WriteHexField(name, snapshot->r[i]);
+	}
+	TELEMETRY_WriteHexField("r12", snapshot->r12);
+	TELEMETRY_WriteEnd();
+
+	TELEMETRY_WriteString("F");
+	TELEMETRY_WriteHexField("ctrl", snapshot->sctCtrl);
+	TELEMETRY_WriteHexField("out", snapshot->sctOutput);
+	TELEMETRY_WriteField("state", snapshot->sctState);
+	TELEMETRY_WriteField("count", snapshot->sctCount);
+	TELEMETRY_WriteField("rpm", snapshot->pulse.rpm);
+	TELEMETRY_WriteField("width", snapshot->pulse.pulseWidth_us);
+	TELEMETRY_WriteField("on", snapshot->pulse.enabled);
+	TELEMETRY_WriteField("faults", s_live.faultCount);
+	TELEMETRY_WriteEnd();
+
+	for(i = 0; i < CRASH_EVENT_COUNT; i++){
+		if(snapshot->events[i].code){
+			TELEMETRY_WriteString("E");
+			TELEMETRY_WriteField("tick", snapshot->events[i].tick);
+			TELEMETRY_WriteField("code", snapshot->events[i].code);
+			TELEMETRY_WriteField("arg", snapshot->events[i].arg);
+			TELEMETRY_WriteEnd();
+		}
+	}
+
+	if(args[0] == '0'){
+		s_snapshot.magic = 0;
+	}
+}
+
+/**
+ * @brief Capture the snapshot and reset the chip. Called by the hard fault handler.
+ * @param frame Exception stack frame (R0-R3, R12, LR, PC, xPSR).
+ * @param excReturn EXC_RETURN value.
+ * @param callee Registers R4 to R7 pushed by the hard fault handler.
+ */
+void CRASH_HardFault(uint32_t *frame, uint32_t excReturn, uint32_t *callee){
+
+	uint32_t i;
+
+	// Put the coil output in its inactive state before anything else
+	if(SYSCON->SYSAHBCLKCTRL & SYSCON_SYSAHBCLKCTRL_SCT_MASK){
+		s_snapshot.sctCtrl = SCT0->CTRL;
+		SCT0->CTRL |= SCT_CTRL_HALT_L_MASK | SCT_CTRL_HALT_H_MASK;
+		s_snapshot.sctOutput = SCT0->OUTPUT;
+		SCT0->OUTPUT = 0;
+		s_snapshot.sctState = SCT0->STATE;
+		s_snapshot.sctCount = SCT0->COUNT;
+	}
+	else{
+		s_snapshot.sctCtrl = 0;
+		s_snapshot.sctOutput = 0;
+		s_snapshot.sctState = 0;
+		s_snapshot.sctCount = 0;
+	}
+
+	// The frame can't be read if the fault comes from a corrupted stack pointer
+	if((uint32_t)frame >= CRASH_RAM_START && (uint32_t)frame <= CRASH_RAM_END - 8 * sizeof(uint32_t)){
+		for(i = 0; i < 4; i++){
+			s_snapshot.r[i] = frame[i];
+		}
+		s_snapshot.r12 = frame[4];
+		s_snapshot.lr = frame[5];
+		s_snapshot.pc = frame[6];
+		s_snapshot.xpsr = frame[7];
+	}
+	else{
+		for(i = 0; i < 4; i++){
+			s_snapshot.r[i] = 0;
+		}
+		s_snapshot.r12 = 0;
+		s_snapshot.lr = 0;
+		s_snapshot.pc = 0;
+		s_snapshot.xpsr = 0;
+	}
+
+	for(i = 0; i < 4; i++){
+		s_snapshot.r[4 + i] = callee[i];
+	}
+	s_snapshot.excReturn = excReturn;
+	s_snapshot.sp = (uint32_t)frame + 8 * sizeof(uint32_t);
+	s_snapshot.tick = SYSTICK_GetTicks();
+	s_snapshot.pulse = s_live.pulse;
+
+	// Copy the event log oldest first
+	for(i = 0; i < CRASH_EVENT_COUNT; i++){
+		s_snapshot.events[i] = s_live.events[(s_live.eventIndex + i) & (CRASH_EVENT_COUNT - 1)];
+	}
+
+	s_snapshot.magic = CRASH_SNAPSHOT_MAGIC;
+	s_snapshot.checksum = CRASH_Checksum(&s_snapshot);
+
+	s_live.faultCount++;
+	s_live.faultPending = 1;
+
+	NVIC_SystemReset();
+	while(1);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file crash.h
+ *
+ * @brief Crash snapshot kept in no-init RAM and warm restart of the pulse engine.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The running pulse configuration and the last events are continuously stored in a RAM
+ * region that is not initialized by the startup code. On a hard fault the coil output is
+ * forced to its inactive state, the core registers are captured with the last events and
+ * the pulse configuration, then the chip is reset.\n
+ * At the next boot 'CRASH_Init()' reports the warm restart so the previous RPM and pulse
+ * width can be restored before anything slow is initialized.
+ */
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include "board.h"
+
+#define CRASH_EVENT_COUNT			8			///< Number of events kept in the event log. Must be a power of 2.
+#define CRASH_MAX_WARM_RESTARTS		3			///< Consecutive faults after which the pulses are not restarted.
+#define CRASH_STABLE_TIME_MS		10000		///< Run time without fault after which the fault counter is cleared [ms].
+
+/**
+ * @brief Events stored in the event log.
+ */
+enum CRASH_EVENT
+{
+	CRASH_EVT_BOOT = 1,		///< Boot. Argument is the consecutive fault count.
+	CRASH_EVT_STATE,		///< Main state machine state. Argument is the state.
+	CRASH_EVT_ENABLE,		///< Pulse enable. Argument is the enable state.
+	CRASH_EVT_RPM,			///< RPM update. Argument is the RPM.
+	CRASH_EVT_WIDTH,		///< Pulse width update. Argument is the width [us].
+	CRASH_EVT_TIMING,		///< Measured pulse out of tolerance. Argument is the RPM.
+	CRASH_EVT_WATCHDOG,		///< Watchdog warning, the output is cut before the reset. No argument.
+	CRASH_EVT_OVERCURRENT,	///< Overcurrent trip. Argument is the trip count.
+	CRASH_EVT_MODE_REFUSED	///< Pulse mode refused, the single pulse is kept. Argument is the wheel teeth, else the strikes.
+};
+
+/**
+ * @brief Pulse configuration restored on warm restart.
+ */
+typedef struct
+{
+	uint32_t rpm;				///< Running RPM.
+	uint32_t pulseWidth_us;		///< Pulse width [us].
+	uint32_t enabled;			///< Pulse output enabled.
+}crash_pulse_config_t;
+
+/**
+ * @brief Entry of the event log.
+ */
+typedef struct
+{
+	uint32_t tick;		///< SysTick count when the event occurred [ms].
+	uint16_t code;		///< Event code (CRASH_EVENT).
+	uint16_t arg;		///< Event argument.
+}crash_event_t;
+
+/**
+ * @brief Snapshot captured by the hard fault handler.
+ */
+typedef struct
+{
+	uint32_t magic;			///< Set to a known value when the snapshot is valid.
+	uint32_t r[8];			///< Registers R0 to R7.
+	uint32_t r12;			///< Stacked R12.
+	uint32_t lr;			///< Stacked LR.
+	uint32_t pc;			///< Stacked PC (faulting instruction).
+	uint32_t xpsr;			///< Stacked xPSR.
+	uint32_t excReturn;		///< EXC_RETURN value of the fault.
+	uint32_t sp;			///< Stack pointer before the exception frame.
+	uint32_t tick;			///< SysTick count at fault [ms].
+	uint32_t sctCtrl;		///< SCTimer CTRL register at fault.
+	uint32_t sctOutput;		///< SCTimer OUTPUT register at fault.
+	uint32_t sctState;		///< SCTimer STATE register at fault.
+	uint32_t sctCount;		///< SCTimer COUNT register at fault.
+	crash_pulse_config_t pulse;					///< Pulse configuration at fault.
+	crash_event_t events[CRASH_EVENT_COUNT];	///< Last events, oldest first.
+	uint32_t checksum;		///< Checksum of the snapshot.
+}crash_snapshot_t;
+
+/**
+ * @brief Validate the no-init RAM region.
+ * Must be called before any other function of this module.
+ * @return '1' if the previous run ended with a captured fault, '0' otherwise.
+ */
+uint8_t CRASH_Init(void);
+
+/**
+ * @brief Get the pulse configuration to restore after a warm restart.
+ * @param config Pointer where the configuration is stored.
+ * @return '1' if the configuration must be restored, '0' on cold boot or if too many faults occurred.
+ */
+uint8_t CRASH_GetPulseConfig(crash_pulse_config_t *config);
+
+/**
+ * @brief Store the running pulse configuration.
+ * @param rpm Running RPM.
+ * @param pulseWidth_us Pulse width [us].
+ * @param enabled Pulse output enabled.
+ */
+void CRASH_SetPulseConfig(uint32_t rpm, uint32_t pulseWidth_us, uint8_t enabled);
+
+/**
+ * @brief Add an event to the event log.
+ * @param code Event code (CRASH_EVENT).
+ * @param arg Event argument.
+ */
+void CRASH_LogEvent(uint16_t code, uint16_t arg);
+
+/**
+ * @brief Clear the fault counter once the application ran long enough without fault.
+ * Must be called from the main loop.
+ */
+void CRASH_Process(void);
+
+/**
+ * @brief Get the last captured snapshot.
+ * @return The snapshot or 'NULL' if none is valid.
+ */
+const crash_snapshot_t *CRASH_GetSnapshot(void);
+
+/**
+ * @brief Telemetry command printing the last snapshot.
+ * @param args "0" clears the snapshot after printing it.
+ */
+void CRASH_PrintSnapshot(const char *args);
+
+/**
+ * @brief Capture the snapshot and reset the chip. Called by the hard fault handler.
+ * @param frame Exception stack frame (R0-R3, R12, LR, PC, xPSR).
+ * @param excReturn EXC_RETURN value.
+ * @param callee Registers R4 to R7 pushed by the hard fault handler.
+ */
+void CRASH_HardFault(uint32_t *frame, uint32_t excReturn, uint32_t *callee) __attribute__((noreturn));
+
+#endif /* CRASH_H_ */
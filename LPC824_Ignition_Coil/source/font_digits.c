@@ -0,0 +1,50 @@
+/**
+ * @file font_digits.c
+ *
+ * @brief Scaled digit fonts, generated by 'tools/font_gen.py' from the 8x8 font. Do not edit.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each glyph column is a 32-bit word, bit 0 is the top pixel and page 'n' is byte 'n'. The offset and
+ * width of each glyph are stored in tables so the renderer only reads them.
+ */
+
+#include "font_digits.h"
+
+// Characters '0' to '9' scaled by 2
+static const uint32_t s_digits2xColumns[138] =
+{
+	0x00003FF0,0x00003FF0,0x0000FFFC,0x0000FFFC,0x0000CF0C,0x0000CF0C,0x0000C3CC,0x0000C3CC,0x0000C0FC,0x0000C0FC,0x0000FFFC,0x0000FFFC,0x00003FF0,0x00003FF0,	// [0]
+	0x0000C000,0x0000C000,0x0000C030,0x0000C030,0x0000FFFC,0x0000FFFC,0x0000FFFC,0x0000FFFC,0x0000C000,0x0000C000,0x0000C000,0x0000C000,0x00000000,0x00000000,	// [1]
+	0x0000F030,0x0000F030,0x0000FC3C,0x0000FC3C,0x0000CF0C,0x0000CF0C,0x0000C30C,0x0000C30C,0x0000F3FC,0x0000F3FC,0x0000F3F0,0x0000F3F0,	// [2]
+	0x00003030,0x00003030,0x0000F03C,0x0000F03C,0x0000C30C,0x0000C30C,0x0000C30C,0x0000C30C,0x0000FFFC,0x0000FFFC,0x00003CF0,0x00003CF0,0x00000000,0x00000000,	// [3]
+	0x00000F00,0x00000F00,0x00000FC0,0x00000FC0,0x00000CF0,0x00000CF0,0x0000CC3C,0x0000CC3C,0x0000FFFC,0x0000FFFC,0x0000FFFC,0x0000FFFC,0x0000CC00,0x0000CC00,	// [4]
+	0x000030FC,0x000030FC,0x0000F0FC,0x0000F0FC,0x0000C0CC,0x0000C0CC,0x0000C0CC,0x0000C0CC,0x0000FFCC,0x0000FFCC,0x00003F0C,0x00003F0C,0x00000000,0x00000000,	// [5]
+	0x00003FC0,0x00003FC0,0x0000FFF0,0x0000FFF0,0x0000C33C,0x0000C33C,0x0000C30C,0x0000C30C,0x0000F30C,0x0000F30C,0x00003C00,0x00003C00,0x00000000,0x00000000,	// [6]
+	0x0000003C,0x0000003C,0x0000003C,0x0000003C,0x0000FC0C,0x0000FC0C,0x0000FF0C,0x0000FF0C,0x000003FC,0x000003FC,0x000000FC,0x000000FC,0x00000000,0x00000000,	// [7]
+	0x00003CF0,0x00003CF0,0x0000FFFC,0x0000FFFC,0x0000C30C,0x0000C30C,0x0000C30C,0x0000C30C,0x0000FFFC,0x0000FFFC,0x00003CF0,0x00003CF0,0x00000000,0x00000000,	// [8]
+	0x000000F0,0x000000F0,0x0000C3FC,0x0000C3FC,0x0000C30C,0x0000C30C,0x0000F30C,0x0000F30C,0x00003FFC,0x00003FFC,0x00000FF0,0x00000FF0,0x00000000,0x00000000 	// [9]
+};
+static const uint16_t s_digits2xOffsets[10] = {0,14,28,40,54,68,82,96,110,124};
+static const uint8_t s_digits2xWidths[10] = {14,14,12,14,14,14,14,14,14,14};
+const lcd_font_t FONT_Digits2x = {.columns = s_digits2xColumns, .offsets = s_digits2xOffsets, .widths = s_digits2xWidths,
+	.first = '0', .count = 10, .pages = 2, .spacing = 2, .cellWidth = 16};
+
+// Characters '0' to '9' scaled by 3
+static const uint32_t s_digits3xColumns[207] =
+{
+	0x001FFFC0,0x001FFFC0,0x001FFFC0,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00E3F038,0x00E3F038,0x00E3F038,0x00E07E38,0x00E07E38,0x00E07E38,0x00E00FF8,0x00E00FF8,0x00E00FF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x001FFFC0,0x001FFFC0,0x001FFFC0,	// [0]
+	0x00E00000,0x00E00000,0x00E00000,0x00E001C0,0x00E001C0,0x00E001C0,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00E00000,0x00E00000,0x00E00000,0x00E00000,0x00E00000,0x00E00000,0x00000000,0x00000000,0x00000000,	// [1]
+	0x00FC01C0,0x00FC01C0,0x00FC01C0,0x00FF81F8,0x00FF81F8,0x00FF81F8,0x00E3F038,0x00E3F038,0x00E3F038,0x00E07038,0x00E07038,0x00E07038,0x00FC7FF8,0x00FC7FF8,0x00FC7FF8,0x00FC7FC0,0x00FC7FC0,0x00FC7FC0,	// [2]
+	0x001C01C0,0x001C01C0,0x001C01C0,0x00FC01F8,0x00FC01F8,0x00FC01F8,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x001F8FC0,0x001F8FC0,0x001F8FC0,0x00000000,0x00000000,0x00000000,	// [3]
+	0x0003F000,0x0003F000,0x0003F000,0x0003FE00,0x0003FE00,0x0003FE00,0x00038FC0,0x00038FC0,0x00038FC0,0x00E381F8,0x00E381F8,0x00E381F8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00E38000,0x00E38000,0x00E38000,	// [4]
+	0x001C0FF8,0x001C0FF8,0x001C0FF8,0x00FC0FF8,0x00FC0FF8,0x00FC0FF8,0x00E00E38,0x00E00E38,0x00E00E38,0x00E00E38,0x00E00E38,0x00E00E38,0x00FFFE38,0x00FFFE38,0x00FFFE38,0x001FF038,0x001FF038,0x001FF038,0x00000000,0x00000000,0x00000000,	// [5]
+	0x001FFE00,0x001FFE00,0x001FFE00,0x00FFFFC0,0x00FFFFC0,0x00FFFFC0,0x00E071F8,0x00E071F8,0x00E071F8,0x00E07038,0x00E07038,0x00E07038,0x00FC7038,0x00FC7038,0x00FC7038,0x001F8000,0x001F8000,0x001F8000,0x00000000,0x00000000,0x00000000,	// [6]
+	0x000001F8,0x000001F8,0x000001F8,0x000001F8,0x000001F8,0x000001F8,0x00FF8038,0x00FF8038,0x00FF8038,0x00FFF038,0x00FFF038,0x00FFF038,0x00007FF8,0x00007FF8,0x00007FF8,0x00000FF8,0x00000FF8,0x00000FF8,0x00000000,0x00000000,0x00000000,	// [7]
+	0x001F8FC0,0x001F8FC0,0x001F8FC0,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00E07038,0x00FFFFF8,0x00FFFFF8,0x00FFFFF8,0x001F8FC0,0x001F8FC0,0x001F8FC0,0x00000000,0x00000000,0x00000000,	// [8]
+	0x00000FC0,0x00000FC0,0x00000FC0,0x00E07FF8,0x00E07FF8,0x00E07FF8,0x00E07038,0x00E07038,0x00E07038,0x00FC7038,0x00FC7038,0x00FC7038,0x001FFFF8,0x001FFFF8,0x001FFFF8,0x0003FFC0,0x0003FFC0,0x0003FFC0,0x00000000,0x00000000,0x00000000 	// [9]
+};
+static const uint16_t s_digits3xOffsets[10] = {0,21,42,60,81,102,123,144,165,186};
+static const uint8_t s_digits3xWidths[10] = {21,21,18,21,21,21,21,21,21,21};
+const lcd_font_t FONT_Digits3x = {.columns = s_digits3xColumns, .offsets = s_digits3xOffsets, .widths = s_digits3xWidths,
+	.first = '0', .count = 10, .pages = 3, .spacing = 2, .cellWidth = 23};
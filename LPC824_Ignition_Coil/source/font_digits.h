@@ -0,0 +1,20 @@
+/**
+ * @file font_digits.h
+ *
+ * @brief Scaled digit fonts, generated by 'tools/font_gen.py' from the 8x8 font. Do not edit.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each glyph column is a 32-bit word, bit 0 is the top pixel and page 'n' is byte 'n'. The offset and
+ * width of each glyph are stored in tables so the renderer only reads them.
+ */
+
+#ifndef FONT_DIGITS_H_
+#define FONT_DIGITS_H_
+
+#include "lcd.h"
+
+extern const lcd_font_t FONT_Digits2x;		///< Characters '0' to '9' scaled by 2, 2 pages high.
+extern const lcd_font_t FONT_Digits3x;		///< Characters '0' to '9' scaled by 3, 3 pages high.
+
+#endif /* FONT_DIGITS_H_ */
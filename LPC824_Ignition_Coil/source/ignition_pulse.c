@@ -8,13 +8,121 @@
  *
  *  Override PMW functions to set an impulsion width and a frequency.\n
  *  The precision for the pulse width is +- 1[us] and the frequency +- 1[mHz].\n
- *  These Methods are based on the 'SCTIMER_SetupPwm()' in drivers files fsl_sctimer.
+ *  These Methods are based on the 'SCTIMER_SetupPwm()' in drivers files fsl_sctimer.\n
+ *  In dithering mode the period alternates between N and N+1 ticks so the average frequency is exact.\n
+ *  In crank trigger mode the pulse follows an SCTimer input: the edge restarts the counter and the pulse
+ *  starts after a programmable delay, without interrupt between the edge and the pulse.
  */
 
 #include "ignition_pulse.h"
 
-static uint32_t s_currentEvent;		///< Keep track of SCTimer event number.
+static SCT_Type *s_ditherBase;					///< SCTimer used in dithering mode.
+static uint32_t s_ditherMatch;					///< Match register of the period event.
+static uint8_t s_ditherEnabled;					///< Dithering mode enabled.
+static volatile uint32_t s_ditherPeriod;		///< Truncated period [tick].
+static volatile uint32_t s_ditherRemainder;		///< Period remainder, in 1/'s_ditherDivisor' tick.
+static volatile uint32_t s_ditherDivisor;		///< Period remainder divisor.
+static volatile uint32_t s_ditherAccumulator;	///< Accumulated remainder.
+
+static uint8_t s_multiEnabled;					///< Multi-spark mode enabled.
+static uint32_t s_multiEvent;					///< Period event of the multi-spark mode.
+static uint32_t s_multiStrikes;					///< Number of strikes per period.
+static uint32_t s_multiGap;						///< Time between the end of a strike and the next one [tick].
+
+static uint8_t s_crankEnabled;					///< Crank trigger mode enabled.
+static uint32_t s_crankEvent;					///< Input event of the crank trigger mode.
+static uint32_t s_crankCapture;					///< Capture register of the crank period.
+static uint32_t s_crankWidth;					///< Pulse width in crank trigger mode [tick].
+static uint32_t s_crankDelay;					///< Delay between the crank edge and the pulse [tick], '0' when no pulse is scheduled.
 
+/**
+ * @brief Period event callback in dithering mode.
+ * Set the period of the next cycle, the reload value is loaded in the match register at the next period event.
+ */
+static void IPULSE_DitherCallback(void){
+
+	uint32_t period = s_ditherPeriod;
+
+	s_ditherAccumulator += s_ditherRemainder;
+	if(s_ditherAccumulator >= s_ditherDivisor){
+		s_ditherAccumulator -= s_ditherDivisor;
+		period++;
+	}
+
+	s_ditherBase->SCTMATCHREL[s_ditherMatch] = period - 1;
+}
+
+/**
+ * @brief Set the dithered period.
+ * @param sctClock	SCTimer counter clock [Hz].
+ * @param freq_mHz	Pulse frequency in milli-Hertz [mHz].
+ * @return The truncated period [tick].
+ */
+static uint32_t IPULSE_SetDitherPeriod(uint32_t sctClock, uint32_t freq_mHz){
+
+	uint64_t t = (uint64_t)sctClock * 1000U;
+	uint32_t primask = DisableGlobalIRQ();
+
+	s_ditherPeriod = t / freq_mHz;
+	s_ditherRemainder = t % freq_mHz;
+	s_ditherDivisor = freq_mHz;
+	s_ditherAccumulator = 0;
+
+	EnableGlobalIRQ(primask);
+
+	return s_ditherPeriod;
+}
+
+
+/**
+ * @brief Allocate the SCTimer resources of a pulse mode. Nothing is allocated on failure.
+ * @param base			SCTimer peripheral base address.
+ * @param output		Output to allocate.
+ * @param eventCount	Number of consecutive events, each event uses its own match register.
+ * @param stateCount	Number of consecutive states.
+ * @param event			Pointer where the first event is stored.
+ * @param matches		Array where the match registers are stored, one per event.
+ * @param state			Pointer where the first state is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail'.
+ */
+static status_t IPULSE_AllocResources(SCT_Type *base, sctimer_out_t output, uint32_t eventCount, uint32_t stateCount,
+		uint32_t *event, uint32_t *matches, uint32_t *state){
+
+	uint32_t i = 0;
+
+	if(SCTMGR_AllocEvents(eventCount, event) != kStatus_Success){
+		return kStatus_Fail;
+	}
+
+	while(i < eventCount && SCTMGR_AllocMatch(&matches[i]) == kStatus_Success){
+		i++;
+	}
+
+	if(i == eventCount){
+		if(SCTMGR_AllocStates(stateCount, state) == kStatus_Success){
+			if(SCTMGR_AllocOutput(output) == kStatus_Success){
+				return kStatus_Success;
+			}
+			SCTMGR_FreeStates(*state, stateCount);
+		}
+	}
+
+	while(i){
+		SCTMGR_FreeMatch(base, matches[--i]);
+	}
+	SCTMGR_FreeEvents(base, *event, eventCount);
+
+	return kStatus_Fail;
+}
+
+/**
+ * @brief Time between the first strike start and the last strike start in multi-spark mode.
+ * @param pulsePeriod Strike width [tick].
+ * @return The span [tick].
+ */
+static uint32_t IPULSE_MultiSparkSpan(uint32_t pulsePeriod){
+	return (s_multiStrikes - 1) * (pulsePeriod + s_multiGap);
+}
 
 /**
  *@brief Initialize the impulsion width and frequency.
@@ -28,6 +136,7 @@ static uint32_t s_currentEvent;		///< Keep track of SCTimer event number.
  *
  * @return	'kStatus_Success' on success.
  * @return	'kStatus_Fail' If the limit in terms of event count is reached or if an incorrect pulse/frequency values are provided.
+ * @remark The counter must be halted, it is cleared.
  */
 status_t IPULSE_SetupPulse(SCT_Type *base,
 						  uint32_t pulseWidth_us,
@@ -44,15 +153,10 @@ status_t IPULSE_SetupPulse(SCT_Type *base,
     uint32_t period, pulsePeriod = 0;
     uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
     uint32_t periodEvent = 0, pulseEvent = 0;
+    uint32_t matches[2], state = 0;
 
     uint64_t t = sctClock;
 
-    // Return an error if not enough remaining events are available
-    if ((s_currentEvent + 2) > FSL_FEATURE_SCT_NUMBER_OF_EVENTS)
-    {
-        return kStatus_Fail;
-    }
-
     // Set unify bit to operate in 32-bit counter mode
     base->CONFIG |= SCT_CONFIG_UNIFY_MASK;
 
@@ -73,11 +177,17 @@ status_t IPULSE_SetupPulse(SCT_Type *base,
     	return kStatus_InvalidArgument;
     }
 
+    // Return an error if not enough resources are available
+    if(IPULSE_AllocResources(base, output, 2, 1, &periodEvent, matches, &state) != kStatus_Success){
+    	return kStatus_Fail;
+    }
+    pulseEvent = periodEvent + 1;
+
     // Schedule an event when the period is reached
-    SCTIMER_CreateAndScheduleEvent(base, kSCTIMER_MatchEventOnly, period, 0, kSCTIMER_Counter_L, &periodEvent);
+    SCTMGR_SetMatchEvent(base, periodEvent, matches[0], period, 1U << state);
 
     // Schedule an event when the pulse width period is reached
-    SCTIMER_CreateAndScheduleEvent(base, kSCTIMER_MatchEventOnly, pulsePeriod, 0, kSCTIMER_Counter_L, &pulseEvent);
+    SCTMGR_SetMatchEvent(base, pulseEvent, matches[1], pulsePeriod, 1U << state);
 
     // Reset the counter when the period is reached
     SCTIMER_SetupCounterLimitAction(base, kSCTIMER_Counter_L, periodEvent);
@@ -94,9 +204,359 @@ status_t IPULSE_SetupPulse(SCT_Type *base,
 	// Clear the output when the pulse period is reached
 	SCTIMER_SetupOutputClearAction(base, output, pulseEvent);
 
+	// Start the next run from the beginning of a period
+	base->STATE = state;
+	base->CTRL |= SCT_CTRL_CLRCTR_L_MASK;
+
+    return kStatus_Success;
+}
+
+/**
+ * @brief Initialize a multi-spark pulse: several strikes per period, sequenced by the SCTimer states.
+ *
+ * Each strike starts on a counter limit. The counter runs in state 'first + k' during the strike 'k':
+ * - the pulse event clears the output after the strike width, in all the states,
+ * - the next event sets the output, limits the counter and adds 1 to the state, in all the states but the last one,
+ * - the period event sets the output, limits the counter and loads the first state, in the last state only.
+ * The period event occurs one period after the first strike start, so the CPU does nothing per strike.
+ *
+ * @param base			SCTimer peripheral base address
+ * @param pulseWidth_us	Strike width in micro-second [us].
+ * @param gap_us		Time between the end of a strike and the next one [us].
+ * @param strikes		Number of strikes per period (2 to the number of states).
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Pulse frequency in milli-Hertz [mHz].
+ * @param output		Output to set.
+ * @param event			Pointer to a variable where the pulse period event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the strikes don't fit in the period.
+ * @remark The counter must be halted, it is cleared. Only one multi-spark pulse can be configured.
+ */
+status_t IPULSE_SetupMultiSpark(SCT_Type *base,
+						  uint32_t pulseWidth_us,
+						  uint32_t gap_us,
+						  uint32_t strikes,
+						  uint32_t srcClock_Hz,
+                          uint32_t freq_mHz,
+						  sctimer_out_t output,
+                          uint32_t *event)
+{
+    assert(pulseWidth_us);
+    assert(srcClock_Hz);
+    assert(freq_mHz);
+    assert(output < FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS);
+
+    uint32_t period, pulsePeriod, span;
+    uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+    uint32_t first = 0, state = 0;
+    uint32_t matches[3];
+
+    uint64_t t = sctClock;
+
+    if(s_multiEnabled || strikes < 2 || strikes > FSL_FEATURE_SCT_NUMBER_OF_STATES){
+    	return kStatus_InvalidArgument;
+    }
+
+    // Set unify bit to operate in 32-bit counter mode
+    base->CONFIG |= SCT_CONFIG_UNIFY_MASK;
+
+    // Calculate the ticks period with provide frequency [mHz]
+	t *= 1000;
+	t /= freq_mHz;
+	period = t;
+
+    // Calculate the ticks strike width and gap with provided timing [us]
+	t = pulseWidth_us;
+	t *= sctClock;
+	t /= 1000000U;
+	pulsePeriod = t;
+
+	t = gap_us;
+	t *= sctClock;
+	t /= 1000000U;
+
+	s_multiStrikes = strikes;
+	s_multiGap = t;
+	span = IPULSE_MultiSparkSpan(pulsePeriod);
+
+	// The last strike must end before the period ends
+    if(s_multiGap == 0 || span + pulsePeriod >= period){
+    	return kStatus_InvalidArgument;
+    }
+
+    if(IPULSE_AllocResources(base, output, 3, strikes, &first, matches, &state) != kStatus_Success){
+    	return kStatus_Fail;
+    }
+
+    // Period event: last state, remaining time of the period then back to the first state
+    SCTMGR_SetMatchEvent(base, first, matches[0], period - span - 1, 1U << (state + strikes - 1));
+    SCTIMER_SetupNextStateAction(base, state, first);
+
+    // Pulse event: end of the strike in all the states
+    SCTMGR_SetMatchEvent(base, first + 1, matches[1], pulsePeriod, ((1U << strikes) - 1) << state);
+
+    // Next event: next strike in all the states but the last one, 'STATELD = 0' adds 'STATEV' to the state
+    SCTMGR_SetMatchEvent(base, first + 2, matches[2], pulsePeriod + s_multiGap - 1, ((1U << (strikes - 1)) - 1) << state);
+    base->EVENT[first + 2].CTRL |= SCT_EVENT_CTRL_STATEV(1);
+
+    // Each strike starts on a counter limit
+    SCTIMER_SetupCounterLimitAction(base, kSCTIMER_Counter_L, first);
+    SCTIMER_SetupCounterLimitAction(base, kSCTIMER_Counter_L, first + 2);
+
+	// Set the initial output level to low which is the inactive state
+	base->OUTPUT &= ~(1U << output);
+
+	SCTIMER_SetupOutputSetAction(base, output, first);
+	SCTIMER_SetupOutputSetAction(base, output, first + 2);
+	SCTIMER_SetupOutputClearAction(base, output, first + 1);
+
+	// Start the next run from the beginning of a period
+	base->STATE = state + strikes - 1;
+	base->CTRL |= SCT_CTRL_CLRCTR_L_MASK;
+
+	s_multiEvent = first;
+	s_multiEnabled = 1;
+	*event = first;
+
+    return kStatus_Success;
+}
+
+/**
+ * @brief Program the crank trigger pulse position, applied from the next crank edge.
+ * @param base	SCTimer peripheral base address.
+ * @param event	Crank input event number.
+ * @param delay	Delay between the crank edge and the pulse [tick], '0' to stop the pulses.
+ */
+static void IPULSE_SetCrankDelay(SCT_Type *base, uint32_t event, uint32_t delay){
+
+	uint32_t clearMatchReg = base->EVENT[event + 1].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	uint32_t setMatchReg = base->EVENT[event + 2].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+
+	s_crankDelay = delay;
+
+	// Both reload values must be loaded by the same crank edge
+	base->CONFIG |= SCT_CONFIG_NORELAOD_L_MASK;
+	if(delay){
+		base->SCTMATCHREL[setMatchReg] = delay;
+		base->SCTMATCHREL[clearMatchReg] = delay + s_crankWidth;
+	}
+	else{
+		base->SCTMATCHREL[setMatchReg] = 0xFFFFFFFFU;
+		base->SCTMATCHREL[clearMatchReg] = 0xFFFFFFFFU;
+	}
+	base->CONFIG &= ~SCT_CONFIG_NORELAOD_L_MASK;
+}
+
+/**
+ * @brief Initialize the crank trigger mode: the pulse follows the edges of an SCTimer input.
+ *
+ * The crank edge captures the counter (the crank period), restarts it and arms the pulse:
+ * - the set event sets the output after the delay,
+ * - the pulse event clears the output after the delay plus the pulse width and disarms the pulse.
+ * The pulse is only produced once per edge, no pulse is produced if the crank stops. The delay is
+ * programmed with 'IPULSE_UpdateCrankAdvance()', no pulse is produced until it is called.
+ *
+ * @param base			SCTimer peripheral base address
+ * @param pulseWidth_us	Pulse width in micro-second [us].
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param input			SCTimer input of the crank signal, the pulse is triggered on its rising edge.
+ * @param output		Output to set.
+ * @param event			Pointer to a variable where the crank input event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the crank trigger mode is already configured.
+ * @remark The counter must be halted, it is cleared.
+ */
+status_t IPULSE_SetupCrankTrigger(SCT_Type *base, uint32_t pulseWidth_us, uint32_t srcClock_Hz, sctimer_input_t input,
+		sctimer_out_t output, uint32_t *event)
+{
+    assert(pulseWidth_us);
+    assert(srcClock_Hz);
+    assert(output < FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS);
+
+    uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+    uint32_t first = 0, state = 0;
+    uint32_t matches[3];
+
+    uint64_t t = pulseWidth_us;
+
+    if(s_crankEnabled){
+    	return kStatus_InvalidArgument;
+    }
+
+    // Set unify bit to operate in 32-bit counter mode
+    base->CONFIG |= SCT_CONFIG_UNIFY_MASK;
+
+    // Calculate the ticks pulse width with provided timing [us]
+	t *= sctClock;
+	t /= 1000000U;
+	s_crankWidth = t;
+
+    if(IPULSE_AllocResources(base, output, 3, 2, &first, matches, &state) != kStatus_Success){
+    	return kStatus_Fail;
+    }
+
+    // Crank event: capture the period, restart the counter and arm the pulse, in both states
+    base->REGMODE |= 1U << matches[0];
+    base->SCTCAP[matches[0]] = 0;
+    base->SCTCAPCTRL[matches[0]] = 1U << first;
+    base->EVENT[first].CTRL = kSCTIMER_InputRiseEvent | SCT_EVENT_CTRL_IOSEL(input);
+    base->EVENT[first].STATE = 3U << state;
+    SCTIMER_SetupCounterLimitAction(base, kSCTIMER_Counter_L, first);
+    SCTIMER_SetupNextStateAction(base, state + 1, first);
+
+    // Pulse event: end of the pulse in the armed state, then disarm
+    SCTMGR_SetMatchEvent(base, first + 1, matches[1], 0xFFFFFFFFU, 1U << (state + 1));
+    SCTIMER_SetupNextStateAction(base, state, first + 1);
+
+    // Set event: start of the pulse in the armed state
+    SCTMGR_SetMatchEvent(base, first + 2, matches[2], 0xFFFFFFFFU, 1U << (state + 1));
+
+	// Set the initial output level to low which is the inactive state
+	base->OUTPUT &= ~(1U << output);
+
+	SCTIMER_SetupOutputSetAction(base, output, first + 2);
+	SCTIMER_SetupOutputClearAction(base, output, first + 1);
+
+	base->STATE = state;
+	base->CTRL |= SCT_CTRL_CLRCTR_L_MASK;
+
+	s_crankEvent = first;
+	s_crankCapture = matches[0];
+	s_crankDelay = 0;
+	s_crankEnabled = 1;
+	*event = first;
+
     return kStatus_Success;
 }
 
+/**
+ * @brief Get the crank period measured by the SCTimer capture.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param event			Crank input event number.
+ * @return The period [us], '0' before the first period or if the crank stopped (no edge for two periods).
+ */
+uint32_t IPULSE_GetCrankPeriod_us(SCT_Type *base, uint32_t srcClock_Hz, uint32_t event){
+
+	uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	uint32_t period;
+	uint64_t t;
+
+	if(!s_crankEnabled || s_crankEvent != event){
+		return 0;
+	}
+
+	period = base->SCTCAP[s_crankCapture];
+	if(period == 0 || base->COUNT / 2 > period){
+		return 0;
+	}
+
+	t = period;
+	t *= 1000000U;
+	t /= sctClock;
+
+	return t;
+}
+
+/**
+ * @brief Update the crank trigger pulse position from the measured crank period.
+ * Must be called periodically, the delay follows the crank speed. The new delay is loaded by the SCTimer
+ * on the next crank edge, the time between the edge and the pulse doesn't depend on the CPU.
+ * @param base				SCTimer peripheral base address.
+ * @param event				Crank input event number.
+ * @param triggerAngle_cdeg	Angle of the crank edge before the top dead center [1/100 degree].
+ * @param advance_cdeg		Pulse advance before the top dead center [1/100 degree], negative after it.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse can't be scheduled (the pulses are stopped).
+ */
+status_t IPULSE_UpdateCrankAdvance(SCT_Type *base, uint32_t event, uint32_t triggerAngle_cdeg, int32_t advance_cdeg){
+
+	uint32_t period;
+	uint64_t t;
+
+	if(!s_crankEnabled || s_crankEvent != event){
+		return kStatus_InvalidArgument;
+	}
+
+	period = base->SCTCAP[s_crankCapture];
+
+	// One crank edge per revolution, the delay is the angle between the edge and the pulse
+	t = period;
+	t *= (uint32_t)((int32_t)triggerAngle_cdeg - advance_cdeg);
+	t /= 36000U;
+
+	if(period == 0 || base->COUNT / 2 > period || advance_cdeg >= (int32_t)triggerAngle_cdeg || t == 0 ||
+			t + s_crankWidth >= period){
+		if(s_crankDelay){
+			IPULSE_SetCrankDelay(base, event, 0);
+		}
+		return kStatus_InvalidArgument;
+	}
+
+	if(t != s_crankDelay){
+		IPULSE_SetCrankDelay(base, event, t);
+	}
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Release the resources used by a pulse configured with 'IPULSE_SetupPulse()'.
+ * The counter is halted at the end of the pulse and stays halted so another mode can be configured.
+ *
+ * @param base              SCTimer peripheral base address.
+ * @param output            The output to release.
+ * @param event             Pulse period event number.
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter had to be halted during a pulse.
+ */
+status_t IPULSE_ReleasePulse(SCT_Type *base, sctimer_out_t output, uint32_t event)
+{
+	uint32_t state = 0;
+	uint32_t stateMask = base->EVENT[event + 1].STATE;
+	uint32_t eventCount = 2;
+	uint32_t stateCount = 1;
+	uint32_t i;
+	status_t res;
+
+	// Halt when the output is cleared
+	res = SCTMGR_HaltOnEvent(base, event + 1, SCTMGR_HALT_TIMEOUT_MS);
+
+	if(s_ditherEnabled && s_ditherBase == base){
+		s_ditherEnabled = 0;
+	}
+
+	if(s_multiEnabled && s_multiEvent == event){
+		eventCount = 3;
+		stateCount = s_multiStrikes;
+		s_multiEnabled = 0;
+	}
+
+	// The crank event is enabled in both states
+	if(s_crankEnabled && s_crankEvent == event){
+		eventCount = 3;
+		stateCount = 2;
+		stateMask = base->EVENT[event].STATE;
+		s_crankEnabled = 0;
+	}
+
+	while(stateMask && !(stateMask & 1U)){
+		stateMask >>= 1;
+		state++;
+	}
+
+	for(i = 0; i < eventCount; i++){
+		SCTMGR_FreeMatch(base, base->EVENT[event + i].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK);
+	}
+	SCTMGR_FreeStates(state, stateCount);
+	SCTMGR_FreeEvents(base, event, eventCount);
+	SCTMGR_FreeOutput(base, output);
+
+	return res;
+}
+
 /**
  * @brief Updates the pulse frequency [mHz].
  *
@@ -120,6 +580,11 @@ status_t IPULSE_UpdatePulseFrequency(SCT_Type *base, sctimer_out_t output, uint3
 
     uint64_t t = sctClock;
 
+    // The frequency follows the crank input
+    if(s_crankEnabled && s_crankEvent == event){
+    	return kStatus_InvalidArgument;
+    }
+
     // Retrieve the match register number for the main period
     periodMatchReg = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
 
@@ -128,15 +593,28 @@ status_t IPULSE_UpdatePulseFrequency(SCT_Type *base, sctimer_out_t output, uint3
 
     pulsePeriod = base->SCTMATCH[pulseMatchReg];
 
-    // Calculate the period
+    // Calculate the period, the match value is the period minus one tick
     t *= 1000;
     t /= freq_mHz;
-    period = t;
+    period = t - 1;
+
+    // In multi-spark mode the period event occurs after the last strike start
+    if(s_multiEnabled && s_multiEvent == event){
+    	if(IPULSE_MultiSparkSpan(pulsePeriod) >= period){
+    		return kStatus_InvalidArgument;
+    	}
+    	period -= IPULSE_MultiSparkSpan(pulsePeriod);
+    }
 
     if(pulsePeriod > period ){
     	return kStatus_InvalidArgument;
     }
 
+    // The dithering restarts from the truncated period
+    if(s_ditherEnabled && !(s_multiEnabled && s_multiEvent == event)){
+    	IPULSE_SetDitherPeriod(sctClock, freq_mHz);
+    }
+
     // Stop the counter before updating match register
     SCTIMER_StopTimer(base, kSCTIMER_Counter_L);
 
@@ -171,6 +649,7 @@ status_t IPULSE_UpdatePulseWidth(SCT_Type *base, sctimer_out_t output, uint32_t
     uint64_t t = pulseWidth_us;
     uint32_t periodMatchReg, pulseMatchReg;
     uint32_t pulsePeriod = 0, period;
+    uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
 
     // Retrieve the match register number for the main period
     periodMatchReg = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
@@ -181,11 +660,29 @@ status_t IPULSE_UpdatePulseWidth(SCT_Type *base, sctimer_out_t output, uint32_t
     period = base->SCTMATCH[periodMatchReg];
 
     // Calculate pulse width match value
-    t *= srcClock_Hz;
+    t *= sctClock;
     t/= 1000000U;
     pulsePeriod = t;
    // pulsePeriod = (unsigned long)pulseWidth_us * (unsigned long)(srcClock_Hz / 1000000U);
 
+    // In crank trigger mode the width is checked against the crank period at the next advance update
+    if(s_crankEnabled && s_crankEvent == event){
+    	s_crankWidth = pulsePeriod;
+    	if(s_crankDelay){
+    		IPULSE_SetCrankDelay(base, event, s_crankDelay);
+    	}
+    	return kStatus_Success;
+    }
+
+    // In multi-spark mode the strikes span changes with the width, the full period is kept
+    if(s_multiEnabled && s_multiEvent == event){
+    	period += IPULSE_MultiSparkSpan(base->SCTMATCH[pulseMatchReg]);
+    	if(IPULSE_MultiSparkSpan(pulsePeriod) >= period){
+    		return kStatus_InvalidArgument;
+    	}
+    	period -= IPULSE_MultiSparkSpan(pulsePeriod);
+    }
+
     // If pulse period is greater than period, the event will never occur
     if (pulsePeriod >= period)
     {
@@ -201,12 +698,60 @@ status_t IPULSE_UpdatePulseWidth(SCT_Type *base, sctimer_out_t output, uint32_t
     base->SCTMATCH[pulseMatchReg]    = pulsePeriod;
     base->SCTMATCHREL[pulseMatchReg] = pulsePeriod;
 
+    if(s_multiEnabled && s_multiEvent == event){
+    	uint32_t nextMatchReg = base->EVENT[event + 2].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+
+    	base->SCTMATCH[periodMatchReg]    = period;
+    	base->SCTMATCHREL[periodMatchReg] = period;
+    	base->SCTMATCH[nextMatchReg]      = pulsePeriod + s_multiGap - 1;
+    	base->SCTMATCHREL[nextMatchReg]   = pulsePeriod + s_multiGap - 1;
+    }
+
     // Restart the counter
     SCTIMER_StartTimer(base, kSCTIMER_Counter_L);
     return kStatus_Success;
 }
 
 
+/**
+ * @brief Set the period dithering mode.
+ * The period reload value is updated at each period event by the SCTimer interrupt so the period
+ * alternates between N and N+1 ticks, with N the truncated period. The remainder is accumulated
+ * so the average frequency is exact and the cycle to cycle jitter is one tick.
+ *
+ * @param base              SCTimer peripheral base address.
+ * @param srcClock_Hz		SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz			Pulse frequency in milli-Hertz [mHz].
+ * @param event             Pulse period event number.
+ * @param enable			'1' to enable dithering, '0' to use the truncated period.
+ * @return 'kStatus_Success'.
+ */
+status_t IPULSE_EnableDithering(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event, uint8_t enable)
+{
+    assert(freq_mHz > 0);
+    assert(srcClock_Hz > 0);
+
+    uint32_t sctClock    = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+    uint32_t period      = IPULSE_SetDitherPeriod(sctClock, freq_mHz);
+
+    s_ditherBase = base;
+    s_ditherMatch = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+
+    if(enable){
+    	SCTIMER_SetCallback(base, IPULSE_DitherCallback, event);
+    	SCTIMER_EnableInterrupts(base, 1U << event);
+    	EnableIRQ(SCT0_IRQn);
+    }
+    else{
+    	SCTIMER_DisableInterrupts(base, 1U << event);
+    	SCTIMER_SetCallback(base, NULL, event);
+    	base->SCTMATCHREL[s_ditherMatch] = period - 1;
+    }
+    s_ditherEnabled = enable;
+
+    return kStatus_Success;
+}
+
 /**
  * @brief Set the enable state of the pulsing.
  * @param base              SCTimer peripheral base address.
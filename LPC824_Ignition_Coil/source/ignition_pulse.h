@@ -8,7 +8,8 @@
  *
  *  Override PMW functions to set an impulsion width and a frequency.\n
  *  The precision for the pulse width is +- 1[us] and the frequency +- 1[mHz].\n
- *  These Methods are based on the 'SCTIMER_SetupPwm()' in drivers files fsl_sctimer.
+ *  These Methods are based on the 'SCTIMER_SetupPwm()' in drivers files fsl_sctimer.\n
+ *  In dithering mode the period alternates between N and N+1 ticks so the average frequency is exact.
  */
 
 #ifndef IGNITION_PULSE_H_
@@ -16,6 +17,7 @@
 
 #include "board.h"
 #include "fsl_sctimer.h"
+#include "sct_manager.h"
 
 /**
  *@brief Initialize the impulsion width and frequency.
@@ -29,9 +31,92 @@
  *
  * @return	'kStatus_Success' on success.
  * @return	'kStatus_Fail' If the limit in terms of event count is reached or if an incorrect pulse/frequency values are provided.
+ * @remark The counter must be halted, it is cleared.
  */
 status_t IPULSE_SetupPulse(SCT_Type *base, uint32_t pulseWidth_us, uint32_t srcClock_Hz, uint32_t freq_mHz, sctimer_out_t output, uint32_t *event);
 
+/**
+ * @brief Initialize a multi-spark pulse: several strikes per period, sequenced by the SCTimer states.
+ *
+ * Each strike starts on a counter limit. The counter runs in state 'first + k' during the strike 'k':
+ * - the pulse event clears the output after the strike width, in all the states,
+ * - the next event sets the output, limits the counter and adds 1 to the state, in all the states but the last one,
+ * - the period event sets the output, limits the counter and loads the first state, in the last state only.
+ * The period event occurs one period after the first strike start, so the CPU does nothing per strike.
+ *
+ * @param base			SCTimer peripheral base address
+ * @param pulseWidth_us	Strike width in micro-second [us].
+ * @param gap_us		Time between the end of a strike and the next one [us].
+ * @param strikes		Number of strikes per period (2 to the number of states).
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Pulse frequency in milli-Hertz [mHz].
+ * @param output		Output to set.
+ * @param event			Pointer to a variable where the pulse period event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the strikes don't fit in the period.
+ * @remark The counter must be halted, it is cleared. Only one multi-spark pulse can be configured.
+ */
+status_t IPULSE_SetupMultiSpark(SCT_Type *base, uint32_t pulseWidth_us, uint32_t gap_us, uint32_t strikes,
+		uint32_t srcClock_Hz, uint32_t freq_mHz, sctimer_out_t output, uint32_t *event);
+
+/**
+ * @brief Initialize the crank trigger mode: the pulse follows the edges of an SCTimer input.
+ *
+ * The crank edge captures the counter (the crank period), restarts it and arms the pulse:
+ * - the set event sets the output after the delay,
+ * - the pulse event clears the output after the delay plus the pulse width and disarms the pulse.
+ * The pulse is only produced once per edge, no pulse is produced if the crank stops. The delay is
+ * programmed with 'IPULSE_UpdateCrankAdvance()', no pulse is produced until it is called.
+ *
+ * @param base			SCTimer peripheral base address
+ * @param pulseWidth_us	Pulse width in micro-second [us].
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param input			SCTimer input of the crank signal, the pulse is triggered on its rising edge.
+ * @param output		Output to set.
+ * @param event			Pointer to a variable where the crank input event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the crank trigger mode is already configured.
+ * @remark The counter must be halted, it is cleared.
+ */
+status_t IPULSE_SetupCrankTrigger(SCT_Type *base, uint32_t pulseWidth_us, uint32_t srcClock_Hz, sctimer_input_t input,
+		sctimer_out_t output, uint32_t *event);
+
+/**
+ * @brief Get the crank period measured by the SCTimer capture.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param event			Crank input event number.
+ * @return The period [us], '0' before the first period or if the crank stopped (no edge for two periods).
+ */
+uint32_t IPULSE_GetCrankPeriod_us(SCT_Type *base, uint32_t srcClock_Hz, uint32_t event);
+
+/**
+ * @brief Update the crank trigger pulse position from the measured crank period.
+ * Must be called periodically, the delay follows the crank speed. The new delay is loaded by the SCTimer
+ * on the next crank edge, the time between the edge and the pulse doesn't depend on the CPU.
+ * @param base				SCTimer peripheral base address.
+ * @param event				Crank input event number.
+ * @param triggerAngle_cdeg	Angle of the crank edge before the top dead center [1/100 degree].
+ * @param advance_cdeg		Pulse advance before the top dead center [1/100 degree], negative after it.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse can't be scheduled (the pulses are stopped).
+ */
+status_t IPULSE_UpdateCrankAdvance(SCT_Type *base, uint32_t event, uint32_t triggerAngle_cdeg, int32_t advance_cdeg);
+
+/**
+ * @brief Release the resources used by a pulse configured with 'IPULSE_SetupPulse()'.
+ * The counter is halted at the end of the pulse and stays halted so another mode can be configured.
+ *
+ * @param base              SCTimer peripheral base address.
+ * @param output            The output to release.
+ * @param event             Pulse period event number.
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter had to be halted during a pulse.
+ */
+status_t IPULSE_ReleasePulse(SCT_Type *base, sctimer_out_t output, uint32_t event);
+
 /**
  * @brief Updates the pulse frequency [mHz].
  *
@@ -56,6 +141,21 @@ status_t IPULSE_UpdatePulseFrequency(SCT_Type *base, sctimer_out_t output, uint3
  */
 status_t IPULSE_UpdatePulseWidth(SCT_Type *base, sctimer_out_t output, uint32_t srcClock_Hz, uint32_t pulseWidth_us, uint32_t event);
 
+/**
+ * @brief Set the period dithering mode.
+ * The period reload value is updated at each period event by the SCTimer interrupt so the period
+ * alternates between N and N+1 ticks, with N the truncated period. The remainder is accumulated
+ * so the average frequency is exact and the cycle to cycle jitter is one tick.
+ *
+ * @param base              SCTimer peripheral base address.
+ * @param srcClock_Hz		SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz			Pulse frequency in milli-Hertz [mHz].
+ * @param event             Pulse period event number.
+ * @param enable			'1' to enable dithering, '0' to use the truncated period.
+ * @return 'kStatus_Success'.
+ */
+status_t IPULSE_EnableDithering(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event, uint8_t enable);
+
 /**
  * @brief Set the enable state of the pulsing.
  * @param base              SCTimer peripheral base address.
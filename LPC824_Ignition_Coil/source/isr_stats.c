@@ -0,0 +1,297 @@
+/**
+ * @file isr_stats.c
+ *
+ * @brief Interrupt latency and duration histograms.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The instrumented handlers are timestamped at entry and exit with a free-running MRT channel
+ * clocked by the system clock. The duration, nested interrupts included, and the latency are
+ * accumulated in log2 histograms: bucket 'n' counts the values from 2^(n-1) to 2^n - 1 ticks,
+ * the last bucket counts the larger ones. The latency is only known for the handlers whose
+ * event time is kept by the hardware: the Systick (reload value) and the SCTimer limit events
+ * (counter restarted). The pin and USART interrupts have no such reference, their delay is
+ * bounded by the duration of the handlers of the same or higher priority.\n
+ * The cost of one entry and exit is measured at initialization. Building with 'ISRSTATS_ENABLE'
+ * set to '0' removes the instrumentation from the handlers. The histograms are printed on the
+ * telemetry link and can be read by the debugger with 'ISRSTATS_Get()'.
+ */
+
+#include <string.h>
+
+#include "isr_stats.h"
+#include "fsl_mrt.h"
+#include "telemetry.h"
+
+#define ISRSTATS_NOW()	(MRT0->CHANNEL[ISRSTATS_MRT_CHANNEL].TIMER)	///< Current value of the down counter.
+
+static isrstats_t s_stats[ISRSTATS_IRQ_COUNT];		///< Statistics of each handler.
+static uint32_t s_entry[ISRSTATS_IRQ_COUNT];		///< Counter value at the entry of each handler.
+static volatile uint32_t s_active;					///< Handlers being run, one bit per handler.
+static uint32_t s_overhead;							///< Cost of an entry and an exit [tick].
+
+/**
+ * @brief Names printed in the report.
+ */
+static const char *const s_names[ISRSTATS_IRQ_COUNT] = {
+		"sys",
+		"sct",
+		"pint1",
+		"pint2",
+		"pint3",
+		"usart",
+		"dma"
+};
+
+/**
+ * @brief Add a value to a histogram.
+ * The bucket is the number of significant bits, computed without the CLZ instruction missing
+ * on the Cortex-M0+.
+ * @param histogram Histogram.
+ * @param value Value [tick].
+ */
+static void ISRSTATS_Add(uint16_t *histogram, uint32_t value){
+
+	uint32_t bucket = 0;
+
+	if(value >= 1U << 16){
+		value >>= 16;
+		bucket += 16;
+	}
+	if(value >= 1U << 8){
+		value >>= 8;
+		bucket += 8;
+	}
+	if(value >= 1U << 4){
+		value >>= 4;
+		bucket += 4;
+	}
+	if(value >= 1U << 2){
+		value >>= 2;
+		bucket += 2;
+	}
+	if(value >= 1U << 1){
+		value >>= 1;
+		bucket += 1;
+	}
+	bucket += value;
+
+	if(bucket >= ISRSTATS_BUCKETS){
+		bucket = ISRSTATS_BUCKETS - 1;
+	}
+	if(histogram[bucket] != UINT16_MAX){
+		histogram[bucket]++;
+	}
+}
+
+/**
+ * @brief Start the MRT channel and measure the instrumentation cost.
+ * Must be called before the instrumented interrupts are enabled.
+ */
+void ISRSTATS_Init(void){
+
+	mrt_config_t config;
+	uint32_t primask, start;
+
+	MRT_GetDefaultConfig(&config);
+	MRT_Init(MRT0, &config);
+	MRT_SetupChannelMode(MRT0, ISRSTATS_MRT_CHANNEL, kMRT_RepeatMode);
+
+	// Full range: the differences modulo 2^31 are the elapsed ticks
+	MRT0->CHANNEL[ISRSTATS_MRT_CHANNEL].INTVAL = MRT_CHANNEL_INTVAL_IVALUE_MASK | MRT_CHANNEL_INTVAL_LOAD_MASK;
+
+	primask = DisableGlobalIRQ();
+	start = ISRSTATS_NOW();
+	ISRSTATS_Enter(ISRSTATS_SYSTICK, 0);
+	ISRSTATS_Exit(ISRSTATS_SYSTICK);
+	s_overhead = (start - ISRSTATS_NOW()) & MRT_CHANNEL_TIMER_VALUE_MASK;
+	EnableGlobalIRQ(primask);
+
+	ISRSTATS_Reset();
+}
+
+/**
+ * @brief Record the entry of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ * @param latency Time since the interrupt event [tick], or 'ISRSTATS_NO_LATENCY'.
+ */
+void ISRSTATS_Enter(uint32_t irq, uint32_t latency){
+
+	isrstats_t *stats = &s_stats[irq];
+
+	s_entry[irq] = ISRSTATS_NOW();
+
+	// A handler preempted by a higher priority one restores the bits it reads
+	if(s_active){
+		stats->nested++;
+	}
+	s_active |= 1U << irq;
+
+	if(latency != ISRSTATS_NO_LATENCY){
+		ISRSTATS_Add(stats->latency, latency);
+		if(latency > stats->latencyMax){
+			stats->latencyMax = latency;
+		}
+	}
+}
+
+/**
+ * @brief Record the exit of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ */
+void ISRSTATS_Exit(uint32_t irq){
+
+	isrstats_t *stats = &s_stats[irq];
+	uint32_t duration = (s_entry[irq] - ISRSTATS_NOW()) & MRT_CHANNEL_TIMER_VALUE_MASK;
+
+	s_active &= ~(1U << irq);
+
+	stats->count++;
+	ISRSTATS_Add(stats->duration, duration);
+	if(duration > stats->durationMax){
+		stats->durationMax = duration;
+	}
+}
+
+/**
+ * @brief Get the statistics of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ * @return The statistics, updated by the interrupts.
+ */
+const isrstats_t *ISRSTATS_Get(uint32_t irq){
+	return &s_stats[irq];
+}
+
+/**
+ * @brief Clear the statistics of all the handlers.
+ */
+void ISRSTATS_Reset(void){
+
+	uint32_t primask = DisableGlobalIRQ();
+
+	memset(s_stats, 0, sizeof(s_stats));
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Queue the buckets of a histogram up to the last non-empty one.
+ * @param name Field name.
+ * @param histogram Histogram.
+ */
+static void ISRSTATS_WriteHistogram(const char *name, const uint16_t *histogram){
+
+	int last = ISRSTATS_BUCKETS - 1;
+	int i;
+
+	while(last > 0 && histogram[last] == 0){
+		last--;
+	}
+
+	TELEMETRY_WriteField(name, histogram[0]);
+	for(i = 1; i <= last; i++){
+		TELEMETRY_WriteString(",");
+		TELEMETRY_WriteDec(histogram[i]);
+	}
+}
+
+/**
+ * @brief Telemetry command printing the statistics.
+ * Without argument the call counts are printed, with a handler number its histograms,
+ * with 'R' the statistics are cleared.
+ * @param args Handler number (ISRSTATS_IRQ), 'R' or nothing.
+ */
+void ISRSTATS_Command(const char *args){
+
+	const isrstats_t *stats;
+	uint32_t irq;
+	uint8_t i;
+
+	while(*args == ' '){
+		args++;
+	}
+	if(*args == 'R'){
+		ISRSTATS_Reset();
+	}
+
+	TELEMETRY_WriteString("I");
+	if(!TELEMETRY_ParseDec(&args, &irq) || irq >= ISRSTATS_IRQ_COUNT){
+		TELEMETRY_WriteField("on", ISRSTATS_ENABLE);
+		TELEMETRY_WriteField("clock", CLOCK_GetFreq(kCLOCK_CoreSysClk));
+		TELEMETRY_WriteField("overhead", s_overhead);
+		for(i = 0; i < ISRSTATS_IRQ_COUNT; i++){
+			TELEMETRY_WriteField(s_names[i], s_stats[i].count);
+		}
+		TELEMETRY_WriteEnd();
+		return;
+	}
+
+	// Read while the interrupts update it, the fields can come from two consecutive calls
+	stats = &s_stats[irq];
+	TELEMETRY_WriteString(" ");
+	TELEMETRY_WriteString(s_names[irq]);
+	TELEMETRY_WriteField("count", stats->count);
+	TELEMETRY_WriteField("nested", stats->nested);
+	TELEMETRY_WriteField("dMax", stats->durationMax);
+	TELEMETRY_WriteField("lMax", stats->latencyMax);
+	ISRSTATS_WriteHistogram("d", stats->duration);
+	ISRSTATS_WriteHistogram("l", stats->latency);
+	TELEMETRY_WriteEnd();
+}
+
+#if ISRSTATS_ENABLE
+
+// Handlers of the drivers, called by the instrumented ones instead of the weak startup handlers
+void SCT0_DriverIRQHandler(void);
+void PIN_INT1_DriverIRQHandler(void);
+void PIN_INT2_DriverIRQHandler(void);
+void PIN_INT3_DriverIRQHandler(void);
+
+/**
+ * @brief SCTimer interrupt, instrumented.
+ * After a limit event the counter restarts from 0, its value is the time since the event.
+ */
+void SCT0_IRQHandler(void){
+
+	uint32_t latency = ISRSTATS_NO_LATENCY;
+
+	if(SCT0->EVFLAG & SCT0->EVEN & SCT0->LIMIT & SCT_LIMIT_LIMMSK_L_MASK){
+		latency = SCT0->COUNT * (((SCT0->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	}
+
+	ISRSTATS_Enter(ISRSTATS_SCT, latency);
+	SCT0_DriverIRQHandler();
+	ISRSTATS_Exit(ISRSTATS_SCT);
+}
+
+/**
+ * @brief Coder push button interrupt, instrumented.
+ */
+void PIN_INT1_IRQHandler(void){
+
+	ISRSTATS_Enter(ISRSTATS_PINT1, ISRSTATS_NO_LATENCY);
+	PIN_INT1_DriverIRQHandler();
+	ISRSTATS_Exit(ISRSTATS_PINT1);
+}
+
+/**
+ * @brief Enable switch interrupt, instrumented.
+ */
+void PIN_INT2_IRQHandler(void){
+
+	ISRSTATS_Enter(ISRSTATS_PINT2, ISRSTATS_NO_LATENCY);
+	PIN_INT2_DriverIRQHandler();
+	ISRSTATS_Exit(ISRSTATS_PINT2);
+}
+
+/**
+ * @brief Coder channel B interrupt, instrumented.
+ */
+void PIN_INT3_IRQHandler(void){
+
+	ISRSTATS_Enter(ISRSTATS_PINT3, ISRSTATS_NO_LATENCY);
+	PIN_INT3_DriverIRQHandler();
+	ISRSTATS_Exit(ISRSTATS_PINT3);
+}
+
+#endif
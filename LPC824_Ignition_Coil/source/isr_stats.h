@@ -0,0 +1,108 @@
+/**
+ * @file isr_stats.h
+ *
+ * @brief Interrupt latency and duration histograms.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The instrumented handlers are timestamped at entry and exit with a free-running MRT channel
+ * clocked by the system clock. The duration, nested interrupts included, and the latency are
+ * accumulated in log2 histograms: bucket 'n' counts the values from 2^(n-1) to 2^n - 1 ticks,
+ * the last bucket counts the larger ones. The latency is only known for the handlers whose
+ * event time is kept by the hardware: the Systick (reload value) and the SCTimer limit events
+ * (counter restarted). The pin and USART interrupts have no such reference, their delay is
+ * bounded by the duration of the handlers of the same or higher priority.\n
+ * The cost of one entry and exit is measured at initialization. Building with 'ISRSTATS_ENABLE'
+ * set to '0' removes the instrumentation from the handlers. The histograms are printed on the
+ * telemetry link and can be read by the debugger with 'ISRSTATS_Get()'.
+ */
+
+#ifndef ISR_STATS_H_
+#define ISR_STATS_H_
+
+#include "board.h"
+
+#ifndef ISRSTATS_ENABLE
+#define ISRSTATS_ENABLE			1			///< Instrument the handlers. Defined to '0' in the Release build.
+#endif
+
+#define ISRSTATS_MRT_CHANNEL	3			///< MRT channel used as free-running counter.
+#define ISRSTATS_BUCKETS		16			///< Number of buckets of a histogram.
+#define ISRSTATS_NO_LATENCY		0xFFFFFFFFU	///< Latency of a handler without hardware reference.
+
+/**
+ * @brief Instrumented handlers.
+ */
+enum ISRSTATS_IRQ
+{
+	ISRSTATS_SYSTICK = 0,	///< Systick, 1 ms time base.
+	ISRSTATS_SCT,			///< SCTimer events of the pulse engine.
+	ISRSTATS_PINT1,			///< Coder push button.
+	ISRSTATS_PINT2,			///< Enable switch.
+	ISRSTATS_PINT3,			///< Coder channel B.
+	ISRSTATS_USART,			///< Telemetry USART.
+	ISRSTATS_DMA,			///< LCD DMA.
+	ISRSTATS_IRQ_COUNT		///< Number of instrumented handlers.
+};
+
+/**
+ * @brief Statistics of a handler [system clock tick].
+ */
+typedef struct
+{
+	uint32_t count;			///< Number of completed calls.
+	uint32_t nested;		///< Calls preempting another instrumented handler.
+	uint32_t durationMax;	///< Longest duration.
+	uint32_t latencyMax;	///< Longest latency.
+	uint16_t duration[ISRSTATS_BUCKETS];	///< Duration histogram, saturated counts.
+	uint16_t latency[ISRSTATS_BUCKETS];		///< Latency histogram, saturated counts.
+}isrstats_t;
+
+#if ISRSTATS_ENABLE
+#define ISRSTATS_ENTER(irq, latency)	ISRSTATS_Enter(irq, latency)	///< Instrument the entry of a handler.
+#define ISRSTATS_EXIT(irq)				ISRSTATS_Exit(irq)				///< Instrument the exit of a handler.
+#else
+#define ISRSTATS_ENTER(irq, latency)
+#define ISRSTATS_EXIT(irq)
+#endif
+
+/**
+ * @brief Start the MRT channel and measure the instrumentation cost.
+ * Must be called before the instrumented interrupts are enabled.
+ */
+void ISRSTATS_Init(void);
+
+/**
+ * @brief Record the entry of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ * @param latency Time since the interrupt event [tick], or 'ISRSTATS_NO_LATENCY'.
+ */
+void ISRSTATS_Enter(uint32_t irq, uint32_t latency);
+
+/**
+ * @brief Record the exit of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ */
+void ISRSTATS_Exit(uint32_t irq);
+
+/**
+ * @brief Get the statistics of a handler.
+ * @param irq Handler (ISRSTATS_IRQ).
+ * @return The statistics, updated by the interrupts.
+ */
+const isrstats_t *ISRSTATS_Get(uint32_t irq);
+
+/**
+ * @brief Clear the statistics of all the handlers.
+ */
+void ISRSTATS_Reset(void);
+
+/**
+ * @brief Telemetry command printing the statistics.
+ * Without argument the call counts are printed, with a handler number its histograms,
+ * with 'R' the statistics are cleared.
+ * @param args Handler number (ISRSTATS_IRQ), 'R' or nothing.
+ */
+void ISRSTATS_Command(const char *args);
+
+#endif /* ISR_STATS_H_ */
@@ -0,0 +1,231 @@
+/**
+ * @file jitter.c
+ *
+ * @brief Stochastic RPM stress mode: reproducible random perturbation of each pulse period.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The period event interrupt draws a number from a seeded xorshift32 generator (shifts 13, 17, 5).
+ * Its 'JITTER_TABLE_BITS' most significant bits index the inverse cumulative distribution table
+ * of the selected distribution, a Q15 fraction of the amplitude. A first order low-pass filter
+ * limits the bandwidth of the perturbation: filtered += (sample - filtered) >> shift, arithmetic
+ * shift. The reload value of the next period is the center period plus filtered * amplitude >> 15.\n
+ * The sequence only depends on the seed, the distribution and the filter shift, so a host
+ * simulator running the same steps reproduces the applied periods ('tools/jitter_sim.py'). Only
+ * the single pulse mode is perturbed.\n
+ * The cost of the period callback isn't taken from a cycle count, it is measured on the target in
+ * the SCTimer histogram of the interrupt statistics ('I' command). The budget is the whole SCTimer
+ * handler under 256 system clock ticks, buckets 0 to 8 (21 us at 12 MHz). The 2 us first requested
+ * at 12 MHz are 24 cycles: the exception entry of the Cortex-M0+ alone takes 15 of them.
+ */
+
+#include "jitter.h"
+#include "telemetry.h"
+
+#define JITTER_TABLE_SIZE	(1U << JITTER_TABLE_BITS)	///< Number of entries of a table.
+#define JITTER_MIN_GAP		16							///< Minimum time between the pulse end and the period end [tick].
+
+/**
+ * @brief Inverse cumulative distribution tables, sampled at the middle of each interval [Q15 of the amplitude].
+ */
+static const int16_t s_tables[JITTER_DISTRIBUTION_COUNT - 1][JITTER_TABLE_SIZE] =
+{
+	// Uniform
+	{
+		-32511, -31999, -31487, -30975, -30463, -29951, -29439, -28927, -28415, -27903, -27391, -26879, -26367, -25855, -25343, -24831,
+		-24319, -23807, -23295, -22783, -22271, -21759, -21247, -20735, -20223, -19711, -19199, -18687, -18175, -17663, -17151, -16639,
+		-16128, -15616, -15104, -14592, -14080, -13568, -13056, -12544, -12032, -11520, -11008, -10496, -9984, -9472, -8960, -8448,
+		-7936, -7424, -6912, -6400, -5888, -5376, -4864, -4352, -3840, -3328, -2816, -2304, -1792, -1280, -768, -256,
+		256, 768, 1280, 1792, 2304, 2816, 3328, 3840, 4352, 4864, 5376, 5888, 6400, 6912, 7424, 7936,
+		8448, 8960, 9472, 9984, 10496, 11008, 11520, 12032, 12544, 13056, 13568, 14080, 14592, 15104, 15616, 16128,
+		16639, 17151, 17663, 18175, 18687, 19199, 19711, 20223, 20735, 21247, 21759, 22271, 22783, 23295, 23807, 24319,
+		24831, 25343, 25855, 26367, 26879, 27391, 27903, 28415, 28927, 29439, 29951, 30463, 30975, 31487, 31999, 32511
+	},
+	// Normal, standard deviation of 1/3
+	{
+		-29054, -24752, -22539, -20986, -19768, -18756, -17883, -17112, -16417, -15784, -15199, -14655, -14145, -13664, -13208, -12774,
+		-12359, -11962, -11580, -11211, -10855, -10510, -10175, -9849, -9532, -9223, -8921, -8626, -8337, -8053, -7775, -7502,
+		-7233, -6969, -6709, -6452, -6199, -5950, -5703, -5459, -5218, -4980, -4744, -4510, -4278, -4048, -3820, -3593,
+		-3368, -3144, -2922, -2701, -2481, -2262, -2044, -1827, -1610, -1394, -1179, -964, -749, -535, -321, -107,
+		107, 321, 535, 749, 964, 1179, 1394, 1610, 1827, 2044, 2262, 2481, 2701, 2922, 3144, 3368,
+		3593, 3820, 4048, 4278, 4510, 4744, 4980, 5218, 5459, 5703, 5950, 6199, 6452, 6709, 6969, 7233,
+		7502, 7775, 8053, 8337, 8626, 8921, 9223, 9532, 9849, 10175, 10510, 10855, 11211, 11580, 11962, 12359,
+		12774, 13208, 13664, 14145, 14655, 15199, 15784, 16417, 17112, 17883, 18756, 19768, 20986, 22539, 24752, 29054
+	}
+};
+
+static SCT_Type *s_base;					///< Perturbed SCTimer.
+static uint32_t s_event;					///< Pulse period event.
+static uint32_t s_periodMatch;				///< Match register of the pulse period.
+static uint32_t s_sctClock;					///< SCTimer counter clock [Hz].
+static uint8_t s_running;					///< The perturbation is running.
+
+static const int16_t *s_table;				///< Table of the selected distribution.
+static uint32_t s_shift;					///< Filter shift.
+static uint32_t s_amplitude_us;				///< Requested amplitude [us].
+static int32_t s_amplitude;					///< Applied amplitude [tick].
+static volatile uint32_t s_center;			///< Reload value of the center period (period - 1) [tick].
+
+static uint32_t s_state;					///< Generator state.
+static int32_t s_filtered;					///< Filtered perturbation [Q15 of the amplitude].
+static volatile uint32_t s_count;			///< Number of perturbed periods.
+static volatile uint32_t s_min;				///< Shortest applied reload value [tick].
+static volatile uint32_t s_max;				///< Longest applied reload value [tick].
+
+/**
+ * @brief Period event callback. Draw the perturbation of the next period.
+ * The reload value is loaded in the match register at the next period event.
+ */
+static void JITTER_PeriodCallback(void){
+
+	uint32_t x = s_state;
+	uint32_t period;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	s_state = x;
+
+	s_filtered += (s_table[x >> (32 - JITTER_TABLE_BITS)] - s_filtered) >> s_shift;
+	period = s_center + ((s_filtered * s_amplitude) >> 15);
+	s_base->SCTMATCHREL[s_periodMatch] = period;
+
+	if(period < s_min){
+		s_min = period;
+	}
+	if(period > s_max){
+		s_max = period;
+	}
+	s_count++;
+}
+
+/**
+ * @brief Compute the center period and limit the amplitude so the pulse always ends in its period.
+ * @param freq_mHz		Center pulse frequency in milli-Hertz [mHz].
+ * @param amplitude_us	Requested amplitude [us].
+ */
+static void JITTER_SetCenter(uint32_t freq_mHz, uint32_t amplitude_us){
+
+	uint32_t width = s_base->SCTMATCHREL[s_base->EVENT[s_event + 1].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK];
+	uint32_t center, limit;
+	uint64_t t;
+
+	t = (uint64_t)s_sctClock * 1000U;
+	center = t / freq_mHz - 1;
+
+	t = amplitude_us;
+	t *= s_sctClock;
+	t /= 1000000U;
+
+	// The product with a Q15 value must fit in 32 bits
+	limit = center > width + JITTER_MIN_GAP ? center - width - JITTER_MIN_GAP : 0;
+	if(limit > 0xFFFF){
+		limit = 0xFFFF;
+	}
+
+	s_center = center;
+	s_amplitude = t < limit ? t : limit;
+}
+
+/**
+ * @brief Start the perturbation of a pulse configured with 'IPULSE_SetupPulse()'.
+ * The period event interrupt is used, the dithering must be disabled.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Center pulse frequency in milli-Hertz [mHz].
+ * @param event			Pulse period event number.
+ * @param config		Perturbation configuration.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the configuration is incorrect.
+ */
+status_t JITTER_Start(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event, const jitter_config_t *config){
+
+	if(config->distribution == JITTER_OFF || config->distribution >= JITTER_DISTRIBUTION_COUNT
+			|| config->shift > JITTER_MAX_SHIFT || config->seed == 0 || freq_mHz == 0){
+		return kStatus_InvalidArgument;
+	}
+
+	s_base = base;
+	s_event = event;
+	s_periodMatch = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	s_sctClock = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+
+	s_table = s_tables[config->distribution - 1];
+	s_shift = config->shift;
+	s_state = config->seed;
+	s_filtered = 0;
+	s_amplitude_us = config->amplitude_us;
+	JITTER_SetCenter(freq_mHz, s_amplitude_us);
+
+	s_count = 0;
+	s_min = 0xFFFFFFFFU;
+	s_max = 0;
+
+	SCTIMER_SetCallback(base, JITTER_PeriodCallback, event);
+	SCTIMER_EnableInterrupts(base, 1U << event);
+	EnableIRQ(SCT0_IRQn);
+
+	s_running = 1;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Stop the perturbation. The last period is held until the pulse is reconfigured.
+ */
+void JITTER_Stop(void){
+
+	if(!s_running){
+		return;
+	}
+
+	SCTIMER_DisableInterrupts(s_base, 1U << s_event);
+	SCTIMER_SetCallback(s_base, NULL, s_event);
+
+	s_running = 0;
+}
+
+/**
+ * @brief Set the center pulse frequency, applied from the next period. The counter clock is also
+ * updated, as after a change of the clock plan.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Center pulse frequency in milli-Hertz [mHz].
+ */
+void JITTER_SetFrequency(uint32_t srcClock_Hz, uint32_t freq_mHz){
+
+	uint32_t primask;
+
+	if(!s_running || freq_mHz == 0){
+		return;
+	}
+
+	primask = DisableGlobalIRQ();
+	s_sctClock = srcClock_Hz / (((s_base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	JITTER_SetCenter(freq_mHz, s_amplitude_us);
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Check if the perturbation is running.
+ * @return '1' if running.
+ */
+uint8_t JITTER_IsActive(void){
+	return s_running;
+}
+
+/**
+ * @brief Telemetry command printing the perturbation statistics.
+ * @param args Unused.
+ */
+void JITTER_PrintStats(const char *args){
+
+	TELEMETRY_WriteString("J");
+	TELEMETRY_WriteField("on", s_running);
+	TELEMETRY_WriteField("center", s_center);
+	TELEMETRY_WriteField("amplitude", s_amplitude);
+	TELEMETRY_WriteField("count", s_count);
+	TELEMETRY_WriteField("min", s_count ? s_min : 0);
+	TELEMETRY_WriteField("max", s_max);
+	TELEMETRY_WriteHexField("state", s_state);
+	TELEMETRY_WriteEnd();
+}
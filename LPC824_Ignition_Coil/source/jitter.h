@@ -0,0 +1,90 @@
+/**
+ * @file jitter.h
+ *
+ * @brief Stochastic RPM stress mode: reproducible random perturbation of each pulse period.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The period event interrupt draws a number from a seeded xorshift32 generator (shifts 13, 17, 5).
+ * Its 'JITTER_TABLE_BITS' most significant bits index the inverse cumulative distribution table
+ * of the selected distribution, a Q15 fraction of the amplitude. A first order low-pass filter
+ * limits the bandwidth of the perturbation: filtered += (sample - filtered) >> shift, arithmetic
+ * shift. The reload value of the next period is the center period plus filtered * amplitude >> 15.\n
+ * The sequence only depends on the seed, the distribution and the filter shift, so a host
+ * simulator running the same steps reproduces the applied periods ('tools/jitter_sim.py'). Only
+ * the single pulse mode is perturbed.\n
+ * The cost of the period callback isn't taken from a cycle count, it is measured on the target in
+ * the SCTimer histogram of the interrupt statistics ('I' command). The budget is the whole SCTimer
+ * handler under 256 system clock ticks, buckets 0 to 8 (21 us at 12 MHz). The 2 us first requested
+ * at 12 MHz are 24 cycles: the exception entry of the Cortex-M0+ alone takes 15 of them.
+ */
+
+#ifndef JITTER_H_
+#define JITTER_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+
+#define JITTER_TABLE_BITS		7		///< Number of bits indexing the inverse cumulative distribution tables.
+#define JITTER_MAX_SHIFT		8		///< Largest filter shift.
+
+/**
+ * @brief Distributions of the perturbation.
+ */
+enum JITTER_DISTRIBUTION
+{
+	JITTER_OFF = 0,			///< No perturbation.
+	JITTER_UNIFORM,			///< Uniform between -amplitude and +amplitude.
+	JITTER_NORMAL,			///< Normal, the amplitude is 3 standard deviations.
+	JITTER_DISTRIBUTION_COUNT	///< Number of distributions.
+};
+
+/**
+ * @brief Perturbation configuration.
+ */
+typedef struct
+{
+	uint32_t distribution;		///< Distribution (JITTER_DISTRIBUTION).
+	uint32_t amplitude_us;		///< Amplitude of the perturbation [us].
+	uint32_t shift;				///< Filter shift, '0' for a white perturbation, higher for a lower bandwidth.
+	uint32_t seed;				///< Seed of the generator, must not be '0'.
+}jitter_config_t;
+
+/**
+ * @brief Start the perturbation of a pulse configured with 'IPULSE_SetupPulse()'.
+ * The period event interrupt is used, the dithering must be disabled.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Center pulse frequency in milli-Hertz [mHz].
+ * @param event			Pulse period event number.
+ * @param config		Perturbation configuration.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the configuration is incorrect.
+ */
+status_t JITTER_Start(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event, const jitter_config_t *config);
+
+/**
+ * @brief Stop the perturbation. The last period is held until the pulse is reconfigured.
+ */
+void JITTER_Stop(void);
+
+/**
+ * @brief Set the center pulse frequency, applied from the next period. The counter clock is also
+ * updated, as after a change of the clock plan.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Center pulse frequency in milli-Hertz [mHz].
+ */
+void JITTER_SetFrequency(uint32_t srcClock_Hz, uint32_t freq_mHz);
+
+/**
+ * @brief Check if the perturbation is running.
+ * @return '1' if running.
+ */
+uint8_t JITTER_IsActive(void);
+
+/**
+ * @brief Telemetry command printing the perturbation statistics.
+ * @param args Unused.
+ */
+void JITTER_PrintStats(const char *args);
+
+#endif /* JITTER_H_ */
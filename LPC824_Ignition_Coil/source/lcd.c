@@ -8,25 +8,110 @@
 #include "fsl_clock.h"
 #include "fsl_gpio.h"
 #include "Font.h"
+#include "SysTick.h"
+#include "lcd_dma.h"
 
-extern T_picture IMG_sevenLogo_c;	///< 'Lotus Seven' picture from "Font.h"
+extern const T_picture IMG_sevenLogo_c;	///< 'Lotus Seven' picture from "Font.h"
 
 // SPI transfer structure to use for sending data.
 spi_transfer_t _transfert;
 
+/**
+ * @brief LCD initialization steps.
+ */
+enum LCD_INIT_STEP
+{
+	LCD_INIT_IDLE = 0,		///< Initialization not started.
+	LCD_INIT_RESET_LOW,		///< Drive the reset pin low.
+	LCD_INIT_RESET_HIGH,	///< Release the reset pin.
+	LCD_INIT_PARAMETERS,	///< Write the LCD parameters.
+	LCD_INIT_REGULATOR,		///< Regulator ON.
+	LCD_INIT_FOLLOWER,		///< Voltage follower circuit ON.
+	LCD_INIT_DISPLAY,		///< Display ON and splash screen.
+	LCD_INIT_SPLASH,		///< Splash screen hold.
+	LCD_INIT_DONE			///< Initialization done.
+};
+
+static uint8_t s_initStep = LCD_INIT_IDLE;	///< Current initialization step.
+static uint32_t s_stepTick;					///< Tick when the current step started [ms].
+
+static uint8_t s_clearData[SCREEN_WIDTH];	///< Pattern sent by 'LCD_DisplayClear()', read by the DMA.
+
+/**
+ * @brief Commands selecting the first column of each page, read by the DMA.
+ */
+static const uint8_t s_pageCommands[SCREEN_HEIGHT / PAGE_HEIGHT][3] =
+{
+	{PAGE_ADDR | 0, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 1, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 2, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 3, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 4, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 5, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 6, COLUMN_LSB, COLUMN_MSB},
+	{PAGE_ADDR | 7, COLUMN_LSB, COLUMN_MSB}
+};
+
 /**
  * @brief Initialize the LCD screen.
  * Initialize the SPI as master, the LCD and display a picture for 3sec.
+ * Blocking version of 'LCD_InitStart()' and 'LCD_InitProcess()'.
  * @return Initialization status.
  */
 uint8_t LCD_Init(){
 
+	if(LCD_InitStart() != kStatus_Success){
+		return kStatus_Fail;
+	}
+
+	while(!LCD_InitProcess());
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Start the LCD initialization.
+ * Initialize the SPI as master and start the reset sequence. The power-up sequence and the
+ * splash screen are then handled by 'LCD_InitProcess()'. The Systick must be running.
+ * @return Initialization status.
+ */
+uint8_t LCD_InitStart(void){
+
 	spi_master_config_t userConfig;
 	uint32_t srcFreq = 0U;
-	uint32_t dataSize = 8;
+
+	SPI_MasterGetDefaultConfig(&userConfig);
+	userConfig.baudRate_Bps = 1000000;
+	userConfig.sselNumber   = 0;
+	srcFreq					= CLOCK_GetFreq(kCLOCK_CoreSysClk);
+
+	if(SPI_MasterInit(SPI0, &userConfig, srcFreq) != kStatus_Success){
+		return kStatus_Fail;
+	}
+	// Initialize the configuration flag.
+	_transfert.configFlags = kSPI_ReceiveIgnore | kSPI_EndOfTransfer;
+
+	// Pages are sent by the DMA
+	LCDDMA_Init(SPI0, IO_CD);
+
+	// Reset LCD
+	GPIO_PinWrite(GPIO, 0, IO_RESET, 1);
+
+	s_initStep = LCD_INIT_RESET_LOW;
+	s_stepTick = SYSTICK_GetTicks();
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Run the next step of the LCD initialization once its delay has elapsed.
+ * Must be called periodically after 'LCD_InitStart()'. Never waits.
+ * @return '1' once the splash screen hold has elapsed and the screen can be used, '0' otherwise.
+ */
+uint8_t LCD_InitProcess(void){
 
 	// Set the initialization commands to send.
-	uint8_t cmd[] = {
+	static uint8_t cmd[] = {
 			X_DIRECTION,
 			(uint8_t)(Y_DIRECTION | (0x1F & 0x08)),
 			(uint8_t)(RESISTOR_RATIO | 0b100),
@@ -36,45 +121,65 @@ uint8_t LCD_Init(){
 			(uint8_t)ADV_PROG_CTL_2,
 			(uint8_t)(POWER_CTRL | 0b100)
 	};
+	uint32_t delay = (s_initStep == LCD_INIT_DONE - 1) ? LCD_SPLASH_TIME_MS : LCD_STEP_DELAY_MS;
 
-	SPI_MasterGetDefaultConfig(&userConfig);
-	userConfig.baudRate_Bps = 1000000;
-	userConfig.sselNumber   = 0;
-	srcFreq					= CLOCK_GetFreq(kCLOCK_Irc);
+	if(s_initStep == LCD_INIT_DONE){
+		return 1;
+	}
 
-	if(SPI_MasterInit(SPI0, &userConfig, srcFreq) != kStatus_Success){
-		return kStatus_Fail;
+	// Wait at least the full delay, the current tick may be almost elapsed.
+	if(s_initStep == LCD_INIT_IDLE || SYSTICK_GetTicks() - s_stepTick <= delay){
+		return 0;
 	}
-	// Initialize the configuration flag.
-	_transfert.configFlags = kSPI_ReceiveIgnore | kSPI_EndOfTransfer;
 
-	// Reset LCD
-	GPIO_PinWrite(GPIO, 0, IO_RESET, 1);
-	CLOCK_Delay(10000);
-	GPIO_PinWrite(GPIO, 0, IO_RESET, 0);
-	CLOCK_Delay(10000);
-	GPIO_PinWrite(GPIO, 0, IO_RESET, 1);
-	CLOCK_Delay(10000);
-
-	// Write LCD parameters to use.
-	LCD_WriteCommands(cmd, dataSize);
-
-	// Voltage Follower Circuit ON.
-	CLOCK_Delay(10000);
-	LCD_WriteOneCommand(POWER_CTRL | 0b110);
-
-	// Voltage Follower Circuit ON.
-	CLOCK_Delay(10000);
-	LCD_WriteOneCommand(POWER_CTRL | 0b111);
-
-	// Display ON Set Display enable.
-	CLOCK_Delay(10000);
-	LCD_WriteOneCommand(ENABLE_DISPLAY | 1);
-	// Display picture.
-	LCD_DisplayCompressPictureI(0,0,IMG_sevenLogo_c);
-	// Wait to show picture.
-	CLOCK_Delay(300000);
-	return kStatus_Success;
+	switch(s_initStep){
+
+	case LCD_INIT_RESET_LOW:
+		GPIO_PinWrite(GPIO, 0, IO_RESET, 0);
+		break;
+
+	case LCD_INIT_RESET_HIGH:
+		GPIO_PinWrite(GPIO, 0, IO_RESET, 1);
+		break;
+
+	case LCD_INIT_PARAMETERS:
+		// Write LCD parameters to use.
+		LCD_WriteCommands(cmd, sizeof(cmd));
+		break;
+
+	case LCD_INIT_REGULATOR:
+		// Voltage Follower Circuit ON.
+		LCD_WriteOneCommand(POWER_CTRL | 0b110);
+		break;
+
+	case LCD_INIT_FOLLOWER:
+		// Voltage Follower Circuit ON.
+		LCD_WriteOneCommand(POWER_CTRL | 0b111);
+		break;
+
+	case LCD_INIT_DISPLAY:
+		// Display ON Set Display enable.
+		LCD_WriteOneCommand(ENABLE_DISPLAY | 1);
+		// Display picture.
+		LCD_DisplayCompressPictureI(0,0,&IMG_sevenLogo_c);
+		break;
+
+	default:
+		break;
+	}
+
+	s_initStep++;
+	s_stepTick = SYSTICK_GetTicks();
+
+	return s_initStep == LCD_INIT_DONE;
+}
+
+/**
+ * @brief Check if the LCD display is enabled.
+ * @return '1' once the splash screen is displayed.
+ */
+uint8_t LCD_IsOn(void){
+	return s_initStep >= LCD_INIT_SPLASH;
 }
 
 /**
@@ -84,6 +189,8 @@ uint8_t LCD_Init(){
  */
 void LCD_WriteCommands(uint8_t cmd[], uint32_t size)
 {
+	LCDDMA_Wait();
+
 	// Activate CD = command
 	GPIO_PinWrite(GPIO, 0, IO_CD, 0);
 
@@ -99,7 +206,7 @@ void LCD_WriteCommands(uint8_t cmd[], uint32_t size)
 void LCD_WriteOneCommand(uint8_t cmd){
 
 	uint8_t cmdData[] = {cmd};
-	LCD_WriteData(cmdData, 1);
+	LCD_WriteCommands(cmdData, 1);
 }
 
 /**
@@ -109,6 +216,8 @@ void LCD_WriteOneCommand(uint8_t cmd){
  */
 void LCD_WriteData(uint8_t data[], uint32_t size)
 {
+	LCDDMA_Wait();
+
 	GPIO_PinWrite(GPIO, 0, IO_CD, 1);
 
 	_transfert.txData = data;
@@ -122,11 +231,14 @@ void LCD_WriteData(uint8_t data[], uint32_t size)
  * @param size Number of bytes to send.
  * @param startIndex Data buffer starting index.
  */
-void LCD_WriteDataFromStart(uint8_t data[], uint32_t size, uint32_t startIndex)
+void LCD_WriteDataFromStart(const uint8_t data[], uint32_t size, uint32_t startIndex)
 {
+	LCDDMA_Wait();
+
 	GPIO_PinWrite(GPIO, 0, IO_CD, 1);
 
-	_transfert.txData = data + startIndex;
+	// The buffer is only read, it may be in flash
+	_transfert.txData = (uint8_t *)data + startIndex;
 	_transfert.dataSize = size;
 	SPI_MasterTransferBlocking(SPI0, &_transfert);
 }
@@ -155,29 +267,39 @@ void LCD_SelectColumn(uint8_t col)
 
 /**
  * @brief Send a couple of byte to fill the screen.
+ * The pages are sent by the DMA, the function returns once they are queued.
  * @param data1 First data to set.
  * @param data2 Second data to set
  */
 void LCD_DisplayClear(uint8_t data1, uint8_t data2)
 {
-	uint8_t cmd[SCREEN_WIDTH];
 	uint8_t i = 0;
 
+	// The pattern may still be read by the DMA
+	LCDDMA_Wait();
+
 	for (i=0; i < SCREEN_WIDTH; i += 2){
-		cmd[i] = data1;
-		cmd[i+1] = data2;
+		s_clearData[i] = data1;
+		s_clearData[i+1] = data2;
 	}
 
 	// Write 8 pages of 128 column of 8 pixels
-	for (i=0; i < PAGE_HEIGHT; i++) {
-		// Write 1 Page of 128 column of 8 pixels
-		LCD_WriteOneCommand(PAGE_ADDR | i);	// Set Page address (up to 8 pages)
-		LCD_SelectColumn(0);
-
-		LCD_WriteData(cmd,SCREEN_WIDTH);
+	for (i=0; i < SCREEN_HEIGHT / PAGE_HEIGHT; i++) {
+		LCD_DisplayPage(i, s_clearData);
 	}
 }
 
+/**
+ * @brief Display a full page, sent by the DMA.
+ * @param page Page to write.
+ * @param data 'SCREEN_WIDTH' bytes, one per column. Must stay valid until sent ('LCDDMA_Wait()').
+ */
+void LCD_DisplayPage(uint8_t page, const uint8_t *data)
+{
+	LCDDMA_Send(s_pageCommands[page], sizeof(s_pageCommands[page]), 0);
+	LCDDMA_Send(data, SCREEN_WIDTH, 1);
+}
+
 /**
  * @brief Display a string at the provided position.
  * @param y 'Y' position [page].
@@ -205,7 +327,7 @@ void LCD_DisplayString(uint8_t y, uint8_t x, char *string)
 		// First byte is used as size of displayed char
 		charSize = one_char;
 		// Increment pointer
-		*one_char++;
+		one_char++;
 
 		// Write max 7 columns
 		for (j = 0; j < *charSize; j++)
@@ -222,18 +344,18 @@ void LCD_DisplayString(uint8_t y, uint8_t x, char *string)
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayPicture(uint8_t x0, uint8_t y0, T_picture pic) {
+void LCD_DisplayPicture(uint8_t x0, uint8_t y0, const T_picture *pic) {
 
 	int i = y0;
 
 	// Get starting line and increment until last one
-	for (; i < y0 + pic.HEIGHT; i++) {
+	for (; i < y0 + pic->HEIGHT; i++) {
 		// Select current working page
-		LCD_WriteCommand(PAGE_ADDR | i);
+		LCD_WriteOneCommand(PAGE_ADDR | i);
 		// Select first column of line
 		LCD_SelectColumn(x0);
 
-		LCD_WriteDataFromStart(pic.DATA, pic.WIDTH, x0);
+		LCD_WriteDataFromStart(pic->DATA, pic->WIDTH, x0);
 	}
 }
 
@@ -247,10 +369,10 @@ void LCD_DisplayPicture(uint8_t x0, uint8_t y0, T_picture pic) {
  * @param height Height of the picture to display [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t yStart, uint8_t width, uint8_t height, T_picture pic)
+void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t yStart, uint8_t width, uint8_t height, const T_picture *pic)
 {
 	int i, j;
-	int index = yStart * pic.WIDTH + xStart;
+	int index = yStart * pic->WIDTH + xStart;
 
 	// Get starting line and increment until last one
 	for (i = y0 + yStart; i < y0 + yStart + height; i++)
@@ -261,12 +383,12 @@ void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t ySta
 		LCD_SelectColumn(x0+xStart);
 
 		// Compute next starting index index
-		index =  i * pic.WIDTH + xStart;
+		index =  i * pic->WIDTH + xStart;
 
 		// Write data on each column
 		for (j = x0 + xStart; j < x0 + xStart + width; j++)
 		{
-			LCD_WriteOneData(pic.DATA[index++]);
+			LCD_WriteOneData(pic->DATA[index++]);
 		}
 	}
 }
@@ -277,21 +399,21 @@ void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t ySta
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayCompressPicture(uint8_t x0, uint8_t y0, T_picture pic) {
+void LCD_DisplayCompressPicture(uint8_t x0, uint8_t y0, const T_picture *pic) {
 	int i = 0, j = 1, k;
 	int index = 0;
 	// The loop use double indexes to limit the operation 'i+1' that should be performed on second loop
-	for (;  j < pic.DATA_LENGTH; i += 2, j +=2) {
+	for (;  j < pic->DATA_LENGTH; i += 2, j +=2) {
 		// Add the number of same byte
-		for (k = 0; k < pic.DATA[i]; k++) {
+		for (k = 0; k < pic->DATA[i]; k++) {
 			// Change line when picture width is reached
-			if (index % pic.WIDTH == 0) {
+			if (index % pic->WIDTH == 0) {
 				LCD_SelectColumn(x0);
-				LCD_WriteCommand(PAGE_ADDR | y0);
+				LCD_WriteOneCommand(PAGE_ADDR | y0);
 				y0++;
 			}
 			// Write data
-			LCD_WriteOneData(pic.DATA[j]);
+			LCD_WriteOneData(pic->DATA[j]);
 			index++;
 		}
 	}
@@ -303,21 +425,21 @@ void LCD_DisplayCompressPicture(uint8_t x0, uint8_t y0, T_picture pic) {
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayCompressPictureI(uint8_t x0, uint8_t y0, T_picture pic) {
+void LCD_DisplayCompressPictureI(uint8_t x0, uint8_t y0, const T_picture *pic) {
 	int i = 0, j = 1, k;
 	int index = 0;
 	// The loop use double indexes to limit the operation 'i+1' that should be performed on second loop
-	for (;  j < pic.DATA_LENGTH; i += 2, j +=2) {
+	for (;  j < pic->DATA_LENGTH; i += 2, j +=2) {
 		// Add the number of same byte
-		for (k = 0; k < pic.DATA[i]; k++) {
+		for (k = 0; k < pic->DATA[i]; k++) {
 			// Change line when picture width is reached
-			if (index % pic.WIDTH == 0) {
+			if (index % pic->WIDTH == 0) {
 				LCD_SelectColumn(x0);
 				LCD_WriteOneCommand(PAGE_ADDR | y0);
 				y0++;
 			}
 			// Write data
-			LCD_WriteOneData(~pic.DATA[j]); // Inverse color
+			LCD_WriteOneData(~pic->DATA[j]); // Inverse color
 			index++;
 		}
 	}
@@ -366,7 +488,7 @@ uint8_t LCD_DisplaySetPixel(uint8_t x, uint8_t y, uint8_t rootPage) {
 
 	// Set on the page the corresponding pixel.
 	rootPage |= (1 << y % 8);
-	LCD_WriteCommand(PAGE_ADDR | (y / 8));
+	LCD_WriteOneCommand(PAGE_ADDR | (y / 8));
 	LCD_SelectColumn(x);
 
 	LCD_WriteOneData(rootPage);
@@ -384,10 +506,11 @@ void LCD_ProgressBar(uint8_t x0, uint8_t y0, uint8_t value) {
 	// the result will look like : ||||||::::::|
 	uint8_t passed = 0x7E;	//[|]
 	uint8_t nok = 0x42;		//[:]
-	uint8_t size = 100;
+	uint8_t size = LCD_PROGRESS_LENGTH;
 	uint8_t i = 1;
 
-	uint8_t data[size + 2];
+	// Fixed size so the stack use is known at compile time
+	uint8_t data[LCD_PROGRESS_LENGTH + 2];
 
 	// Set end of progress bar
 	data[0] = passed;
@@ -408,9 +531,258 @@ void LCD_ProgressBar(uint8_t x0, uint8_t y0, uint8_t value) {
 	size ++;
 
 	// Select provided page addr
-	LCD_WriteCommand(PAGE_ADDR | y0);
+	LCD_WriteOneCommand(PAGE_ADDR | y0);
 	// Select provided column
 	LCD_SelectColumn(x0);
 
-	LCD_WriteDataFrom(data, size, x0);
+	LCD_WriteData(data, size);
+}
+
+/**
+ * @brief Get a column of a character.
+ * @param font Font, 'NULL' for the standard 8x8 font.
+ * @param c Character.
+ * @param column Column in the glyph [px].
+ * @return The column word, page 'n' is byte 'n'. '0' after the glyph or for an unknown character.
+ */
+static uint32_t LCD_GlyphColumn(const lcd_font_t *font, char c, uint32_t column)
+{
+	const unsigned char *glyph;
+	uint32_t index;
+
+	// The last column of a standard cell is the space between the characters
+	if (font == NULL)
+	{
+		glyph = &Font_TAB[(c - (char) 24) * PIXEL_8X8_SIZE];
+		return (c != ' ' && column < glyph[0] && column < PIXEL_8X8_SIZE - 1) ? glyph[column + 1] : 0x00;
+	}
+
+	index = (uint8_t)(c - font->first);
+	if (index >= font->count || column >= font->widths[index])
+		return 0;
+
+	return font->columns[font->offsets[index] + column];
+}
+
+/**
+ * @brief Display a string with a font, the glyph columns are sent page by page.
+ * @param font Font, the characters out of its range are blank glyphs of its cell width.
+ * @param y 'Y' position of the top page [page].
+ * @param x 'X' position [px].
+ * @param string Message to write, cut at the screen edge.
+ */
+void LCD_DisplayText(const lcd_font_t *font, uint8_t y, uint8_t x, const char *string)
+{
+	uint8_t data[SCREEN_WIDTH];
+	uint8_t cmd[3];
+	uint32_t index, width, column;
+	uint32_t size;
+	const char *c;
+	int page;
+
+	for (page = 0; page < font->pages; page++)
+	{
+		size = 0;
+		for (c = string; *c != '\0' && x + size < SCREEN_WIDTH; c++)
+		{
+			index = (uint8_t)(*c - font->first);
+			width = index < font->count ? font->widths[index] + font->spacing : font->cellWidth;
+
+			// One word per glyph column, the page byte is extracted by a shift
+			for (column = 0; column < width && x + size < SCREEN_WIDTH; column++)
+				data[size++] = LCD_GlyphColumn(font, *c, column) >> (page * PAGE_HEIGHT);
+		}
+
+		if (size == 0)
+			return;
+
+		cmd[0] = PAGE_ADDR | (y + page);
+		cmd[1] = COLUMN_LSB | (0x0F & x);
+		cmd[2] = COLUMN_MSB | (0x0F & (x >> 4));
+
+		LCD_WriteCommands(cmd, sizeof(cmd));
+		LCD_WriteData(data, size);
+	}
+}
+
+/**
+ * @brief Initialize a numeric field, its cells are drawn by the next 'LCD_DisplayNumber()'.
+ * @param field Field to initialize.
+ * @param font Font of the digits, 'NULL' for the standard 8x8 font.
+ * @param x 'X' position of the first cell [px].
+ * @param y 'Y' position of the top page [page].
+ * @param cells Number of cells, at most 'LCD_NUMBER_MAX_CELLS'.
+ */
+void LCD_NumberInit(lcd_number_t *field, const lcd_font_t *font, uint8_t x, uint8_t y, uint8_t cells)
+{
+	field->font = font;
+	field->x = x;
+	field->y = y;
+	field->cells = cells > LCD_NUMBER_MAX_CELLS ? LCD_NUMBER_MAX_CELLS : cells;
+	memset(field->drawn, 0, sizeof(field->drawn));
+}
+
+/**
+ * @brief Display a value in a numeric field, only the changed cells are sent.
+ * The cells from the first to the last changed one are sent in a single data transfer per page.
+ * @param field Numeric field.
+ * @param value Value to display, only the lower digits are displayed if it doesn't fit.
+ */
+void LCD_DisplayNumber(lcd_number_t *field, uint32_t value)
+{
+	char text[LCD_NUMBER_MAX_CELLS];
+	uint8_t data[SCREEN_WIDTH];
+	uint8_t cmd[3];
+	uint8_t cell = field->font ? field->font->cellWidth : PIXEL_8X8_SIZE;
+	uint8_t pages = field->font ? field->font->pages : 1;
+	uint8_t x;
+	int first = -1, last = -1;
+	int i, j, page;
+	uint32_t size;
+
+	// Right aligned digits, the leading cells are blank
+	for (i = field->cells - 1; i >= 0; i--)
+	{
+		text[i] = (value != 0 || i == field->cells - 1) ? '0' + value % 10 : ' ';
+		value /= 10;
+
+		if (text[i] != field->drawn[i])
+		{
+			if (last < 0)
+				last = i;
+			first = i;
+		}
+	}
+
+	if (first < 0)
+		return;
+
+	x = field->x + first * cell;
+
+	// The cell width is fixed, the columns after a glyph clear the previous one
+	for (page = 0; page < pages; page++)
+	{
+		size = 0;
+		for (i = first; i <= last; i++)
+		{
+			for (j = 0; j < cell && x + size < SCREEN_WIDTH; j++)
+				data[size++] = LCD_GlyphColumn(field->font, text[i], j) >> (page * PAGE_HEIGHT);
+		}
+
+		cmd[0] = PAGE_ADDR | (field->y + page);
+		cmd[1] = COLUMN_LSB | (0x0F & x);
+		cmd[2] = COLUMN_MSB | (0x0F & (x >> 4));
+
+		LCD_WriteCommands(cmd, sizeof(cmd));
+		LCD_WriteData(data, size);
+	}
+
+	for (i = first; i <= last; i++)
+		field->drawn[i] = text[i];
+}
+
+/**
+ * @brief Initialize a sweep chart and clear its area.
+ * @param chart Chart to initialize.
+ * @param x 'X' position of the first column [px].
+ * @param y 'Y' position of the top page [page].
+ * @param width Number of columns, at least 2 [px].
+ * @param pages Height, at most 'LCD_CHART_MAX_PAGES' [page].
+ * @param min Value of the bottom row.
+ * @param max Value of the top row, greater than 'min'.
+ */
+void LCD_ChartInit(lcd_chart_t *chart, uint8_t x, uint8_t y, uint8_t width, uint8_t pages, uint32_t min, uint32_t max)
+{
+	chart->x = x;
+	chart->y = y;
+	chart->width = width;
+	chart->pages = pages > LCD_CHART_MAX_PAGES ? LCD_CHART_MAX_PAGES : pages;
+	chart->min = min;
+	chart->max = max;
+	chart->column = 0;
+	chart->last = chart->pages * PAGE_HEIGHT - 1;
+
+	LCD_DisplayRectangle(x, y, width, chart->pages, 0x00);
+}
+
+/**
+ * @brief Write one column of a chart on all its pages.
+ * @param chart Sweep chart.
+ * @param column Written column.
+ * @param data One byte per page, then a second one per page if 'size' is 2.
+ * @param size Number of columns written from 'column', '1' or '2'.
+ */
+static void LCD_ChartWrite(lcd_chart_t *chart, uint8_t column, uint8_t data[][2], uint32_t size)
+{
+	uint8_t cmd[3];
+	uint8_t x = chart->x + column;
+	int i;
+
+	for (i = 0; i < chart->pages; i++)
+	{
+		cmd[0] = PAGE_ADDR | (chart->y + i);
+		cmd[1] = COLUMN_LSB | (0x0F & x);
+		cmd[2] = COLUMN_MSB | (0x0F & (x >> 4));
+
+		LCD_WriteCommands(cmd, sizeof(cmd));
+		LCD_WriteData(data[i], size);
+	}
+}
+
+/**
+ * @brief Add a sample to a sweep chart.
+ * The sample column joins the previous sample and the next column is cleared to show the sweep
+ * position, so only two columns per page are sent.
+ * @param chart Sweep chart.
+ * @param value Sample, clamped to the chart range.
+ */
+void LCD_ChartAdd(lcd_chart_t *chart, uint32_t value)
+{
+	uint8_t data[LCD_CHART_MAX_PAGES][2];
+	uint32_t rows = chart->pages * PAGE_HEIGHT;
+	uint32_t row, top, bottom, bit;
+	uint8_t next;
+	int i;
+
+	if (value < chart->min)
+		value = chart->min;
+	else if (value > chart->max)
+		value = chart->max;
+
+	// Row 0 is the top of the chart
+	row = rows - 1 - (value - chart->min) * (rows - 1) / (chart->max - chart->min);
+
+	// Vertical segment from the previous sample, the trace stays continuous on steps
+	top = row < chart->last ? row : chart->last;
+	bottom = row < chart->last ? chart->last : row;
+	chart->last = row;
+
+	// The LSB of a page byte is its top pixel
+	for (i = 0; i < chart->pages; i++)
+	{
+		data[i][0] = 0x00;
+		data[i][1] = 0x00;
+		for (bit = 0; bit < PAGE_HEIGHT; bit++)
+		{
+			if (i * PAGE_HEIGHT + bit >= top && i * PAGE_HEIGHT + bit <= bottom)
+				data[i][0] |= 1 << bit;
+		}
+	}
+
+	next = chart->column + 1 < chart->width ? chart->column + 1 : 0;
+
+	// The gap is sent with the sample column unless the sweep wraps
+	if (next != 0)
+	{
+		LCD_ChartWrite(chart, chart->column, data, 2);
+	}
+	else
+	{
+		LCD_ChartWrite(chart, chart->column, data, 1);
+		for (i = 0; i < chart->pages; i++)
+			data[i][0] = 0x00;
+		LCD_ChartWrite(chart, 0, data, 1);
+	}
+
+	chart->column = next;
 }
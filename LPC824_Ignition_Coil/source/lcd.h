@@ -38,6 +38,13 @@
 #define SCREEN_WIDTH	128		///< Screen width in pixel.
 #define PAGE_HEIGHT		8		///< Page height in pixel. A page is the minimum manageable size for screen writing.
 
+#define LCD_STEP_DELAY_MS	10		///< Delay between the reset and power-up steps [ms].
+#define LCD_SPLASH_TIME_MS	300		///< Time the splash screen is displayed [ms].
+
+#define LCD_NUMBER_MAX_CELLS	6		///< Maximum number of digits of a numeric field.
+#define LCD_CHART_MAX_PAGES		4		///< Maximum height of a chart [page].
+#define LCD_PROGRESS_LENGTH		100		///< Length of the progress bar [px].
+
 enum LCD_PIN		///< Enumeration used to store LCD pin in GPIO.
 {
 	IO_CS0 = 0,		///< GPIO pin for CS0.
@@ -47,13 +54,78 @@ enum LCD_PIN		///< Enumeration used to store LCD pin in GPIO.
 	IO_SCLK = 23	///< GPIO pin for SCLK.
 };
 
+/**
+ * @brief Font with precomputed glyph metrics, generated by 'tools/font_gen.py'.
+ */
+typedef struct
+{
+	const uint32_t *columns;	///< Glyph columns, one word per column: bit 0 is the top pixel, page 'n' is byte 'n'.
+	const uint16_t *offsets;	///< First column of each glyph.
+	const uint8_t *widths;		///< Width of each glyph [px].
+	char first;					///< First character.
+	uint8_t count;				///< Number of glyphs.
+	uint8_t pages;				///< Height, at most 4 [page].
+	uint8_t spacing;			///< Blank columns after a glyph [px].
+	uint8_t cellWidth;			///< Width of the widest glyph and the spacing [px].
+}lcd_font_t;
+
+/**
+ * @brief Numeric field: right aligned digits in fixed width cells.
+ * The cells are 'PIXEL_8X8_SIZE' columns wide with the standard font, 'cellWidth' otherwise.
+ */
+typedef struct
+{
+	const lcd_font_t *font;					///< Font of the digits, 'NULL' for the standard 8x8 font.
+	uint8_t x;								///< 'X' position of the first cell [px].
+	uint8_t y;								///< 'Y' position of the top page [page].
+	uint8_t cells;							///< Number of cells.
+	char drawn[LCD_NUMBER_MAX_CELLS];		///< Characters on the screen, '0' if unknown.
+}lcd_number_t;
+
+/**
+ * @brief Sweep chart: one column per sample, written over the oldest one with a blank gap ahead.
+ */
+typedef struct
+{
+	uint8_t x;				///< 'X' position of the first column [px].
+	uint8_t y;				///< 'Y' position of the top page [page].
+	uint8_t width;			///< Number of columns [px].
+	uint8_t pages;			///< Height [page].
+	uint32_t min;			///< Value of the bottom row.
+	uint32_t max;			///< Value of the top row.
+	uint8_t column;			///< Column of the next sample.
+	uint8_t last;			///< Row of the last sample, from the top [px].
+}lcd_chart_t;
+
 /**
  * @brief Initialize the LCD screen.
  * Initialize the SPI as master, the LCD and display a picture for 3sec.
+ * Blocking version of 'LCD_InitStart()' and 'LCD_InitProcess()'.
  * @return Initialization status.
  */
 uint8_t LCD_Init();		///< Initialize the LCD.
 
+/**
+ * @brief Start the LCD initialization.
+ * Initialize the SPI as master and start the reset sequence. The power-up sequence and the
+ * splash screen are then handled by 'LCD_InitProcess()'. The Systick must be running.
+ * @return Initialization status.
+ */
+uint8_t LCD_InitStart(void);	///< Start the LCD initialization.
+
+/**
+ * @brief Run the next step of the LCD initialization once its delay has elapsed.
+ * Must be called periodically after 'LCD_InitStart()'. Never waits.
+ * @return '1' once the splash screen hold has elapsed and the screen can be used, '0' otherwise.
+ */
+uint8_t LCD_InitProcess(void);	///< Process the LCD initialization.
+
+/**
+ * @brief Check if the LCD display is enabled.
+ * @return '1' once the splash screen is displayed.
+ */
+uint8_t LCD_IsOn(void);		///< Check if the LCD display is enabled.
+
 /**
  * @brief Command to be sent through SPI.
  * @param cmd Buffer data to send.
@@ -64,7 +136,7 @@ void LCD_WriteCommands(uint8_t cmd[], uint32_t size);	///< Write commands to the
  * @brief Write one byte command.
  * @param cmd Command to send.
  */
-void LCD_WriteCommand(uint8_t cmd);		///< Write one byte command to the LCD.
+void LCD_WriteOneCommand(uint8_t cmd);		///< Write one byte command to the LCD.
 
 /**
  * @brief Write the number of byte provided of the provide data buffer.
@@ -83,7 +155,7 @@ void LCD_WriteOneData(uint8_t cmd);		///< Write one byte data to the LCD.
  * @param size Number of bytes to send.
  * @param startIndex Data buffer starting index.
  */
-void LCD_WriteDataFromStart(uint8_t data[], uint32_t size, uint32_t startIndex);	///< Write commands at the provided starting index to the LCD.
+void LCD_WriteDataFromStart(const uint8_t data[], uint32_t size, uint32_t startIndex);	///< Write commands at the provided starting index to the LCD.
 /**
  * @brief Select a column in the screen to send data
  * @param col Column index.
@@ -91,10 +163,17 @@ void LCD_WriteDataFromStart(uint8_t data[], uint32_t size, uint32_t startIndex);
 void LCD_SelectColumn(uint8_t col);		///< Select the LCD cursor column.
 /**
  * @brief Send a couple of byte to fill the screen.
+ * The pages are sent by the DMA, the function returns once they are queued.
  * @param data1 First data to set.
  * @param data2 Second data to set
  */
 void LCD_DisplayClear(uint8_t data1, uint8_t data2);	///< Display on screen by packet of 2 the provided data.
+/**
+ * @brief Display a full page, sent by the DMA.
+ * @param page Page to write.
+ * @param data 'SCREEN_WIDTH' bytes, one per column. Must stay valid until sent ('LCDDMA_Wait()').
+ */
+void LCD_DisplayPage(uint8_t page, const uint8_t *data);	///< Display a full page.
 /**
  * @brief Display a string at the provided position.
  * @param y 'Y' position [page].
@@ -109,7 +188,7 @@ void LCD_DisplayString(uint8_t yPos, uint8_t xPos, char *string);	///< Display a
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayPicture(uint8_t x0, uint8_t y0, T_picture pic);		///< Display a picture at the provided position.
+void LCD_DisplayPicture(uint8_t x0, uint8_t y0, const T_picture *pic);		///< Display a picture at the provided position.
 /**
  * @brief Display a part of raw picture on selected position.
  * @param x0 'X' position of the full picture [px].
@@ -120,21 +199,21 @@ void LCD_DisplayPicture(uint8_t x0, uint8_t y0, T_picture pic);		///< Display a
  * @param height Height of the picture to display [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t yStart, uint8_t width, uint8_t height, T_picture pic); ///< Display a part of a picture at the provided position.
+void LCD_DisplayPartPicture(uint8_t x0, uint8_t y0, uint8_t xStart, uint8_t yStart, uint8_t width, uint8_t height, const T_picture *pic); ///< Display a part of a picture at the provided position.
 /**
  * @brief Display a compressed picture on selected position.
  * @param x0 'X' position [px].
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayCompressPicture(uint8_t x0, uint8_t y0, T_picture pic);		///< Display a compressed picture at the provided position.
+void LCD_DisplayCompressPicture(uint8_t x0, uint8_t y0, const T_picture *pic);		///< Display a compressed picture at the provided position.
 /**
  * @brief Display a inverse compressed picture on selected position.
  * @param x0 'X' position [px].
  * @param y0 'Y' position [page].
  * @param pic Picture to display.
  */
-void LCD_DisplayCompressPictureI(uint8_t x0, uint8_t y0, T_picture pic);	///< Display a color inverse picture at the provided position.
+void LCD_DisplayCompressPictureI(uint8_t x0, uint8_t y0, const T_picture *pic);	///< Display a color inverse picture at the provided position.
 /**
  * @brief Display a rectangle with provided color on selected area.
  * @param x0 Up Left corner of the rectangle [px].
@@ -160,5 +239,48 @@ uint8_t LCD_DisplaySetPixel(uint8_t x, uint8_t y, uint8_t rootPage);		///< Set a
  * @param value Progress bar value to set [0-100].
  */
 void LCD_ProgressBar(uint8_t x0, uint8_t y0, uint8_t value);		///< Display a progress bar with value from 0 to 100.
+/**
+ * @brief Display a string with a font, the glyph columns are sent page by page.
+ * @param font Font, the characters out of its range are blank glyphs of its cell width.
+ * @param y 'Y' position of the top page [page].
+ * @param x 'X' position [px].
+ * @param string Message to write, cut at the screen edge.
+ */
+void LCD_DisplayText(const lcd_font_t *font, uint8_t y, uint8_t x, const char *string);	///< Display a string with a font.
+/**
+ * @brief Initialize a numeric field, its cells are drawn by the next 'LCD_DisplayNumber()'.
+ * @param field Field to initialize.
+ * @param font Font of the digits, 'NULL' for the standard 8x8 font.
+ * @param x 'X' position of the first cell [px].
+ * @param y 'Y' position of the top page [page].
+ * @param cells Number of cells, at most 'LCD_NUMBER_MAX_CELLS'.
+ */
+void LCD_NumberInit(lcd_number_t *field, const lcd_font_t *font, uint8_t x, uint8_t y, uint8_t cells);	///< Initialize a numeric field.
+/**
+ * @brief Display a value in a numeric field, only the changed cells are sent.
+ * The cells from the first to the last changed one are sent in a single data transfer per page.
+ * @param field Numeric field.
+ * @param value Value to display, only the lower digits are displayed if it doesn't fit.
+ */
+void LCD_DisplayNumber(lcd_number_t *field, uint32_t value);	///< Display a value in a numeric field.
+/**
+ * @brief Initialize a sweep chart and clear its area.
+ * @param chart Chart to initialize.
+ * @param x 'X' position of the first column [px].
+ * @param y 'Y' position of the top page [page].
+ * @param width Number of columns, at least 2 [px].
+ * @param pages Height, at most 'LCD_CHART_MAX_PAGES' [page].
+ * @param min Value of the bottom row.
+ * @param max Value of the top row, greater than 'min'.
+ */
+void LCD_ChartInit(lcd_chart_t *chart, uint8_t x, uint8_t y, uint8_t width, uint8_t pages, uint32_t min, uint32_t max);	///< Initialize a sweep chart.
+/**
+ * @brief Add a sample to a sweep chart.
+ * The sample column joins the previous sample and the next column is cleared to show the sweep
+ * position, so only two columns per page are sent.
+ * @param chart Sweep chart.
+ * @param value Sample, clamped to the chart range.
+ */
+void LCD_ChartAdd(lcd_chart_t *chart, uint32_t value);	///< Add a sample to a sweep chart.
 
 #endif /* LCD_H_ */
@@ -0,0 +1,224 @@
+/**
+ * @file lcd_dma.c
+ *
+ * @brief DMA transmission of the LCD commands and data over SPI0.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The transfers are queued as segments: a buffer and the level of the LCD command/data pin. The
+ * DMA channel of the SPI0 transmitter streams a segment paced by the SPI requests, the segments
+ * longer than the DMA transfer count are split in linked descriptors. The interrupt of the last
+ * descriptor waits for the SPI to be idle when the command/data pin must change, sets it and starts
+ * the next segment, so the CPU only runs once per segment.\n
+ * The buffers must stay valid until the segment is sent: 'LCDDMA_Wait()' returns when the queue is
+ * empty and must be called before the SPI is used by the blocking functions.
+ */
+
+#include "lcd_dma.h"
+#include "fsl_gpio.h"
+#include "isr_stats.h"
+
+/**
+ * @brief DMA descriptor, as read by the DMA controller.
+ */
+typedef struct
+{
+	volatile uint32_t xfercfg;		///< Transfer configuration (reserved in the channel descriptor).
+	uint32_t srcEnd;				///< Address of the last source byte.
+	uint32_t dstEnd;				///< Address of the last destination byte.
+	uint32_t next;					///< Address of the next descriptor, '0' for none.
+}lcddma_descriptor_t;
+
+/**
+ * @brief Queued segment.
+ */
+typedef struct
+{
+	const uint8_t *data;		///< Bytes to send.
+	uint16_t size;				///< Number of bytes.
+	uint8_t cd;					///< Level of the command/data pin.
+}lcddma_segment_t;
+
+// The channel descriptor table must be aligned on 512 bytes, only the channels up to the used one are allocated
+static lcddma_descriptor_t s_channels[LCDDMA_CHANNEL + 1] __attribute__((aligned(512)));
+static lcddma_descriptor_t s_links[LCDDMA_MAX_LINKS] __attribute__((aligned(16)));
+
+static SPI_Type *s_spi;								///< SPI used by the LCD.
+static uint32_t s_cdPin;							///< GPIO pin of the command/data signal.
+static lcddma_segment_t s_queue[LCDDMA_QUEUE_SIZE];	///< Queued segments.
+static volatile uint32_t s_head;					///< Next written segment.
+static volatile uint32_t s_tail;					///< Segment being sent.
+static volatile uint8_t s_busy;						///< A segment is being sent.
+static uint8_t s_cd = 0xFF;							///< Current level of the command/data pin.
+
+/**
+ * @brief Transfer configuration of a descriptor.
+ * @param count Number of bytes.
+ * @param last '1' for the last descriptor of a segment.
+ * @return The XFERCFG value.
+ */
+static uint32_t LCDDMA_XferCfg(uint32_t count, uint8_t last){
+
+	uint32_t cfg = DMA_CHANNEL_XFERCFG_CFGVALID_MASK | DMA_CHANNEL_XFERCFG_WIDTH(0)
+			| DMA_CHANNEL_XFERCFG_SRCINC(1) | DMA_CHANNEL_XFERCFG_DSTINC(0) | DMA_CHANNEL_XFERCFG_XFERCOUNT(count - 1);
+
+	if(last){
+		cfg |= DMA_CHANNEL_XFERCFG_CLRTRIG_MASK | DMA_CHANNEL_XFERCFG_SETINTA_MASK;
+	}
+	else{
+		cfg |= DMA_CHANNEL_XFERCFG_RELOAD_MASK;
+	}
+	return cfg;
+}
+
+/**
+ * @brief Start the segment at the tail of the queue, or end the transmission if the queue is empty.
+ * Called from the DMA interrupt or with the DMA interrupt masked.
+ */
+static void LCDDMA_StartNext(void){
+
+	const lcddma_segment_t *segment;
+	lcddma_descriptor_t *descriptor = &s_channels[LCDDMA_CHANNEL];
+	uint32_t remaining, count;
+	uint32_t first = 0;
+	uint32_t link = 0;
+
+	if(s_tail == s_head){
+		// Release the chip select once the last byte is shifted out
+		s_spi->STAT = SPI_STAT_ENDTRANSFER_MASK;
+		s_busy = 0;
+		return;
+	}
+
+	segment = &s_queue[s_tail];
+	s_busy = 1;
+
+	// The LCD samples the command/data pin with the last bit of each byte
+	if(segment->cd != s_cd){
+		while(!(s_spi->STAT & SPI_STAT_MSTIDLE_MASK));
+		GPIO_PinWrite(GPIO, 0, s_cdPin, segment->cd);
+		s_cd = segment->cd;
+	}
+
+	// Split the segment in the channel descriptor and the linked ones
+	remaining = segment->size;
+	while(remaining){
+		count = remaining > LCDDMA_MAX_TRANSFER ? LCDDMA_MAX_TRANSFER : remaining;
+		remaining -= count;
+
+		descriptor->srcEnd = (uint32_t)(segment->data + (segment->size - remaining) - 1);
+		descriptor->dstEnd = (uint32_t)&s_spi->TXDAT;
+		descriptor->next = remaining ? (uint32_t)&s_links[link] : 0;
+
+		if(descriptor == &s_channels[LCDDMA_CHANNEL]){
+			first = LCDDMA_XferCfg(count, remaining == 0);
+		}
+		else{
+			descriptor->xfercfg = LCDDMA_XferCfg(count, remaining == 0);
+		}
+
+		if(remaining){
+			descriptor = &s_links[link++];
+		}
+	}
+
+	DMA0->COMMON[0].SETVALID = 1U << LCDDMA_CHANNEL;
+	DMA0->CHANNEL[LCDDMA_CHANNEL].XFERCFG = first | DMA_CHANNEL_XFERCFG_SWTRIG_MASK;
+}
+
+/**
+ * @brief DMA interrupt. A segment has been sent, start the next one.
+ */
+void DMA0_IRQHandler(void){
+
+	uint32_t mask = 1U << LCDDMA_CHANNEL;
+
+	ISRSTATS_ENTER(ISRSTATS_DMA, ISRSTATS_NO_LATENCY);
+
+	if(DMA0->COMMON[0].INTA & mask){
+		DMA0->COMMON[0].INTA = mask;
+		s_tail = (s_tail + 1) & (LCDDMA_QUEUE_SIZE - 1);
+		LCDDMA_StartNext();
+	}
+
+	ISRSTATS_EXIT(ISRSTATS_DMA);
+}
+
+/**
+ * @brief Initialize the DMA channel of the SPI transmitter. The SPI must be initialized.
+ * @param base SPI peripheral base address.
+ * @param cdPin GPIO pin (port 0) of the LCD command/data signal.
+ */
+void LCDDMA_Init(SPI_Type *base, uint32_t cdPin){
+
+	s_spi = base;
+	s_cdPin = cdPin;
+	s_head = 0;
+	s_tail = 0;
+	s_busy = 0;
+	s_cd = 0xFF;
+
+	CLOCK_EnableClock(kCLOCK_Dma);
+	DMA0->SRAMBASE = (uint32_t)s_channels;
+	DMA0->CTRL = DMA_CTRL_ENABLE_MASK;
+
+	// One byte per SPI transmitter request
+	DMA0->CHANNEL[LCDDMA_CHANNEL].CFG = DMA_CHANNEL_CFG_PERIPHREQEN_MASK;
+	DMA0->COMMON[0].ENABLESET = 1U << LCDDMA_CHANNEL;
+	DMA0->COMMON[0].INTENSET = 1U << LCDDMA_CHANNEL;
+
+	NVIC_SetPriority(DMA0_IRQn, LCDDMA_IRQ_PRIORITY);
+	EnableIRQ(DMA0_IRQn);
+}
+
+/**
+ * @brief Queue a segment and start the transmission if idle.
+ * Waits for a free entry when the queue is full.
+ * @param data Bytes to send, must stay valid until sent.
+ * @param size Number of bytes, at most 'LCDDMA_MAX_TRANSFER' * ('LCDDMA_MAX_LINKS' + 1).
+ * @param cd Level of the command/data pin, '0' for commands and '1' for data.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the size is incorrect.
+ */
+status_t LCDDMA_Send(const uint8_t *data, uint32_t size, uint8_t cd){
+
+	uint32_t next;
+
+	if(size == 0 || size > LCDDMA_MAX_TRANSFER * (LCDDMA_MAX_LINKS + 1)){
+		return kStatus_InvalidArgument;
+	}
+
+	next = (s_head + 1) & (LCDDMA_QUEUE_SIZE - 1);
+	while(next == s_tail);
+
+	s_queue[s_head].data = data;
+	s_queue[s_head].size = size;
+	s_queue[s_head].cd = cd;
+
+	DisableIRQ(DMA0_IRQn);
+
+	// The words that configure the transfer are written once the segment is complete
+	s_head = next;
+	if(!s_busy){
+		// The blocking functions may have used the SPI with other settings
+		s_spi->TXCTL = (s_spi->TXCTL & ~(SPI_TXCTL_EOT_MASK | SPI_TXCTL_EOF_MASK)) | SPI_TXCTL_RXIGNORE_MASK;
+		s_cd = GPIO_PinRead(GPIO, 0, s_cdPin);
+		LCDDMA_StartNext();
+	}
+
+	EnableIRQ(DMA0_IRQn);
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Wait for the queued segments to be sent and the SPI to be idle.
+ */
+void LCDDMA_Wait(void){
+
+	if(s_spi == NULL){
+		return;
+	}
+
+	while(s_busy);
+	while(!(s_spi->STAT & SPI_STAT_MSTIDLE_MASK));
+}
@@ -0,0 +1,51 @@
+/**
+ * @file lcd_dma.h
+ *
+ * @brief DMA transmission of the LCD commands and data over SPI0.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The transfers are queued as segments: a buffer and the level of the LCD command/data pin. The
+ * DMA channel of the SPI0 transmitter streams a segment paced by the SPI requests, the segments
+ * longer than the DMA transfer count are split in linked descriptors. The interrupt of the last
+ * descriptor waits for the SPI to be idle when the command/data pin must change, sets it and starts
+ * the next segment, so the CPU only runs once per segment.\n
+ * The buffers must stay valid until the segment is sent: 'LCDDMA_Wait()' returns when the queue is
+ * empty and must be called before the SPI is used by the blocking functions.
+ */
+
+#ifndef LCD_DMA_H_
+#define LCD_DMA_H_
+
+#include "board.h"
+#include "fsl_spi.h"
+
+#define LCDDMA_CHANNEL			7		///< DMA channel of the SPI0 transmitter request.
+#define LCDDMA_QUEUE_SIZE		32		///< Number of queued segments. Must be a power of 2.
+#define LCDDMA_MAX_TRANSFER		1024	///< Maximum number of bytes of a descriptor.
+#define LCDDMA_MAX_LINKS		1		///< Number of linked descriptors following the channel descriptor.
+#define LCDDMA_IRQ_PRIORITY		3		///< Interrupt priority, lower than the pulse engine.
+
+/**
+ * @brief Initialize the DMA channel of the SPI transmitter. The SPI must be initialized.
+ * @param base SPI peripheral base address.
+ * @param cdPin GPIO pin (port 0) of the LCD command/data signal.
+ */
+void LCDDMA_Init(SPI_Type *base, uint32_t cdPin);
+
+/**
+ * @brief Queue a segment and start the transmission if idle.
+ * Waits for a free entry when the queue is full.
+ * @param data Bytes to send, must stay valid until sent.
+ * @param size Number of bytes, at most 'LCDDMA_MAX_TRANSFER' * ('LCDDMA_MAX_LINKS' + 1).
+ * @param cd Level of the command/data pin, '0' for commands and '1' for data.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the size is incorrect.
+ */
+status_t LCDDMA_Send(const uint8_t *data, uint32_t size, uint8_t cd);
+
+/**
+ * @brief Wait for the queued segments to be sent and the SPI to be idle.
+ */
+void LCDDMA_Wait(void);
+
+#endif /* LCD_DMA_H_ */
@@ -0,0 +1,262 @@
+/**
+ * @file maps.c
+ *
+ * @brief Dwell and spark advance maps with fixed-point bilinear interpolation.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * A map is a table of 16-bit cells indexed by the RPM and the load (the coil supply voltage).
+ * The defaults are stored in flash and copied in RAM where they can be replaced over the telemetry
+ * link. The reciprocals of the axis steps are computed when a map is loaded so the evaluation has
+ * no division: the interpolation factors are Q15 values obtained with one multiply and one shift,
+ * the evaluation time is bounded by the axis size.
+ */
+
+#include "maps.h"
+#include "telemetry.h"
+
+#define Q15_ONE			32767		///< Largest Q15 interpolation factor.
+#define RECIP_SHIFT		30			///< The reciprocal of an axis step is (1 << RECIP_SHIFT) / step.
+#define WRITE_WORDS		8			///< Maximum number of words written by one telemetry command.
+
+/**
+ * @brief Map loaded in RAM.
+ */
+typedef struct
+{
+	map_table_t table;						///< Table.
+	uint32_t rpmRecip[MAP_SIZE - 1];		///< Reciprocals of the RPM axis steps.
+	uint32_t loadRecip[MAP_SIZE - 1];		///< Reciprocals of the load axis steps.
+	uint8_t valid;							///< The axes are increasing.
+}map_t;
+
+/**
+ * @brief Default maps, stored in flash.
+ */
+static const map_table_t s_defaults[MAP_COUNT] =
+{
+	// Dwell [us]: constant coil energy, the charge time is inversely proportional to the supply voltage
+	{
+		{1000, 2000, 3000, 4000, 5000, 6000, 7500, 9000},
+		{8000, 9000, 10000, 11000, 12000, 13000, 14000, 16000},
+		{
+			{3000, 3000, 3000, 3000, 3000, 3000, 3000, 3000},
+			{2667, 2667, 2667, 2667, 2667, 2667, 2667, 2667},
+			{2400, 2400, 2400, 2400, 2400, 2400, 2400, 2400},
+			{2182, 2182, 2182, 2182, 2182, 2182, 2182, 2182},
+			{2000, 2000, 2000, 2000, 2000, 2000, 2000, 2000},
+			{1846, 1846, 1846, 1846, 1846, 1846, 1846, 1846},
+			{1714, 1714, 1714, 1714, 1714, 1714, 1714, 1714},
+			{1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500}
+		}
+	},
+	// Advance [1/100 degree]: increases with the RPM, independent of the supply voltage
+	{
+		{1000, 2000, 3000, 4000, 5000, 6000, 7500, 9000},
+		{8000, 9000, 10000, 11000, 12000, 13000, 14000, 16000},
+		{
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400},
+			{1000, 1500, 2000, 2500, 2800, 3000, 3200, 3400}
+		}
+	}
+};
+
+static map_t s_maps[MAP_COUNT];		///< Maps loaded in RAM.
+
+/**
+ * @brief Compute the reciprocals of the steps of an axis.
+ * @param axis Axis points.
+ * @param recip Array where the reciprocals are stored.
+ * @return '1' if the axis is strictly increasing.
+ */
+static uint8_t MAP_Prepare(const uint16_t *axis, uint32_t *recip){
+
+	uint32_t i;
+
+	for(i = 0; i < MAP_SIZE - 1; i++){
+		if(axis[i + 1] <= axis[i]){
+			return 0;
+		}
+		recip[i] = (1U << RECIP_SHIFT) / (axis[i + 1] - axis[i]);
+	}
+	return 1;
+}
+
+/**
+ * @brief Find the axis segment of a value and its Q15 position in the segment.
+ * @param axis Axis points.
+ * @param recip Reciprocals of the axis steps.
+ * @param x Value, clamped to the axis.
+ * @param fraction Pointer where the Q15 position is stored.
+ * @return The first point of the segment.
+ */
+static uint32_t MAP_Locate(const uint16_t *axis, const uint32_t *recip, uint32_t x, int32_t *fraction){
+
+	uint32_t i = 0;
+	uint32_t f;
+
+	if(x <= axis[0]){
+		*fraction = 0;
+		return 0;
+	}
+	if(x >= axis[MAP_SIZE - 1]){
+		*fraction = Q15_ONE;
+		return MAP_SIZE - 2;
+	}
+
+	while(x >= axis[i + 1]){
+		i++;
+	}
+
+	// (x - axis[i]) < step so the product is lower than 2^30
+	f = ((x - axis[i]) * recip[i]) >> (RECIP_SHIFT - 15);
+	*fraction = f > Q15_ONE ? Q15_ONE : f;
+
+	return i;
+}
+
+/**
+ * @brief Load the default maps.
+ */
+void MAP_Init(void){
+
+	uint32_t i;
+
+	for(i = 0; i < MAP_COUNT; i++){
+		MAP_Write(i, 0, (const uint16_t *)&s_defaults[i], sizeof(map_table_t) / sizeof(uint16_t));
+	}
+}
+
+/**
+ * @brief Evaluate a map with a bilinear interpolation.
+ * The inputs are clamped to the axes. Runs without division in a bounded time.
+ * @param map Map to evaluate (MAP_ID).
+ * @param rpm RPM.
+ * @param load Load (supply voltage [mV]).
+ * @return The interpolated value.
+ */
+int32_t MAP_Evaluate(uint32_t map, uint32_t rpm, uint32_t load){
+
+	const map_t *m = &s_maps[map];
+	const int16_t *row0, *row1;
+	int32_t fx, fy;
+	int32_t v0, v1;
+	uint32_t x, y;
+
+	x = MAP_Locate(m->table.rpm, m->rpmRecip, rpm, &fx);
+	y = MAP_Locate(m->table.load, m->loadRecip, load, &fy);
+
+	row0 = m->table.value[y];
+	row1 = m->table.value[y + 1];
+
+	// The differences fit in 17 bits and the factors in 15 bits, the products fit in 32 bits
+	v0 = row0[x] + (((row0[x + 1] - row0[x]) * fx) >> 15);
+	v1 = row1[x] + (((row1[x + 1] - row1[x]) * fx) >> 15);
+
+	return v0 + (((v1 - v0) * fy) >> 15);
+}
+
+/**
+ * @brief Write consecutive 16-bit words of a map table.
+ * The table is seen as an array of words: the RPM axis, the load axis then the cells row by row.
+ * @param map Map to write (MAP_ID).
+ * @param index First word to write.
+ * @param data Words to write.
+ * @param count Number of words.
+ * @return 'kStatus_Success', 'kStatus_OutOfRange' if the words don't fit in the table
+ * or 'kStatus_InvalidArgument' if the axes are not increasing (the map is invalid until they are).
+ */
+status_t MAP_Write(uint32_t map, uint32_t index, const uint16_t *data, uint32_t count){
+
+	map_t *m;
+	uint16_t *words;
+
+	if(map >= MAP_COUNT || index + count > sizeof(map_table_t) / sizeof(uint16_t)){
+		return kStatus_OutOfRange;
+	}
+
+	m = &s_maps[map];
+	words = (uint16_t *)&m->table + index;
+
+	while(count--){
+		*words++ = *data++;
+	}
+
+	m->valid = MAP_Prepare(m->table.rpm, m->rpmRecip) && MAP_Prepare(m->table.load, m->loadRecip);
+
+	return m->valid ? kStatus_Success : kStatus_InvalidArgument;
+}
+
+/**
+ * @brief Check that a map can be evaluated.
+ * @param map Map to check (MAP_ID).
+ * @return '1' if the axes of the map are increasing.
+ */
+uint8_t MAP_IsValid(uint32_t map){
+	return map < MAP_COUNT && s_maps[map].valid;
+}
+
+/**
+ * @brief Telemetry command writing a map.
+ * @param args Map number, first word and words to write ("1 16 1000 1200"), negative values in two's complement.
+ * Without word the map checksum is printed.
+ */
+void MAP_WriteCommand(const char *args){
+
+	uint16_t data[WRITE_WORDS];
+	const uint16_t *words;
+	uint32_t map, index, value;
+	uint32_t count = 0;
+	uint32_t sum = 0;
+	uint32_t i;
+
+	if(!TELEMETRY_ParseDec(&args, &map) || map >= MAP_COUNT){
+		return;
+	}
+
+	if(TELEMETRY_ParseDec(&args, &index)){
+		while(count < WRITE_WORDS && TELEMETRY_ParseDec(&args, &value)){
+			data[count++] = value;
+		}
+		MAP_Write(map, index, data, count);
+	}
+
+	// Checksum of the table, compared by the host with the uploaded one
+	words = (const uint16_t *)&s_maps[map].table;
+	for(i = 0; i < sizeof(map_table_t) / sizeof(uint16_t); i++){
+		sum = ((sum << 1) | (sum >> 31)) ^ words[i];
+	}
+
+	TELEMETRY_WriteString("T");
+	TELEMETRY_WriteField("map", map);
+	TELEMETRY_WriteField("valid", s_maps[map].valid);
+	TELEMETRY_WriteHexField("sum", sum);
+	TELEMETRY_WriteEnd();
+}
+
+/**
+ * @brief Telemetry command evaluating the maps.
+ * @param args RPM and load.
+ */
+void MAP_EvaluateCommand(const char *args){
+
+	uint32_t rpm, load;
+	uint32_t i;
+
+	if(!TELEMETRY_ParseDec(&args, &rpm) || !TELEMETRY_ParseDec(&args, &load)){
+		return;
+	}
+
+	TELEMETRY_WriteString("Q");
+	for(i = 0; i < MAP_COUNT; i++){
+		char name[] = {'m', '0' + i, '\0'};
+		TELEMETRY_WriteField(name, MAP_IsValid(i) ? (uint32_t)MAP_Evaluate(i, rpm, load) : 0);
+	}
+	TELEMETRY_WriteEnd();
+}
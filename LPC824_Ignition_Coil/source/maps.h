@@ -0,0 +1,89 @@
+/**
+ * @file maps.h
+ *
+ * @brief Dwell and spark advance maps with fixed-point bilinear interpolation.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * A map is a table of 16-bit cells indexed by the RPM and the load (the coil supply voltage).
+ * The defaults are stored in flash and copied in RAM where they can be replaced over the telemetry
+ * link. The reciprocals of the axis steps are computed when a map is loaded so the evaluation has
+ * no division: the interpolation factors are Q15 values obtained with one multiply and one shift,
+ * the evaluation time is bounded by the axis size.
+ */
+
+#ifndef MAPS_H_
+#define MAPS_H_
+
+#include "board.h"
+
+#define MAP_SIZE	8		///< Number of points of each axis.
+
+/**
+ * @brief Maps.
+ */
+enum MAP_ID
+{
+	MAP_DWELL = 0,		///< Coil dwell (pulse width) [us].
+	MAP_ADVANCE,		///< Spark advance before the top dead center [1/100 degree].
+	MAP_COUNT			///< Number of maps.
+};
+
+/**
+ * @brief Map table, as stored in flash and uploaded over the telemetry link.
+ */
+typedef struct
+{
+	uint16_t rpm[MAP_SIZE];					///< RPM axis, strictly increasing.
+	uint16_t load[MAP_SIZE];				///< Load axis (supply voltage [mV]), strictly increasing.
+	int16_t value[MAP_SIZE][MAP_SIZE];		///< Cells, indexed by load then RPM.
+}map_table_t;
+
+/**
+ * @brief Load the default maps.
+ */
+void MAP_Init(void);
+
+/**
+ * @brief Evaluate a map with a bilinear interpolation.
+ * The inputs are clamped to the axes. Runs without division in a bounded time.
+ * @param map Map to evaluate (MAP_ID).
+ * @param rpm RPM.
+ * @param load Load (supply voltage [mV]).
+ * @return The interpolated value.
+ */
+int32_t MAP_Evaluate(uint32_t map, uint32_t rpm, uint32_t load);
+
+/**
+ * @brief Write consecutive 16-bit words of a map table.
+ * The table is seen as an array of words: the RPM axis, the load axis then the cells row by row.
+ * @param map Map to write (MAP_ID).
+ * @param index First word to write.
+ * @param data Words to write.
+ * @param count Number of words.
+ * @return 'kStatus_Success', 'kStatus_OutOfRange' if the words don't fit in the table
+ * or 'kStatus_InvalidArgument' if the axes are not increasing (the map is invalid until they are).
+ */
+status_t MAP_Write(uint32_t map, uint32_t index, const uint16_t *data, uint32_t count);
+
+/**
+ * @brief Check that a map can be evaluated.
+ * @param map Map to check (MAP_ID).
+ * @return '1' if the axes of the map are increasing.
+ */
+uint8_t MAP_IsValid(uint32_t map);
+
+/**
+ * @brief Telemetry command writing a map.
+ * @param args Map number, first word and words to write ("1 16 1000 1200"), negative values in two's complement.
+ * Without word the map checksum is printed.
+ */
+void MAP_WriteCommand(const char *args);
+
+/**
+ * @brief Telemetry command evaluating the maps.
+ * @param args RPM and load.
+ */
+void MAP_EvaluateCommand(const char *args);
+
+#endif /* MAPS_H_ */
@@ -0,0 +1,178 @@
+/**
+ * @file overcurrent.c
+ *
+ * @brief Coil overcurrent protection with the analog comparator routed to the SCTimer.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The analog comparator compares the coil driver current sense voltage with the voltage ladder.
+ * Its output is routed to an SCTimer input by the input multiplexer: the high level is an event
+ * clearing the coil output in all the states, so the pulse is ended by the hardware a few SCTimer
+ * clocks after the threshold is crossed, and no pulse is set while the current stays above it. A
+ * second event on the rising edge counts the trips in its interrupt.\n
+ * The sense input is ACMP_I2, fixed on P0_1. On this board P0_1 is the encoder channel A and no
+ * current sense is wired, so the protection is built disabled: the comparator stays powered down
+ * and 'OCP_Start()' fails. 'OCP_ENABLE' is set on a board with the current sense on P0_1.
+ */
+
+#include "overcurrent.h"
+#include "fsl_power.h"
+#include "fsl_swm.h"
+#include "telemetry.h"
+
+#define OCP_INMUX_ACMP_O	5		///< SCTimer input multiplexer selection of the comparator output.
+#define OCP_CMP_LADDER		0		///< Comparator input selection of the voltage ladder.
+#define OCP_CMP_ACMP_I2		2		///< Comparator input selection of ACMP_I2.
+#define OCP_HYSTERESIS		2		///< Comparator hysteresis selection (10 mV).
+
+static uint8_t s_running;				///< The protection is running.
+static uint32_t s_event;				///< Comparator high level event, then its rising edge event.
+static sctimer_input_t s_input;			///< SCTimer input receiving the comparator output.
+static uint32_t s_step;					///< Voltage ladder step of the threshold.
+static volatile uint32_t s_trips;		///< Number of trips since boot.
+
+/**
+ * @brief Comparator rising edge callback. The output is already cleared by the hardware.
+ */
+static void OCP_TripCallback(void){
+	s_trips++;
+}
+
+/**
+ * @brief Power the analog comparator and route its output to an SCTimer input.
+ * Does nothing if the protection is disabled.
+ * @param input			SCTimer input receiving the comparator output.
+ * @param threshold_mV	Sense voltage above which the pulse is ended [mV].
+ */
+void OCP_Init(sctimer_input_t input, uint32_t threshold_mV){
+
+	if(!OCP_ENABLE){
+		return;
+	}
+
+	POWER_DisablePD(kPDRUNCFG_PD_ACMP);
+	CLOCK_EnableClock(kCLOCK_Acmp);
+
+	s_input = input;
+	OCP_SetThreshold(threshold_mV);
+
+	// Output used directly, the SCTimer synchronizes its inputs
+	ACOMP->CTRL = ACOMP_CTRL_COMP_VP_SEL(OCP_CMP_ACMP_I2) | ACOMP_CTRL_COMP_VM_SEL(OCP_CMP_LADDER)
+			| ACOMP_CTRL_HYS(OCP_HYSTERESIS);
+
+	INPUTMUX->SCT0_INMUX[input] = INPUTMUX_SCT0_INMUX_INP_N(OCP_INMUX_ACMP_O);
+}
+
+/**
+ * @brief Set the trip threshold, rounded to the nearest ladder step.
+ * @param threshold_mV Sense voltage above which the pulse is ended [mV].
+ * @return The applied threshold [mV].
+ */
+uint32_t OCP_SetThreshold(uint32_t threshold_mV){
+
+	uint32_t step = (threshold_mV * OCP_LADDER_STEPS + OCP_VREF_MV / 2) / OCP_VREF_MV;
+
+	// A zero threshold would trip on every pulse
+	if(step == 0){
+		step = 1;
+	}
+	else if(step > OCP_LADDER_STEPS){
+		step = OCP_LADDER_STEPS;
+	}
+
+	s_step = step;
+	if(OCP_ENABLE){
+		ACOMP->LAD = ACOMP_LAD_LADEN_MASK | ACOMP_LAD_LADSEL(step) | ACOMP_LAD_LADREF(0);
+	}
+
+	return step * OCP_VREF_MV / OCP_LADDER_STEPS;
+}
+
+/**
+ * @brief Start the protection: the comparator high level clears the coil output.
+ * Connects the sense pin to the comparator.
+ * @param base		SCTimer peripheral base address.
+ * @param output	Output of the coil pulse.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if the protection is disabled or if not enough SCTimer
+ * resources are available.
+ * @remark The counter must be halted.
+ */
+status_t OCP_Start(SCT_Type *base, sctimer_out_t output){
+
+	if(!OCP_ENABLE || s_running){
+		return kStatus_Fail;
+	}
+
+	if(SCTMGR_AllocEvents(2, &s_event) != kStatus_Success){
+		return kStatus_Fail;
+	}
+
+	CLOCK_EnableClock(kCLOCK_Swm);
+	SWM_SetFixedPinSelect(SWM0, kSWM_ACMP_INPUT2, true);
+	CLOCK_DisableClock(kCLOCK_Swm);
+
+	// The level also clears the pulses set while the comparator output stays high, an edge would only
+	// cut the first one
+	base->EVENT[s_event].CTRL = kSCTIMER_InputHighEvent | SCT_EVENT_CTRL_IOSEL(s_input);
+	base->EVENT[s_event].STATE = 0xFF;
+	SCTIMER_SetupOutputClearAction(base, output, s_event);
+
+	// The level event occurs on each clock while high, the trips are counted on the rising edge
+	base->EVENT[s_event + 1].CTRL = kSCTIMER_InputRiseEvent | SCT_EVENT_CTRL_IOSEL(s_input);
+	base->EVENT[s_event + 1].STATE = 0xFF;
+	SCTIMER_SetCallback(base, OCP_TripCallback, s_event + 1);
+	SCTIMER_EnableInterrupts(base, 1U << (s_event + 1));
+	EnableIRQ(SCT0_IRQn);
+
+	s_running = 1;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Stop the protection, release its events and the sense pin.
+ * @param base SCTimer peripheral base address.
+ */
+void OCP_Stop(SCT_Type *base){
+
+	if(!s_running){
+		return;
+	}
+
+	SCTIMER_DisableInterrupts(base, 1U << (s_event + 1));
+	SCTMGR_FreeEvents(base, s_event, 2);
+
+	CLOCK_EnableClock(kCLOCK_Swm);
+	SWM_SetFixedPinSelect(SWM0, kSWM_ACMP_INPUT2, false);
+	CLOCK_DisableClock(kCLOCK_Swm);
+
+	s_running = 0;
+}
+
+/**
+ * @brief Get the number of trips since boot.
+ * @return The trip count.
+ */
+uint32_t OCP_GetTrips(void){
+	return s_trips;
+}
+
+/**
+ * @brief Telemetry command setting the threshold and printing the trip count.
+ * @param args Threshold [mV] ("1200"), the threshold is unchanged without argument.
+ */
+void OCP_Command(const char *args){
+
+	uint32_t threshold;
+
+	if(TELEMETRY_ParseDec(&args, &threshold)){
+		OCP_SetThreshold(threshold);
+	}
+
+	TELEMETRY_WriteString("O");
+	TELEMETRY_WriteField("on", s_running);
+	TELEMETRY_WriteField("mV", s_step * OCP_VREF_MV / OCP_LADDER_STEPS);
+	TELEMETRY_WriteField("level", OCP_ENABLE && (ACOMP->CTRL & ACOMP_CTRL_COMPSTAT_MASK) != 0);
+	TELEMETRY_WriteField("trips", s_trips);
+	TELEMETRY_WriteEnd();
+}
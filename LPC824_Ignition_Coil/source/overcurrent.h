@@ -0,0 +1,76 @@
+/**
+ * @file overcurrent.h
+ *
+ * @brief Coil overcurrent protection with the analog comparator routed to the SCTimer.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The analog comparator compares the coil driver current sense voltage with the voltage ladder.
+ * Its output is routed to an SCTimer input by the input multiplexer: the high level is an event
+ * clearing the coil output in all the states, so the pulse is ended by the hardware a few SCTimer
+ * clocks after the threshold is crossed, and no pulse is set while the current stays above it. A
+ * second event on the rising edge counts the trips in its interrupt.\n
+ * The sense input is ACMP_I2, fixed on P0_1. On this board P0_1 is the encoder channel A and no
+ * current sense is wired, so the protection is built disabled: the comparator stays powered down
+ * and 'OCP_Start()' fails. 'OCP_ENABLE' is set on a board with the current sense on P0_1.
+ */
+
+#ifndef OVERCURRENT_H_
+#define OVERCURRENT_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+#include "sct_manager.h"
+
+#ifndef OCP_ENABLE
+#define OCP_ENABLE				0		///< Current sense wired to ACMP_I2 (P0_1, instead of the encoder channel A).
+#endif
+
+#define OCP_VREF_MV				3300	///< Voltage ladder reference (supply voltage) [mV].
+#define OCP_LADDER_STEPS		31		///< Number of steps of the voltage ladder.
+
+/**
+ * @brief Power the analog comparator and route its output to an SCTimer input.
+ * Does nothing if the protection is disabled.
+ * @param input			SCTimer input receiving the comparator output.
+ * @param threshold_mV	Sense voltage above which the pulse is ended [mV].
+ */
+void OCP_Init(sctimer_input_t input, uint32_t threshold_mV);
+
+/**
+ * @brief Set the trip threshold, rounded to the nearest ladder step.
+ * @param threshold_mV Sense voltage above which the pulse is ended [mV].
+ * @return The applied threshold [mV].
+ */
+uint32_t OCP_SetThreshold(uint32_t threshold_mV);
+
+/**
+ * @brief Start the protection: the comparator high level clears the coil output.
+ * Connects the sense pin to the comparator.
+ * @param base		SCTimer peripheral base address.
+ * @param output	Output of the coil pulse.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if the protection is disabled or if not enough SCTimer
+ * resources are available.
+ * @remark The counter must be halted.
+ */
+status_t OCP_Start(SCT_Type *base, sctimer_out_t output);
+
+/**
+ * @brief Stop the protection, release its events and the sense pin.
+ * @param base SCTimer peripheral base address.
+ */
+void OCP_Stop(SCT_Type *base);
+
+/**
+ * @brief Get the number of trips since boot.
+ * @return The trip count.
+ */
+uint32_t OCP_GetTrips(void);
+
+/**
+ * @brief Telemetry command setting the threshold and printing the trip count.
+ * @param args Threshold [mV] ("1200"), the threshold is unchanged without argument.
+ */
+void OCP_Command(const char *args);
+
+#endif /* OVERCURRENT_H_ */
@@ -0,0 +1,283 @@
+/**
+ * @file playback.c
+ *
+ * @brief Playback of recorded RPM traces: one (period, width) pair applied per pulse.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pairs are played from two chunks of entries already converted in SCTimer ticks. The period
+ * event interrupt only copies the next pair in the reload registers and switches chunk when the
+ * active one is consumed. The main loop refills the free chunk with 'PLAYBACK_Process()', from the
+ * trace stored in flash (played in loop) or from the stream uploaded over the telemetry link, so
+ * the conversions and the link are off the critical path.\n
+ * If the next chunk isn't ready when the active one is consumed the last pair is held and an
+ * underrun is counted. Only the single pulse mode can be played.
+ */
+
+#include "playback.h"
+#include "telemetry.h"
+
+/**
+ * @brief Pair converted in SCTimer ticks.
+ */
+typedef struct
+{
+	uint32_t period;		///< Reload value of the period match (period - 1) [tick].
+	uint32_t width;			///< Reload value of the pulse match [tick].
+}playback_entry_t;
+
+/**
+ * @brief Chunk of converted pairs.
+ */
+typedef struct
+{
+	playback_entry_t entries[PLAYBACK_CHUNK_SIZE];	///< Converted pairs.
+	volatile uint32_t count;						///< Number of pairs, '0' when the chunk can be refilled.
+}playback_chunk_t;
+
+/**
+ * @brief Trace stored in flash: idle, acceleration to the maximum RPM, hold and deceleration.
+ */
+static const playback_pair_t s_trace[] =
+{
+	{24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000},
+	{24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000}, {24000, 2000},
+	{20647, 2000}, {18116, 2000}, {16138, 2000}, {14545, 2000}, {13242, 2000}, {12153, 2000}, {11230, 2000}, {10435, 2000},
+	{9747, 2000}, {9144, 2000}, {8611, 2000}, {8136, 2000}, {7711, 2000}, {7329, 2000}, {6982, 2000}, {6667, 2000},
+	{6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000},
+	{6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000}, {6667, 2000},
+	{6982, 2000}, {7328, 2000}, {7710, 2000}, {8136, 2000}, {8610, 2000}, {9142, 2000}, {9745, 2000}, {10435, 2000},
+	{11228, 2000}, {12151, 2000}, {13239, 2000}, {14545, 2000}, {16133, 2000}, {18110, 2000}, {20640, 2000}, {24000, 2000}
+};
+
+static SCT_Type *s_base;						///< Played SCTimer.
+static uint32_t s_event;						///< Pulse period event.
+static uint32_t s_periodMatch;					///< Match register of the pulse period.
+static uint32_t s_widthMatch;					///< Match register of the pulse width.
+static uint32_t s_sctClock;						///< SCTimer counter clock [Hz].
+static uint32_t s_source;						///< Source of the pairs (PLAYBACK_SOURCE).
+
+static playback_chunk_t s_chunks[2];			///< Played and refilled chunks.
+static volatile uint32_t s_active;				///< Chunk read by the interrupt.
+static uint32_t s_index;						///< Next pair of the active chunk.
+static uint32_t s_traceIndex;					///< Next pair of the flash trace.
+
+static playback_pair_t s_stream[PLAYBACK_STREAM_SIZE];	///< Pairs uploaded over the telemetry link.
+static volatile uint32_t s_streamHead;			///< Next written pair of the stream.
+static volatile uint32_t s_streamTail;			///< Next read pair of the stream.
+
+static volatile uint32_t s_played;				///< Number of played pairs.
+static volatile uint32_t s_underruns;			///< Number of periods without a ready pair.
+
+/**
+ * @brief Period event callback. Load the pair of the next period.
+ * The reload values are loaded in the match registers at the next period event.
+ */
+static void PLAYBACK_PeriodCallback(void){
+
+	playback_chunk_t *chunk = &s_chunks[s_active];
+	const playback_entry_t *entry;
+
+	if(chunk->count == 0){
+		s_underruns++;
+		return;
+	}
+
+	entry = &chunk->entries[s_index++];
+	s_base->SCTMATCHREL[s_periodMatch] = entry->period;
+	s_base->SCTMATCHREL[s_widthMatch] = entry->width;
+	s_played++;
+
+	// Give the chunk back to the main loop
+	if(s_index >= chunk->count){
+		s_index = 0;
+		chunk->count = 0;
+		s_active ^= 1;
+	}
+}
+
+/**
+ * @brief Get the next pair of the source.
+ * @param pair Pointer where the pair is stored.
+ * @return '1' if a pair is available.
+ */
+static uint8_t PLAYBACK_NextPair(playback_pair_t *pair){
+
+	if(s_source == PLAYBACK_FLASH){
+		*pair = s_trace[s_traceIndex];
+		if(++s_traceIndex >= sizeof(s_trace) / sizeof(s_trace[0])){
+			s_traceIndex = 0;
+		}
+		return 1;
+	}
+
+	if(s_streamTail == s_streamHead){
+		return 0;
+	}
+	*pair = s_stream[s_streamTail];
+	s_streamTail = (s_streamTail + 1) & (PLAYBACK_STREAM_SIZE - 1);
+	return 1;
+}
+
+/**
+ * @brief Fill a chunk with the available pairs of the source.
+ * @param chunk Chunk to fill, its count must be '0'.
+ */
+static void PLAYBACK_Fill(playback_chunk_t *chunk){
+
+	playback_pair_t pair;
+	uint32_t count = 0;
+	uint64_t t;
+
+	while(count < PLAYBACK_CHUNK_SIZE && PLAYBACK_NextPair(&pair)){
+		t = pair.period_us;
+		t *= s_sctClock;
+		t /= 1000000U;
+		chunk->entries[count].period = t - 1;
+
+		// The pulse must end in its period
+		t = pair.width_us;
+		t *= s_sctClock;
+		t /= 1000000U;
+		chunk->entries[count].width = t < chunk->entries[count].period ? t : chunk->entries[count].period;
+		count++;
+	}
+
+	// Published last, the interrupt reads the entries once the count is set
+	chunk->count = count;
+}
+
+/**
+ * @brief Start the playback on a pulse configured with 'IPULSE_SetupPulse()'.
+ * The period event interrupt is used, the dithering must be disabled. The counter must be halted.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param event			Pulse period event number.
+ * @param source		Source of the pairs (PLAYBACK_SOURCE).
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the source is unknown.
+ */
+status_t PLAYBACK_Start(SCT_Type *base, uint32_t srcClock_Hz, uint32_t event, uint32_t source){
+
+	if(source != PLAYBACK_FLASH && source != PLAYBACK_STREAM){
+		return kStatus_InvalidArgument;
+	}
+
+	s_base = base;
+	s_event = event;
+	s_periodMatch = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	s_widthMatch = base->EVENT[event + 1].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	s_sctClock = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	s_source = source;
+
+	s_chunks[0].count = 0;
+	s_chunks[1].count = 0;
+	s_active = 0;
+	s_index = 0;
+	s_traceIndex = 0;
+	s_played = 0;
+	s_underruns = 0;
+
+	// Both chunks are ready before the first period event, the stream keeps what was uploaded
+	PLAYBACK_Fill(&s_chunks[0]);
+	PLAYBACK_Fill(&s_chunks[1]);
+
+	// The first pair is loaded in the match registers and the second one in the reload registers,
+	// the counter is halted. The first period event then starts the second pair.
+	if(s_chunks[0].count){
+		PLAYBACK_PeriodCallback();
+		base->SCTMATCH[s_periodMatch] = base->SCTMATCHREL[s_periodMatch];
+		base->SCTMATCH[s_widthMatch] = base->SCTMATCHREL[s_widthMatch];
+		if(s_chunks[s_active].count){
+			PLAYBACK_PeriodCallback();
+		}
+	}
+
+	SCTIMER_SetCallback(base, PLAYBACK_PeriodCallback, event);
+	SCTIMER_EnableInterrupts(base, 1U << event);
+	EnableIRQ(SCT0_IRQn);
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Stop the playback. The last pair is held until the pulse is reconfigured.
+ */
+void PLAYBACK_Stop(void){
+
+	if(s_source == PLAYBACK_OFF){
+		return;
+	}
+
+	SCTIMER_DisableInterrupts(s_base, 1U << s_event);
+	SCTIMER_SetCallback(s_base, NULL, s_event);
+
+	s_source = PLAYBACK_OFF;
+	s_streamHead = 0;
+	s_streamTail = 0;
+}
+
+/**
+ * @brief Refill the free chunks. Must be called from the main loop.
+ */
+void PLAYBACK_Process(void){
+
+	uint32_t active = s_active;
+
+	if(s_source == PLAYBACK_OFF){
+		return;
+	}
+
+	// The active chunk is empty only after an underrun, it is played first
+	if(s_chunks[active].count == 0){
+		PLAYBACK_Fill(&s_chunks[active]);
+	}
+	if(s_chunks[active ^ 1].count == 0){
+		PLAYBACK_Fill(&s_chunks[active ^ 1]);
+	}
+}
+
+/**
+ * @brief Check if a playback is running.
+ * @return '1' if running.
+ */
+uint8_t PLAYBACK_IsActive(void){
+	return s_source != PLAYBACK_OFF;
+}
+
+/**
+ * @brief Telemetry command queuing pairs in the stream.
+ * @param args Periods and widths [us] ("24000 2000 23500 2000"), the number of free pairs is printed.
+ */
+void PLAYBACK_DataCommand(const char *args){
+
+	uint32_t period, width;
+	uint32_t next;
+
+	while(TELEMETRY_ParseDec(&args, &period) && TELEMETRY_ParseDec(&args, &width)){
+		next = (s_streamHead + 1) & (PLAYBACK_STREAM_SIZE - 1);
+		if(next == s_streamTail || period == 0 || period > 0xFFFF || width > 0xFFFF){
+			break;
+		}
+		s_stream[s_streamHead].period_us = period;
+		s_stream[s_streamHead].width_us = width;
+		s_streamHead = next;
+	}
+
+	TELEMETRY_WriteString("D");
+	TELEMETRY_WriteField("free", (s_streamTail - s_streamHead - 1) & (PLAYBACK_STREAM_SIZE - 1));
+	TELEMETRY_WriteEnd();
+}
+
+/**
+ * @brief Telemetry command printing the playback statistics.
+ * @param args Unused.
+ */
+void PLAYBACK_PrintStats(const char *args){
+
+	TELEMETRY_WriteString("P");
+	TELEMETRY_WriteField("source", s_source);
+	TELEMETRY_WriteField("played", s_played);
+	TELEMETRY_WriteField("underruns", s_underruns);
+	TELEMETRY_WriteField("buffered", (s_streamHead - s_streamTail) & (PLAYBACK_STREAM_SIZE - 1));
+	TELEMETRY_WriteEnd();
+}
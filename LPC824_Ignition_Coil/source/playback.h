@@ -0,0 +1,84 @@
+/**
+ * @file playback.h
+ *
+ * @brief Playback of recorded RPM traces: one (period, width) pair applied per pulse.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pairs are played from two chunks of entries already converted in SCTimer ticks. The period
+ * event interrupt only copies the next pair in the reload registers and switches chunk when the
+ * active one is consumed. The main loop refills the free chunk with 'PLAYBACK_Process()', from the
+ * trace stored in flash (played in loop) or from the stream uploaded over the telemetry link, so
+ * the conversions and the link are off the critical path.\n
+ * If the next chunk isn't ready when the active one is consumed the last pair is held and an
+ * underrun is counted. Only the single pulse mode can be played.
+ */
+
+#ifndef PLAYBACK_H_
+#define PLAYBACK_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+
+#define PLAYBACK_CHUNK_SIZE		16		///< Number of pairs of a chunk.
+#define PLAYBACK_STREAM_SIZE	32		///< Number of pairs buffered from the telemetry link. Must be a power of 2.
+
+/**
+ * @brief Sources of the played pairs.
+ */
+enum PLAYBACK_SOURCE
+{
+	PLAYBACK_OFF = 0,		///< No playback.
+	PLAYBACK_FLASH,			///< Trace stored in flash, played in loop.
+	PLAYBACK_STREAM			///< Pairs uploaded with the telemetry 'D' command.
+};
+
+/**
+ * @brief Recorded pair.
+ */
+typedef struct
+{
+	uint16_t period_us;		///< Pulse period [us].
+	uint16_t width_us;		///< Pulse width [us].
+}playback_pair_t;
+
+/**
+ * @brief Start the playback on a pulse configured with 'IPULSE_SetupPulse()'.
+ * The period event interrupt is used, the dithering must be disabled. The counter must be halted.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param event			Pulse period event number.
+ * @param source		Source of the pairs (PLAYBACK_SOURCE).
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the source is unknown.
+ */
+status_t PLAYBACK_Start(SCT_Type *base, uint32_t srcClock_Hz, uint32_t event, uint32_t source);
+
+/**
+ * @brief Stop the playback. The last pair is held until the pulse is reconfigured.
+ */
+void PLAYBACK_Stop(void);
+
+/**
+ * @brief Refill the free chunks. Must be called from the main loop.
+ */
+void PLAYBACK_Process(void);
+
+/**
+ * @brief Check if a playback is running.
+ * @return '1' if running.
+ */
+uint8_t PLAYBACK_IsActive(void);
+
+/**
+ * @brief Telemetry command queuing pairs in the stream.
+ * @param args Periods and widths [us] ("24000 2000 23500 2000"), the number of free pairs is printed.
+ */
+void PLAYBACK_DataCommand(const char *args);
+
+/**
+ * @brief Telemetry command printing the playback statistics.
+ * @param args Unused.
+ */
+void PLAYBACK_PrintStats(const char *args);
+
+#endif /* PLAYBACK_H_ */
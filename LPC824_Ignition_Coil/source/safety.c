@@ -0,0 +1,137 @@
+/**
+ * @file safety.c
+ *
+ * @brief Hardware limits of the coil dwell: maximum dwell event and windowed watchdog.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * A dedicated SCTimer event clears the coil output when the counter reaches the maximum dwell,
+ * in all the states. The pulses start on a counter limit so the cutoff is independent of the pulse
+ * event and of the match values computed by the software.\n
+ * The windowed watchdog is fed by the main loop. If the loop stops servicing it, the warning
+ * interrupt halts the SCTimer and forces the outputs low, then the watchdog resets the chip.
+ */
+
+#include "safety.h"
+#include "crash.h"
+
+static uint8_t s_dwellEnabled;		///< The maximum dwell event is configured.
+static uint32_t s_dwellEvent;		///< Maximum dwell event.
+static uint32_t s_dwellMatch;		///< Match register of the maximum dwell.
+
+/**
+ * @brief Watchdog warning interrupt. The main loop stopped feeding the watchdog, the coil
+ * output is cut before the reset.
+ */
+void WDT_IRQHandler(void){
+
+	if(SYSCON->SYSAHBCLKCTRL & SYSCON_SYSAHBCLKCTRL_SCT_MASK){
+		SCT0->CTRL |= SCT_CTRL_HALT_L_MASK | SCT_CTRL_HALT_H_MASK;
+		SCT0->OUTPUT = 0;
+	}
+
+	CRASH_LogEvent(CRASH_EVT_WATCHDOG, 0);
+
+	// Acknowledge the warning, the watchdog is not fed: the chip is reset at the timeout
+	WWDT->MOD = (WWDT->MOD & ~WWDT_MOD_WDTOF_MASK) | WWDT_MOD_WDINT_MASK;
+	while(1);
+}
+
+/**
+ * @brief Start the watchdog. It can't be stopped until the next reset.
+ * @param timeout_ms Time without feed after which the chip is reset [ms].
+ */
+void SAFETY_Init(uint32_t timeout_ms){
+
+	uint32_t ticks = timeout_ms * (SAFETY_WDT_CLOCK_HZ / 1000);
+
+	if(ticks <= SAFETY_WDT_WARNING){
+		ticks = SAFETY_WDT_WARNING + 1;
+	}
+	else if(ticks > WWDT_TC_COUNT_MASK){
+		ticks = WWDT_TC_COUNT_MASK;
+	}
+
+	CLOCK_InitWdtOsc(kCLOCK_WdtAnaFreq600KHZ, 2);
+	CLOCK_EnableClock(kCLOCK_Wwdt);
+
+	WWDT->TC = WWDT_TC_COUNT(ticks);
+	WWDT->WARNINT = WWDT_WARNINT_WARNINT(SAFETY_WDT_WARNING);
+	WWDT->MOD = WWDT_MOD_WDEN_MASK | WWDT_MOD_WDRESET_MASK;
+
+	NVIC_SetPriority(WDT_IRQn, 0);
+	EnableIRQ(WDT_IRQn);
+
+	// The watchdog starts with the first feed
+	SAFETY_Feed();
+}
+
+/**
+ * @brief Feed the watchdog. Must be called at least once per timeout.
+ */
+void SAFETY_Feed(void){
+
+	// The feed sequence must not be interrupted by another watchdog register access
+	uint32_t primask = DisableGlobalIRQ();
+
+	WWDT->FEED = WWDT_FEED_FEED(0xAA);
+	WWDT->FEED = WWDT_FEED_FEED(0x55);
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Clear an output when the counter reaches the maximum dwell, in all the states.
+ * Only valid in the modes starting the pulse on a counter limit (single pulse and multi-spark).
+ * @param base			SCTimer peripheral base address.
+ * @param output		Output of the coil pulse.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param maxDwell_us	Maximum dwell [us].
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough SCTimer resources are available.
+ * @remark The counter must be halted.
+ */
+status_t SAFETY_SetMaxDwell(SCT_Type *base, sctimer_out_t output, uint32_t srcClock_Hz, uint32_t maxDwell_us){
+
+	uint32_t sctClock = srcClock_Hz / (((base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	uint64_t t;
+
+	if(s_dwellEnabled){
+		SAFETY_ReleaseMaxDwell(base);
+	}
+
+	if(SCTMGR_AllocEvents(1, &s_dwellEvent) != kStatus_Success){
+		return kStatus_Fail;
+	}
+	if(SCTMGR_AllocMatch(&s_dwellMatch) != kStatus_Success){
+		SCTMGR_FreeEvents(base, s_dwellEvent, 1);
+		return kStatus_Fail;
+	}
+
+	t = maxDwell_us;
+	t *= sctClock;
+	t /= 1000000U;
+
+	// Never reached if the period is shorter than the maximum dwell, the pulse event then ends the pulse
+	SCTMGR_SetMatchEvent(base, s_dwellEvent, s_dwellMatch, t, 0xFF);
+	SCTIMER_SetupOutputClearAction(base, output, s_dwellEvent);
+
+	s_dwellEnabled = 1;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Release the maximum dwell event.
+ * @param base SCTimer peripheral base address.
+ */
+void SAFETY_ReleaseMaxDwell(SCT_Type *base){
+
+	if(!s_dwellEnabled){
+		return;
+	}
+
+	SCTMGR_FreeMatch(base, s_dwellMatch);
+	SCTMGR_FreeEvents(base, s_dwellEvent, 1);
+
+	s_dwellEnabled = 0;
+}
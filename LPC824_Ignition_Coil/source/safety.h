@@ -0,0 +1,54 @@
+/**
+ * @file safety.h
+ *
+ * @brief Hardware limits of the coil dwell: maximum dwell event and windowed watchdog.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * A dedicated SCTimer event clears the coil output when the counter reaches the maximum dwell,
+ * in all the states. The pulses start on a counter limit so the cutoff is independent of the pulse
+ * event and of the match values computed by the software.\n
+ * The windowed watchdog is fed by the main loop. If the loop stops servicing it, the warning
+ * interrupt halts the SCTimer and forces the outputs low, then the watchdog resets the chip.
+ */
+
+#ifndef SAFETY_H_
+#define SAFETY_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+#include "sct_manager.h"
+
+#define SAFETY_WDT_CLOCK_HZ		75000		///< Watchdog counter clock: 600 kHz oscillator divided by 2, then by 4 in the watchdog [Hz].
+#define SAFETY_WDT_WARNING		1023		///< Ticks before the timeout at which the warning interrupt occurs (maximum).
+
+/**
+ * @brief Start the watchdog. It can't be stopped until the next reset.
+ * @param timeout_ms Time without feed after which the chip is reset [ms].
+ */
+void SAFETY_Init(uint32_t timeout_ms);
+
+/**
+ * @brief Feed the watchdog. Must be called at least once per timeout.
+ */
+void SAFETY_Feed(void);
+
+/**
+ * @brief Clear an output when the counter reaches the maximum dwell, in all the states.
+ * Only valid in the modes starting the pulse on a counter limit (single pulse and multi-spark).
+ * @param base			SCTimer peripheral base address.
+ * @param output		Output of the coil pulse.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param maxDwell_us	Maximum dwell [us].
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough SCTimer resources are available.
+ * @remark The counter must be halted.
+ */
+status_t SAFETY_SetMaxDwell(SCT_Type *base, sctimer_out_t output, uint32_t srcClock_Hz, uint32_t maxDwell_us);
+
+/**
+ * @brief Release the maximum dwell event.
+ * @param base SCTimer peripheral base address.
+ */
+void SAFETY_ReleaseMaxDwell(SCT_Type *base);
+
+#endif /* SAFETY_H_ */
@@ -0,0 +1,299 @@
+/**
+ * @file sct_manager.c
+ *
+ * @brief SCTimer resources manager.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The events, match/capture registers, states and outputs of the SCTimer are allocated and
+ * released at runtime, unlike the 'fsl_sctimer' functions which hand them out once per reset.
+ * A pulse mode can then be released and another one configured without resetting the SCTimer.\n
+ * The reconfiguration is done while the counter is halted by a chosen event, so the outputs are
+ * in a known state and the new configuration starts on a period boundary. The setup of each mode
+ * clears the counter, the pulses are then restarted by 'IPULSE_EnablePulse()'.
+ */
+
+#include "sct_manager.h"
+#include "SysTick.h"
+#include "telemetry.h"
+
+static SCT_Type *s_base;			///< Managed SCTimer.
+static uint32_t s_events;			///< Allocated events mask.
+static uint32_t s_matches;			///< Allocated match/capture registers mask.
+static uint32_t s_states;			///< Allocated states mask.
+static uint32_t s_outputs;			///< Allocated outputs mask.
+
+/**
+ * @brief Allocate consecutive resources in a mask.
+ * @param mask Allocated resources mask.
+ * @param size Number of resources.
+ * @param count Number of resources to allocate.
+ * @param first Pointer where the first resource number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail'.
+ */
+static status_t SCTMGR_AllocBlock(uint32_t *mask, uint32_t size, uint32_t count, uint32_t *first){
+
+	uint32_t block;
+	uint32_t i;
+
+	if(count == 0 || count > size){
+		return kStatus_Fail;
+	}
+
+	block = (1U << count) - 1;
+
+	for(i = 0; i + count <= size; i++){
+		if((*mask & (block << i)) == 0){
+			*mask |= block << i;
+			*first = i;
+			return kStatus_Success;
+		}
+	}
+	return kStatus_Fail;
+}
+
+/**
+ * @brief Release all the resources.
+ * Must be called after 'SCTIMER_Init()'.
+ * @param base SCTimer peripheral base address.
+ */
+void SCTMGR_Init(SCT_Type *base){
+
+	s_base = base;
+	s_events = 0;
+	s_matches = 0;
+	s_states = 0;
+	s_outputs = 0;
+}
+
+/**
+ * @brief Allocate consecutive events.
+ * @param count Number of events.
+ * @param first Pointer where the first event number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough consecutive events are free.
+ */
+status_t SCTMGR_AllocEvents(uint32_t count, uint32_t *first){
+	return SCTMGR_AllocBlock(&s_events, FSL_FEATURE_SCT_NUMBER_OF_EVENTS, count, first);
+}
+
+/**
+ * @brief Release consecutive events and clear all their actions.
+ * @param base SCTimer peripheral base address.
+ * @param first First event number.
+ * @param count Number of events.
+ */
+void SCTMGR_FreeEvents(SCT_Type *base, uint32_t first, uint32_t count){
+
+	uint32_t mask = ((1U << count) - 1) << first;
+	uint32_t i;
+
+	base->EVEN &= ~mask;
+	base->LIMIT &= ~mask;
+	base->HALT &= ~mask;
+	base->STOP &= ~mask;
+	base->START &= ~mask;
+	base->DMA0REQUEST &= ~mask;
+	base->DMA1REQUEST &= ~mask;
+
+	for(i = 0; i < FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS; i++){
+		base->OUT[i].SET &= ~mask;
+		base->OUT[i].CLR &= ~mask;
+	}
+
+	// Capture control registers of the registers in capture mode
+	for(i = 0; i < FSL_FEATURE_SCT_NUMBER_OF_MATCH_CAPTURE; i++){
+		if(base->REGMODE & (1U << i)){
+			base->SCTCAPCTRL[i] &= ~mask;
+		}
+	}
+
+	for(i = first; i < first + count; i++){
+		base->EVENT[i].STATE = 0;
+		base->EVENT[i].CTRL = 0;
+		SCTIMER_SetCallback(base, NULL, i);
+	}
+
+	base->EVFLAG = mask;
+	s_events &= ~mask;
+}
+
+/**
+ * @brief Allocate a match/capture register.
+ * @param match Pointer where the register number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no register is free.
+ */
+status_t SCTMGR_AllocMatch(uint32_t *match){
+	return SCTMGR_AllocBlock(&s_matches, FSL_FEATURE_SCT_NUMBER_OF_MATCH_CAPTURE, 1, match);
+}
+
+/**
+ * @brief Release a match/capture register. The register is set back to match mode.
+ * @param base SCTimer peripheral base address.
+ * @param match Register number.
+ */
+void SCTMGR_FreeMatch(SCT_Type *base, uint32_t match){
+
+	// The capture control register shares its address with the reload register
+	if(base->REGMODE & (1U << match)){
+		base->SCTCAPCTRL[match] = 0;
+	}
+	base->REGMODE &= ~(1U << match);
+	base->SCTMATCH[match] = 0;
+	base->SCTMATCHREL[match] = 0;
+
+	s_matches &= ~(1U << match);
+}
+
+/**
+ * @brief Allocate consecutive states.
+ * @param count Number of states.
+ * @param first Pointer where the first state number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough consecutive states are free.
+ */
+status_t SCTMGR_AllocStates(uint32_t count, uint32_t *first){
+	return SCTMGR_AllocBlock(&s_states, FSL_FEATURE_SCT_NUMBER_OF_STATES, count, first);
+}
+
+/**
+ * @brief Release consecutive states.
+ * @param first First state number.
+ * @param count Number of states.
+ */
+void SCTMGR_FreeStates(uint32_t first, uint32_t count){
+	s_states &= ~(((1U << count) - 1) << first);
+}
+
+/**
+ * @brief Allocate an output.
+ * @param output Output to allocate.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if the output is already used.
+ */
+status_t SCTMGR_AllocOutput(sctimer_out_t output){
+
+	if(output >= FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS || (s_outputs & (1U << output))){
+		return kStatus_Fail;
+	}
+
+	s_outputs |= 1U << output;
+	return kStatus_Success;
+}
+
+/**
+ * @brief Release an output. The output is set to its inactive (low) state.
+ * @param base SCTimer peripheral base address.
+ * @param output Output to release.
+ */
+void SCTMGR_FreeOutput(SCT_Type *base, sctimer_out_t output){
+
+	base->OUT[output].SET = 0;
+	base->OUT[output].CLR = 0;
+	base->OUTPUT &= ~(1U << output);
+
+	s_outputs &= ~(1U << output);
+}
+
+/**
+ * @brief Configure an event occurring when the counter matches a value.
+ * @param base SCTimer peripheral base address.
+ * @param event Event number.
+ * @param match Match register used by the event.
+ * @param value Match and reload value [tick].
+ * @param stateMask States in which the event is enabled.
+ */
+void SCTMGR_SetMatchEvent(SCT_Type *base, uint32_t event, uint32_t match, uint32_t value, uint32_t stateMask){
+
+	base->SCTMATCH[match] = value;
+	base->SCTMATCHREL[match] = value;
+	base->EVENT[event].CTRL = kSCTIMER_MatchEventOnly | SCT_EVENT_CTRL_MATCHSEL(match);
+	base->EVENT[event].STATE = stateMask;
+}
+
+/**
+ * @brief Halt the counter when an event occurs.
+ * Wait for the event so the reconfiguration starts on a known point of the period. The counter
+ * is halted immediately if the event doesn't occur before the timeout.
+ * @param base SCTimer peripheral base address.
+ * @param event Event halting the counter.
+ * @param timeout_ms Maximum time to wait for the event [ms].
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter was halted without the event.
+ */
+status_t SCTMGR_HaltOnEvent(SCT_Type *base, uint32_t event, uint32_t timeout_ms){
+
+	uint32_t start = SYSTICK_GetTicks();
+	status_t res = kStatus_Success;
+
+	// Already halted or stopped
+	if(base->CTRL & (SCT_CTRL_HALT_L_MASK | SCT_CTRL_STOP_L_MASK)){
+		base->CTRL |= SCT_CTRL_HALT_L_MASK;
+		return kStatus_Success;
+	}
+
+	base->HALT |= 1U << event;
+
+	while(!(base->CTRL & SCT_CTRL_HALT_L_MASK)){
+		if(SYSTICK_GetTicks() - start > timeout_ms){
+			base->CTRL |= SCT_CTRL_HALT_L_MASK;
+			res = kStatus_Timeout;
+		}
+	}
+
+	base->HALT &= ~(1U << event);
+
+	return res;
+}
+
+/**
+ * @brief Telemetry command printing the allocated resources and their registers.
+ * @param args Unused.
+ */
+void SCTMGR_Dump(const char *args){
+
+	uint32_t i;
+
+	if(s_base == NULL){
+		return;
+	}
+
+	TELEMETRY_WriteString("M");
+	TELEMETRY_WriteHexField("events", s_events);
+	TELEMETRY_WriteHexField("matches", s_matches);
+	TELEMETRY_WriteHexField("states", s_states);
+	TELEMETRY_WriteHexField("outputs", s_outputs);
+	TELEMETRY_WriteHexField("ctrl", s_base->CTRL);
+	TELEMETRY_WriteHexField("limit", s_base->LIMIT);
+	TELEMETRY_WriteHexField("even", s_base->EVEN);
+	TELEMETRY_WriteField("state", s_base->STATE);
+	TELEMETRY_WriteEnd();
+
+	for(i = 0; i < FSL_FEATURE_SCT_NUMBER_OF_EVENTS; i++){
+		if(s_events & (1U << i)){
+			TELEMETRY_WriteString("ME");
+			TELEMETRY_WriteField("n", i);
+			TELEMETRY_WriteHexField("state", s_base->EVENT[i].STATE);
+			TELEMETRY_WriteHexField("ctrl", s_base->EVENT[i].CTRL);
+			TELEMETRY_WriteEnd();
+		}
+	}
+
+	for(i = 0; i < FSL_FEATURE_SCT_NUMBER_OF_MATCH_CAPTURE; i++){
+		if(s_matches & (1U << i)){
+			TELEMETRY_WriteString("MR");
+			TELEMETRY_WriteField("n", i);
+			TELEMETRY_WriteField("cap", (s_base->REGMODE >> i) & 1U);
+			TELEMETRY_WriteField("value", s_base->SCTMATCH[i]);
+			TELEMETRY_WriteField("reload", s_base->SCTMATCHREL[i]);
+			TELEMETRY_WriteEnd();
+		}
+	}
+
+	for(i = 0; i < FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS; i++){
+		if(s_outputs & (1U << i)){
+			TELEMETRY_WriteString("MO");
+			TELEMETRY_WriteField("n", i);
+			TELEMETRY_WriteHexField("set", s_base->OUT[i].SET);
+			TELEMETRY_WriteHexField("clr", s_base->OUT[i].CLR);
+			TELEMETRY_WriteField("level", (s_base->OUTPUT >> i) & 1U);
+			TELEMETRY_WriteEnd();
+		}
+	}
+}
@@ -0,0 +1,117 @@
+/**
+ * @file sct_manager.h
+ *
+ * @brief SCTimer resources manager.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The events, match/capture registers, states and outputs of the SCTimer are allocated and
+ * released at runtime, unlike the 'fsl_sctimer' functions which hand them out once per reset.
+ * A pulse mode can then be released and another one configured without resetting the SCTimer.\n
+ * The reconfiguration is done while the counter is halted by a chosen event, so the outputs are
+ * in a known state and the new configuration starts on a period boundary. The setup of each mode
+ * clears the counter, the pulses are then restarted by 'IPULSE_EnablePulse()'.
+ */
+
+#ifndef SCT_MANAGER_H_
+#define SCT_MANAGER_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+
+#define SCTMGR_HALT_TIMEOUT_MS	50		///< Default time to wait for the halt event [ms].
+
+/**
+ * @brief Release all the resources.
+ * Must be called after 'SCTIMER_Init()'.
+ * @param base SCTimer peripheral base address.
+ */
+void SCTMGR_Init(SCT_Type *base);
+
+/**
+ * @brief Allocate consecutive events.
+ * @param count Number of events.
+ * @param first Pointer where the first event number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough consecutive events are free.
+ */
+status_t SCTMGR_AllocEvents(uint32_t count, uint32_t *first);
+
+/**
+ * @brief Release consecutive events and clear all their actions.
+ * @param base SCTimer peripheral base address.
+ * @param first First event number.
+ * @param count Number of events.
+ */
+void SCTMGR_FreeEvents(SCT_Type *base, uint32_t first, uint32_t count);
+
+/**
+ * @brief Allocate a match/capture register.
+ * @param match Pointer where the register number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no register is free.
+ */
+status_t SCTMGR_AllocMatch(uint32_t *match);
+
+/**
+ * @brief Release a match/capture register. The register is set back to match mode.
+ * @param base SCTimer peripheral base address.
+ * @param match Register number.
+ */
+void SCTMGR_FreeMatch(SCT_Type *base, uint32_t match);
+
+/**
+ * @brief Allocate consecutive states.
+ * @param count Number of states.
+ * @param first Pointer where the first state number is stored.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough consecutive states are free.
+ */
+status_t SCTMGR_AllocStates(uint32_t count, uint32_t *first);
+
+/**
+ * @brief Release consecutive states.
+ * @param first First state number.
+ * @param count Number of states.
+ */
+void SCTMGR_FreeStates(uint32_t first, uint32_t count);
+
+/**
+ * @brief Allocate an output.
+ * @param output Output to allocate.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if the output is already used.
+ */
+status_t SCTMGR_AllocOutput(sctimer_out_t output);
+
+/**
+ * @brief Release an output. The output is set to its inactive (low) state.
+ * @param base SCTimer peripheral base address.
+ * @param output Output to release.
+ */
+void SCTMGR_FreeOutput(SCT_Type *base, sctimer_out_t output);
+
+/**
+ * @brief Configure an event occurring when the counter matches a value.
+ * @param base SCTimer peripheral base address.
+ * @param event Event number.
+ * @param match Match register used by the event.
+ * @param value Match and reload value [tick].
+ * @param stateMask States in which the event is enabled.
+ */
+void SCTMGR_SetMatchEvent(SCT_Type *base, uint32_t event, uint32_t match, uint32_t value, uint32_t stateMask);
+
+/**
+ * @brief Halt the counter when an event occurs.
+ * Wait for the event so the reconfiguration starts on a known point of the period. The counter
+ * is halted immediately if the event doesn't occur before the timeout.
+ * @param base SCTimer peripheral base address.
+ * @param event Event halting the counter.
+ * @param timeout_ms Maximum time to wait for the event [ms].
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter was halted without the event.
+ */
+status_t SCTMGR_HaltOnEvent(SCT_Type *base, uint32_t event, uint32_t timeout_ms);
+
+/**
+ * @brief Telemetry command printing the allocated resources and their registers.
+ * @param args Unused.
+ */
+void SCTMGR_Dump(const char *args);
+
+#endif /* SCT_MANAGER_H_ */
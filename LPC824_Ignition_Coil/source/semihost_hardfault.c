@@ -87,8 +87,13 @@ void HardFault_Handler(void){
             "LDR    R3,=0xBEAB \n"
             "CMP     R2,R3 \n"
             "BEQ    _semihost_return \n"
-        // Wasn't semihosting instruction so enter infinite loop
-            "B . \n"
+        // Wasn't semihosting instruction so capture the crash snapshot
+        // CRASH_HardFault(frame = R0, excReturn = LR, callee = R4-R7), never returns
+            "MOV    R1, LR \n"
+            "PUSH   {R4-R7} \n"
+            "MOV    R2, SP \n"
+            "LDR    R3,=CRASH_HardFault \n"
+            "BX     R3 \n"
         // Was semihosting instruction, so adjust location to
         // return to by 1 instruction (2 bytes), then exit function
         "_semihost_return: \n"
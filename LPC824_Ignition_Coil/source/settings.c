@@ -0,0 +1,321 @@
+/**
+ * @file settings.c
+ *
+ * @brief Settings persisted in the last flash sectors.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The settings are stored as a log of records, one record per flash page, written through the
+ * ROM IAP functions. The newest valid record (highest sequence number with a correct CRC) is the
+ * current one. When a sector is full the current settings are written at the beginning of the
+ * other sector after erasing it, so each page is written once per sector erase.\n
+ * Writes are deferred: 'SETTINGS_Set()' only updates the RAM copy and the record is programmed
+ * by 'SETTINGS_Process()' once the settings have not changed for 'SETTINGS_WRITE_DELAY_MS'.
+ * The flash can't be read while it is programmed so the interrupts are disabled during each IAP
+ * call: about 1 ms for a page write and 100 ms for a sector erase. The SCTimer interrupts of the
+ * pulse modes would be delayed as long, so nothing is written while the pulses are enabled: the
+ * settings changed while pulsing are written once the pulses are disabled.\n
+ * The ROM IAP uses the top 32 bytes of the RAM and up to 148 bytes of the caller stack (UM10800,
+ * Flash ISP and IAP programming chapter), the project sets a stack offset of 32 bytes so the stack
+ * starts below them.
+ */
+
+#include <string.h>
+
+#include "settings.h"
+#include "SysTick.h"
+#include "telemetry.h"
+
+#define PAGE_SIZE		FSL_FEATURE_SYSCON_FLASH_PAGE_SIZE_BYTES		///< Flash page size [byte].
+#define SECTOR_SIZE		FSL_FEATURE_SYSCON_FLASH_SECTOR_SIZE_BYTES		///< Flash sector size [byte].
+
+#define STORE_START		(SETTINGS_FIRST_SECTOR * SECTOR_SIZE)						///< Address of the settings store.
+#define STORE_END		((SETTINGS_FIRST_SECTOR + SETTINGS_SECTOR_COUNT) * SECTOR_SIZE)	///< End address of the settings store.
+
+#define RECORD_MAGIC	0x53455454U		///< Magic of a record ("SETT").
+#define ERASED_WORD		0xFFFFFFFFU		///< Value of an erased flash word.
+
+#define IAP_PREPARE_SECTOR		50		///< IAP command: prepare sectors for write operation.
+#define IAP_COPY_RAM_TO_FLASH	51		///< IAP command: copy RAM to flash.
+#define IAP_ERASE_SECTOR		52		///< IAP command: erase sectors.
+#define IAP_BLANK_CHECK			53		///< IAP command: blank check sectors.
+#define IAP_CMD_SUCCESS			0		///< IAP status: command executed successfully.
+
+/**
+ * @brief ROM IAP entry point.
+ */
+typedef void (*iap_entry_t)(uint32_t *command, uint32_t *result);
+
+/**
+ * @brief Record stored in one flash page.
+ */
+typedef struct
+{
+	uint32_t magic;			///< 'RECORD_MAGIC'.
+	uint32_t sequence;		///< Sequence number, incremented at each write.
+	settings_t settings;	///< Stored settings.
+	uint16_t length;		///< Size of the stored settings [byte].
+	uint16_t crc;			///< CRC16 of the record up to this field.
+	uint8_t reserved[PAGE_SIZE - 3 * sizeof(uint32_t) - sizeof(settings_t)];	///< Pad the record to a page.
+}settings_record_t;
+
+static settings_t s_settings;			///< Current settings.
+static uint32_t s_sequence;				///< Sequence number of the last written record.
+static uint32_t s_nextAddress;			///< Address of the next page to write.
+static uint32_t s_sector;				///< Sector currently written.
+static uint8_t s_dirty;					///< The settings have to be written.
+static uint8_t s_held;					///< The write is held by the pulses.
+static uint32_t s_changeTick;			///< Tick of the last settings update [ms].
+static uint32_t s_writeCount;			///< Number of records written since boot.
+static uint32_t s_errorCount;			///< Number of failed flash operations since boot.
+static settings_record_t s_record;		///< Word aligned RAM copy of the record to program.
+
+/**
+ * @brief Compute the CRC16 (CCITT) of a record.
+ * @param record Record to check.
+ * @return The CRC.
+ */
+static uint16_t SETTINGS_Crc(const settings_record_t *record){
+
+	const uint8_t *data = (const uint8_t *)record;
+	uint32_t length = (const uint8_t *)&record->crc - data;
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while(length--){
+		crc ^= (uint16_t)(*data++) << 8;
+		for(bit = 0; bit < 8; bit++){
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Check that a flash page holds a valid record.
+ * @param record Record to check.
+ * @return '1' if the record is valid.
+ */
+static uint8_t SETTINGS_IsValid(const settings_record_t *record){
+
+	return record->magic == RECORD_MAGIC && record->length == sizeof(settings_t) &&
+			record->crc == SETTINGS_Crc(record);
+}
+
+/**
+ * @brief Check that a flash page is erased.
+ * @param address Page address.
+ * @return '1' if the page is blank.
+ */
+static uint8_t SETTINGS_IsBlank(uint32_t address){
+
+	const uint32_t *word = (const uint32_t *)address;
+	uint32_t i;
+
+	for(i = 0; i < PAGE_SIZE / sizeof(uint32_t); i++){
+		if(word[i] != ERASED_WORD){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Call an IAP command with the interrupts disabled.
+ * @param command Command and parameters.
+ * @return The IAP status code.
+ */
+static uint32_t SETTINGS_Iap(uint32_t *command){
+
+	uint32_t result[4];
+	uint32_t primask = DisableGlobalIRQ();
+
+	((iap_entry_t)FSL_FEATURE_SYSCON_IAP_ENTRY_LOCATION)(command, result);
+
+	EnableGlobalIRQ(primask);
+
+	return result[0];
+}
+
+/**
+ * @brief Prepare a sector for a write or erase operation.
+ * @param sector Sector number.
+ * @return The IAP status code.
+ */
+static uint32_t SETTINGS_Prepare(uint32_t sector){
+
+	uint32_t command[5] = {IAP_PREPARE_SECTOR, sector, sector, 0, 0};
+
+	return SETTINGS_Iap(command);
+}
+
+/**
+ * @brief Find the newest valid record in flash.
+ * @param settings Pointer where the stored settings are copied.
+ * @return '1' if valid settings have been found, '0' otherwise ('settings' is unchanged).
+ */
+uint8_t SETTINGS_Init(settings_t *settings){
+
+	const settings_record_t *record;
+	const settings_record_t *newest = NULL;
+	uint32_t address;
+	uint32_t sectorEnd;
+
+	// Only the magic is checked on each page, the CRC is computed for the candidates
+	for(address = STORE_START; address < STORE_END; address += PAGE_SIZE){
+		record = (const settings_record_t *)address;
+		if(record->magic == RECORD_MAGIC && (newest == NULL || record->sequence > newest->sequence) &&
+				SETTINGS_IsValid(record)){
+			newest = record;
+		}
+	}
+
+	s_dirty = 0;
+
+	if(newest == NULL){
+		s_sequence = 0;
+		s_sector = SETTINGS_FIRST_SECTOR;
+		s_nextAddress = STORE_START;
+	}
+	else{
+		s_settings = newest->settings;
+		s_sequence = newest->sequence;
+		s_sector = (uint32_t)newest / SECTOR_SIZE;
+		s_nextAddress = (uint32_t)newest + PAGE_SIZE;
+	}
+
+	// Skip the pages written by an interrupted programming
+	sectorEnd = (s_sector + 1) * SECTOR_SIZE;
+	while(s_nextAddress < sectorEnd && !SETTINGS_IsBlank(s_nextAddress)){
+		s_nextAddress += PAGE_SIZE;
+	}
+
+	if(newest == NULL){
+		return 0;
+	}
+
+	*settings = s_settings;
+	return 1;
+}
+
+/**
+ * @brief Update the settings to persist.
+ * The record is written later by 'SETTINGS_Process()', successive updates are coalesced.
+ * @param settings Settings to persist.
+ */
+void SETTINGS_Set(const settings_t *settings){
+
+	s_changeTick = SYSTICK_GetTicks();
+
+	if(memcmp(settings, &s_settings, sizeof(settings_t)) == 0){
+		return;
+	}
+
+	s_settings = *settings;
+	s_dirty = 1;
+}
+
+/**
+ * @brief Write the pending settings once they are stable.
+ * Must be called from the main loop. Each call performs at most one flash operation.
+ * @param pulsesEnabled '1' while the pulses are enabled, the write is then held until they are disabled.
+ */
+void SETTINGS_Process(uint8_t pulsesEnabled){
+
+	uint32_t command[5];
+
+	if(!s_dirty || SYSTICK_GetTicks() - s_changeTick < SETTINGS_WRITE_DELAY_MS){
+		return;
+	}
+
+	// The interrupts are disabled during the flash operations
+	s_held = pulsesEnabled;
+	if(s_held){
+		return;
+	}
+
+	// Sector full: continue in the next sector of the store, erased first if needed
+	if(s_nextAddress >= (s_sector + 1) * SECTOR_SIZE){
+
+		uint32_t sector = s_sector + 1;
+
+		if(sector >= SETTINGS_FIRST_SECTOR + SETTINGS_SECTOR_COUNT){
+			sector = SETTINGS_FIRST_SECTOR;
+		}
+
+		command[0] = IAP_BLANK_CHECK;
+		command[1] = sector;
+		command[2] = sector;
+		if(SETTINGS_Iap(command) != IAP_CMD_SUCCESS){
+
+			// The sector holds older records, they are replaced by the record written next
+			if(SETTINGS_Prepare(sector) == IAP_CMD_SUCCESS){
+				command[0] = IAP_ERASE_SECTOR;
+				command[1] = sector;
+				command[2] = sector;
+				command[3] = CLOCK_GetFreq(kCLOCK_CoreSysClk) / 1000U;
+				SETTINGS_Iap(command);
+			}
+			else{
+				s_errorCount++;
+			}
+			// The blank check is done again on the next call
+			return;
+		}
+
+		s_sector = sector;
+		s_nextAddress = sector * SECTOR_SIZE;
+	}
+
+	// A page written by an interrupted programming can't be written again
+	if(!SETTINGS_IsBlank(s_nextAddress)){
+		s_nextAddress += PAGE_SIZE;
+		return;
+	}
+
+	memset(&s_record, 0xFF, sizeof(s_record));
+	s_record.magic = RECORD_MAGIC;
+	s_record.sequence = s_sequence + 1;
+	s_record.settings = s_settings;
+	s_record.length = sizeof(settings_t);
+	s_record.crc = SETTINGS_Crc(&s_record);
+
+	if(SETTINGS_Prepare(s_sector) == IAP_CMD_SUCCESS){
+		command[0] = IAP_COPY_RAM_TO_FLASH;
+		command[1] = s_nextAddress;
+		command[2] = (uint32_t)&s_record;
+		command[3] = PAGE_SIZE;
+		command[4] = CLOCK_GetFreq(kCLOCK_CoreSysClk) / 1000U;
+		SETTINGS_Iap(command);
+	}
+
+	// The page is used even if the write failed, the next call writes the following page
+	s_nextAddress += PAGE_SIZE;
+
+	if(memcmp((const void *)(s_nextAddress - PAGE_SIZE), &s_record, PAGE_SIZE) == 0){
+		s_sequence = s_record.sequence;
+		s_dirty = 0;
+		s_writeCount++;
+	}
+	else{
+		s_errorCount++;
+	}
+}
+
+/**
+ * @brief Telemetry command printing the settings store status.
+ * @param args Unused.
+ */
+void SETTINGS_PrintStatus(const char *args){
+
+	TELEMETRY_WriteString("S");
+	TELEMETRY_WriteField("rpm", s_settings.rpm);
+	TELEMETRY_WriteField("width", s_settings.pulseWidth_us);
+	TELEMETRY_WriteField("seq", s_sequence);
+	TELEMETRY_WriteHexField("next", s_nextAddress);
+	TELEMETRY_WriteField("dirty", s_dirty);
+	TELEMETRY_WriteField("held", s_dirty && s_held);
+	TELEMETRY_WriteField("writes", s_writeCount);
+	TELEMETRY_WriteField("errors", s_errorCount);
+	TELEMETRY_WriteEnd();
+}
@@ -0,0 +1,69 @@
+/**
+ * @file settings.h
+ *
+ * @brief Settings persisted in the last flash sectors.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The settings are stored as a log of records, one record per flash page, written through the
+ * ROM IAP functions. The newest valid record (highest sequence number with a correct CRC) is the
+ * current one. When a sector is full the current settings are written at the beginning of the
+ * other sector after erasing it, so each page is written once per sector erase.\n
+ * Writes are deferred: 'SETTINGS_Set()' only updates the RAM copy and the record is programmed
+ * by 'SETTINGS_Process()' once the settings have not changed for 'SETTINGS_WRITE_DELAY_MS'.
+ * The flash can't be read while it is programmed so the interrupts are disabled during each IAP
+ * call: about 1 ms for a page write and 100 ms for a sector erase. The SCTimer interrupts of the
+ * pulse modes would be delayed as long, so nothing is written while the pulses are enabled: the
+ * settings changed while pulsing are written once the pulses are disabled.\n
+ * The ROM IAP uses the top 32 bytes of the RAM and up to 148 bytes of the caller stack (UM10800,
+ * Flash ISP and IAP programming chapter), the project sets a stack offset of 32 bytes so the stack
+ * starts below them.
+ */
+
+#ifndef SETTINGS_H_
+#define SETTINGS_H_
+
+#include "board.h"
+
+#define SETTINGS_FIRST_SECTOR		30			///< First flash sector used by the settings store.
+#define SETTINGS_SECTOR_COUNT		2			///< Number of flash sectors used by the settings store.
+#define SETTINGS_WRITE_DELAY_MS		2000		///< Time without change before the settings are written [ms].
+
+/**
+ * @brief Persisted settings.
+ */
+typedef struct
+{
+	uint32_t rpm;				///< Command RPM.
+	uint32_t pulseWidth_us;		///< Pulse width [us].
+	uint32_t flags;				///< Reserved for future use.
+}settings_t;
+
+/**
+ * @brief Find the newest valid record in flash.
+ * @param settings Pointer where the stored settings are copied.
+ * @return '1' if valid settings have been found, '0' otherwise ('settings' is unchanged).
+ */
+uint8_t SETTINGS_Init(settings_t *settings);
+
+/**
+ * @brief Update the settings to persist.
+ * The record is written later by 'SETTINGS_Process()', successive updates are coalesced.
+ * @param settings Settings to persist.
+ */
+void SETTINGS_Set(const settings_t *settings);
+
+/**
+ * @brief Write the pending settings once they are stable.
+ * Must be called from the main loop. Each call performs at most one flash operation.
+ * @param pulsesEnabled '1' while the pulses are enabled, the write is then held until they are disabled.
+ */
+void SETTINGS_Process(uint8_t pulsesEnabled);
+
+/**
+ * @brief Telemetry command printing the settings store status.
+ * @param args Unused.
+ */
+void SETTINGS_PrintStatus(const char *args);
+
+#endif /* SETTINGS_H_ */
@@ -0,0 +1,88 @@
+/**
+ * @file stack.c
+ *
+ * @brief Stack painting and high-water mark.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The free RAM between the end of the heap and the stack pointer is filled with a pattern at
+ * boot. The stack grows down over it: the lowest overwritten word gives the deepest stack use
+ * since the boot, interrupts included. The report is printed on the telemetry link.\n
+ * The worst case given by the call graph is computed on the host by 'tools/stack_report.py'.
+ */
+
+#include "stack.h"
+#include "telemetry.h"
+
+// Symbols of the managed linker script
+extern uint32_t _pvHeapLimit[];		///< End of the heap, the stack can grow down to it.
+extern uint32_t _vStackBase[];		///< Bottom of the stack size reserved in the project settings.
+extern uint32_t _vStackTop[];		///< Top of the stack, 32 bytes below the end of the RAM (used by the IAP).
+
+static uint32_t *s_mark;		///< Lowest used word found by the last scan.
+static uint8_t s_painted;		///< The stack has been painted.
+
+/**
+ * @brief Fill the free stack with the pattern.
+ * Must be called first in 'main()', before any interrupt is enabled.
+ */
+void STACK_Paint(void){
+
+	uint32_t *word = _pvHeapLimit;
+	uint32_t *sp = (uint32_t *)__get_MSP();
+
+	// Only the words below the stack pointer are free, the frames of the callers are above
+	while(word < sp){
+		*word++ = STACK_PAINT_PATTERN;
+	}
+
+	s_mark = sp;
+	s_painted = 1;
+}
+
+/**
+ * @brief Size of the stack, from the end of the heap to the top of the stack.
+ * @return The size [byte].
+ */
+uint32_t STACK_GetSize(void){
+	return (uint32_t)_vStackTop - (uint32_t)_pvHeapLimit;
+}
+
+/**
+ * @brief Deepest stack use since the boot.
+ * The painted area is scanned from its bottom, the time spent is proportional to the free stack.
+ * @return The used size [byte], or '0' if the stack has not been painted.
+ */
+uint32_t STACK_GetHighWater(void){
+
+	uint32_t *word = _pvHeapLimit;
+
+	if(!s_painted){
+		return 0;
+	}
+
+	// The mark only moves down, the words above it are already known to be used
+	while(word < s_mark && *word == STACK_PAINT_PATTERN){
+		word++;
+	}
+	s_mark = word;
+
+	return (uint32_t)_vStackTop - (uint32_t)s_mark;
+}
+
+/**
+ * @brief Telemetry command printing the stack size and its high-water mark.
+ * @param args Unused.
+ */
+void STACK_PrintReport(const char *args){
+
+	uint32_t used = STACK_GetHighWater();
+
+	TELEMETRY_WriteString("H");
+	TELEMETRY_WriteField("painted", s_painted);
+	TELEMETRY_WriteField("size", STACK_GetSize());
+	TELEMETRY_WriteField("reserved", (uint32_t)_vStackTop - (uint32_t)_vStackBase);
+	TELEMETRY_WriteField("used", used);
+	TELEMETRY_WriteField("free", STACK_GetSize() - used);
+	TELEMETRY_WriteEnd();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file stack.h
+ *
+ * @brief Stack painting and high-water mark.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The free RAM between the end of the heap and the stack pointer is filled with a pattern at
+ * boot. The stack grows down over it: the lowest overwritten word gives the deepest stack use
+ * since the boot, interrupts included. The report is printed on the telemetry link.\n
+ * The worst case given by the call graph is computed on the host by 'tools/stack_report.py'.
+ */
+
+#ifndef STACK_H_
+#define STACK_H_
+
+#include "board.h"
+
+#define STACK_PAINT_PATTERN		0xA5A5A5A5U		///< Value of the unused stack words.
+
+/**
+ * @brief Fill the free stack with the pattern.
+ * Must be called first in 'main()', before any interrupt is enabled.
+ */
+void STACK_Paint(void);
+
+/**
+ * @brief Size of the stack, from the end of the heap to the top of the stack.
+ * @return The size [byte].
+ */
+uint32_t STACK_GetSize(void);
+
+/**
+ * @brief Deepest stack use since the boot.
+ * The painted area is scanned from its bottom, the time spent is proportional to the free stack.
+ * @return The used size [byte], or '0' if the stack has not been painted.
+ */
+uint32_t STACK_GetHighWater(void);
+
+/**
+ * @brief Telemetry command printing the stack size and its high-water mark.
+ * @param args Unused.
+ */
+void STACK_PrintReport(const char *args);
+
+#endif /* STACK_H_ */
@@ -0,0 +1,299 @@
+/**
+ * @file telemetry.c
+ *
+ * @brief Line based telemetry link over the USART.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The link never blocks the caller: transmitted bytes are queued in a ring buffer drained by
+ * the USART interrupt (bytes are dropped when the buffer is full) and received lines are
+ * dispatched from the main loop by 'TELEMETRY_Process()'.\n
+ * A request is one line starting with a command character, the rest of the line is passed
+ * as argument to the registered handler.\n
+ * All the pins of the 20 pins package are used by the board, the USART takes the pins of the
+ * LEDs (P3[12] and P3[13]): the LEDs are not driven while the link is enabled. Building with
+ * 'TELEMETRY_ENABLE' set to '0' leaves the pins to the LEDs, the commands are then unreachable.
+ */
+
+#include "telemetry.h"
+#include "fsl_usart.h"
+#include "fsl_swm.h"
+#include "fsl_gpio.h"
+#include "isr_stats.h"
+
+#define TX_MASK (TELEMETRY_TX_BUFFER_SIZE - 1)	///< Mask used to wrap the transmit ring buffer indexes.
+
+static uint8_t s_txBuffer[TELEMETRY_TX_BUFFER_SIZE];	///< Transmit ring buffer.
+static volatile uint32_t s_txHead;		///< Next index to write in the transmit buffer.
+static volatile uint32_t s_txTail;		///< Next index to send from the transmit buffer.
+
+static char s_rxLine[TELEMETRY_RX_LINE_SIZE];	///< Line being received.
+static volatile uint8_t s_rxLength;			///< Number of chars in the received line.
+static volatile uint8_t s_rxReady;			///< A complete line is waiting to be dispatched.
+
+static char s_commands[TELEMETRY_COMMAND_COUNT];					///< Registered command chars.
+static telemetry_command_t s_handlers[TELEMETRY_COMMAND_COUNT];	///< Registered command handlers.
+static uint8_t s_commandCount;										///< Number of registered commands.
+
+/**
+ * @brief Initialize the USART used by the telemetry link.
+ * @param srcClock_Hz System clock [Hz], the USART clock is set to the same frequency.
+ * @return 'kStatus_Success' on success.
+ */
+status_t TELEMETRY_Init(uint32_t srcClock_Hz){
+
+	usart_config_t config;
+
+	if(!TELEMETRY_ENABLE){
+		return kStatus_Success;
+	}
+
+	// Route the USART on its pins, the receiver pin must not be driven by the LED output
+	GPIO->DIRCLR[0] = 1U << TELEMETRY_RXD_PIN;
+	CLOCK_EnableClock(kCLOCK_Swm);
+	SWM_SetMovablePinSelect(SWM0, kSWM_USART0_TXD, TELEMETRY_TXD_PIN);
+	SWM_SetMovablePinSelect(SWM0, kSWM_USART0_RXD, TELEMETRY_RXD_PIN);
+	CLOCK_DisableClock(kCLOCK_Swm);
+
+	// The USART clock is the main clock divided by UARTCLKDIV, use the system clock divider
+	CLOCK_SetClkDivider(kCLOCK_DivUsartClk, SYSCON->SYSAHBCLKDIV & SYSCON_SYSAHBCLKDIV_DIV_MASK);
+
+	USART_GetDefaultConfig(&config);
+	config.baudRate_Bps = TELEMETRY_BAUDRATE;
+	config.enableTx = true;
+	config.enableRx = true;
+
+	if(USART_Init(TELEMETRY_USART, &config, srcClock_Hz) != kStatus_Success){
+		return kStatus_Fail;
+	}
+
+	s_txHead = 0;
+	s_txTail = 0;
+	s_rxLength = 0;
+	s_rxReady = 0;
+
+	// Only the reception interrupt is enabled, transmission is enabled when data are queued
+	USART_EnableInterrupts(TELEMETRY_USART, kUSART_RxReadyInterruptEnable);
+	EnableIRQ(TELEMETRY_USART_IRQ);
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Register a command handler.
+ * @param cmd Command character.
+ * @param handler Function called when a line starting with 'cmd' is received.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no more command can be registered.
+ */
+status_t TELEMETRY_RegisterCommand(char cmd, telemetry_command_t handler){
+
+	if(s_commandCount >= TELEMETRY_COMMAND_COUNT){
+		return kStatus_Fail;
+	}
+
+	s_commands[s_commandCount] = cmd;
+	s_handlers[s_commandCount] = handler;
+	s_commandCount++;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Dispatch the last received line to its command handler.
+ * Must be called from the main loop.
+ */
+void TELEMETRY_Process(void){
+
+	uint8_t i;
+
+	if(!s_rxReady){
+		return;
+	}
+
+	for(i = 0; i < s_commandCount; i++){
+		if(s_commands[i] == s_rxLine[0]){
+			s_handlers[i](&s_rxLine[1]);
+			break;
+		}
+	}
+
+	if(i == s_commandCount){
+		TELEMETRY_WriteString("? ");
+		TELEMETRY_WriteString(s_rxLine);
+		TELEMETRY_WriteEnd();
+	}
+
+	// Release the line for the next reception
+	s_rxLength = 0;
+	s_rxReady = 0;
+}
+
+/**
+ * @brief Queue one byte to send.
+ * @param data Byte to send.
+ */
+static void TELEMETRY_WriteByte(uint8_t data){
+
+	uint32_t head = s_txHead;
+
+	// Drop the byte rather than blocking the caller, the USART is not clocked without the link
+	if(!TELEMETRY_ENABLE || ((head + 1) & TX_MASK) == s_txTail){
+		return;
+	}
+
+	s_txBuffer[head] = data;
+	s_txHead = (head + 1) & TX_MASK;
+
+	USART_EnableInterrupts(TELEMETRY_USART, kUSART_TxReadyInterruptEnable);
+}
+
+/**
+ * @brief Queue a string to send.
+ * @param string String to send.
+ */
+void TELEMETRY_WriteString(const char *string){
+
+	while(*string){
+		TELEMETRY_WriteByte(*string++);
+	}
+}
+
+/**
+ * @brief Queue an unsigned decimal value to send.
+ * @param value Value to send.
+ */
+void TELEMETRY_WriteDec(uint32_t value){
+
+	char digits[10];
+	int i = 0;
+
+	do{
+		digits[i++] = '0' + (value % 10);
+		value /= 10;
+	}while(value);
+
+	while(i){
+		TELEMETRY_WriteByte(digits[--i]);
+	}
+}
+
+/**
+ * @brief Queue an hexadecimal value to send (8 digits with '0x' prefix).
+ * @param value Value to send.
+ */
+void TELEMETRY_WriteHex(uint32_t value){
+
+	int shift;
+	uint8_t nibble;
+
+	TELEMETRY_WriteString("0x");
+	for(shift = 28; shift >= 0; shift -= 4){
+		nibble = (value >> shift) & 0xF;
+		TELEMETRY_WriteByte(nibble < 10 ? '0' + nibble : 'A' + nibble - 10);
+	}
+}
+
+/**
+ * @brief Queue a " name=value" decimal field to send.
+ * @param name Field name.
+ * @param value Field value.
+ */
+void TELEMETRY_WriteField(const char *name, uint32_t value){
+
+	TELEMETRY_WriteByte(' ');
+	TELEMETRY_WriteString(name);
+	TELEMETRY_WriteByte('=');
+	TELEMETRY_WriteDec(value);
+}
+
+/**
+ * @brief Queue a " name=0x........" hexadecimal field to send.
+ * @param name Field name.
+ * @param value Field value.
+ */
+void TELEMETRY_WriteHexField(const char *name, uint32_t value){
+
+	TELEMETRY_WriteByte(' ');
+	TELEMETRY_WriteString(name);
+	TELEMETRY_WriteByte('=');
+	TELEMETRY_WriteHex(value);
+}
+
+/**
+ * @brief Queue the end of line.
+ */
+void TELEMETRY_WriteEnd(void){
+	TELEMETRY_WriteString("\r\n");
+}
+
+/**
+ * @brief Parse an unsigned decimal value in a command argument.
+ * @param args Pointer to the argument string. Updated to the first char after the value.
+ * @param value Pointer where the value is stored.
+ * @return '1' if a value has been read, '0' otherwise.
+ */
+uint8_t TELEMETRY_ParseDec(const char **args, uint32_t *value){
+
+	const char *c = *args;
+	uint32_t result = 0;
+
+	// Skip separators
+	while(*c == ' ' || *c == ','){
+		c++;
+	}
+
+	if(*c < '0' || *c > '9'){
+		*args = c;
+		return 0;
+	}
+
+	while(*c >= '0' && *c <= '9'){
+		result = result * 10 + (*c++ - '0');
+	}
+
+	*args = c;
+	*value = result;
+	return 1;
+}
+
+/**
+ * @brief USART interrupt handler.
+ *
+ * Store the received chars until the end of line and send the queued bytes.
+ */
+void USART0_IRQHandler(void){
+
+	uint32_t status = USART_GetStatusFlags(TELEMETRY_USART);
+	uint8_t data;
+
+	ISRSTATS_ENTER(ISRSTATS_USART, ISRSTATS_NO_LATENCY);
+
+	if(status & kUSART_RxReady){
+		data = USART_ReadByte(TELEMETRY_USART);
+
+		// Chars received while a line is pending are dropped
+		if(!s_rxReady){
+			if(data == '\r' || data == '\n'){
+				if(s_rxLength){
+					s_rxLine[s_rxLength] = '\0';
+					s_rxReady = 1;
+				}
+			}
+			else if(s_rxLength < TELEMETRY_RX_LINE_SIZE - 1){
+				s_rxLine[s_rxLength++] = data;
+			}
+		}
+	}
+
+	if((status & kUSART_TxReady) && (USART_GetEnabledInterrupts(TELEMETRY_USART) & kUSART_TxReadyInterruptEnable)){
+		if(s_txTail != s_txHead){
+			USART_WriteByte(TELEMETRY_USART, s_txBuffer[s_txTail]);
+			s_txTail = (s_txTail + 1) & TX_MASK;
+		}
+		else{
+			USART_DisableInterrupts(TELEMETRY_USART, kUSART_TxReadyInterruptEnable);
+		}
+	}
+
+	ISRSTATS_EXIT(ISRSTATS_USART);
+}
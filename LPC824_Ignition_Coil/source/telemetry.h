@@ -0,0 +1,111 @@
+/**
+ * @file telemetry.h
+ *
+ * @brief Line based telemetry link over the USART.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The link never blocks the caller: transmitted bytes are queued in a ring buffer drained by
+ * the USART interrupt (bytes are dropped when the buffer is full) and received lines are
+ * dispatched from the main loop by 'TELEMETRY_Process()'.\n
+ * A request is one line starting with a command character, the rest of the line is passed
+ * as argument to the registered handler.\n
+ * All the pins of the 20 pins package are used by the board, the USART takes the pins of the
+ * LEDs (P3[12] and P3[13]): the LEDs are not driven while the link is enabled. Building with
+ * 'TELEMETRY_ENABLE' set to '0' leaves the pins to the LEDs, the commands are then unreachable.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "board.h"
+
+#define TELEMETRY_USART			USART0				///< USART used by the telemetry link.
+#define TELEMETRY_USART_CLK		kCLOCK_Uart0		///< Clock of the USART used by the telemetry link.
+#define TELEMETRY_USART_IRQ		USART0_IRQn			///< Interrupt of the USART used by the telemetry link.
+#define TELEMETRY_BAUDRATE		115200				///< Telemetry link baud rate [bps].
+
+#ifndef TELEMETRY_ENABLE
+#define TELEMETRY_ENABLE		1					///< Route the USART to its pins. Defined to '0' in the Release build.
+#endif
+
+#define TELEMETRY_TXD_PIN		kSWM_PortPin_P0_9	///< Pin used for the USART TXD (red LED, P3[12]).
+#define TELEMETRY_RXD_PIN		kSWM_PortPin_P0_8	///< Pin used for the USART RXD (green LED, P3[13]).
+
+#define TELEMETRY_TX_BUFFER_SIZE	256		///< Transmit ring buffer size [byte]. Must be a power of 2.
+#define TELEMETRY_RX_LINE_SIZE		48		///< Maximum length of a received line [char].
+#define TELEMETRY_COMMAND_COUNT		24		///< Maximum number of registered commands.
+
+/**
+ * @brief Handler of a telemetry command.
+ * @param args Rest of the received line after the command character (null terminated).
+ */
+typedef void (*telemetry_command_t)(const char *args);
+
+/**
+ * @brief Initialize the USART used by the telemetry link.
+ * @param srcClock_Hz System clock [Hz], the USART clock is set to the same frequency.
+ * @return 'kStatus_Success' on success.
+ */
+status_t TELEMETRY_Init(uint32_t srcClock_Hz);
+
+/**
+ * @brief Register a command handler.
+ * @param cmd Command character.
+ * @param handler Function called when a line starting with 'cmd' is received.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no more command can be registered.
+ */
+status_t TELEMETRY_RegisterCommand(char cmd, telemetry_command_t handler);
+
+/**
+ * @brief Dispatch the last received line to its command handler.
+ * Must be called from the main loop.
+ */
+void TELEMETRY_Process(void);
+
+/**
+ * @brief Queue a string to send.
+ * @param string String to send.
+ */
+void TELEMETRY_WriteString(const char *string);
+
+/**
+ * @brief Queue an unsigned decimal value to send.
+ * @param value Value to send.
+ */
+void TELEMETRY_WriteDec(uint32_t value);
+
+/**
+ * @brief Queue an hexadecimal value to send (8 digits with '0x' prefix).
+ * @param value Value to send.
+ */
+void TELEMETRY_WriteHex(uint32_t value);
+
+/**
+ * @brief Queue a " name=value" decimal field to send.
+ * @param name Field name.
+ * @param value Field value.
+ */
+void TELEMETRY_WriteField(const char *name, uint32_t value);
+
+/**
+ * @brief Queue a " name=0x........" hexadecimal field to send.
+ * @param name Field name.
+ * @param value Field value.
+ */
+void TELEMETRY_WriteHexField(const char *name, uint32_t value);
+
+/**
+ * @brief Queue the end of line.
+ */
+void TELEMETRY_WriteEnd(void);
+
+/**
+ * @brief Parse an unsigned decimal value in a command argument.
+ * @param args Pointer to the argument string. Updated to the first char after the value.
+ * @param value Pointer where the value is stored.
+ * @return '1' if a value has been read, '0' otherwise.
+ */
+uint8_t TELEMETRY_ParseDec(const char **args, uint32_t *value);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,167 @@
+/**
+ * @file timing.c
+ *
+ * @brief Clock and SCTimer prescaler planner.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Choose the fastest system clock (12MHz IRC, 24MHz or 30MHz from the system PLL) and the
+ * smallest SCTimer prescaler such that the longest pulse period still fits in the 32-bit
+ * counter and the tick period meets the required resolution.\n
+ * The SCTimer counts on the system clock so a faster system clock gives a finer pulse width
+ * granularity: 33.3ns at 30MHz instead of 83.3ns with the IRC.
+ */
+
+#include "timing.h"
+#include "fsl_power.h"
+#include "telemetry.h"
+
+/**
+ * @brief Clock candidate.
+ */
+typedef struct
+{
+	uint32_t pllFreq_Hz;	///< System PLL output frequency [Hz], '0' to run from the IRC.
+	uint32_t sysDiv;		///< System clock divider.
+}timing_clock_t;
+
+/**
+ * @brief Clock candidates, fastest first.
+ * The PLL output is an integer multiple of the 12MHz IRC so 30MHz is 60MHz divided by 2.
+ */
+static const timing_clock_t s_clocks[] = {
+		{60000000U, 2},
+		{24000000U, 1},
+		{0, 1}
+};
+
+static timing_plan_t s_plan;	///< Applied plan.
+
+/**
+ * @brief Store a clock candidate and its SCTimer prescaler in a plan.
+ * @param clock			Clock candidate.
+ * @param core			System clock of the candidate [Hz].
+ * @param prescaler		SCTimer prescaler value.
+ * @param ticks			Ticks of the longest pulse period at the system clock.
+ * @param plan			Pointer where the configuration is stored.
+ */
+static void TIMING_Fill(const timing_clock_t *clock, uint32_t core, uint32_t prescaler, uint64_t ticks, timing_plan_t *plan){
+
+	plan->pllFreq_Hz = clock->pllFreq_Hz;
+	plan->sysDiv = clock->sysDiv;
+	plan->coreClock_Hz = core;
+	plan->sctPrescaler = prescaler;
+	plan->sctClock_Hz = core / (prescaler + 1);
+	plan->tickPeriod_ps = 1000000000000ULL / plan->sctClock_Hz;
+	plan->maxPeriodTicks = ticks / (prescaler + 1);
+}
+
+/**
+ * @brief Find the clock configuration with the finest SCTimer resolution.
+ * @param minFreq_mHz	Lowest pulse frequency to generate [mHz].
+ * @param resolution_ns	Required SCTimer tick period [ns].
+ * @param plan			Pointer where the chosen configuration is stored. If no configuration meets the
+ * 						resolution, the IRC configuration is stored: it can still be applied.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no configuration meets the resolution.
+ */
+status_t TIMING_Plan(uint32_t minFreq_mHz, uint32_t resolution_ns, timing_plan_t *plan){
+
+	const timing_clock_t *irc = &s_clocks[sizeof(s_clocks) / sizeof(s_clocks[0]) - 1];
+	uint32_t i;
+	uint32_t core;
+	uint64_t ticks;
+	uint32_t prescaler;
+
+	assert(minFreq_mHz);
+
+	for(i = 0; i < sizeof(s_clocks) / sizeof(s_clocks[0]); i++){
+
+		core = (s_clocks[i].pllFreq_Hz ? s_clocks[i].pllFreq_Hz : CLOCK_GetIrcFreq()) / s_clocks[i].sysDiv;
+		if(core > TIMING_MAX_CORE_CLOCK_HZ){
+			continue;
+		}
+
+		// Smallest prescaler keeping the longest period in the 32-bit counter
+		ticks = (uint64_t)core * 1000U / minFreq_mHz;
+		prescaler = ticks >> 32;
+		if(prescaler > 0xFF){
+			continue;
+		}
+
+		// Tick period check: (prescaler + 1) / core <= resolution
+		if((uint64_t)(prescaler + 1) * 1000000000U > (uint64_t)resolution_ns * core){
+			continue;
+		}
+
+		TIMING_Fill(&s_clocks[i], core, prescaler, ticks, plan);
+		return kStatus_Success;
+	}
+
+	// Fallback on the IRC, the longest period is limited by the largest prescaler
+	core = CLOCK_GetIrcFreq() / irc->sysDiv;
+	ticks = (uint64_t)core * 1000U / minFreq_mHz;
+	prescaler = ticks >> 32;
+	if(prescaler > 0xFF){
+		prescaler = 0xFF;
+		ticks = (uint64_t)0xFFFFFFFFU * (prescaler + 1);
+	}
+	TIMING_Fill(irc, core, prescaler, ticks, plan);
+
+	return kStatus_Fail;
+}
+
+/**
+ * @brief Apply the clock configuration of a plan.
+ * The flash access time is set before the clock is raised. 'SystemCoreClock' is updated.
+ * The SCTimer prescaler is applied by the caller when the SCTimer is initialized.
+ * @param plan Plan to apply.
+ */
+void TIMING_Apply(const timing_plan_t *plan){
+
+	clock_sys_pll_t config;
+
+	POWER_DisablePD(kPDRUNCFG_PD_IRC_OUT);		// Ensure IRC OUT is on
+	POWER_DisablePD(kPDRUNCFG_PD_IRC);			// Ensure IRC is on
+
+	// Run from the IRC while the PLL is configured, 2 clocks flash access time is safe for any clock
+	CLOCK_SetMainClkSrc(kCLOCK_MainClkSrcIrc);
+	FLASH_CTRL->FLASHCFG = (FLASH_CTRL->FLASHCFG & ~FLASH_CTRL_FLASHCFG_FLASHTIM_MASK) | FLASH_CTRL_FLASHCFG_FLASHTIM(1);
+
+	if(plan->pllFreq_Hz){
+		CLOCK_Select(kSYSPLL_From_Irc);
+		config.src = kCLOCK_SysPllSrcIrc;
+		config.targetFreq = plan->pllFreq_Hz;
+		CLOCK_InitSystemPll(&config);
+
+		// The divider is set before the PLL is selected so the system clock never exceeds its maximum
+		CLOCK_SetCoreSysClkDiv(plan->sysDiv);
+		CLOCK_SetMainClkSrc(kCLOCK_MainClkSrcSysPll);
+	}
+	else{
+		CLOCK_SetCoreSysClkDiv(plan->sysDiv);
+	}
+
+	if(plan->coreClock_Hz <= TIMING_FLASH_1WS_CLOCK_HZ){
+		FLASH_CTRL->FLASHCFG = (FLASH_CTRL->FLASHCFG & ~FLASH_CTRL_FLASHCFG_FLASHTIM_MASK) | FLASH_CTRL_FLASHCFG_FLASHTIM(0);
+	}
+
+	SystemCoreClock = plan->coreClock_Hz;
+	s_plan = *plan;
+}
+
+/**
+ * @brief Telemetry command printing the applied plan.
+ * @param args Unused.
+ */
+void TIMING_PrintPlan(const char *args){
+
+	TELEMETRY_WriteString("C");
+	TELEMETRY_WriteField("pll", s_plan.pllFreq_Hz);
+	TELEMETRY_WriteField("div", s_plan.sysDiv);
+	TELEMETRY_WriteField("core", s_plan.coreClock_Hz);
+	TELEMETRY_WriteField("pre", s_plan.sctPrescaler);
+	TELEMETRY_WriteField("sct", s_plan.sctClock_Hz);
+	TELEMETRY_WriteField("tick_ps", s_plan.tickPeriod_ps);
+	TELEMETRY_WriteField("maxTicks", s_plan.maxPeriodTicks);
+	TELEMETRY_WriteEnd();
+}
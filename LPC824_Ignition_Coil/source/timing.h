@@ -0,0 +1,61 @@
+/**
+ * @file timing.h
+ *
+ * @brief Clock and SCTimer prescaler planner.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Choose the fastest system clock (12MHz IRC, 24MHz or 30MHz from the system PLL) and the
+ * smallest SCTimer prescaler such that the longest pulse period still fits in the 32-bit
+ * counter and the tick period meets the required resolution.\n
+ * The SCTimer counts on the system clock so a faster system clock gives a finer pulse width
+ * granularity: 33.3ns at 30MHz instead of 83.3ns with the IRC.
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include "board.h"
+
+#define TIMING_MAX_CORE_CLOCK_HZ	30000000U	///< Maximum system clock of the LPC82x [Hz].
+#define TIMING_FLASH_1WS_CLOCK_HZ	20000000U	///< System clock above which the flash needs 2 clocks access time [Hz].
+
+/**
+ * @brief Clock configuration chosen by the planner.
+ */
+typedef struct
+{
+	uint32_t pllFreq_Hz;		///< System PLL output frequency [Hz], '0' to run from the IRC.
+	uint32_t sysDiv;			///< System clock divider (SYSAHBCLKDIV).
+	uint32_t coreClock_Hz;		///< System clock, also the SCTimer input clock [Hz].
+	uint8_t sctPrescaler;		///< SCTimer prescaler value (PRE_L), the counter clock is divided by 'sctPrescaler + 1'.
+	uint32_t sctClock_Hz;		///< SCTimer counter clock [Hz].
+	uint32_t tickPeriod_ps;		///< SCTimer counter tick period [ps].
+	uint32_t maxPeriodTicks;	///< Ticks of the longest pulse period.
+}timing_plan_t;
+
+/**
+ * @brief Find the clock configuration with the finest SCTimer resolution.
+ * @param minFreq_mHz	Lowest pulse frequency to generate [mHz].
+ * @param resolution_ns	Required SCTimer tick period [ns].
+ * @param plan			Pointer where the chosen configuration is stored. If no configuration meets the
+ * 						resolution, the IRC configuration is stored: it can still be applied.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if no configuration meets the resolution.
+ */
+status_t TIMING_Plan(uint32_t minFreq_mHz, uint32_t resolution_ns, timing_plan_t *plan);
+
+/**
+ * @brief Apply the clock configuration of a plan.
+ * The flash access time is set before the clock is raised. 'SystemCoreClock' is updated.
+ * The SCTimer prescaler is applied by the caller when the SCTimer is initialized.
+ * @param plan Plan to apply.
+ */
+void TIMING_Apply(const timing_plan_t *plan);
+
+/**
+ * @brief Telemetry command printing the applied plan.
+ * @param args Unused.
+ */
+void TIMING_PrintPlan(const char *args);
+
+#endif /* TIMING_H_ */
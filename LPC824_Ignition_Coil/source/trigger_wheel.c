@@ -0,0 +1,378 @@
+/**
+ * @file trigger_wheel.c
+ *
+ * @brief Crank trigger wheel generator synchronized with the coil pulse.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The SCTimer counter period is one tooth: the tooth period event limits the counter and sets the
+ * wheel output, a match at half the tooth clears it. The missing teeth are made by lengthening the
+ * period of the last tooth before the gap.\n
+ * A compact interrupt on the tooth period event loads the reload values of the next tooth. The coil
+ * pulse is phase-locked to the wheel: it starts on the limit of the spark tooth and ends on a match
+ * in the tooth where the pulse width elapses, so both edges are placed by the SCTimer.\n
+ * The generator is unreachable on this board: all the pins of the package are used, so
+ * 'WHEEL_OUTPUT_PIN' defaults to 'SWM_PIN_NONE' in 'LPC824_Ignition_Coil.c' and the 'W' command is
+ * refused. A board using it must define 'WHEEL_OUTPUT_PIN' to a free 'kSWM_PortPin_P0_x' pin, which
+ * 'SetupPulses()' routes to the SCT_OUT1 movable function (wheel signal on 'kSCTIMER_Out_1').\n
+ * The frequency and width updates are taken by the interrupt when it prepares the spark tooth, so a
+ * revolution is always generated with one configuration and a running pulse is always ended.
+ */
+
+#include "trigger_wheel.h"
+
+#define NO_MATCH	0xFFFFFFFFU		///< Match value never reached in a tooth.
+
+static SCT_Type *s_base;				///< SCTimer of the generator.
+static uint8_t s_active;				///< The generator is configured.
+static uint32_t s_event;				///< Tooth period event, the coil pulse event and the tooth clear event follow.
+static uint32_t s_state;				///< State of the events.
+static sctimer_out_t s_coilOutput;		///< Coil pulse output.
+static sctimer_out_t s_wheelOutput;		///< Wheel signal output.
+static uint32_t s_periodMatch;			///< Match register of the tooth period.
+static uint32_t s_coilMatch;			///< Match register of the coil pulse end.
+static uint32_t s_toothMatch;			///< Match register of the tooth end.
+
+static uint32_t s_count;				///< Number of teeth present on the wheel.
+static uint32_t s_missing;				///< Number of missing teeth.
+static uint32_t s_sparkTooth;			///< Tooth on which the coil pulse starts.
+static volatile uint32_t s_tooth;		///< Running tooth.
+
+static uint32_t s_width;				///< Last requested coil pulse width [tick].
+static uint32_t s_toothPeriod;			///< Tooth period [tick].
+static uint32_t s_endTooth;				///< Tooth in which the coil pulse ends.
+static uint32_t s_endOffset;			///< Coil pulse end in its last tooth [tick].
+
+static volatile uint8_t s_pending;		///< A new configuration has to be taken at the next revolution.
+static uint32_t s_nextToothPeriod;		///< Pending tooth period [tick].
+static uint32_t s_nextEndTooth;			///< Pending tooth in which the coil pulse ends.
+static uint32_t s_nextEndOffset;		///< Pending coil pulse end in its last tooth [tick].
+
+/**
+ * @brief Period of a tooth, the last tooth before the gap includes the missing teeth.
+ * @param tooth Tooth number.
+ * @param toothPeriod Period of a regular tooth [tick].
+ * @return The tooth period [tick].
+ */
+static uint32_t TWHEEL_ToothPeriod(uint32_t tooth, uint32_t toothPeriod){
+	return tooth == s_count - 1 ? (s_missing + 1) * toothPeriod : toothPeriod;
+}
+
+/**
+ * @brief Find the tooth in which the coil pulse ends.
+ * @param toothPeriod Period of a regular tooth [tick].
+ * @param width Coil pulse width [tick].
+ * @param endTooth Pointer where the last tooth of the pulse is stored.
+ * @param endOffset Pointer where the pulse end in the last tooth is stored [tick].
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse doesn't end before the next one.
+ */
+static status_t TWHEEL_PlanPulse(uint32_t toothPeriod, uint32_t width, uint32_t *endTooth, uint32_t *endOffset){
+
+	uint32_t tooth = s_sparkTooth;
+
+	if(width == 0){
+		return kStatus_InvalidArgument;
+	}
+
+	while(width >= TWHEEL_ToothPeriod(tooth, toothPeriod)){
+		width -= TWHEEL_ToothPeriod(tooth, toothPeriod);
+		tooth = tooth + 1 == s_count ? 0 : tooth + 1;
+		if(tooth == s_sparkTooth){
+			return kStatus_InvalidArgument;
+		}
+	}
+
+	*endTooth = tooth;
+	*endOffset = width;
+	return kStatus_Success;
+}
+
+/**
+ * @brief Compute the period of a regular tooth.
+ * @param srcClock_Hz SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz Wheel revolution frequency [mHz].
+ * @return The tooth period of the full wheel, missing teeth included [tick].
+ */
+static uint32_t TWHEEL_ToothTicks(uint32_t srcClock_Hz, uint32_t freq_mHz){
+
+	uint32_t sctClock = srcClock_Hz / (((s_base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	uint64_t t = sctClock;
+
+	t *= 1000;
+	t /= (uint64_t)freq_mHz * (s_count + s_missing);
+	return t;
+}
+
+/**
+ * @brief Convert a pulse width to ticks.
+ * @param srcClock_Hz SCTimer counter clock in Hertz [Hz].
+ * @param pulseWidth_us Pulse width [us].
+ * @return The pulse width [tick].
+ */
+static uint32_t TWHEEL_WidthTicks(uint32_t srcClock_Hz, uint32_t pulseWidth_us){
+
+	uint32_t sctClock = srcClock_Hz / (((s_base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+	uint64_t t = pulseWidth_us;
+
+	t *= sctClock;
+	t /= 1000000U;
+	return t;
+}
+
+/**
+ * @brief Tooth period event callback.
+ * Load the reload values and the coil set action of the next tooth.
+ */
+static void TWHEEL_ToothCallback(void){
+
+	uint32_t tooth = s_tooth + 1 == s_count ? 0 : s_tooth + 1;
+	uint32_t next = tooth + 1 == s_count ? 0 : tooth + 1;
+
+	s_tooth = tooth;
+
+	// A new configuration starts with the coil pulse
+	if(next == s_sparkTooth && s_pending){
+		s_toothPeriod = s_nextToothPeriod;
+		s_endTooth = s_nextEndTooth;
+		s_endOffset = s_nextEndOffset;
+		s_base->SCTMATCHREL[s_toothMatch] = s_toothPeriod / 2;
+		s_pending = 0;
+	}
+
+	s_base->SCTMATCHREL[s_periodMatch] = TWHEEL_ToothPeriod(next, s_toothPeriod) - 1;
+	s_base->SCTMATCHREL[s_coilMatch] = next == s_endTooth ? s_endOffset : NO_MATCH;
+	s_base->OUT[s_coilOutput].SET = next == s_sparkTooth ? 1U << s_event : 0;
+}
+
+/**
+ * @brief Initialize the trigger wheel generator and the synchronized coil pulse.
+ *
+ * @param base			SCTimer peripheral base address.
+ * @param teeth			Number of teeth of the wheel, including the missing ones (60 for a 60-2 wheel).
+ * @param missing		Number of missing teeth (2 for a 60-2 wheel).
+ * @param sparkTooth	Tooth on which the coil pulse starts, '0' is the first tooth after the gap.
+ * @param pulseWidth_us	Coil pulse width [us].
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Wheel revolution frequency in milli-Hertz [mHz].
+ * @param coilOutput	Output of the coil pulse.
+ * @param wheelOutput	Output of the wheel signal.
+ * @param event			Pointer to a variable where the tooth period event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the wheel or the pulse width is incorrect.
+ * @remark The counter must be halted, it is cleared.
+ */
+status_t TWHEEL_Setup(SCT_Type *base, uint32_t teeth, uint32_t missing, uint32_t sparkTooth, uint32_t pulseWidth_us,
+		uint32_t srcClock_Hz, uint32_t freq_mHz, sctimer_out_t coilOutput, sctimer_out_t wheelOutput, uint32_t *event){
+
+	assert(srcClock_Hz);
+	assert(freq_mHz);
+
+	uint32_t first = 0, state = 0;
+	uint32_t matches[3];
+	uint32_t i = 0;
+	uint8_t allocated = 0;
+
+	if(s_active || missing >= teeth || sparkTooth >= teeth - missing){
+		return kStatus_InvalidArgument;
+	}
+
+	s_base = base;
+	s_count = teeth - missing;
+	s_missing = missing;
+	s_sparkTooth = sparkTooth;
+
+	s_toothPeriod = TWHEEL_ToothTicks(srcClock_Hz, freq_mHz);
+	s_width = TWHEEL_WidthTicks(srcClock_Hz, pulseWidth_us);
+
+	if(s_toothPeriod < 2 || TWHEEL_PlanPulse(s_toothPeriod, s_width, &s_endTooth, &s_endOffset) != kStatus_Success){
+		return kStatus_InvalidArgument;
+	}
+
+	// Three events with one match register each, one state and both outputs
+	if(SCTMGR_AllocEvents(3, &first) != kStatus_Success){
+		return kStatus_Fail;
+	}
+	while(i < 3 && SCTMGR_AllocMatch(&matches[i]) == kStatus_Success){
+		i++;
+	}
+	if(i == 3 && SCTMGR_AllocStates(1, &state) == kStatus_Success){
+		if(SCTMGR_AllocOutput(coilOutput) == kStatus_Success){
+			if(SCTMGR_AllocOutput(wheelOutput) == kStatus_Success){
+				allocated = 1;
+			}
+			else{
+				SCTMGR_FreeOutput(base, coilOutput);
+			}
+		}
+		if(!allocated){
+			SCTMGR_FreeStates(state, 1);
+		}
+	}
+	if(!allocated){
+		while(i){
+			SCTMGR_FreeMatch(base, matches[--i]);
+		}
+		SCTMGR_FreeEvents(base, first, 3);
+		return kStatus_Fail;
+	}
+
+	// Set unify bit to operate in 32-bit counter mode
+	base->CONFIG |= SCT_CONFIG_UNIFY_MASK;
+
+	s_event = first;
+	s_state = state;
+	s_coilOutput = coilOutput;
+	s_wheelOutput = wheelOutput;
+	s_periodMatch = matches[0];
+	s_coilMatch = matches[1];
+	s_toothMatch = matches[2];
+	s_tooth = 0;
+	s_pending = 0;
+
+	// Tooth period event: starts the next tooth
+	SCTMGR_SetMatchEvent(base, first, s_periodMatch, TWHEEL_ToothPeriod(0, s_toothPeriod) - 1, 1U << state);
+	SCTIMER_SetupCounterLimitAction(base, kSCTIMER_Counter_L, first);
+	SCTIMER_SetupOutputSetAction(base, wheelOutput, first);
+
+	// Coil pulse event: only reached in the last tooth of the pulse
+	SCTMGR_SetMatchEvent(base, first + 1, s_coilMatch, s_endTooth == 0 ? s_endOffset : NO_MATCH, 1U << state);
+	SCTIMER_SetupOutputClearAction(base, coilOutput, first + 1);
+
+	// Tooth clear event: half of a regular tooth
+	SCTMGR_SetMatchEvent(base, first + 2, s_toothMatch, s_toothPeriod / 2, 1U << state);
+	SCTIMER_SetupOutputClearAction(base, wheelOutput, first + 2);
+
+	// Reload values of the second tooth, the first one starts with the counter
+	base->SCTMATCHREL[s_periodMatch] = TWHEEL_ToothPeriod(1 % s_count, s_toothPeriod) - 1;
+	base->SCTMATCHREL[s_coilMatch] = s_endTooth == 1 % s_count ? s_endOffset : NO_MATCH;
+	base->OUT[coilOutput].SET = sparkTooth == 1 % s_count ? 1U << first : 0;
+
+	base->OUTPUT = (base->OUTPUT & ~(1U << coilOutput)) | (1U << wheelOutput);
+
+	SCTIMER_SetCallback(base, TWHEEL_ToothCallback, first);
+	SCTIMER_EnableInterrupts(base, 1U << first);
+	EnableIRQ(SCT0_IRQn);
+
+	base->STATE = state;
+	base->CTRL |= SCT_CTRL_CLRCTR_L_MASK;
+
+	s_active = 1;
+	*event = first;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Release the resources used by the trigger wheel generator.
+ * The counter is halted at the end of a coil pulse.
+ * @param base			SCTimer peripheral base address.
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter had to be halted during a pulse.
+ */
+status_t TWHEEL_Release(SCT_Type *base, uint32_t event){
+
+	status_t res;
+
+	if(!s_active || event != s_event){
+		return kStatus_InvalidArgument;
+	}
+
+	res = SCTMGR_HaltOnEvent(base, event + 1, SCTMGR_HALT_TIMEOUT_MS);
+
+	SCTIMER_DisableInterrupts(base, 1U << event);
+
+	SCTMGR_FreeMatch(base, s_periodMatch);
+	SCTMGR_FreeMatch(base, s_coilMatch);
+	SCTMGR_FreeMatch(base, s_toothMatch);
+	SCTMGR_FreeStates(s_state, 1);
+	SCTMGR_FreeEvents(base, event, 3);
+	SCTMGR_FreeOutput(base, s_coilOutput);
+	SCTMGR_FreeOutput(base, s_wheelOutput);
+
+	s_active = 0;
+
+	return res;
+}
+
+/**
+ * @brief Store a configuration taken at the next revolution.
+ * @param toothPeriod Tooth period [tick].
+ * @param endTooth Last tooth of the pulse.
+ * @param endOffset Pulse end in the last tooth [tick].
+ */
+static void TWHEEL_SetPending(uint32_t toothPeriod, uint32_t endTooth, uint32_t endOffset){
+
+	uint32_t primask = DisableGlobalIRQ();
+
+	s_nextToothPeriod = toothPeriod;
+	s_nextEndTooth = endTooth;
+	s_nextEndOffset = endOffset;
+	s_pending = 1;
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Update the wheel revolution frequency, applied from the next revolution.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Wheel revolution frequency in milli-Hertz [mHz].
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse doesn't fit in a revolution.
+ */
+status_t TWHEEL_UpdateFrequency(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event){
+
+	uint32_t toothPeriod, endTooth, endOffset;
+
+	if(!s_active || event != s_event || freq_mHz == 0){
+		return kStatus_InvalidArgument;
+	}
+
+	toothPeriod = TWHEEL_ToothTicks(srcClock_Hz, freq_mHz);
+
+	if(toothPeriod < 2 || TWHEEL_PlanPulse(toothPeriod, s_width, &endTooth, &endOffset) != kStatus_Success){
+		return kStatus_InvalidArgument;
+	}
+
+	TWHEEL_SetPending(toothPeriod, endTooth, endOffset);
+	return kStatus_Success;
+}
+
+/**
+ * @brief Update the coil pulse width, applied from the next revolution.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param pulseWidth_us	Coil pulse width [us].
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse doesn't fit in a revolution.
+ */
+status_t TWHEEL_UpdatePulseWidth(SCT_Type *base, uint32_t srcClock_Hz, uint32_t pulseWidth_us, uint32_t event){
+
+	uint32_t toothPeriod = s_pending ? s_nextToothPeriod : s_toothPeriod;
+	uint32_t endTooth, endOffset, width;
+
+	if(!s_active || event != s_event){
+		return kStatus_InvalidArgument;
+	}
+
+	width = TWHEEL_WidthTicks(srcClock_Hz, pulseWidth_us);
+
+	if(TWHEEL_PlanPulse(toothPeriod, width, &endTooth, &endOffset) != kStatus_Success){
+		return kStatus_InvalidArgument;
+	}
+
+	s_width = width;
+
+	TWHEEL_SetPending(toothPeriod, endTooth, endOffset);
+	return kStatus_Success;
+}
+
+/**
+ * @brief Check if the trigger wheel generator is configured.
+ * @return '1' if configured.
+ */
+uint8_t TWHEEL_IsActive(void){
+	return s_active;
+}
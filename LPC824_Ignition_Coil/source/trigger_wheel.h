@@ -0,0 +1,84 @@
+/**
+ * @file trigger_wheel.h
+ *
+ * @brief Crank trigger wheel generator synchronized with the coil pulse.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The SCTimer counter period is one tooth: the tooth period event limits the counter and sets the
+ * wheel output, a match at half the tooth clears it. The missing teeth are made by lengthening the
+ * period of the last tooth before the gap.\n
+ * A compact interrupt on the tooth period event loads the reload values of the next tooth. The coil
+ * pulse is phase-locked to the wheel: it starts on the limit of the spark tooth and ends on a match
+ * in the tooth where the pulse width elapses, so both edges are placed by the SCTimer.\n
+ * The generator is unreachable on this board: all the pins of the package are used, so
+ * 'WHEEL_OUTPUT_PIN' defaults to 'SWM_PIN_NONE' in 'LPC824_Ignition_Coil.c' and the 'W' command is
+ * refused. A board using it must define 'WHEEL_OUTPUT_PIN' to a free 'kSWM_PortPin_P0_x' pin, which
+ * 'SetupPulses()' routes to the SCT_OUT1 movable function (wheel signal on 'kSCTIMER_Out_1').
+ */
+
+#ifndef TRIGGER_WHEEL_H_
+#define TRIGGER_WHEEL_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+#include "sct_manager.h"
+
+/**
+ * @brief Initialize the trigger wheel generator and the synchronized coil pulse.
+ *
+ * @param base			SCTimer peripheral base address.
+ * @param teeth			Number of teeth of the wheel, including the missing ones (60 for a 60-2 wheel).
+ * @param missing		Number of missing teeth (2 for a 60-2 wheel).
+ * @param sparkTooth	Tooth on which the coil pulse starts, '0' is the first tooth after the gap.
+ * @param pulseWidth_us	Coil pulse width [us].
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Wheel revolution frequency in milli-Hertz [mHz].
+ * @param coilOutput	Output of the coil pulse.
+ * @param wheelOutput	Output of the wheel signal.
+ * @param event			Pointer to a variable where the tooth period event number is stored.
+ *
+ * @return	'kStatus_Success' on success.
+ * @return	'kStatus_Fail' If not enough SCTimer resources are available.
+ * @return	'kStatus_InvalidArgument' If the wheel or the pulse width is incorrect.
+ * @remark The counter must be halted, it is cleared.
+ */
+status_t TWHEEL_Setup(SCT_Type *base, uint32_t teeth, uint32_t missing, uint32_t sparkTooth, uint32_t pulseWidth_us,
+		uint32_t srcClock_Hz, uint32_t freq_mHz, sctimer_out_t coilOutput, sctimer_out_t wheelOutput, uint32_t *event);
+
+/**
+ * @brief Release the resources used by the trigger wheel generator.
+ * The counter is halted at the end of a coil pulse.
+ * @param base			SCTimer peripheral base address.
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_Timeout' if the counter had to be halted during a pulse.
+ */
+status_t TWHEEL_Release(SCT_Type *base, uint32_t event);
+
+/**
+ * @brief Update the wheel revolution frequency, applied from the next revolution.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Wheel revolution frequency in milli-Hertz [mHz].
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse doesn't fit in a revolution.
+ */
+status_t TWHEEL_UpdateFrequency(SCT_Type *base, uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t event);
+
+/**
+ * @brief Update the coil pulse width, applied from the next revolution.
+ * @param base			SCTimer peripheral base address.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param pulseWidth_us	Coil pulse width [us].
+ * @param event			Tooth period event number.
+ * @return 'kStatus_Success' or 'kStatus_InvalidArgument' if the pulse doesn't fit in a revolution.
+ */
+status_t TWHEEL_UpdatePulseWidth(SCT_Type *base, uint32_t srcClock_Hz, uint32_t pulseWidth_us, uint32_t event);
+
+/**
+ * @brief Check if the trigger wheel generator is configured.
+ * @return '1' if configured.
+ */
+uint8_t TWHEEL_IsActive(void);
+
+#endif /* TRIGGER_WHEEL_H_ */
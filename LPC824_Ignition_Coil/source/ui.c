@@ -0,0 +1,204 @@
+/**
+ * @file ui.c
+ *
+ * @brief Main screen refreshed at a fixed rate from a model of the displayed values.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The encoder and telemetry events only write the model returned by 'UI_GetModel()'. The main loop
+ * calls 'UI_Process()' which renders the model every 'UI_REFRESH_PERIOD_MS': each field is compared
+ * with the last rendered value and only the changed ones are drawn, so a burst of encoder steps costs
+ * a single redraw and an unchanged screen costs nothing.\n
+ * The top line is a sweep chart of the running RPM, one column is added every 'UI_CHART_PERIOD_MS'.
+ * The running RPM is displayed with the triple size digits, on three lines. In multi-spark mode the
+ * strike count is written on their left by 'LCD_DisplayText()' with the same font. The overcurrent
+ * trip count is only displayed when the protection is built ('OCP_ENABLE').
+ */
+
+#include "ui.h"
+#include "lcd.h"
+#include "font_digits.h"
+#include "overcurrent.h"
+#include "SysTick.h"
+
+#define SCREEN_RMP_OFFSET 48
+#define SCREEN_CMD_OFFSET 80
+#define SCREEN_MATCH_OFFSET 0
+#define SCREEN_RUN_OFFSET 76
+#define SCREEN_VALUE_CELLS 5
+#define SCREEN_RUNNING_CELLS 4
+#define SCREEN_STRIKES_OFFSET 0
+#define SCREEN_STRIKES_X_OFFSET 24
+
+enum SCREEN_LINE{
+	CHART = 0,
+	S_RPM,
+	MSG_R_RPM,
+	R_RPM,
+	STATUS = 6,
+	TRIPS
+};
+
+static ui_model_t s_model;				///< Values written by the events.
+static ui_model_t s_rendered;			///< Values on the screen.
+static uint8_t s_ready;					///< The main screen is drawn.
+static uint32_t s_lastRender;			///< Last render [ms].
+static uint32_t s_lastSample;			///< Last chart sample [ms].
+
+static lcd_number_t s_cmdField;			///< Command RPM field.
+static lcd_number_t s_runningField;		///< Running RPM field.
+#if OCP_ENABLE
+static lcd_number_t s_tripsField;		///< Trip count field.
+#endif
+static lcd_chart_t s_chart;				///< Running RPM chart.
+
+/**
+ * @brief Display the RPM match status.
+ * @param match The running RPM is the command one.
+ */
+static void UI_DisplayMatch(uint8_t match){
+
+	if(match){
+		LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: YES");
+	}
+	else{
+		LCD_DisplayRectangle(56, STATUS, 16, 1 , 0x00);
+		LCD_DisplayString(STATUS,SCREEN_MATCH_OFFSET,"RMP match: NO");
+	}
+}
+
+/**
+ * @brief Display the strike count of the multi-spark mode, blank in the other modes.
+ * @param strikes Strikes per period.
+ */
+static void UI_DisplayStrikes(uint8_t strikes){
+
+	char text[2] = {' ', '\0'};
+
+	// The glyphs are narrower than a blank cell, the previous count is cleared first
+	LCD_DisplayText(&FONT_Digits3x, R_RPM, SCREEN_STRIKES_OFFSET, text);
+
+	if(strikes > 1){
+		text[0] = '0' + strikes % 10;
+		LCD_DisplayText(&FONT_Digits3x, R_RPM, SCREEN_STRIKES_OFFSET, text);
+		LCD_DisplayString(R_RPM + 2, SCREEN_STRIKES_X_OFFSET, "x");
+	}
+	else{
+		LCD_DisplayString(R_RPM + 2, SCREEN_STRIKES_X_OFFSET, " ");
+	}
+}
+
+/**
+ * @brief Display the pulse output state.
+ * @param enabled Pulse output enabled.
+ */
+static void UI_DisplayState(uint8_t enabled){
+
+	if(enabled){
+		LCD_DisplayRectangle(117, STATUS, 10, 1 , 0x00);
+		LCD_DisplayString(STATUS,SCREEN_RUN_OFFSET,"State: ON");
+	}
+	else{
+		LCD_DisplayString(STATUS,SCREEN_RUN_OFFSET,"State: OFF");
+	}
+}
+
+/**
+ * @brief Draw the main screen with the provided values. The LCD must be initialized.
+ * @param model		Initial values of the model.
+ * @param chartMin	RPM of the chart bottom.
+ * @param chartMax	RPM of the chart top.
+ */
+void UI_Init(const ui_model_t *model, uint32_t chartMin, uint32_t chartMax){
+
+	s_model = *model;
+	s_rendered = *model;
+
+	LCD_DisplayClear(0x00,0x00);
+
+	// The running RPM is read from a distance, its digits use the two lines below and end at the right edge
+	LCD_NumberInit(&s_cmdField, NULL, SCREEN_CMD_OFFSET, S_RPM, SCREEN_VALUE_CELLS);
+	LCD_NumberInit(&s_runningField, &FONT_Digits3x, SCREEN_WIDTH - SCREEN_RUNNING_CELLS * FONT_Digits3x.cellWidth,
+			R_RPM, SCREEN_RUNNING_CELLS);
+#if OCP_ENABLE
+	LCD_NumberInit(&s_tripsField, NULL, SCREEN_RMP_OFFSET, TRIPS, SCREEN_VALUE_CELLS);
+#endif
+	LCD_ChartInit(&s_chart, 0, CHART, SCREEN_WIDTH, 1, chartMin, chartMax);
+
+	LCD_DisplayString(S_RPM,4,"Set RPM:");
+	LCD_DisplayNumber(&s_cmdField, s_rendered.cmdRpm);
+
+	LCD_DisplayString(MSG_R_RPM,4,"Running RPM:");
+	LCD_DisplayNumber(&s_runningField, s_rendered.runningRpm);
+	UI_DisplayStrikes(s_rendered.strikes);
+
+	UI_DisplayMatch(s_rendered.match);
+	UI_DisplayState(s_rendered.enabled);
+
+#if OCP_ENABLE
+	LCD_DisplayString(TRIPS,4,"Trips:");
+	LCD_DisplayNumber(&s_tripsField, s_rendered.trips);
+#endif
+
+	s_lastRender = SYSTICK_GetTicks();
+	s_lastSample = s_lastRender;
+	s_ready = 1;
+}
+
+/**
+ * @brief Get the model, its fields are rendered at the next refresh.
+ * @return Pointer to the model.
+ */
+ui_model_t *UI_GetModel(void){
+	return &s_model;
+}
+
+/**
+ * @brief Render the changed fields of the model every 'UI_REFRESH_PERIOD_MS'.
+ * Must be called from the main loop once 'UI_Init()' is done.
+ */
+void UI_Process(void){
+
+	if(!s_ready || SYSTICK_GetTicks() - s_lastRender < UI_REFRESH_PERIOD_MS){
+		return;
+	}
+	s_lastRender = SYSTICK_GetTicks();
+
+	if(s_lastRender - s_lastSample >= UI_CHART_PERIOD_MS){
+		s_lastSample = s_lastRender;
+		LCD_ChartAdd(&s_chart, s_model.runningRpm);
+	}
+
+	if(s_model.cmdRpm != s_rendered.cmdRpm){
+		s_rendered.cmdRpm = s_model.cmdRpm;
+		LCD_DisplayNumber(&s_cmdField, s_rendered.cmdRpm);
+	}
+
+	if(s_model.runningRpm != s_rendered.runningRpm){
+		s_rendered.runningRpm = s_model.runningRpm;
+		LCD_DisplayNumber(&s_runningField, s_rendered.runningRpm);
+	}
+
+	if(s_model.strikes != s_rendered.strikes){
+		s_rendered.strikes = s_model.strikes;
+		UI_DisplayStrikes(s_rendered.strikes);
+	}
+
+	// The match and state texts share the status line
+	if(s_model.match != s_rendered.match){
+		s_rendered.match = s_model.match;
+		UI_DisplayMatch(s_rendered.match);
+	}
+
+	if(s_model.enabled != s_rendered.enabled){
+		s_rendered.enabled = s_model.enabled;
+		UI_DisplayState(s_rendered.enabled);
+	}
+
+#if OCP_ENABLE
+	if(s_model.trips != s_rendered.trips){
+		s_rendered.trips = s_model.trips;
+		LCD_DisplayNumber(&s_tripsField, s_rendered.trips);
+	}
+#endif
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ui.h
+ *
+ * @brief Main screen refreshed at a fixed rate from a model of the displayed values.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The encoder and telemetry events only write the model returned by 'UI_GetModel()'. The main loop
+ * calls 'UI_Process()' which renders the model every 'UI_REFRESH_PERIOD_MS': each field is compared
+ * with the last rendered value and only the changed ones are drawn, so a burst of encoder steps costs
+ * a single redraw and an unchanged screen costs nothing.\n
+ * The top line is a sweep chart of the running RPM, one column is added every 'UI_CHART_PERIOD_MS'.
+ * The running RPM is displayed with the triple size digits, on three lines. In multi-spark mode the
+ * strike count is written on their left by 'LCD_DisplayText()' with the same font. The overcurrent
+ * trip count is only displayed when the protection is built ('OCP_ENABLE').
+ */
+
+#ifndef UI_H_
+#define UI_H_
+
+#include "board.h"
+
+#define UI_REFRESH_PERIOD_MS	40		///< Render period of the model (25 Hz) [ms].
+#define UI_CHART_PERIOD_MS		250		///< Sample period of the running RPM chart [ms].
+
+/**
+ * @brief Displayed values.
+ */
+typedef struct
+{
+	uint32_t cmdRpm;		///< Command RPM.
+	uint32_t runningRpm;	///< Running RPM, the measured one in crank trigger mode.
+	uint32_t trips;			///< Overcurrent trip count, displayed if 'OCP_ENABLE' is set.
+	uint8_t strikes;		///< Strikes per period, '0' in crank trigger mode. Displayed in multi-spark mode.
+	uint8_t match;			///< The running RPM is the command one.
+	uint8_t enabled;		///< Pulse output enabled.
+}ui_model_t;
+
+/**
+ * @brief Draw the main screen with the provided values. The LCD must be initialized.
+ * @param model		Initial values of the model.
+ * @param chartMin	RPM of the chart bottom.
+ * @param chartMax	RPM of the chart top.
+ */
+void UI_Init(const ui_model_t *model, uint32_t chartMin, uint32_t chartMax);
+
+/**
+ * @brief Get the model, its fields are rendered at the next refresh.
+ * @return Pointer to the model.
+ */
+ui_model_t *UI_GetModel(void);
+
+/**
+ * @brief Render the changed fields of the model every 'UI_REFRESH_PERIOD_MS'.
+ * Must be called from the main loop once 'UI_Init()' is done.
+ */
+void UI_Process(void);
+
+#endif /* UI_H_ */
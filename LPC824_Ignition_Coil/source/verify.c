@@ -0,0 +1,255 @@
+/**
+ * @file verify.c
+ *
+ * @brief Verification of the generated pulses by capturing the coil output.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The coil output pin is routed back to an SCTimer input. Two capture events store the counter
+ * on its rising and falling edges and the falling edge interrupt reads both captures, once per
+ * pulse. The measured width and period are compared with the commanded ones, the errors are
+ * accumulated and an alarm is raised when an error exceeds 'VERIFY_ALARM_TICKS'.\n
+ * The period is the time between two rising edges: the counter period that ran between them
+ * (read from the match register used by the hardware) plus the difference of the captures.
+ * Only the single pulse mode is verified.
+ */
+
+#include "verify.h"
+#include "telemetry.h"
+
+static SCT_Type *s_base;				///< Verified SCTimer.
+static uint8_t s_running;				///< The verification is running.
+static uint32_t s_event;				///< Rising edge event, the falling edge event follows.
+static uint32_t s_riseCapture;			///< Capture register of the rising edge.
+static uint32_t s_fallCapture;			///< Capture register of the falling edge.
+static uint32_t s_periodMatch;			///< Match register of the pulse period.
+
+static uint32_t s_width;				///< Commanded width [tick].
+static uint32_t s_period;				///< Commanded period [1/1000 tick].
+
+static uint8_t s_previous;				///< A previous rising edge is known.
+static uint32_t s_previousRise;			///< Capture of the previous rising edge [tick].
+static uint32_t s_previousLimit;		///< Counter period of the previous pulse [tick].
+
+static volatile verify_stats_t s_stats;	///< Measurement statistics.
+static volatile uint8_t s_alarm;		///< An error exceeded the threshold.
+
+/**
+ * @brief Falling edge event callback. Measure the pulse that just ended.
+ */
+static void VERIFY_FallCallback(void){
+
+	uint32_t rise = s_base->SCTCAP[s_riseCapture];
+	uint32_t fall = s_base->SCTCAP[s_fallCapture];
+	uint32_t limit = s_base->SCTMATCH[s_periodMatch] + 1;
+	int32_t error;
+	uint8_t alarm = 0;
+
+	// Edges captured in different periods, the interrupt has been delayed
+	if(fall < rise){
+		s_previous = 0;
+		return;
+	}
+
+	s_stats.width = fall - rise;
+	error = (int32_t)(s_stats.width - s_width);
+	s_stats.widthErrorSum += error;
+	if(error < 0){
+		error = -error;
+	}
+	if(error > s_stats.widthErrorMax){
+		s_stats.widthErrorMax = error;
+	}
+	alarm |= error > VERIFY_ALARM_TICKS;
+
+	if(s_previous){
+		s_stats.period = s_previousLimit - s_previousRise + rise;
+		error = (int32_t)(s_stats.period * 1000 - s_period);
+		s_stats.periodErrorSum += error;
+		if(error < 0){
+			error = -error;
+		}
+		if(error > s_stats.periodErrorMax){
+			s_stats.periodErrorMax = error;
+		}
+		alarm |= error > VERIFY_ALARM_TICKS * 1000;
+	}
+
+	s_previous = 1;
+	s_previousRise = rise;
+	s_previousLimit = limit;
+
+	s_stats.count++;
+	if(alarm){
+		s_stats.alarms++;
+		s_alarm = 1;
+	}
+}
+
+/**
+ * @brief Start the verification of a pulse configured with 'IPULSE_SetupPulse()'.
+ * The coil output must be routed to the SCTimer input.
+ * @param base	SCTimer peripheral base address.
+ * @param input	SCTimer input receiving the coil output.
+ * @param event	Pulse period event number.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough SCTimer resources are available.
+ */
+status_t VERIFY_Start(SCT_Type *base, sctimer_input_t input, uint32_t event){
+
+	uint32_t first = 0;
+	uint32_t rise = 0, fall = 0;
+
+	if(s_running){
+		return kStatus_Fail;
+	}
+
+	if(SCTMGR_AllocEvents(2, &first) != kStatus_Success){
+		return kStatus_Fail;
+	}
+	if(SCTMGR_AllocMatch(&rise) != kStatus_Success){
+		SCTMGR_FreeEvents(base, first, 2);
+		return kStatus_Fail;
+	}
+	if(SCTMGR_AllocMatch(&fall) != kStatus_Success){
+		SCTMGR_FreeMatch(base, rise);
+		SCTMGR_FreeEvents(base, first, 2);
+		return kStatus_Fail;
+	}
+
+	s_base = base;
+	s_event = first;
+	s_riseCapture = rise;
+	s_fallCapture = fall;
+	s_periodMatch = base->EVENT[event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	s_previous = 0;
+
+	// Capture the counter on both edges, in all the states
+	base->REGMODE |= (1U << rise) | (1U << fall);
+	base->SCTCAPCTRL[rise] = 1U << first;
+	base->SCTCAPCTRL[fall] = 1U << (first + 1);
+
+	base->EVENT[first].CTRL = kSCTIMER_InputRiseEvent | SCT_EVENT_CTRL_IOSEL(input);
+	base->EVENT[first].STATE = 0xFF;
+	base->EVENT[first + 1].CTRL = kSCTIMER_InputFallEvent | SCT_EVENT_CTRL_IOSEL(input);
+	base->EVENT[first + 1].STATE = 0xFF;
+
+	// One interrupt per pulse, both captures are read on the falling edge
+	SCTIMER_SetCallback(base, VERIFY_FallCallback, first + 1);
+	SCTIMER_EnableInterrupts(base, 1U << (first + 1));
+	EnableIRQ(SCT0_IRQn);
+
+	s_running = 1;
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Stop the verification and release its resources.
+ * @param base SCTimer peripheral base address.
+ */
+void VERIFY_Stop(SCT_Type *base){
+
+	if(!s_running){
+		return;
+	}
+
+	SCTIMER_DisableInterrupts(base, 1U << (s_event + 1));
+	SCTMGR_FreeMatch(base, s_riseCapture);
+	SCTMGR_FreeMatch(base, s_fallCapture);
+	SCTMGR_FreeEvents(base, s_event, 2);
+
+	s_running = 0;
+}
+
+/**
+ * @brief Set the commanded pulse, the statistics are cleared.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Pulse frequency in milli-Hertz [mHz].
+ * @param pulseWidth_us	Pulse width in micro-second [us].
+ */
+void VERIFY_SetCommand(uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t pulseWidth_us){
+
+	uint32_t sctClock;
+	uint32_t primask;
+	uint64_t t;
+
+	if(!s_running || freq_mHz == 0){
+		return;
+	}
+
+	sctClock = srcClock_Hz / (((s_base->CTRL & SCT_CTRL_PRE_L_MASK) >> SCT_CTRL_PRE_L_SHIFT) + 1);
+
+	primask = DisableGlobalIRQ();
+
+	// Exact period, the dithering makes the average measured period match it
+	t = sctClock;
+	t *= 1000000U;
+	t /= freq_mHz;
+	s_period = t;
+
+	t = pulseWidth_us;
+	t *= sctClock;
+	t /= 1000000U;
+	s_width = t;
+
+	s_previous = 0;
+	s_stats.count = 0;
+	s_stats.widthErrorSum = 0;
+	s_stats.periodErrorSum = 0;
+	s_stats.widthErrorMax = 0;
+	s_stats.periodErrorMax = 0;
+	s_stats.alarms = 0;
+	s_alarm = 0;
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Get and clear the alarm.
+ * @return '1' if an error exceeded the threshold since the last call.
+ */
+uint8_t VERIFY_GetAlarm(void){
+
+	uint8_t alarm = s_alarm;
+
+	s_alarm = 0;
+	return alarm;
+}
+
+/**
+ * @brief Get the measurement statistics.
+ * @param stats Pointer where the statistics are copied.
+ */
+void VERIFY_GetStats(verify_stats_t *stats){
+
+	uint32_t primask = DisableGlobalIRQ();
+
+	*stats = *(const verify_stats_t *)&s_stats;
+
+	EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief Telemetry command printing the measurement statistics.
+ * @param args Unused.
+ */
+void VERIFY_PrintStats(const char *args){
+
+	verify_stats_t stats;
+
+	VERIFY_GetStats(&stats);
+
+	TELEMETRY_WriteString("V");
+	TELEMETRY_WriteField("on", s_running);
+	TELEMETRY_WriteField("count", stats.count);
+	TELEMETRY_WriteField("width", stats.width);
+	TELEMETRY_WriteField("cmdWidth", s_width);
+	TELEMETRY_WriteField("period", stats.period);
+	TELEMETRY_WriteField("cmdPeriod_m", s_period);
+	TELEMETRY_WriteHexField("wSum", stats.widthErrorSum);
+	TELEMETRY_WriteHexField("pSum_m", stats.periodErrorSum);
+	TELEMETRY_WriteField("wMax", stats.widthErrorMax);
+	TELEMETRY_WriteField("pMax_m", stats.periodErrorMax);
+	TELEMETRY_WriteField("alarms", stats.alarms);
+	TELEMETRY_WriteEnd();
+}
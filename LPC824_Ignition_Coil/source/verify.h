@@ -0,0 +1,83 @@
+/**
+ * @file verify.h
+ *
+ * @brief Verification of the generated pulses by capturing the coil output.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The coil output pin is routed back to an SCTimer input. Two capture events store the counter
+ * on its rising and falling edges and the falling edge interrupt reads both captures, once per
+ * pulse. The measured width and period are compared with the commanded ones, the errors are
+ * accumulated and an alarm is raised when an error exceeds 'VERIFY_ALARM_TICKS'.\n
+ * The period is the time between two rising edges: the counter period that ran between them
+ * (read from the match register used by the hardware) plus the difference of the captures.
+ * Only the single pulse mode is verified.
+ */
+
+#ifndef VERIFY_H_
+#define VERIFY_H_
+
+#include "board.h"
+#include "fsl_sctimer.h"
+#include "sct_manager.h"
+
+#define VERIFY_ALARM_TICKS		4		///< Error above which the alarm is raised [tick].
+
+/**
+ * @brief Measurement statistics.
+ */
+typedef struct
+{
+	uint32_t count;				///< Number of measured pulses.
+	uint32_t width;				///< Last measured width [tick].
+	uint32_t period;			///< Last measured period [tick].
+	int32_t widthErrorSum;		///< Sum of the width errors [tick].
+	int32_t periodErrorSum;		///< Sum of the period errors [1/1000 tick].
+	uint32_t widthErrorMax;		///< Largest absolute width error [tick].
+	uint32_t periodErrorMax;	///< Largest absolute period error [1/1000 tick].
+	uint32_t alarms;			///< Number of pulses with an error above the threshold.
+}verify_stats_t;
+
+/**
+ * @brief Start the verification of a pulse configured with 'IPULSE_SetupPulse()'.
+ * The coil output must be routed to the SCTimer input.
+ * @param base	SCTimer peripheral base address.
+ * @param input	SCTimer input receiving the coil output.
+ * @param event	Pulse period event number.
+ * @return 'kStatus_Success' or 'kStatus_Fail' if not enough SCTimer resources are available.
+ */
+status_t VERIFY_Start(SCT_Type *base, sctimer_input_t input, uint32_t event);
+
+/**
+ * @brief Stop the verification and release its resources.
+ * @param base SCTimer peripheral base address.
+ */
+void VERIFY_Stop(SCT_Type *base);
+
+/**
+ * @brief Set the commanded pulse, the statistics are cleared.
+ * @param srcClock_Hz	SCTimer counter clock in Hertz [Hz].
+ * @param freq_mHz		Pulse frequency in milli-Hertz [mHz].
+ * @param pulseWidth_us	Pulse width in micro-second [us].
+ */
+void VERIFY_SetCommand(uint32_t srcClock_Hz, uint32_t freq_mHz, uint32_t pulseWidth_us);
+
+/**
+ * @brief Get and clear the alarm.
+ * @return '1' if an error exceeded the threshold since the last call.
+ */
+uint8_t VERIFY_GetAlarm(void);
+
+/**
+ * @brief Get the measurement statistics.
+ * @param stats Pointer where the statistics are copied.
+ */
+void VERIFY_GetStats(verify_stats_t *stats);
+
+/**
+ * @brief Telemetry command printing the measurement statistics.
+ * @param args Unused.
+ */
+void VERIFY_PrintStats(const char *args);
+
+#endif /* VERIFY_H_ */
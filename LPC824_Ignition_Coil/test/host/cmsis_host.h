@@ -0,0 +1,60 @@
+/**
+ * @file cmsis_host.h
+ *
+ * @brief Host replacement of the CMSIS compiler header, included before any other header.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The firmware sources and the SDK drivers are compiled for the host. 'cmsis_gcc.h' is skipped
+ * (its guard is defined here) because its core register accesses are ARM instructions: the
+ * interrupt mask is a variable of the host harness and the barriers do nothing.
+ */
+
+#ifndef CMSIS_HOST_H_
+#define CMSIS_HOST_H_
+
+#include <stdint.h>
+
+#define __CMSIS_GCC_H
+
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+
+#define __UNALIGNED_UINT32(x)                  (*(uint32_t *)(x))
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)(*(uint16_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT16_READ(addr)          (*(const uint16_t *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)(*(uint32_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (*(const uint32_t *)(const void *)(addr))
+
+extern volatile uint32_t host_primask;		///< PRIMASK of the emulated core, '1' when the interrupts are disabled.
+extern uint32_t host_msp;					///< Value returned for the main stack pointer.
+
+__STATIC_FORCEINLINE void __enable_irq(void){ host_primask = 0; }
+__STATIC_FORCEINLINE void __disable_irq(void){ host_primask = 1; }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void){ return host_primask; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t priMask){ host_primask = priMask & 1U; }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void){ return host_msp; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void){ return 0; }
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value){ return __builtin_bswap32(value); }
+
+#define __NOP()		__asm volatile ("" ::: "memory")
+#define __WFI()		__asm volatile ("" ::: "memory")
+#define __WFE()		__asm volatile ("" ::: "memory")
+#define __SEV()		__asm volatile ("" ::: "memory")
+#define __ISB()		__asm volatile ("" ::: "memory")
+#define __DSB()		__asm volatile ("" ::: "memory")
+#define __DMB()		__asm volatile ("" ::: "memory")
+#define __BKPT(value)	__builtin_trap()
+#define __CLZ		(uint8_t)__builtin_clz
+
+#endif /* CMSIS_HOST_H_ */
@@ -0,0 +1,19 @@
+/**
+ * @file cr_section_macros.h
+ *
+ * @brief Host replacement of the MCUXpresso section macros.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The host has no linker script placing the sections, the variables stay in '.bss'.
+ */
+
+#ifndef CR_SECTION_MACROS_H_
+#define CR_SECTION_MACROS_H_
+
+#define __NOINIT_DEF
+#define __DATA(bank)
+#define __BSS(bank)
+#define __RAMFUNC(bank)
+
+#endif /* CR_SECTION_MACROS_H_ */
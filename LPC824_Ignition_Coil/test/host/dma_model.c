@@ -0,0 +1,197 @@
+/**
+ * @file dma_model.c
+ *
+ * @brief Host model of the DMA channel of the SPI0 transmitter and of the SPI0 output.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * A descriptor is read as four 32-bit words: transfer configuration, source end address,
+ * destination end address and next descriptor address. The addresses are valid host pointers, the
+ * static data of the tests are below 4 GB.\n
+ * The interrupt flag is a write-one-to-clear register: it is set with a marker bit before the
+ * handler is called, the marker must be overwritten by the clear of the handler.
+ */
+
+#include <stddef.h>
+
+#include "dma_model.h"
+#include "host.h"
+#include "fsl_device_registers.h"
+
+#define INTA_MARKER			(1U << 31)	///< Reserved bit of INTA, cleared by the write of the handler.
+#define SPI_IDLE			(SPI_STAT_TXRDY_MASK | SPI_STAT_MSTIDLE_MASK)
+
+void DMA0_IRQHandler(void);
+
+static uint32_t s_cdPin;				///< GPIO pin of the command/data signal.
+static dmamodel_byte_t s_byte;			///< Observer of the bytes.
+static dmamodel_end_t s_end;			///< Observer of the chip select.
+static uint32_t s_interrupts;			///< Number of interrupts.
+
+static uint8_t s_active;				///< A descriptor is being transferred.
+static uint8_t s_trigger;				///< The channel is triggered.
+static uint32_t s_xfercfg;				///< Configuration of the transferred descriptor.
+static const uint8_t *s_src;			///< Next source byte.
+static uint32_t s_remaining;			///< Bytes left in the descriptor.
+static uint32_t s_next;					///< Next descriptor address.
+
+/**
+ * @brief Report the end of transfer written by the firmware and set the SPI back to idle.
+ */
+static void DMAMODEL_SpiStatus(void){
+
+	if(SPI0->STAT & SPI_STAT_ENDTRANSFER_MASK){
+		if(s_end){
+			s_end();
+		}
+	}
+	SPI0->STAT = SPI_IDLE;
+}
+
+/**
+ * @brief Load a descriptor in the channel.
+ * @param xfercfg Transfer configuration.
+ * @param words Descriptor: the source end, destination end and next addresses from word 1.
+ */
+static void DMAMODEL_Load(uint32_t xfercfg, const volatile uint32_t *words){
+
+	uint32_t count = ((xfercfg & DMA_CHANNEL_XFERCFG_XFERCOUNT_MASK) >> DMA_CHANNEL_XFERCFG_XFERCOUNT_SHIFT) + 1;
+
+	CHECK(xfercfg & DMA_CHANNEL_XFERCFG_CFGVALID_MASK, "DMA: descriptor 0x%08X loaded without a valid configuration",
+			(uint32_t)(uintptr_t)words);
+	CHECK((xfercfg & (DMA_CHANNEL_XFERCFG_WIDTH_MASK | DMA_CHANNEL_XFERCFG_SRCINC_MASK | DMA_CHANNEL_XFERCFG_DSTINC_MASK))
+			== DMA_CHANNEL_XFERCFG_SRCINC(1), "DMA: XFERCFG 0x%08X is not a byte stream to a register", xfercfg);
+	CHECK(words[2] == (uint32_t)(uintptr_t)&SPI0->TXDAT, "DMA: destination 0x%08X is not the SPI0 TXDAT", words[2]);
+	CHECK((words[3] & 0xF) == 0, "DMA: next descriptor 0x%08X not aligned on 16 bytes", words[3]);
+	CHECK(SPI0->TXCTL & SPI_TXCTL_RXIGNORE_MASK, "SPI: bytes sent without ignoring the reception");
+
+	s_xfercfg = xfercfg;
+	s_src = (const uint8_t *)(uintptr_t)(words[1] - (count - 1));
+	s_remaining = count;
+	s_next = words[3];
+	s_active = 1;
+}
+
+/**
+ * @brief End of the transferred descriptor: reload, clear the trigger and raise the interrupt.
+ */
+static void DMAMODEL_EndDescriptor(void){
+
+	volatile uint32_t *xfercfg = &DMA0->CHANNEL[DMAMODEL_CHANNEL].XFERCFG;
+	const volatile uint32_t *next = (const volatile uint32_t *)(uintptr_t)s_next;
+	uint32_t mask = 1U << DMAMODEL_CHANNEL;
+	uint32_t cfg = s_xfercfg;
+
+	s_active = 0;
+	if(cfg & DMA_CHANNEL_XFERCFG_CLRTRIG_MASK){
+		s_trigger = 0;
+	}
+
+	if(cfg & DMA_CHANNEL_XFERCFG_RELOAD_MASK){
+		CHECK(s_next != 0, "DMA: reload without a next descriptor");
+		if(s_next){
+			*xfercfg = next[0];
+			DMAMODEL_Load(next[0], next);
+		}
+	}
+	else{
+		CHECK(s_next == 0, "DMA: next descriptor 0x%08X without reload", s_next);
+		*xfercfg = cfg & ~DMA_CHANNEL_XFERCFG_CFGVALID_MASK;
+	}
+
+	if(cfg & DMA_CHANNEL_XFERCFG_SETINTA_MASK){
+		DMA0->COMMON[0].INTA = mask | INTA_MARKER;
+		if(DMA0->COMMON[0].INTENSET & mask){
+			s_interrupts++;
+			DMA0_IRQHandler();
+			CHECK(!(DMA0->COMMON[0].INTA & INTA_MARKER), "DMA: interrupt A not cleared by the handler");
+			DMAMODEL_SpiStatus();
+		}
+		DMA0->COMMON[0].INTA = 0;
+	}
+}
+
+/**
+ * @brief Reset the model: channel idle, SPI idle, no observer.
+ * The DMA registers are not changed, the SPI status is set to idle.
+ * @param cdPin GPIO pin (port 0) of the command/data signal.
+ */
+void DMAMODEL_Reset(uint32_t cdPin){
+
+	s_cdPin = cdPin;
+	s_byte = NULL;
+	s_end = NULL;
+	s_interrupts = 0;
+	s_active = 0;
+	s_trigger = 0;
+	SPI0->STAT = SPI_IDLE;
+}
+
+/**
+ * @brief Set the observers of the SPI.
+ * @param byte Called for each byte written to the SPI, 'NULL' for none.
+ * @param end Called when the chip select is released, 'NULL' for none.
+ */
+void DMAMODEL_SetObservers(dmamodel_byte_t byte, dmamodel_end_t end){
+
+	s_byte = byte;
+	s_end = end;
+}
+
+/**
+ * @brief Run the channel.
+ * @param maxBytes Maximum number of bytes to move.
+ * @return The number of bytes moved, less than 'maxBytes' when the channel is idle.
+ */
+uint32_t DMAMODEL_Run(uint32_t maxBytes){
+
+	volatile uint32_t *xfercfg = &DMA0->CHANNEL[DMAMODEL_CHANNEL].XFERCFG;
+	const volatile uint32_t *channel;
+	uint32_t mask = 1U << DMAMODEL_CHANNEL;
+	uint32_t moved = 0;
+
+	DMAMODEL_SpiStatus();
+
+	while(moved < maxBytes){
+
+		if(!s_active){
+			if(*xfercfg & DMA_CHANNEL_XFERCFG_SWTRIG_MASK){
+				s_trigger = 1;
+				*xfercfg &= ~DMA_CHANNEL_XFERCFG_SWTRIG_MASK;
+			}
+			if(!s_trigger || !(*xfercfg & DMA_CHANNEL_XFERCFG_CFGVALID_MASK)){
+				break;
+			}
+
+			CHECK((DMA0->CTRL & DMA_CTRL_ENABLE_MASK) && (DMA0->COMMON[0].ENABLESET & mask) &&
+					(DMA0->CHANNEL[DMAMODEL_CHANNEL].CFG & DMA_CHANNEL_CFG_PERIPHREQEN_MASK),
+					"DMA: channel triggered while disabled or without the SPI request");
+			CHECK((DMA0->SRAMBASE & 0x1FF) == 0, "DMA: descriptor table 0x%08X not aligned on 512 bytes", DMA0->SRAMBASE);
+			channel = (const volatile uint32_t *)(uintptr_t)(DMA0->SRAMBASE + 16 * DMAMODEL_CHANNEL);
+			DMAMODEL_Load(*xfercfg, channel);
+		}
+
+		// The SPI requests a byte when its transmitter is ready, it is shifted at once
+		SPI0->TXDAT = *s_src;
+		if(s_byte){
+			s_byte(*s_src, GPIO->B[0][s_cdPin]);
+		}
+		s_src++;
+		moved++;
+
+		if(--s_remaining == 0){
+			CHECK(*xfercfg == s_xfercfg, "DMA: XFERCFG written during a transfer (0x%08X, loaded 0x%08X)", *xfercfg, s_xfercfg);
+			DMAMODEL_EndDescriptor();
+		}
+	}
+
+	return moved;
+}
+
+/**
+ * @brief Get the number of interrupts raised since the reset.
+ * @return The number of calls of the DMA handler.
+ */
+uint32_t DMAMODEL_GetInterrupts(void){
+	return s_interrupts;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file dma_model.h
+ *
+ * @brief Host model of the DMA channel of the SPI0 transmitter and of the SPI0 output.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The model reads the DMA registers and the descriptors in RAM as the controller does: the
+ * channel starts on a software trigger with a valid configuration, moves its bytes to the SPI
+ * transmit register, loads the linked descriptor when the reload bit is set, and raises the
+ * interrupt A of the descriptors that request it by calling the real handler. Each byte written to
+ * the SPI is reported with the level of the LCD command/data pin, and the end of transfer written
+ * by the firmware is reported as the release of the chip select.\n
+ * The SPI shifts a byte as soon as it is written: it is idle whenever the firmware runs, so the
+ * timing of the command/data pin against the last bit of a byte is not modelled. The descriptor
+ * layout, the transfer configurations and the flags left to the firmware are checked with 'CHECK()'.
+ */
+
+#ifndef DMA_MODEL_H_
+#define DMA_MODEL_H_
+
+#include <stdint.h>
+
+#define DMAMODEL_CHANNEL	7		///< DMA channel of the SPI0 transmitter request.
+
+/**
+ * @brief Called for each byte written to the SPI.
+ * @param data Byte.
+ * @param cd Level of the command/data pin.
+ */
+typedef void (*dmamodel_byte_t)(uint8_t data, uint8_t cd);
+
+/**
+ * @brief Called when the firmware ends the SPI transfer (chip select released).
+ */
+typedef void (*dmamodel_end_t)(void);
+
+/**
+ * @brief Reset the model: channel idle, SPI idle, no observer.
+ * The DMA registers are not changed, the SPI status is set to idle.
+ * @param cdPin GPIO pin (port 0) of the command/data signal.
+ */
+void DMAMODEL_Reset(uint32_t cdPin);
+
+/**
+ * @brief Set the observers of the SPI.
+ * @param byte Called for each byte written to the SPI, 'NULL' for none.
+ * @param end Called when the chip select is released, 'NULL' for none.
+ */
+void DMAMODEL_SetObservers(dmamodel_byte_t byte, dmamodel_end_t end);
+
+/**
+ * @brief Run the channel.
+ * @param maxBytes Maximum number of bytes to move.
+ * @return The number of bytes moved, less than 'maxBytes' when the channel is idle.
+ */
+uint32_t DMAMODEL_Run(uint32_t maxBytes);
+
+/**
+ * @brief Get the number of interrupts raised since the reset.
+ * @return The number of calls of the DMA handler.
+ */
+uint32_t DMAMODEL_GetInterrupts(void);
+
+#endif /* DMA_MODEL_H_ */
@@ -0,0 +1,282 @@
+/**
+ * @file flash_iap.c
+ *
+ * @brief Host model of the flash and of the ROM IAP commands, with power loss injection.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The IAP entry address is called as a function by the firmware: a jump to 'FLASHIAP_Command()'
+ * is written at this address in an executable page (x86-64 code, the arguments are passed
+ * unchanged in the registers).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "flash_iap.h"
+#include "host.h"
+
+#define IAP_ENTRY			0x1FFF1FF1U		///< ROM IAP entry called by the firmware (FSL_FEATURE_SYSCON_IAP_ENTRY_LOCATION).
+#define IAP_PAGE			0x1FFF1000U		///< Host page holding the entry.
+#define HOST_PAGE_SIZE		0x1000U			///< Host page size [byte].
+
+#define IAP_PREPARE_SECTOR		50		///< Prepare sectors for write operation.
+#define IAP_COPY_RAM_TO_FLASH	51		///< Copy RAM to flash.
+#define IAP_ERASE_SECTOR		52		///< Erase sectors.
+#define IAP_BLANK_CHECK			53		///< Blank check sectors.
+
+#define IAP_CMD_SUCCESS				0	///< Command executed successfully.
+#define IAP_INVALID_COMMAND			1	///< Invalid command.
+#define IAP_SRC_ADDR_ERROR			2	///< Source address not on a word boundary.
+#define IAP_DST_ADDR_ERROR			3	///< Destination address not on a page boundary.
+#define IAP_COUNT_ERROR				6	///< Byte count not 64, 128, 256, 512 or 1024.
+#define IAP_INVALID_SECTOR			7	///< Invalid sector number or end before start.
+#define IAP_SECTOR_NOT_BLANK		8	///< Sector not blank.
+#define IAP_SECTOR_NOT_PREPARED		9	///< Prepare command not executed before the operation.
+
+static flashiap_stats_t s_stats;		///< Operation counters.
+static uint32_t s_prepared;				///< Sectors prepared for the next operation.
+static uint32_t s_lossOperation;		///< Remaining writes and erases before the power loss, '0' if disarmed.
+static jmp_buf *s_reset;				///< Context restored when the power is lost.
+static uint32_t s_random;				///< State of the pattern generator.
+
+/**
+ * @brief Next value of the pattern generator (xorshift32).
+ * @return A pseudo random value.
+ */
+static uint32_t FLASHIAP_Random(void){
+
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+/**
+ * @brief Allow or forbid the writes to the flash mapping.
+ * @param writable '1' during an IAP operation.
+ */
+static void FLASHIAP_Unlock(int writable){
+	mprotect((void *)(uintptr_t)FLASHIAP_START, FLASHIAP_END - FLASHIAP_START,
+			writable ? PROT_READ | PROT_WRITE : PROT_READ);
+}
+
+/**
+ * @brief Check the sector range of a command.
+ * @param start First sector.
+ * @param end Last sector.
+ * @return '1' if the range is valid.
+ */
+static int FLASHIAP_IsValidRange(uint32_t start, uint32_t end){
+	return start <= end && end < FLASHIAP_END / FLASHIAP_SECTOR_SIZE &&
+			start >= FLASHIAP_START / FLASHIAP_SECTOR_SIZE;
+}
+
+/**
+ * @brief Check that all the sectors of a range are prepared.
+ * @param start First sector.
+ * @param end Last sector.
+ * @return '1' if all the sectors are prepared.
+ */
+static int FLASHIAP_IsPrepared(uint32_t start, uint32_t end){
+
+	uint32_t mask = ((2U << end) - 1) & ~((1U << start) - 1);
+
+	return (s_prepared & mask) == mask;
+}
+
+/**
+ * @brief Count a write or erase, lose the power if it is the armed one.
+ * The words of an interrupted operation are changed in no particular order: each word is either
+ * changed, unchanged or only partly changed.
+ * @param words Words changed by the operation.
+ * @param values New values of the words, 'NULL' for an erase.
+ * @param count Number of words.
+ */
+static void FLASHIAP_Change(uint32_t *words, const uint32_t *values, uint32_t count){
+
+	uint8_t lost = s_lossOperation && --s_lossOperation == 0;
+	uint32_t i;
+
+	FLASHIAP_Unlock(1);
+
+	for(i = 0; i < count; i++){
+		uint32_t target = values ? words[i] & values[i] : 0xFFFFFFFFU;
+
+		if(values && (words[i] & values[i]) != values[i]){
+			s_stats.rewrites++;
+		}
+
+		if(!lost){
+			words[i] = target;
+			continue;
+		}
+
+		switch(FLASHIAP_Random() % 3){
+		case 0:
+			words[i] = target;
+			break;
+		case 1:
+			words[i] ^= (words[i] ^ target) & FLASHIAP_Random();
+			break;
+		default:
+			break;
+		}
+	}
+
+	FLASHIAP_Unlock(0);
+	s_prepared = 0;
+
+	if(lost){
+		longjmp(*s_reset, 1);
+	}
+}
+
+/**
+ * @brief Execute an IAP command, called by the firmware through the ROM entry.
+ * @param command Command code and parameters.
+ * @param result Status code and results.
+ */
+static void FLASHIAP_Command(uint32_t *command, uint32_t *result){
+
+	uint32_t status = IAP_CMD_SUCCESS;
+	uint32_t i;
+
+	if(!host_primask){
+		s_stats.unmasked++;
+	}
+
+	switch(command[0]){
+
+	case IAP_PREPARE_SECTOR:
+		if(!FLASHIAP_IsValidRange(command[1], command[2])){
+			status = IAP_INVALID_SECTOR;
+			break;
+		}
+		for(i = command[1]; i <= command[2]; i++){
+			s_prepared |= 1U << i;
+		}
+		break;
+
+	case IAP_COPY_RAM_TO_FLASH:
+		if(command[1] % FLASHIAP_PAGE_SIZE || command[1] < FLASHIAP_START || command[1] + command[3] > FLASHIAP_END){
+			status = IAP_DST_ADDR_ERROR;
+		}
+		else if(command[2] % sizeof(uint32_t)){
+			status = IAP_SRC_ADDR_ERROR;
+		}
+		else if(command[3] != 64 && command[3] != 128 && command[3] != 256 && command[3] != 512 && command[3] != 1024){
+			status = IAP_COUNT_ERROR;
+		}
+		else if(!FLASHIAP_IsPrepared(command[1] / FLASHIAP_SECTOR_SIZE, (command[1] + command[3] - 1) / FLASHIAP_SECTOR_SIZE)){
+			status = IAP_SECTOR_NOT_PREPARED;
+		}
+		else{
+			s_stats.writes++;
+			FLASHIAP_Change((uint32_t *)(uintptr_t)command[1], (const uint32_t *)(uintptr_t)command[2],
+					command[3] / sizeof(uint32_t));
+		}
+		break;
+
+	case IAP_ERASE_SECTOR:
+		if(!FLASHIAP_IsValidRange(command[1], command[2])){
+			status = IAP_INVALID_SECTOR;
+		}
+		else if(!FLASHIAP_IsPrepared(command[1], command[2])){
+			status = IAP_SECTOR_NOT_PREPARED;
+		}
+		else{
+			s_stats.erases++;
+			FLASHIAP_Change((uint32_t *)(uintptr_t)(command[1] * FLASHIAP_SECTOR_SIZE), NULL,
+					(command[2] - command[1] + 1) * FLASHIAP_SECTOR_SIZE / sizeof(uint32_t));
+		}
+		break;
+
+	case IAP_BLANK_CHECK:
+		if(!FLASHIAP_IsValidRange(command[1], command[2])){
+			status = IAP_INVALID_SECTOR;
+			break;
+		}
+		s_stats.blankChecks++;
+		for(i = command[1] * FLASHIAP_SECTOR_SIZE; i < (command[2] + 1) * FLASHIAP_SECTOR_SIZE; i += sizeof(uint32_t)){
+			if(*(const uint32_t *)(uintptr_t)i != 0xFFFFFFFFU){
+				status = IAP_SECTOR_NOT_BLANK;
+				result[1] = i;
+				result[2] = *(const uint32_t *)(uintptr_t)i;
+				break;
+			}
+		}
+		break;
+
+	default:
+		status = IAP_INVALID_COMMAND;
+		break;
+	}
+
+	if(status != IAP_CMD_SUCCESS && status != IAP_SECTOR_NOT_BLANK){
+		s_stats.errors++;
+	}
+	result[0] = status;
+}
+
+/**
+ * @brief Map the flash and install the IAP entry point.
+ */
+void FLASHIAP_Init(void){
+
+	uintptr_t target = (uintptr_t)FLASHIAP_Command;
+	uint8_t *entry;
+
+	HOST_Map(FLASHIAP_START, FLASHIAP_END - FLASHIAP_START, 0xFF);
+	FLASHIAP_Unlock(0);
+
+	// movabs rax, FLASHIAP_Command; jmp rax
+	HOST_Map(IAP_PAGE, HOST_PAGE_SIZE, 0xCC);
+	entry = (uint8_t *)(uintptr_t)IAP_ENTRY;
+	entry[0] = 0x48;
+	entry[1] = 0xB8;
+	memcpy(&entry[2], &target, sizeof(target));
+	entry[10] = 0xFF;
+	entry[11] = 0xE0;
+	if(mprotect((void *)(uintptr_t)IAP_PAGE, HOST_PAGE_SIZE, PROT_READ | PROT_EXEC) != 0){
+		fprintf(stderr, "flash_iap: can't make the IAP entry executable\n");
+		exit(2);
+	}
+}
+
+/**
+ * @brief Erase the whole emulated flash and clear the counters.
+ */
+void FLASHIAP_Reset(void){
+
+	FLASHIAP_Unlock(1);
+	memset((void *)(uintptr_t)FLASHIAP_START, 0xFF, FLASHIAP_END - FLASHIAP_START);
+	FLASHIAP_Unlock(0);
+
+	memset(&s_stats, 0, sizeof(s_stats));
+	s_prepared = 0;
+	s_lossOperation = 0;
+}
+
+/**
+ * @brief Arm a power loss.
+ * @param operation Number of the write or erase interrupted, '1' for the next one, '0' to disarm.
+ * @param reset Context restored by 'longjmp()' when the power is lost.
+ * @param seed Seed of the pattern left by the interrupted operation.
+ */
+void FLASHIAP_ArmPowerLoss(uint32_t operation, jmp_buf *reset, uint32_t seed){
+
+	s_lossOperation = operation;
+	s_reset = reset;
+	s_random = seed ? seed : 1;
+}
+
+/**
+ * @brief Get the operation counters.
+ * @return The counters since the last reset.
+ */
+const flashiap_stats_t *FLASHIAP_GetStats(void){
+	return &s_stats;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file flash_iap.h
+ *
+ * @brief Host model of the flash and of the ROM IAP commands, with power loss injection.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The flash is mapped read only at its target address, it is only changed by the IAP commands
+ * called through 'FSL_FEATURE_SYSCON_IAP_ENTRY_LOCATION'. As on the target, programming can only
+ * clear bits, each write or erase must follow a prepare command and the sectors stay prepared for
+ * one operation only.\n
+ * A power loss can be armed on a later write or erase: the operation is left half done (some
+ * words changed, one word with only part of its bits changed) and the model jumps back to the
+ * test as a reset would.
+ */
+
+#ifndef FLASH_IAP_H_
+#define FLASH_IAP_H_
+
+#include <setjmp.h>
+#include <stdint.h>
+
+#define FLASHIAP_START			0x1000U		///< First emulated flash address, the page 0 can't be mapped on the host.
+#define FLASHIAP_END			0x8000U		///< End of the flash (32 KB).
+#define FLASHIAP_PAGE_SIZE		64U			///< Flash page size [byte].
+#define FLASHIAP_SECTOR_SIZE	1024U		///< Flash sector size [byte].
+
+/**
+ * @brief Operation counters of the model.
+ */
+typedef struct
+{
+	uint32_t writes;			///< Copy RAM to flash commands executed.
+	uint32_t erases;			///< Erase commands executed.
+	uint32_t blankChecks;		///< Blank check commands executed.
+	uint32_t rewrites;			///< Writes over words which were not erased.
+	uint32_t unmasked;			///< IAP calls with the interrupts enabled.
+	uint32_t errors;			///< Commands rejected with an error status.
+}flashiap_stats_t;
+
+/**
+ * @brief Map the flash and install the IAP entry point.
+ */
+void FLASHIAP_Init(void);
+
+/**
+ * @brief Erase the whole emulated flash and clear the counters.
+ */
+void FLASHIAP_Reset(void);
+
+/**
+ * @brief Arm a power loss.
+ * @param operation Number of the write or erase interrupted, '1' for the next one, '0' to disarm.
+ * @param reset Context restored by 'longjmp()' when the power is lost.
+ * @param seed Seed of the pattern left by the interrupted operation.
+ */
+void FLASHIAP_ArmPowerLoss(uint32_t operation, jmp_buf *reset, uint32_t seed);
+
+/**
+ * @brief Get the operation counters.
+ * @return The counters since the last reset.
+ */
+const flashiap_stats_t *FLASHIAP_GetStats(void);
+
+#endif /* FLASH_IAP_H_ */
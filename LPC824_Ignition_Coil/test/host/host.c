@@ -0,0 +1,141 @@
+/**
+ * @file host.c
+ *
+ * @brief Host harness running the firmware modules against emulated peripherals.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The SysTick module is replaced by a millisecond counter driven by the test.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "host.h"
+
+/**
+ * @brief Address range of the target mapped as host memory.
+ */
+typedef struct
+{
+	uint32_t address;	///< Start address.
+	uint32_t size;		///< Size [byte].
+}host_region_t;
+
+static const host_region_t s_peripherals[] = {
+	{0x40000000U, 0x00080000U},		// APB peripherals
+	{0x50000000U, 0x00010000U},		// AHB peripherals: CRC, SCTimer, DMA
+	{0xA0000000U, 0x00008000U},		// GPIO and pin interrupts
+	{0xE000E000U, 0x00001000U},		// System control space: SysTick, NVIC, SCB
+};
+
+volatile uint32_t host_primask;
+uint32_t host_msp;
+volatile uint32_t host_ticks;
+void (*host_idle)(void);
+
+static uint32_t s_checks;		///< Number of checks.
+static uint32_t s_failures;		///< Number of failed checks.
+
+/**
+ * @brief Map a range of the target address space as host memory, filled with a value.
+ * @param address Start address, multiple of the host page size.
+ * @param size Size [byte], multiple of the host page size.
+ * @param fill Value of each byte.
+ * @return Pointer to the mapped range.
+ */
+void *HOST_Map(uint32_t address, uint32_t size, uint8_t fill){
+
+	void *p = mmap((void *)(uintptr_t)address, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+	if(p != (void *)(uintptr_t)address){
+		fprintf(stderr, "host: can't map 0x%08X-0x%08X\n", address, address + size - 1);
+		exit(2);
+	}
+
+	memset(p, fill, size);
+	return p;
+}
+
+/**
+ * @brief Set the registers of all the emulated peripherals back to 0.
+ */
+void HOST_ResetPeripherals(void){
+
+	uint32_t i;
+
+	for(i = 0; i < sizeof(s_peripherals) / sizeof(s_peripherals[0]); i++){
+		memset((void *)(uintptr_t)s_peripherals[i].address, 0, s_peripherals[i].size);
+	}
+}
+
+/**
+ * @brief Map the peripherals before 'main()'.
+ */
+static void __attribute__((constructor)) HOST_Init(void){
+
+	uint32_t i;
+
+	for(i = 0; i < sizeof(s_peripherals) / sizeof(s_peripherals[0]); i++){
+		HOST_Map(s_peripherals[i].address, s_peripherals[i].size, 0);
+	}
+}
+
+/**
+ * @brief Record the result of a check.
+ * @param ok Result of the check.
+ * @param file Source file of the check.
+ * @param line Line of the check.
+ * @param format printf format of the description, followed by its arguments.
+ */
+void HOST_Check(int ok, const char *file, int line, const char *format, ...){
+
+	va_list args;
+
+	s_checks++;
+	if(ok){
+		return;
+	}
+
+	s_failures++;
+	fprintf(stderr, "%s:%d: check failed: ", file, line);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+/**
+ * @brief Print the result of the checks.
+ * @param name Test name.
+ * @return The exit status of the test: '0' if all the checks passed.
+ */
+int HOST_Report(const char *name){
+
+	printf("%s: %u checks, %u failed\n", name, s_checks, s_failures);
+	return s_failures != 0;
+}
+
+/**
+ * @brief Get the current ticks.
+ * @return Current ticks [ms].
+ */
+uint32_t SYSTICK_GetTicks(void){
+
+	if(host_idle){
+		host_idle();
+	}
+	return host_ticks;
+}
+
+/**
+ * @brief Get the time elapsed since the start of the test.
+ * @return Elapsed time [us].
+ */
+uint32_t SYSTICK_GetTime_us(void){
+	return host_ticks * 1000U;
+}
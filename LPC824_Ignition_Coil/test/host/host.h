@@ -0,0 +1,68 @@
+/**
+ * @file host.h
+ *
+ * @brief Host harness running the firmware modules against emulated peripherals.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The peripheral address ranges of the LPC824 are mapped as plain memory at their real addresses
+ * before 'main()', so the firmware sources and the SDK drivers access the registers unchanged.
+ * The behavior of a peripheral (counters, flags cleared on write, transfers) is given by its model,
+ * run by the test between the firmware calls.\n
+ * The tests are linked without position independent code: the static data of the firmware are
+ * below 4 GB, so the addresses stored in 32 bits registers are valid host pointers.
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Check a condition, the failure is printed with its location and the test continues.
+ * @param cond Condition to check.
+ * @param ... printf format and arguments describing the check.
+ */
+#define CHECK(cond, ...)	HOST_Check((cond) != 0, __FILE__, __LINE__, __VA_ARGS__)
+
+/**
+ * @brief Set a register read only for the firmware, as the peripheral would.
+ * @param reg Register.
+ * @param value Value of the register.
+ */
+#define HOST_SET(reg, value)	(*(volatile uint32_t *)&(reg) = (value))
+
+extern volatile uint32_t host_ticks;		///< Value returned by 'SYSTICK_GetTicks()' [ms].
+extern void (*host_idle)(void);			///< Called by 'SYSTICK_GetTicks()', runs the models while the firmware waits.
+
+/**
+ * @brief Map a range of the target address space as host memory, filled with a value.
+ * @param address Start address, multiple of the host page size.
+ * @param size Size [byte], multiple of the host page size.
+ * @param fill Value of each byte.
+ * @return Pointer to the mapped range.
+ */
+void *HOST_Map(uint32_t address, uint32_t size, uint8_t fill);
+
+/**
+ * @brief Set the registers of all the emulated peripherals back to 0.
+ */
+void HOST_ResetPeripherals(void);
+
+/**
+ * @brief Record the result of a check.
+ * @param ok Result of the check.
+ * @param file Source file of the check.
+ * @param line Line of the check.
+ * @param format printf format of the description, followed by its arguments.
+ */
+void HOST_Check(int ok, const char *file, int line, const char *format, ...) __attribute__((format(printf, 4, 5)));
+
+/**
+ * @brief Print the result of the checks.
+ * @param name Test name.
+ * @return The exit status of the test: '0' if all the checks passed.
+ */
+int HOST_Report(const char *name);
+
+#endif /* HOST_H_ */
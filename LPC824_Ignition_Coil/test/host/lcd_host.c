@@ -0,0 +1,153 @@
+/**
+ * @file lcd_host.c
+ *
+ * @brief Host model of the LCD SPI link: the transfers of 'lcd.c' are written as an SPI trace.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Replaces the SPI driver and the LCD DMA queue: each transfer is written at once.
+ */
+
+#include <string.h>
+
+#include "lcd_host.h"
+#include "lcd_dma.h"
+#include "fsl_gpio.h"
+
+#define HALF_BIT_NS		500U		///< Half period of the 1 MHz SPI clock [ns].
+#define GAP_NS			2000U		///< Time between two transactions [ns].
+
+/**
+ * @brief Signals of the logic analyzer export.
+ */
+enum LCDHOST_SIGNAL
+{
+	SIGNAL_SCLK = 0,
+	SIGNAL_MOSI,
+	SIGNAL_SSEL,
+	SIGNAL_CD,
+	SIGNAL_COUNT
+};
+
+static FILE *s_trace;					///< Trace in the 'tools/lcd_emu.py' format.
+static FILE *s_csv;						///< Raw logic analyzer export.
+static uint32_t s_cdPin;				///< GPIO pin of the command/data signal.
+static uint8_t s_levels[SIGNAL_COUNT];	///< Levels of the exported signals.
+static uint64_t s_time;					///< Time of the next edge [ns].
+
+/**
+ * @brief Change a signal of the logic analyzer export, a line is written if its level changes.
+ * @param signal Signal.
+ * @param level New level.
+ * @param delay Time after the edge [ns].
+ */
+static void LCDHOST_Edge(uint32_t signal, uint8_t level, uint32_t delay){
+
+	if(s_levels[signal] != level){
+		s_levels[signal] = level;
+		fprintf(s_csv, "%llu.%09llu,%u,%u,%u,%u\n", (unsigned long long)(s_time / 1000000000U),
+				(unsigned long long)(s_time % 1000000000U), s_levels[SIGNAL_SCLK], s_levels[SIGNAL_MOSI],
+				s_levels[SIGNAL_SSEL], s_levels[SIGNAL_CD]);
+	}
+	s_time += delay;
+}
+
+/**
+ * @brief Write a transaction.
+ * @param data Bytes.
+ * @param size Number of bytes.
+ * @param cd Level of the command/data pin.
+ */
+static void LCDHOST_Transfer(const uint8_t *data, uint32_t size, uint8_t cd){
+
+	uint32_t i;
+	int bit;
+
+	if(s_trace){
+		fputc(cd ? 'D' : 'C', s_trace);
+		for(i = 0; i < size; i++){
+			fprintf(s_trace, " %02x", data[i]);
+		}
+		fputc('\n', s_trace);
+	}
+
+	// SPI mode 0, MSB first: MOSI changes on the falling edges, sampled on the rising ones
+	if(s_csv){
+		LCDHOST_Edge(SIGNAL_CD, cd, HALF_BIT_NS);
+		LCDHOST_Edge(SIGNAL_SSEL, 0, HALF_BIT_NS);
+		for(i = 0; i < size; i++){
+			for(bit = 7; bit >= 0; bit--){
+				LCDHOST_Edge(SIGNAL_MOSI, (data[i] >> bit) & 1, 0);
+				LCDHOST_Edge(SIGNAL_SCLK, 1, HALF_BIT_NS);
+				LCDHOST_Edge(SIGNAL_SCLK, 0, HALF_BIT_NS);
+			}
+		}
+		LCDHOST_Edge(SIGNAL_SSEL, 1, GAP_NS);
+	}
+}
+
+/**
+ * @brief Set the outputs of the transfers.
+ * @param trace Trace in the 'tools/lcd_emu.py' format, 'NULL' for none.
+ * @param csv Raw logic analyzer export, 'NULL' for none.
+ */
+void LCDHOST_SetOutputs(FILE *trace, FILE *csv){
+
+	s_trace = trace;
+	s_csv = csv;
+
+	// Idle levels, the first line gives them all
+	s_time = 0;
+	s_levels[SIGNAL_SCLK] = 0;
+	s_levels[SIGNAL_MOSI] = 0;
+	s_levels[SIGNAL_SSEL] = 0;
+	s_levels[SIGNAL_CD] = 0;
+	if(s_csv){
+		fprintf(s_csv, "Time [s],SCLK,MOSI,SSEL,CD\n");
+		LCDHOST_Edge(SIGNAL_SSEL, 1, GAP_NS);
+	}
+}
+
+/**
+ * @brief Start an operation of the trace, the following transactions are counted in it.
+ * @param label Name of the operation.
+ */
+void LCDHOST_Label(const char *label){
+
+	if(s_trace){
+		fprintf(s_trace, "# %s\n", label);
+	}
+}
+
+void SPI_MasterGetDefaultConfig(spi_master_config_t *config){
+	memset(config, 0, sizeof(*config));
+}
+
+status_t SPI_MasterInit(SPI_Type *base, const spi_master_config_t *config, uint32_t srcClock_Hz){
+	return kStatus_Success;
+}
+
+status_t SPI_MasterTransferBlocking(SPI_Type *base, spi_transfer_t *xfer){
+
+	LCDHOST_Transfer(xfer->txData, xfer->dataSize, GPIO->B[0][s_cdPin]);
+	return kStatus_Success;
+}
+
+void LCDDMA_Init(SPI_Type *base, uint32_t cdPin){
+	s_cdPin = cdPin;
+}
+
+status_t LCDDMA_Send(const uint8_t *data, uint32_t size, uint8_t cd){
+
+	if(size == 0 || size > LCDDMA_MAX_TRANSFER * (LCDDMA_MAX_LINKS + 1)){
+		return kStatus_InvalidArgument;
+	}
+
+	// The interrupt of the previous segment leaves the pin at the level of this one
+	GPIO_PinWrite(GPIO, 0, s_cdPin, cd);
+	LCDHOST_Transfer(data, size, cd);
+	return kStatus_Success;
+}
+
+void LCDDMA_Wait(void){
+}
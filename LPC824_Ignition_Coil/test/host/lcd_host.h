@@ -0,0 +1,35 @@
+/**
+ * @file lcd_host.h
+ *
+ * @brief Host model of the LCD SPI link: the transfers of 'lcd.c' are written as an SPI trace.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The blocking SPI transfers and the DMA segments are recorded in the trace format of
+ * 'tools/lcd_emu.py', one transaction per line with the level of the command/data pin. The DMA
+ * queue is sent as soon as a segment is queued: on the target 'LCDDMA_Wait()' is called before
+ * each blocking transfer, so the order of the bytes is the same.\n
+ * The same transfers can be written as the raw CSV export of a logic analyzer (one line per edge of
+ * SCLK, MOSI, SSEL and CD, SPI mode 0 at the 1 MHz of 'LCD_InitStart()'), the input of
+ * 'tools/la2trace.py'. The chip select is released after each transaction.
+ */
+
+#ifndef LCD_HOST_H_
+#define LCD_HOST_H_
+
+#include <stdio.h>
+
+/**
+ * @brief Set the outputs of the transfers.
+ * @param trace Trace in the 'tools/lcd_emu.py' format, 'NULL' for none.
+ * @param csv Raw logic analyzer export, 'NULL' for none.
+ */
+void LCDHOST_SetOutputs(FILE *trace, FILE *csv);
+
+/**
+ * @brief Start an operation of the trace, the following transactions are counted in it.
+ * @param label Name of the operation.
+ */
+void LCDHOST_Label(const char *label);
+
+#endif /* LCD_HOST_H_ */
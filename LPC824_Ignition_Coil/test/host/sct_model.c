@@ -0,0 +1,429 @@
+/**
+ * @file sct_model.c
+ *
+ * @brief Host model of the SCTimer in unified 32-bit counter mode.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * On each counter tick the events enabled in the current state are evaluated on the counter
+ * value, then their actions are applied and the counter moves to its next value: 0 after a limit
+ * event (the match registers are reloaded), unchanged after a halt event, else the next value.
+ * Between two ticks with events the counter value is computed directly.\n
+ * When several events of the same tick change the state, the highest numbered event wins. The
+ * event flags are all cleared by the interrupt handler, as 'SCTIMER_EventHandleIRQ()' does.
+ */
+
+#include "sct_model.h"
+#include "host.h"
+#include "fsl_sctimer.h"
+
+#define EVENT_COUNT		FSL_FEATURE_SCT_NUMBER_OF_EVENTS
+#define OUTPUT_COUNT	FSL_FEATURE_SCT_NUMBER_OF_OUTPUTS
+#define REG_COUNT		FSL_FEATURE_SCT_NUMBER_OF_MATCH_CAPTURE
+
+#define IOCOND_LOW		0U		///< Input or output low.
+#define IOCOND_RISE		1U		///< Rising edge.
+#define IOCOND_FALL		2U		///< Falling edge.
+#define IOCOND_HIGH		3U		///< Input or output high.
+
+#define COMBMODE_OR		0U		///< Match or I/O condition.
+#define COMBMODE_MATCH	1U		///< Match only.
+#define COMBMODE_IO		2U		///< I/O condition only.
+#define COMBMODE_AND	3U		///< Match and I/O condition.
+
+void SCT0_DriverIRQHandler(void);
+
+static uint64_t s_time;					///< Time since the reset [tick].
+static uint32_t s_inputs;				///< Input levels.
+static uint32_t s_lastInputs;			///< Input levels seen by the last tick.
+static uint32_t s_lastOutputs;			///< Output levels seen by the last tick.
+static uint32_t s_outputs;				///< Output levels reported to the observer.
+static sctmodel_output_t s_onOutput;	///< Output observer.
+static sctmodel_event_t s_onEvent;		///< Event observer.
+
+/**
+ * @brief Report the output changes since the last report.
+ */
+static void SCTMODEL_ReportOutputs(void){
+
+	uint32_t changed = SCT0->OUTPUT ^ s_outputs;
+	uint32_t i;
+
+	s_outputs = SCT0->OUTPUT;
+	for(i = 0; i < OUTPUT_COUNT && s_onOutput; i++){
+		if(changed & (1U << i)){
+			s_onOutput(i, (s_outputs >> i) & 1U, s_time);
+		}
+	}
+}
+
+/**
+ * @brief Evaluate the I/O condition of an event.
+ * @param ctrl Event control register.
+ * @return '1' if the condition is true.
+ */
+static uint8_t SCTMODEL_IoCondition(uint32_t ctrl){
+
+	uint32_t sel = (ctrl & SCT_EVENT_CTRL_IOSEL_MASK) >> SCT_EVENT_CTRL_IOSEL_SHIFT;
+	uint32_t now = (ctrl & SCT_EVENT_CTRL_OUTSEL_MASK) ? SCT0->OUTPUT : s_inputs;
+	uint32_t last = (ctrl & SCT_EVENT_CTRL_OUTSEL_MASK) ? s_lastOutputs : s_lastInputs;
+	uint8_t level = (now >> sel) & 1U;
+	uint8_t lastLevel = (last >> sel) & 1U;
+
+	switch((ctrl & SCT_EVENT_CTRL_IOCOND_MASK) >> SCT_EVENT_CTRL_IOCOND_SHIFT){
+	case IOCOND_LOW:
+		return !level;
+	case IOCOND_RISE:
+		return level && !lastLevel;
+	case IOCOND_FALL:
+		return !level && lastLevel;
+	default:
+		return level;
+	}
+}
+
+/**
+ * @brief Evaluate the match condition of an event on the counter value.
+ * @param ctrl Event control register.
+ * @return '1' if the condition is true.
+ */
+static uint8_t SCTMODEL_MatchCondition(uint32_t ctrl){
+
+	uint32_t reg = ctrl & SCT_EVENT_CTRL_MATCHSEL_MASK;
+
+	// A register in capture mode doesn't match
+	if(reg >= REG_COUNT || (SCT0->REGMODE & (1U << reg))){
+		return 0;
+	}
+	if(ctrl & SCT_EVENT_CTRL_MATCHMEM_MASK){
+		return SCT0->COUNT >= SCT0->SCTMATCH[reg];
+	}
+	return SCT0->COUNT == SCT0->SCTMATCH[reg];
+}
+
+/**
+ * @brief Events of the current tick.
+ * @param running '0' if the counter is stopped: only the I/O conditions are evaluated.
+ * @return Mask of the events.
+ */
+static uint32_t SCTMODEL_Events(uint8_t running){
+
+	uint32_t events = 0;
+	uint32_t ctrl;
+	uint8_t match;
+	uint32_t e;
+
+	for(e = 0; e < EVENT_COUNT; e++){
+
+		if(SCT0->STATE >= 32 || !(SCT0->EVENT[e].STATE & (1U << SCT0->STATE))){
+			continue;
+		}
+
+		ctrl = SCT0->EVENT[e].CTRL;
+		match = running && SCTMODEL_MatchCondition(ctrl);
+
+		switch((ctrl & SCT_EVENT_CTRL_COMBMODE_MASK) >> SCT_EVENT_CTRL_COMBMODE_SHIFT){
+		case COMBMODE_OR:
+			match = match || SCTMODEL_IoCondition(ctrl);
+			break;
+		case COMBMODE_MATCH:
+			break;
+		case COMBMODE_IO:
+			match = SCTMODEL_IoCondition(ctrl);
+			break;
+		default:
+			match = match && SCTMODEL_IoCondition(ctrl);
+			break;
+		}
+
+		if(match){
+			events |= 1U << e;
+		}
+	}
+	return events;
+}
+
+/**
+ * @brief Apply the output, state and capture actions of events.
+ * @param events Mask of the events.
+ */
+static void SCTMODEL_Actions(uint32_t events){
+
+	uint32_t output = SCT0->OUTPUT;
+	uint32_t set, clear;
+	uint32_t i;
+	int32_t e;
+
+	for(i = 0; i < REG_COUNT; i++){
+		if((SCT0->REGMODE & (1U << i)) && (SCT0->SCTCAPCTRL[i] & events)){
+			SCT0->SCTCAP[i] = SCT0->COUNT;
+		}
+	}
+
+	for(i = 0; i < OUTPUT_COUNT; i++){
+		set = SCT0->OUT[i].SET & events;
+		clear = SCT0->OUT[i].CLR & events;
+
+		if(set && clear){
+			switch((SCT0->RES >> (2 * i)) & 3U){
+			case 1:
+				output |= 1U << i;
+				break;
+			case 2:
+				output &= ~(1U << i);
+				break;
+			case 3:
+				output ^= 1U << i;
+				break;
+			default:
+				break;
+			}
+		}
+		else if(set){
+			output |= 1U << i;
+		}
+		else if(clear){
+			output &= ~(1U << i);
+		}
+	}
+	SCT0->OUTPUT = output;
+
+	for(e = EVENT_COUNT - 1; e >= 0; e--){
+		if(events & (1U << e)){
+			uint32_t ctrl = SCT0->EVENT[e].CTRL;
+			uint32_t value = (ctrl & SCT_EVENT_CTRL_STATEV_MASK) >> SCT_EVENT_CTRL_STATEV_SHIFT;
+
+			SCT0->STATE = (ctrl & SCT_EVENT_CTRL_STATELD_MASK) ? value : (SCT0->STATE + value) & 0x1FU;
+			break;
+		}
+	}
+
+	if(events & SCT0->HALT){
+		SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	}
+	if(events & SCT0->STOP){
+		SCT0->CTRL |= SCT_CTRL_STOP_L_MASK;
+	}
+	if(events & SCT0->START){
+		SCT0->CTRL &= ~SCT_CTRL_STOP_L_MASK;
+	}
+}
+
+/**
+ * @brief Load the match registers from their reload registers.
+ */
+static void SCTMODEL_Reload(void){
+
+	uint32_t i;
+
+	if(SCT0->CONFIG & SCT_CONFIG_NORELAOD_L_MASK){
+		return;
+	}
+	for(i = 0; i < REG_COUNT; i++){
+		if(!(SCT0->REGMODE & (1U << i))){
+			SCT0->SCTMATCH[i] = SCT0->SCTMATCHREL[i];
+		}
+	}
+}
+
+/**
+ * @brief Run one counter tick.
+ * @return The events of the tick.
+ */
+static uint32_t SCTMODEL_Step(void){
+
+	uint32_t events = 0;
+	uint8_t running;
+	uint8_t halted;
+
+	if(SCT0->CTRL & SCT_CTRL_CLRCTR_L_MASK){
+		SCT0->COUNT = 0;
+		SCT0->CTRL &= ~SCT_CTRL_CLRCTR_L_MASK;
+	}
+
+	running = !(SCT0->CTRL & (SCT_CTRL_HALT_L_MASK | SCT_CTRL_STOP_L_MASK));
+	if(!(SCT0->CTRL & SCT_CTRL_HALT_L_MASK)){
+		events = SCTMODEL_Events(running);
+	}
+
+	s_lastInputs = s_inputs;
+	s_lastOutputs = SCT0->OUTPUT;
+
+	if(events){
+		SCTMODEL_Actions(events);
+		if(s_onEvent){
+			s_onEvent(events, s_time);
+		}
+		SCTMODEL_ReportOutputs();
+	}
+
+	halted = (SCT0->CTRL & (SCT_CTRL_HALT_L_MASK | SCT_CTRL_STOP_L_MASK)) != 0;
+	if(running && (events & SCT0->LIMIT)){
+		SCT0->COUNT = 0;
+		SCTMODEL_Reload();
+	}
+	else if(running && !halted){
+		if(++SCT0->COUNT == 0){
+			SCTMODEL_Reload();
+		}
+	}
+	s_time++;
+
+	SCT0->EVFLAG |= events;
+	if((SCT0->EVFLAG & SCT0->EVEN) && !host_primask){
+		SCT0_DriverIRQHandler();
+		SCT0->EVFLAG = 0;
+		SCTMODEL_ReportOutputs();
+	}
+
+	return events;
+}
+
+/**
+ * @brief Move to the next tick which can have events, without passing a time.
+ * @param end Time not to pass [tick].
+ */
+static void SCTMODEL_Skip(uint64_t end){
+
+	uint64_t skip = end - s_time;
+	uint32_t count = SCT0->COUNT;
+	uint32_t ctrl, reg, comb;
+	uint32_t e;
+
+	// An edge is seen by the next tick
+	if(s_inputs != s_lastInputs || SCT0->OUTPUT != s_lastOutputs || (SCT0->CTRL & SCT_CTRL_CLRCTR_L_MASK)){
+		return;
+	}
+
+	if(SCT0->CTRL & SCT_CTRL_HALT_L_MASK){
+		s_time = end;
+		return;
+	}
+
+	// The wrap of the counter reloads the match registers
+	if(!(SCT0->CTRL & SCT_CTRL_STOP_L_MASK) && skip > 0xFFFFFFFFU - count){
+		skip = 0xFFFFFFFFU - count;
+	}
+
+	for(e = 0; e < EVENT_COUNT && skip; e++){
+
+		if(SCT0->STATE >= 32 || !(SCT0->EVENT[e].STATE & (1U << SCT0->STATE))){
+			continue;
+		}
+
+		ctrl = SCT0->EVENT[e].CTRL;
+		reg = ctrl & SCT_EVENT_CTRL_MATCHSEL_MASK;
+		comb = (ctrl & SCT_EVENT_CTRL_COMBMODE_MASK) >> SCT_EVENT_CTRL_COMBMODE_SHIFT;
+
+		// A level condition is true on each tick
+		if((comb == COMBMODE_OR || comb == COMBMODE_IO) && SCTMODEL_IoCondition(ctrl)){
+			return;
+		}
+		if(comb == COMBMODE_IO || (SCT0->CTRL & SCT_CTRL_STOP_L_MASK) || reg >= REG_COUNT ||
+				(SCT0->REGMODE & (1U << reg))){
+			continue;
+		}
+
+		if(SCT0->SCTMATCH[reg] >= count){
+			if(SCT0->SCTMATCH[reg] - count < skip){
+				skip = SCT0->SCTMATCH[reg] - count;
+			}
+		}
+		else if(ctrl & SCT_EVENT_CTRL_MATCHMEM_MASK){
+			return;
+		}
+	}
+
+	s_time += skip;
+	if(!(SCT0->CTRL & SCT_CTRL_STOP_L_MASK)){
+		SCT0->COUNT = count + skip;
+	}
+}
+
+/**
+ * @brief Reset the model: time 0, inputs low, no observer.
+ * The registers are not changed.
+ */
+void SCTMODEL_Reset(void){
+
+	s_time = 0;
+	s_inputs = 0;
+	s_lastInputs = 0;
+	s_lastOutputs = SCT0->OUTPUT;
+	s_outputs = SCT0->OUTPUT;
+	s_onOutput = NULL;
+	s_onEvent = NULL;
+	HOST_SET(SCT0->INPUT, 0);
+}
+
+/**
+ * @brief Set the observers of the outputs and of the events.
+ * @param output Called on each output change, 'NULL' for none.
+ * @param event Called on each counter tick with events, 'NULL' for none.
+ */
+void SCTMODEL_SetObservers(sctmodel_output_t output, sctmodel_event_t event){
+
+	s_outputs = SCT0->OUTPUT;
+	s_onOutput = output;
+	s_onEvent = event;
+}
+
+/**
+ * @brief Run the counter until the next tick with events.
+ * @param maxTicks Maximum number of ticks to run.
+ * @return The events of the tick, '0' if none occurred.
+ */
+uint32_t SCTMODEL_RunToEvent(uint64_t maxTicks){
+
+	uint64_t end = s_time + maxTicks;
+	uint32_t events;
+
+	// Outputs written by the firmware
+	SCTMODEL_ReportOutputs();
+
+	while(s_time < end){
+		events = SCTMODEL_Step();
+		if(events){
+			return events;
+		}
+		SCTMODEL_Skip(end);
+	}
+	return 0;
+}
+
+/**
+ * @brief Run the counter.
+ * @param ticks Number of counter ticks (SCTimer clock divided by the prescaler).
+ */
+void SCTMODEL_Run(uint64_t ticks){
+
+	uint64_t end = s_time + ticks;
+
+	while(s_time < end){
+		SCTMODEL_RunToEvent(end - s_time);
+	}
+}
+
+/**
+ * @brief Set the level of an input, the edge is seen by the next counter tick.
+ * @param input Input number.
+ * @param level New level.
+ */
+void SCTMODEL_SetInput(uint32_t input, uint8_t level){
+
+	if(level){
+		s_inputs |= 1U << input;
+	}
+	else{
+		s_inputs &= ~(1U << input);
+	}
+	HOST_SET(SCT0->INPUT, s_inputs);
+}
+
+/**
+ * @brief Get the time since the reset.
+ * @return The time [tick].
+ */
+uint64_t SCTMODEL_GetTime(void){
+	return s_time;
+}
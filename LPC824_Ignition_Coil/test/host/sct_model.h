@@ -0,0 +1,78 @@
+/**
+ * @file sct_model.h
+ *
+ * @brief Host model of the SCTimer in unified 32-bit counter mode.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The model reads the SCTimer registers configured by the firmware and runs the counter, the
+ * events (match, input and output conditions in the enabled states), the limit, halt, stop and
+ * start actions, the state changes, the captures, the match reloads and the outputs. The event
+ * interrupt calls the real driver handler, so the callbacks of the firmware run between two
+ * counter ticks as on the target (the interrupt latency is not modelled).\n
+ * Time only advances in 'SCTMODEL_Run()', from one event to the next: a simulation of several
+ * minutes costs a few operations per event, not per tick.\n
+ * Not modelled: the 16-bit split mode, the bidirectional counting, the input synchronisation
+ * delay and the DMA requests.
+ */
+
+#ifndef SCT_MODEL_H_
+#define SCT_MODEL_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Called when an output changes.
+ * @param output Output number.
+ * @param level New level.
+ * @param time Time of the change [tick].
+ */
+typedef void (*sctmodel_output_t)(uint32_t output, uint8_t level, uint64_t time);
+
+/**
+ * @brief Called when events occur, before the interrupt handler.
+ * @param events Mask of the events.
+ * @param time Time of the events [tick].
+ */
+typedef void (*sctmodel_event_t)(uint32_t events, uint64_t time);
+
+/**
+ * @brief Reset the model: time 0, inputs low, no observer.
+ * The registers are not changed.
+ */
+void SCTMODEL_Reset(void);
+
+/**
+ * @brief Set the observers of the outputs and of the events.
+ * @param output Called on each output change, 'NULL' for none.
+ * @param event Called on each counter tick with events, 'NULL' for none.
+ */
+void SCTMODEL_SetObservers(sctmodel_output_t output, sctmodel_event_t event);
+
+/**
+ * @brief Run the counter.
+ * @param ticks Number of counter ticks (SCTimer clock divided by the prescaler).
+ */
+void SCTMODEL_Run(uint64_t ticks);
+
+/**
+ * @brief Run the counter until the next tick with events.
+ * @param maxTicks Maximum number of ticks to run.
+ * @return The events of the tick, '0' if none occurred.
+ */
+uint32_t SCTMODEL_RunToEvent(uint64_t maxTicks);
+
+/**
+ * @brief Set the level of an input, the edge is seen by the next counter tick.
+ * @param input Input number.
+ * @param level New level.
+ */
+void SCTMODEL_SetInput(uint32_t input, uint8_t level);
+
+/**
+ * @brief Get the time since the reset.
+ * @return The time [tick].
+ */
+uint64_t SCTMODEL_GetTime(void);
+
+#endif /* SCT_MODEL_H_ */
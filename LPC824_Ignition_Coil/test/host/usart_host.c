@@ -0,0 +1,78 @@
+/**
+ * @file usart_host.c
+ *
+ * @brief Host model of the telemetry USART.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The interrupt enable clear register has no effect on plain memory: it is applied to the
+ * enable set register after each call of the handler.
+ */
+
+#include "usart_host.h"
+#include "host.h"
+#include "telemetry.h"
+
+void USART0_IRQHandler(void);
+
+/**
+ * @brief Call the USART interrupt handler with a status.
+ * @param status Status flags presented to the handler.
+ */
+static void USARTHOST_Interrupt(uint32_t status){
+
+	TELEMETRY_USART->STAT = status;
+	USART0_IRQHandler();
+
+	TELEMETRY_USART->INTENSET &= ~TELEMETRY_USART->INTENCLR;
+	TELEMETRY_USART->INTENCLR = 0;
+	TELEMETRY_USART->STAT = 0;
+}
+
+/**
+ * @brief Receive a line: each char and the end of line go through the USART interrupt.
+ * @param line Line to receive, without end of line.
+ */
+void USARTHOST_Receive(const char *line){
+
+	do{
+		HOST_SET(TELEMETRY_USART->RXDAT, *line ? (uint8_t)*line : '\n');
+		USARTHOST_Interrupt(USART_STAT_RXRDY_MASK);
+	}while(*line++);
+}
+
+/**
+ * @brief Send the queued bytes through the USART interrupt.
+ * @param buffer Buffer where the bytes are stored, null terminated.
+ * @param size Size of the buffer [byte].
+ * @return The number of bytes stored.
+ */
+uint32_t USARTHOST_Transmit(char *buffer, uint32_t size){
+
+	uint32_t length = 0;
+
+	while(TELEMETRY_USART->INTENSET & USART_INTENSET_TXRDYEN_MASK){
+		TELEMETRY_USART->TXDAT = 0xFFFFFFFFU;
+		USARTHOST_Interrupt(USART_STAT_TXRDY_MASK);
+		if(TELEMETRY_USART->TXDAT != 0xFFFFFFFFU && length + 1 < size){
+			buffer[length++] = TELEMETRY_USART->TXDAT;
+		}
+	}
+
+	buffer[length] = '\0';
+	return length;
+}
+
+/**
+ * @brief Receive a command line, dispatch it and collect the answer.
+ * @param line Command line.
+ * @param buffer Buffer where the answer is stored, null terminated.
+ * @param size Size of the buffer [byte].
+ * @return The number of bytes stored.
+ */
+uint32_t USARTHOST_Command(const char *line, char *buffer, uint32_t size){
+
+	USARTHOST_Receive(line);
+	TELEMETRY_Process();
+	return USARTHOST_Transmit(buffer, size);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file usart_host.h
+ *
+ * @brief Host model of the telemetry USART.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The received chars and the transmit ready flag are presented to the real USART interrupt
+ * handler of the telemetry module, the bytes it writes are collected.
+ */
+
+#ifndef USART_HOST_H_
+#define USART_HOST_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Receive a line: each char and the end of line go through the USART interrupt.
+ * @param line Line to receive, without end of line.
+ */
+void USARTHOST_Receive(const char *line);
+
+/**
+ * @brief Send the queued bytes through the USART interrupt.
+ * @param buffer Buffer where the bytes are stored, null terminated.
+ * @param size Size of the buffer [byte].
+ * @return The number of bytes stored.
+ */
+uint32_t USARTHOST_Transmit(char *buffer, uint32_t size);
+
+/**
+ * @brief Receive a command line, dispatch it and collect the answer.
+ * @param line Command line.
+ * @param buffer Buffer where the answer is stored, null terminated.
+ * @param size Size of the buffer [byte].
+ * @return The number of bytes stored.
+ */
+uint32_t USARTHOST_Command(const char *line, char *buffer, uint32_t size);
+
+#endif /* USART_HOST_H_ */
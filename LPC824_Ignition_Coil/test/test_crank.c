@@ -0,0 +1,175 @@
+/**
+ * @file test_crank.c
+ *
+ * @brief Host test of the crank trigger mode on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Simulated crank edges drive the SCTimer input, the advance is updated after each edge as the
+ * main loop does. Each pulse must start a fixed number of ticks after its crank edge: the delay
+ * programmed from the previous captured period plus the one tick of the counter restart, whatever
+ * the firmware does between the edges. The captured period must give the crank period, and no
+ * pulse may follow a stopped crank.
+ */
+
+#include "host.h"
+#include "sct_model.h"
+#include "ignition_pulse.h"
+
+#define SCT_CLOCK_HZ	30000000U			///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define CRANK_INPUT		kSCTIMER_Input_0
+#define PULSE_WIDTH_US	1000U				///< Pulse width [us].
+#define TRIGGER_CDEG	6000U				///< Angle of the crank edge before the top dead center [1/100 degree].
+
+static uint32_t s_event;		///< Crank input event.
+static uint64_t s_edge;			///< Time of the last crank edge [tick].
+static uint64_t s_rise;			///< Time of the last pulse start [tick].
+static uint32_t s_pulses;		///< Pulses since the last crank edge.
+static uint32_t s_width;		///< Width of the last pulse [tick].
+
+/**
+ * @brief Record the pulses.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+	if(level){
+		s_rise = time;
+		s_pulses++;
+	}
+	else{
+		s_width = time - s_rise;
+	}
+}
+
+/**
+ * @brief Captured crank period.
+ * @return The capture register of the crank event [tick].
+ */
+static uint32_t CapturedPeriod(void){
+
+	uint32_t reg = 0;
+
+	while(!(SCT0->REGMODE & (1U << reg))){
+		reg++;
+	}
+	return SCT0->SCTCAP[reg];
+}
+
+/**
+ * @brief Simulate one crank revolution: edge, main loop update, then the rest of the period.
+ * @param period Revolution period [tick].
+ * @param advance_cdeg Advance given to the update [1/100 degree], negative after the top dead center.
+ * @param delay Delay programmed before the edge, '0' if no pulse is expected [tick].
+ * @return The delay programmed by the update for the next edge [tick].
+ */
+static uint32_t Revolution(uint32_t period, int32_t advance_cdeg, uint32_t delay){
+
+	uint32_t width = (uint64_t)PULSE_WIDTH_US * SCT_CLOCK_HZ / 1000000U;
+	uint32_t next = 0;
+	uint32_t captured;
+
+	s_pulses = 0;
+	s_edge = SCTMODEL_GetTime();
+	SCTMODEL_SetInput(CRANK_INPUT, 1);
+	SCTMODEL_Run(period / 2);
+	SCTMODEL_SetInput(CRANK_INPUT, 0);
+
+	if(delay){
+		CHECK(s_pulses == 1, "one pulse per edge (%u)", s_pulses);
+		CHECK(s_rise - s_edge == delay + 1, "pulse %llu ticks after the edge, expected %u",
+				(unsigned long long)(s_rise - s_edge), delay + 1);
+		CHECK(s_width == width, "pulse width %u ticks, expected %u", s_width, width);
+	}
+	else{
+		CHECK(s_pulses == 0, "no pulse without delay");
+	}
+
+	// The counter restarts on the tick following the edge
+	captured = CapturedPeriod();
+	if(IPULSE_UpdateCrankAdvance(SCT0, s_event, TRIGGER_CDEG, advance_cdeg) == kStatus_Success){
+		next = (uint64_t)captured * (uint32_t)((int32_t)TRIGGER_CDEG - advance_cdeg) / 36000U;
+	}
+
+	SCTMODEL_Run(period - period / 2);
+	return next;
+}
+
+/**
+ * @brief Crank edges at a steady speed, then a ramp, then a stop.
+ * @param rpm Crank speed [rpm].
+ */
+static void TestCrank(uint32_t rpm){
+
+	sctimer_config_t config;
+	uint32_t period = 60ULL * SCT_CLOCK_HZ / rpm;
+	uint32_t delay = 0;
+	uint32_t n;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+
+	CHECK(IPULSE_SetupCrankTrigger(SCT0, PULSE_WIDTH_US, SCT_CLOCK_HZ, CRANK_INPUT, PULSE_OUTPUT, &s_event) ==
+			kStatus_Success, "%u rpm: crank trigger configured", rpm);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+
+	// No interrupt between the edge and the pulse
+	CHECK(SCT0->EVEN == 0, "%u rpm: no event interrupt (EVEN 0x%X)", rpm, SCT0->EVEN);
+
+	// The first edge starts the measure, the second one gives the first period
+	Revolution(period, 1000, 0);
+	delay = Revolution(period, 1000, 0);
+	CHECK(delay && CapturedPeriod() == period - 1, "%u rpm: captured %u ticks", rpm, CapturedPeriod());
+	CHECK(IPULSE_GetCrankPeriod_us(SCT0, SCT_CLOCK_HZ, s_event) == (uint64_t)(period - 1) * 1000000U / SCT_CLOCK_HZ,
+			"%u rpm: period %u us", rpm, IPULSE_GetCrankPeriod_us(SCT0, SCT_CLOCK_HZ, s_event));
+
+	for(n = 0; n < 50; n++){
+		delay = Revolution(period, 1000, delay);
+	}
+
+	// Acceleration and advance change: the pulse uses the delay programmed before its edge
+	for(n = 0; n < 50; n++){
+		period -= period / 50;
+		delay = Revolution(period, 1000 + n * 20, delay);
+	}
+
+	// Spark after the top dead center
+	delay = Revolution(period, -1500, delay);
+	delay = Revolution(period, 1000, delay);
+
+	// Advance past the crank edge: the pulses stop, then restart with the next valid advance
+	Revolution(period, TRIGGER_CDEG, delay);
+	delay = Revolution(period, 1000, 0);
+	Revolution(period, 1000, delay);
+
+	// Crank stopped: no pulse and no period
+	SCTMODEL_Run(3ULL * period);
+	CHECK(IPULSE_GetCrankPeriod_us(SCT0, SCT_CLOCK_HZ, s_event) == 0, "%u rpm: stopped crank has no period", rpm);
+	CHECK(IPULSE_UpdateCrankAdvance(SCT0, s_event, TRIGGER_CDEG, 1000) == kStatus_InvalidArgument,
+			"%u rpm: no pulse scheduled on a stopped crank", rpm);
+	n = s_pulses;
+	s_edge = SCTMODEL_GetTime();
+	SCTMODEL_SetInput(CRANK_INPUT, 1);
+	SCTMODEL_Run(period);
+	SCTMODEL_SetInput(CRANK_INPUT, 0);
+	CHECK(s_pulses == n, "%u rpm: no pulse on the first edge after a stop", rpm);
+
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, s_event);
+}
+
+int main(void){
+
+	TestCrank(600);
+	TestCrank(3000);
+	TestCrank(9000);
+
+	return HOST_Report("test_crank");
+}
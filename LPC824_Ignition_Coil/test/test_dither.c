@@ -0,0 +1,175 @@
+/**
+ * @file test_dither.c
+ *
+ * @brief Host test of the period dithering on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pulse is configured by 'IPULSE_SetupPulse()' and 'IPULSE_EnableDithering()', the SCTimer model
+ * runs it for thousands of periods and the period callback runs from the real interrupt handler. The
+ * periods are measured between the rising edges of the output: the average frequency must be exact
+ * to a fraction of a ppm, each period must be N or N+1 ticks and two consecutive periods must not
+ * differ by more than one tick.
+ */
+
+#include <math.h>
+
+#include "host.h"
+#include "sct_model.h"
+#include "ignition_pulse.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define PULSE_WIDTH_US	100U		///< Pulse width [us].
+#define PERIOD_COUNT	20000U		///< Periods measured per frequency.
+
+/**
+ * @brief Periods measured on the output.
+ */
+typedef struct{
+	uint64_t firstRise;		///< Time of the first measured rising edge [tick].
+	uint64_t lastRise;		///< Time of the last rising edge [tick].
+	uint64_t lastFall;		///< Time of the last falling edge [tick].
+	uint32_t rises;			///< Number of rising edges.
+	uint32_t lastPeriod;	///< Last period [tick].
+	uint32_t minPeriod;		///< Shortest period [tick].
+	uint32_t maxPeriod;		///< Longest period [tick].
+	uint32_t maxStep;		///< Largest difference between two consecutive periods [tick].
+	uint32_t minWidth;		///< Shortest pulse [tick].
+	uint32_t maxWidth;		///< Longest pulse [tick].
+} measure_t;
+
+static measure_t s_measure;
+
+/**
+ * @brief Record the edges of the pulse output.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	measure_t *m = &s_measure;
+	uint32_t period, width;
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+
+	if(!level){
+		if(m->rises){
+			width = time - m->lastRise;
+			m->minWidth = width < m->minWidth ? width : m->minWidth;
+			m->maxWidth = width > m->maxWidth ? width : m->maxWidth;
+		}
+		m->lastFall = time;
+		return;
+	}
+
+	// The first period after the start isn't dithered yet
+	if(m->rises >= 2){
+		period = time - m->lastRise;
+		m->minPeriod = period < m->minPeriod ? period : m->minPeriod;
+		m->maxPeriod = period > m->maxPeriod ? period : m->maxPeriod;
+		if(m->rises >= 3){
+			uint32_t step = period > m->lastPeriod ? period - m->lastPeriod : m->lastPeriod - period;
+			m->maxStep = step > m->maxStep ? step : m->maxStep;
+		}
+		m->lastPeriod = period;
+	}
+	else if(m->rises == 1){
+		m->firstRise = time;
+	}
+
+	m->lastRise = time;
+	m->rises++;
+}
+
+/**
+ * @brief Run a pulse and measure its periods.
+ * @param freq_mHz Pulse frequency [mHz].
+ * @param dither '1' to enable the dithering.
+ * @return The average frequency error [ppm].
+ */
+static double RunPulse(uint32_t freq_mHz, uint8_t dither){
+
+	sctimer_config_t config;
+	uint32_t event;
+	uint64_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	double freq;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+
+	s_measure = (measure_t){.minPeriod = UINT32_MAX, .minWidth = UINT32_MAX};
+
+	CHECK(IPULSE_SetupPulse(SCT0, PULSE_WIDTH_US, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event) == kStatus_Success,
+			"%u mHz pulse configured", freq_mHz);
+	IPULSE_EnableDithering(SCT0, SCT_CLOCK_HZ, freq_mHz, event, dither);
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+
+	SCTMODEL_Run(period * (PERIOD_COUNT + 2));
+	IPULSE_EnableDithering(SCT0, SCT_CLOCK_HZ, freq_mHz, event, 0);
+
+	CHECK(s_measure.rises >= PERIOD_COUNT, "%u mHz: %u pulses", freq_mHz, s_measure.rises);
+
+	freq = (double)(s_measure.rises - 2) * SCT_CLOCK_HZ * 1000.0 / (double)(s_measure.lastRise - s_measure.firstRise);
+	return (freq - freq_mHz) * 1e6 / freq_mHz;
+}
+
+/**
+ * @brief Dithered pulse: exact average frequency and one tick of jitter.
+ * @param freq_mHz Pulse frequency [mHz].
+ */
+static void TestDither(uint32_t freq_mHz){
+
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t width = (uint64_t)PULSE_WIDTH_US * SCT_CLOCK_HZ / 1000000U;
+	uint8_t exact = (uint64_t)SCT_CLOCK_HZ * 1000U % freq_mHz == 0;
+	double error = RunPulse(freq_mHz, 1);
+
+	// One period of remainder at most over the measure
+	CHECK(fabs(error) < 1e6 / PERIOD_COUNT / period + 0.01, "%u mHz: average error %.4f ppm", freq_mHz, error);
+	CHECK(s_measure.minPeriod == period && s_measure.maxPeriod == period + !exact,
+			"%u mHz: periods %u to %u ticks, expected %u to %u", freq_mHz, s_measure.minPeriod, s_measure.maxPeriod,
+			period, period + !exact);
+	CHECK(s_measure.maxStep <= 1, "%u mHz: %u ticks between two consecutive periods", freq_mHz, s_measure.maxStep);
+
+	// The output is set on the limit and cleared on the width match of the next counter run
+	CHECK(s_measure.minWidth == width + 1 && s_measure.maxWidth == width + 1, "%u mHz: pulse %u to %u ticks",
+			freq_mHz, s_measure.minWidth, s_measure.maxWidth);
+}
+
+/**
+ * @brief Truncated period: the error is the truncated remainder, no jitter.
+ * @param freq_mHz Pulse frequency [mHz].
+ */
+static void TestTruncated(uint32_t freq_mHz){
+
+	uint64_t t = (uint64_t)SCT_CLOCK_HZ * 1000U;
+	double error = RunPulse(freq_mHz, 0);
+	double expected;
+
+	// The truncated period is shorter by the remainder: t / (t / f) instead of f
+	expected = ((double)t / (double)(t / freq_mHz) - freq_mHz) * 1e6 / freq_mHz;
+	CHECK(fabs(error - expected) < 0.01, "%u mHz truncated: error %.4f ppm, expected %.4f", freq_mHz, error, expected);
+	CHECK(s_measure.minPeriod == s_measure.maxPeriod, "%u mHz truncated: periods %u to %u ticks",
+			freq_mHz, s_measure.minPeriod, s_measure.maxPeriod);
+}
+
+int main(void){
+
+	// 600 rpm, 1000 rpm, 7200 rpm and frequencies with large remainders
+	TestDither(10000);
+	TestDither(16667);
+	TestDither(120000);
+	TestDither(33333);
+	TestDither(299999);
+	TestDither(1234);
+
+	TestTruncated(16667);
+	TestTruncated(299999);
+
+	return HOST_Report("test_dither");
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_jitter.c
+ *
+ * @brief Host test of the stochastic RPM stress mode on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pulse is configured by 'IPULSE_SetupPulse()' and perturbed by 'JITTER_Start()', the period
+ * callback runs from the real interrupt handler. The periods are measured between the rising edges
+ * of the output and compared one by one with the sequence of the host simulator
+ * 'tools/jitter_sim.py' for the same seed, then with the 'J' answer of the firmware. Their
+ * statistics must follow the distribution: bounded by the amplitude, the standard deviation of
+ * the distribution reduced by the filter, and the lag-1 correlation of the filter. A frequency or
+ * counter clock update must move the center period from the next periods.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+#include "sct_model.h"
+#include "usart_host.h"
+#include "ignition_pulse.h"
+#include "jitter.h"
+#include "telemetry.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define PULSE_WIDTH_US	2000U		///< Pulse width [us].
+#define FREQ_MHZ		100000U		///< Center frequency, 6000 rpm [mHz].
+#define PERIOD_COUNT	20000U		///< Measured periods per configuration.
+#define SIMULATOR		"python3 ../tools/jitter_sim.py"
+
+static uint64_t s_rises[PERIOD_COUNT + 3];	///< Times of the rising edges [tick].
+static uint32_t s_riseCount;
+
+/**
+ * @brief Record the rising edges of the pulse output.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output == PULSE_OUTPUT && level && s_riseCount < PERIOD_COUNT + 3){
+		s_rises[s_riseCount++] = time;
+	}
+}
+
+/**
+ * @brief Run a perturbed pulse and compare its periods with the simulator.
+ * @param config Perturbation configuration.
+ * @param deviation Expected standard deviation of the white perturbation [fraction of the amplitude].
+ */
+static void TestJitter(const jitter_config_t *config, double deviation){
+
+	sctimer_config_t sctConfig;
+	uint32_t event, count, i;
+	uint32_t center = (uint64_t)SCT_CLOCK_HZ * 1000U / FREQ_MHZ;
+	uint32_t amplitude = 0;
+	double a = 1.0 / (1U << config->shift);
+	double mean = 0, var = 0, cov = 0, d, previous = 0;
+	int32_t maxAbs = 0;
+	uint32_t errors = 0, reload;
+	char command[384], answer[128];
+	FILE *simulator;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&sctConfig);
+	SCTIMER_Init(SCT0, &sctConfig);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	s_riseCount = 0;
+
+	CHECK(IPULSE_SetupPulse(SCT0, PULSE_WIDTH_US, SCT_CLOCK_HZ, FREQ_MHZ, PULSE_OUTPUT, &event) == kStatus_Success,
+			"pulse configured");
+	CHECK(JITTER_Start(SCT0, SCT_CLOCK_HZ, FREQ_MHZ, event, config) == kStatus_Success,
+			"distribution %u started", config->distribution);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+
+	// The two first runs use the period of the setup, the first perturbed value is loaded in the third
+	while(s_riseCount < PERIOD_COUNT + 3){
+		SCTMODEL_RunToEvent(2ULL * center);
+	}
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 0);
+	USARTHOST_Command("J", answer, sizeof(answer));
+	answer[strcspn(answer, "\r\n")] = '\0';
+	JITTER_Stop();
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+
+	// Same sequence as the simulator for the same seed
+	snprintf(command, sizeof(command), SIMULATOR " %u %u %u %u --freq-mhz %u --width-us %u --sct-clock %u --count %u --periods",
+			config->distribution, config->amplitude_us, config->shift, config->seed, FREQ_MHZ, PULSE_WIDTH_US,
+			SCT_CLOCK_HZ, PERIOD_COUNT);
+	simulator = popen(command, "r");
+	CHECK(simulator != NULL, "simulator started");
+	for(i = 0; simulator && i < PERIOD_COUNT; i++){
+		if(fscanf(simulator, "%u", &reload) != 1){
+			CHECK(0, "simulator period %u missing", i);
+			break;
+		}
+		if(s_rises[i + 2] - s_rises[i + 1] != reload + 1ULL && errors++ < 5){
+			CHECK(0, "period %u: %llu ticks, simulated %u", i, (unsigned long long)(s_rises[i + 2] - s_rises[i + 1]),
+					reload + 1);
+		}
+	}
+	CHECK(simulator && pclose(simulator) == 0 && errors == 0, "seed %u: %u of %u periods differ from the simulator",
+			config->seed, errors, PERIOD_COUNT);
+
+	// Same statistics as the simulator, the count includes the period loaded after the last measured one
+	sscanf(strstr(answer, "count=") ? strstr(answer, "count=") + 6 : "0", "%u", &count);
+	sscanf(strstr(answer, "amplitude=") ? strstr(answer, "amplitude=") + 10 : "0", "%u", &amplitude);
+	CHECK(amplitude && amplitude <= (uint64_t)config->amplitude_us * SCT_CLOCK_HZ / 1000000U && amplitude <= 0xFFFF &&
+			amplitude + PULSE_WIDTH_US * (SCT_CLOCK_HZ / 1000000U) < center, "amplitude %u ticks applied", amplitude);
+	snprintf(command, sizeof(command), SIMULATOR " %u %u %u %u --freq-mhz %u --width-us %u --sct-clock %u --count %u --compare \"%s\" > /dev/null",
+			config->distribution, config->amplitude_us, config->shift, config->seed, FREQ_MHZ, PULSE_WIDTH_US,
+			SCT_CLOCK_HZ, count, answer);
+	CHECK(count >= PERIOD_COUNT && system(command) == 0, "'%s' matches the simulator", answer);
+
+	// Statistics of the perturbation, from the center period
+	for(i = 0; i < PERIOD_COUNT; i++){
+		d = (double)(s_rises[i + 2] - s_rises[i + 1]) - center;
+		mean += d;
+		maxAbs = fabs(d) > maxAbs ? fabs(d) : maxAbs;
+	}
+	mean /= PERIOD_COUNT;
+	for(i = 0; i < PERIOD_COUNT; i++){
+		d = (double)(s_rises[i + 2] - s_rises[i + 1]) - center - mean;
+		var += d * d;
+		if(i){
+			cov += d * previous;
+		}
+		previous = d;
+	}
+	var /= PERIOD_COUNT;
+	cov /= PERIOD_COUNT - 1;
+
+	// The filter reduces the variance to a / (2 - a) of the white one, the lag-1 correlation is 1 - a
+	deviation *= amplitude * sqrt(a / (2 - a));
+	CHECK((uint32_t)maxAbs <= amplitude, "distribution %u shift %u: perturbation %d ticks, amplitude %u",
+			config->distribution, config->shift, maxAbs, amplitude);
+	CHECK(fabs(mean) < 5 * deviation / sqrt(PERIOD_COUNT * a), "distribution %u shift %u: mean %.2f ticks",
+			config->distribution, config->shift, mean);
+	CHECK(fabs(sqrt(var) / deviation - 1) < 0.05, "distribution %u shift %u: deviation %.1f ticks, expected %.1f",
+			config->distribution, config->shift, sqrt(var), deviation);
+	CHECK(fabs(cov / var - (1 - a)) < 0.03, "distribution %u shift %u: lag-1 correlation %.3f, expected %.3f",
+			config->distribution, config->shift, cov / var, 1 - a);
+}
+
+/**
+ * @brief Update the center frequency and the counter clock of a running perturbation.
+ * @param srcClock_Hz Updated SCTimer clock [Hz].
+ * @param freq_mHz Updated center frequency [mHz].
+ */
+static void TestSetFrequency(uint32_t srcClock_Hz, uint32_t freq_mHz){
+
+	sctimer_config_t sctConfig;
+	uint32_t event, i;
+	uint32_t center = (uint64_t)SCT_CLOCK_HZ * 1000U / FREQ_MHZ;
+	uint32_t updated = (uint64_t)srcClock_Hz * 1000U / freq_mHz;
+	uint32_t amplitude = 100U * (SCT_CLOCK_HZ / 1000000U);
+	uint64_t total = 0, mean;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&sctConfig);
+	SCTIMER_Init(SCT0, &sctConfig);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	s_riseCount = 0;
+
+	IPULSE_SetupPulse(SCT0, PULSE_WIDTH_US, SCT_CLOCK_HZ, FREQ_MHZ, PULSE_OUTPUT, &event);
+	JITTER_Start(SCT0, SCT_CLOCK_HZ, FREQ_MHZ, event, &(jitter_config_t){JITTER_UNIFORM, 100, 0, 1234});
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+	while(s_riseCount < 10){
+		SCTMODEL_RunToEvent(2ULL * center);
+	}
+
+	// The period loaded by the interrupt in progress is the last one of the previous center
+	JITTER_SetFrequency(srcClock_Hz, freq_mHz);
+	s_riseCount = 0;
+	while(s_riseCount < 203){
+		SCTMODEL_RunToEvent(2ULL * center);
+	}
+	JITTER_Stop();
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+
+	for(i = 3; i < s_riseCount; i++){
+		total += s_rises[i] - s_rises[i - 1];
+	}
+	mean = total / (s_riseCount - 3);
+	CHECK(mean + amplitude / 4 >= updated && mean <= updated + amplitude / 4,
+			"%u Hz, %u mHz: mean period %llu ticks, expected %u", srcClock_Hz, freq_mHz, (unsigned long long)mean, updated);
+}
+
+int main(void){
+
+	TELEMETRY_RegisterCommand('J', JITTER_PrintStats);
+
+	// White and filtered perturbations. The tables are sampled at the middle of 128 intervals: the
+	// uniform deviation is 1 / sqrt(3), the normal one is a bit less than its 1 / 3.
+	TestJitter(&(jitter_config_t){JITTER_UNIFORM, 500, 0, 1234}, 1 / sqrt(3));
+	TestJitter(&(jitter_config_t){JITTER_UNIFORM, 300, 2, 99}, 1 / sqrt(3));
+	TestJitter(&(jitter_config_t){JITTER_NORMAL, 500, 0, 1234}, 0.32);
+	TestJitter(&(jitter_config_t){JITTER_NORMAL, 1000, 4, 0xCAFE}, 0.32);
+
+	// The amplitude is limited so the pulse ends in its period
+	TestJitter(&(jitter_config_t){JITTER_UNIFORM, 20000, 1, 7}, 1 / sqrt(3));
+
+	// Frequency update, then a counter clock halved for the same frequency
+	TestSetFrequency(SCT_CLOCK_HZ, FREQ_MHZ * 2);
+	TestSetFrequency(SCT_CLOCK_HZ / 2, FREQ_MHZ);
+
+	return HOST_Report("test_jitter");
+}
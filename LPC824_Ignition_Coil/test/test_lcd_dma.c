@@ -0,0 +1,161 @@
+/**
+ * @file test_lcd_dma.c
+ *
+ * @brief Host test of the LCD DMA queue on the DMA and SPI model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Segments of all the sizes around the descriptor limit are queued with both levels of the
+ * command/data pin, before and during the transmission. The bytes written to the SPI must be the
+ * bytes of the segments in order, each one with the level of its segment, with one interrupt per
+ * segment whatever its number of linked descriptors, and the chip select released once the queue
+ * is empty.
+ */
+
+#include <string.h>
+
+#include "host.h"
+#include "dma_model.h"
+#include "lcd_dma.h"
+
+#define CD_PIN			4U			///< GPIO pin of the command/data signal (IO_CD).
+#define MAX_SEGMENT		(LCDDMA_MAX_TRANSFER * (LCDDMA_MAX_LINKS + 1))
+#define STREAM_SIZE		(LCDDMA_QUEUE_SIZE * MAX_SEGMENT)
+
+static uint8_t s_data[LCDDMA_QUEUE_SIZE][MAX_SEGMENT];	///< Bytes of the queued segments.
+
+static uint8_t s_expected[STREAM_SIZE];		///< Expected bytes.
+static uint8_t s_expectedCd[STREAM_SIZE];	///< Expected level of the command/data pin.
+static uint32_t s_expectedCount;
+
+static uint8_t s_sent[STREAM_SIZE];			///< Bytes written to the SPI.
+static uint8_t s_sentCd[STREAM_SIZE];		///< Level of the command/data pin of the bytes.
+static uint32_t s_sentCount;
+static uint32_t s_ends;						///< Releases of the chip select.
+static uint32_t s_segments;					///< Queued segments.
+
+/**
+ * @brief Record a byte written to the SPI.
+ */
+static void OnByte(uint8_t data, uint8_t cd){
+
+	if(s_sentCount < STREAM_SIZE){
+		s_sent[s_sentCount] = data;
+		s_sentCd[s_sentCount] = cd;
+	}
+	s_sentCount++;
+}
+
+/**
+ * @brief Record the release of the chip select.
+ */
+static void OnEnd(void){
+
+	CHECK(s_sentCount == s_expectedCount, "chip select released after %u of %u bytes", s_sentCount, s_expectedCount);
+	s_ends++;
+}
+
+/**
+ * @brief Initialize the SPI registers, the DMA channel and the model.
+ */
+static void Init(void){
+
+	HOST_ResetPeripherals();
+
+	// Settings of the blocking transfers: end of transfer after each byte, reception read
+	SPI0->TXCTL = SPI_TXCTL_EOT_MASK;
+
+	LCDDMA_Init(SPI0, CD_PIN);
+	DMAMODEL_Reset(CD_PIN);
+	DMAMODEL_SetObservers(OnByte, OnEnd);
+
+	s_expectedCount = 0;
+	s_sentCount = 0;
+	s_ends = 0;
+	s_segments = 0;
+}
+
+/**
+ * @brief Queue a segment of a pattern and add it to the expected bytes.
+ * @param size Number of bytes.
+ * @param cd Level of the command/data pin.
+ */
+static void Queue(uint32_t size, uint8_t cd){
+
+	uint8_t *data = s_data[s_segments % LCDDMA_QUEUE_SIZE];
+	uint32_t i;
+
+	for(i = 0; i < size; i++){
+		data[i] = s_segments * 37 + i * 7 + (i >> 8);
+		s_expected[s_expectedCount + i] = data[i];
+		s_expectedCd[s_expectedCount + i] = cd;
+	}
+	s_expectedCount += size;
+	s_segments++;
+
+	CHECK(LCDDMA_Send(data, size, cd) == kStatus_Success, "segment of %u bytes queued", size);
+}
+
+/**
+ * @brief Compare the bytes written to the SPI with the queued segments.
+ * @param name Name of the sequence for the messages.
+ */
+static void CheckStream(const char *name){
+
+	uint32_t i;
+
+	CHECK(s_sentCount == s_expectedCount, "%s: %u bytes sent, %u queued", name, s_sentCount, s_expectedCount);
+	for(i = 0; i < s_sentCount && i < s_expectedCount; i++){
+		if(s_sent[i] != s_expected[i] || s_sentCd[i] != s_expectedCd[i]){
+			CHECK(0, "%s: byte %u is 0x%02X cd %u, expected 0x%02X cd %u", name, i, s_sent[i], s_sentCd[i],
+					s_expected[i], s_expectedCd[i]);
+			break;
+		}
+	}
+	CHECK(DMAMODEL_GetInterrupts() == s_segments, "%s: %u interrupts for %u segments", name,
+			DMAMODEL_GetInterrupts(), s_segments);
+	CHECK(s_ends == 1, "%s: chip select released %u times", name, s_ends);
+}
+
+int main(void){
+
+	static const uint32_t sizes[] = {1, 2, 3, 127, 128, LCDDMA_MAX_TRANSFER - 1, LCDDMA_MAX_TRANSFER,
+			LCDDMA_MAX_TRANSFER + 1, MAX_SEGMENT - 1, MAX_SEGMENT};
+	uint32_t i, n;
+
+	// Each size alone, with both levels
+	for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++){
+		for(n = 0; n < 2; n++){
+			Init();
+			Queue(sizes[i], n);
+			DMAMODEL_Run(STREAM_SIZE);
+			CheckStream("single segment");
+		}
+	}
+
+	// A full queue of mixed sizes and levels, queued before the transmission
+	Init();
+	for(i = 0; i < LCDDMA_QUEUE_SIZE - 1; i++){
+		Queue(sizes[(i * 7) % (sizeof(sizes) / sizeof(sizes[0]))], (i / 3) & 1);
+	}
+	CHECK(DMAMODEL_Run(STREAM_SIZE) == s_expectedCount, "queued segments sent");
+	CheckStream("full queue");
+
+	// Segments queued while the previous ones are sent, as the screen pages are
+	Init();
+	for(i = 0; i < 64; i++){
+		Queue(i & 1 ? 128 : 3, i & 1);
+		DMAMODEL_Run(i % 5 == 0 ? 1 : 40 + i);
+	}
+	DMAMODEL_Run(STREAM_SIZE);
+	CheckStream("interleaved");
+
+	// Sizes out of the descriptors range are refused
+	Init();
+	CHECK(LCDDMA_Send(s_data[0], 0, 1) == kStatus_InvalidArgument, "empty segment refused");
+	CHECK(LCDDMA_Send(s_data[0], MAX_SEGMENT + 1, 1) == kStatus_InvalidArgument, "segment of %u bytes refused",
+			MAX_SEGMENT + 1);
+	CHECK(DMAMODEL_Run(STREAM_SIZE) == 0 && DMAMODEL_GetInterrupts() == 0, "nothing sent");
+
+	return HOST_Report("test_lcd_dma");
+}
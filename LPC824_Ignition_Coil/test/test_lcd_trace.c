@@ -0,0 +1,262 @@
+/**
+ * @file test_lcd_trace.c
+ *
+ * @brief Host test of the screens drawn by 'lcd.c' and 'ui.c', replayed on the LCD emulator.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each display mode (splash screen, main screen in fixed RPM mode, main screen in crank trigger
+ * mode) is drawn through the LCD SPI model and written as a trace in 'build/'. The trace is
+ * replayed by 'tools/lcd_emu.py' against the reference trace of the mode in 'lcd/': the frame after
+ * each operation must be the same, and the final frame of the reference must be its expected
+ * picture. A change of the driver that keeps the screens passes, with its byte and transaction
+ * savings printed in 'build/lcd_<mode>.log'.\n
+ * The crank trigger mode is also written as a logic analyzer export and converted back by
+ * 'tools/la2trace.py': the converted transactions must be the recorded ones.\n
+ * The references are regenerated by 'make lcd_reference' after an intended change of a screen, the
+ * new expected pictures must be checked.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+#include "lcd_host.h"
+#include "lcd.h"
+#include "ui.h"
+#include "overcurrent.h"
+
+#define EMULATOR		"python3 ../tools/lcd_emu.py"
+#define CONVERTER		"python3 ../tools/la2trace.py"
+#define CHART_MIN		2500U		///< RPM of the chart bottom ('MIN_TR_MIN').
+#define CHART_MAX		9000U		///< RPM of the chart top ('MAX_TR_MIN').
+#define LINE_SIZE		1024U		///< Longest line of a trace.
+#define RENDERS_PER_SAMPLE	((UI_CHART_PERIOD_MS + UI_REFRESH_PERIOD_MS - 1) / UI_REFRESH_PERIOD_MS)
+
+/**
+ * @brief Render the model as the main loop does.
+ */
+static void Render(void){
+
+	host_ticks += UI_REFRESH_PERIOD_MS;
+	UI_Process();
+}
+
+/**
+ * @brief Power up the LCD and hold the splash screen, as the main loop does.
+ */
+static void Splash(void){
+
+	LCDHOST_Label("power-up");
+	CHECK(LCD_InitStart() == kStatus_Success, "LCD initialization started");
+	while(!LCD_IsOn()){
+		host_ticks++;
+		LCD_InitProcess();
+	}
+
+	LCDHOST_Label("splash hold");
+	while(!LCD_InitProcess()){
+		host_ticks++;
+	}
+}
+
+/**
+ * @brief Draw the main screen.
+ * @param rpm Command and running RPM.
+ * @param enabled Pulse output enabled.
+ * @param strikes Strikes per period, '0' in crank trigger mode.
+ */
+static void MainScreen(uint32_t rpm, uint8_t enabled, uint8_t strikes){
+
+	ui_model_t model = {.cmdRpm = rpm, .runningRpm = rpm, .trips = 0, .strikes = strikes, .match = 1, .enabled = enabled};
+
+	LCDHOST_Label("main screen");
+	UI_Init(&model, CHART_MIN, CHART_MAX);
+}
+
+/**
+ * @brief Splash screen mode: power-up and logo.
+ */
+static void ModeSplash(void){
+
+	Splash();
+}
+
+/**
+ * @brief Fixed RPM mode: encoder steps, pulses enabled, new command applied, multi-spark strikes.
+ */
+static void ModeFixed(void){
+
+	ui_model_t *ui = UI_GetModel();
+	int i;
+
+	Splash();
+	MainScreen(6900, 0, 1);
+
+	LCDHOST_Label("encoder +3 steps");
+	for(i = 0; i < 3; i++){
+		ui->cmdRpm += 100;
+		ui->match = 0;
+		Render();
+	}
+
+	LCDHOST_Label("pulses on");
+	ui->enabled = 1;
+	Render();
+
+	LCDHOST_Label("command applied");
+	ui->runningRpm = ui->cmdRpm;
+	ui->match = 1;
+	Render();
+
+	LCDHOST_Label("encoder -2 steps in a refresh");
+	ui->cmdRpm -= 200;
+	ui->match = 0;
+	Render();
+
+	// A narrower count must clear the previous one
+	LCDHOST_Label("multi-spark 3 strikes");
+	ui->strikes = 3;
+	Render();
+
+	LCDHOST_Label("multi-spark 2 strikes");
+	ui->strikes = 2;
+	Render();
+
+	LCDHOST_Label("pulses off");
+	ui->enabled = 0;
+	Render();
+}
+
+/**
+ * @brief Crank trigger mode: measured RPM swept on the chart, overcurrent trips if the protection is built.
+ */
+static void ModeCrank(void){
+
+	ui_model_t *ui = UI_GetModel();
+	uint32_t sample, step, i;
+
+	Splash();
+	MainScreen(3000, 1, 0);
+
+	// A triangle of the measured RPM, the sweep wraps after the chart width
+	LCDHOST_Label("acceleration");
+	for(sample = 0; sample < SCREEN_WIDTH + 20; sample++){
+		if(sample == SCREEN_WIDTH / 2){
+			LCDHOST_Label("deceleration");
+		}
+		else if(sample == SCREEN_WIDTH){
+			LCDHOST_Label("sweep wrap");
+		}
+#if OCP_ENABLE
+		else if(sample == SCREEN_WIDTH + 10){
+			LCDHOST_Label("overcurrent trip");
+			ui->trips++;
+		}
+#endif
+
+		step = sample % SCREEN_WIDTH;
+		ui->runningRpm = 3000 + 90 * (step < SCREEN_WIDTH / 2 ? step : SCREEN_WIDTH - step);
+		ui->match = ui->runningRpm == ui->cmdRpm;
+		for(i = 0; i < RENDERS_PER_SAMPLE; i++){
+			Render();
+		}
+	}
+}
+
+/**
+ * @brief Compare the transactions of two traces, the labels are ignored.
+ * @param recorded Trace written by the model.
+ * @param converted Trace converted from the logic analyzer export.
+ */
+static void CompareTransactions(const char *recorded, const char *converted){
+
+	static char a[LINE_SIZE], b[LINE_SIZE];
+	FILE *fa = fopen(recorded, "r");
+	FILE *fb = fopen(converted, "r");
+	uint32_t count = 0;
+	int endA = 0, endB = 0;
+
+	CHECK(fa && fb, "traces '%s' and '%s' opened", recorded, converted);
+	while(fa && fb){
+		do{
+			endA = fgets(a, sizeof(a), fa) == NULL;
+		}while(!endA && a[0] == '#');
+		endB = fgets(b, sizeof(b), fb) == NULL;
+
+		if(endA || endB){
+			break;
+		}
+		if(strcmp(a, b) != 0){
+			CHECK(0, "transaction %u: '%.40s' converted to '%.40s'", count, a, b);
+			break;
+		}
+		count++;
+	}
+	CHECK(endA && endB && count > 0, "%u transactions converted from the logic analyzer export", count);
+
+	if(fa){
+		fclose(fa);
+	}
+	if(fb){
+		fclose(fb);
+	}
+}
+
+/**
+ * @brief Draw a mode and replay it against its reference.
+ * @param name Name of the mode, the reference is 'lcd/<name>.txt'.
+ * @param mode Function drawing the mode.
+ * @param csv Also write the logic analyzer export and convert it.
+ */
+static void TestMode(const char *name, void (*mode)(void), uint8_t csv){
+
+	char trace[64], export[64], converted[64], command[512];
+	FILE *ft, *fc = NULL;
+
+	HOST_ResetPeripherals();
+	host_ticks = 0;
+
+	// Core clock divider of the clock setup, the SPI clock is computed from it
+	SYSCON->SYSAHBCLKDIV = 1;
+
+	snprintf(trace, sizeof(trace), "build/lcd_%s.txt", name);
+	snprintf(export, sizeof(export), "build/lcd_%s.csv", name);
+	snprintf(converted, sizeof(converted), "build/lcd_%s_la.txt", name);
+	ft = fopen(trace, "w");
+	if(csv){
+		fc = fopen(export, "w");
+	}
+	CHECK(ft && (!csv || fc), "%s: outputs opened", name);
+	if(!ft || (csv && !fc)){
+		return;
+	}
+
+	LCDHOST_SetOutputs(ft, fc);
+	mode();
+	LCDHOST_SetOutputs(NULL, NULL);
+	fclose(ft);
+	if(fc){
+		fclose(fc);
+	}
+
+	snprintf(command, sizeof(command), EMULATOR " lcd/%s.txt --expect lcd/%s.pbm --compare %s > build/lcd_%s.log",
+			name, name, trace, name);
+	CHECK(system(command) == 0, "%s: frames of the reference, see build/lcd_%s.log", name, name);
+
+	if(csv){
+		snprintf(command, sizeof(command), CONVERTER " %s -o %s", export, converted);
+		CHECK(system(command) == 0, "%s: logic analyzer export converted", name);
+		CompareTransactions(trace, converted);
+	}
+}
+
+int main(void){
+
+	TestMode("splash", ModeSplash, 0);
+	TestMode("fixed", ModeFixed, 0);
+	TestMode("crank", ModeCrank, 1);
+
+	return HOST_Report("test_lcd_trace");
+}
@@ -0,0 +1,199 @@
+/**
+ * @file test_maps.c
+ *
+ * @brief Host test of the fixed-point map interpolation against a double-precision reference.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Random maps (random axis steps, cells up to the full 16-bit range) are evaluated on a dense grid
+ * of RPM and load, inside and outside the axes, and around each axis point. The fixed-point result
+ * must stay within 3 units of the exact bilinear interpolation, one for each of the three truncated
+ * interpolations, plus 3 / 32768 of the largest cell difference for the truncated Q15 factors.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "maps.h"
+
+#define RANDOM_MAPS		200		///< Random maps evaluated.
+
+static uint32_t s_random = 2463534242U;	///< State of the map generator.
+
+/**
+ * @brief Next value of the map generator (xorshift32).
+ * @return A pseudo random value.
+ */
+static uint32_t Random(void){
+
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+/**
+ * @brief Exact position of a value on an axis.
+ * @param axis Axis points.
+ * @param x Value, clamped to the axis.
+ * @param t Pointer where the position in the segment (0 to 1) is stored.
+ * @return The first point of the segment.
+ */
+static uint32_t Locate(const uint16_t *axis, double x, double *t){
+
+	uint32_t i = 0;
+
+	if(x <= axis[0]){
+		*t = 0;
+		return 0;
+	}
+	if(x >= axis[MAP_SIZE - 1]){
+		*t = 1;
+		return MAP_SIZE - 2;
+	}
+	while(x >= axis[i + 1]){
+		i++;
+	}
+	*t = (x - axis[i]) / (axis[i + 1] - axis[i]);
+	return i;
+}
+
+/**
+ * @brief Double-precision bilinear interpolation.
+ * @param table Map table.
+ * @param rpm RPM.
+ * @param load Load.
+ * @return The interpolated value.
+ */
+static double Reference(const map_table_t *table, uint32_t rpm, uint32_t load){
+
+	double tx, ty;
+	uint32_t x = Locate(table->rpm, rpm, &tx);
+	uint32_t y = Locate(table->load, load, &ty);
+	double v0 = table->value[y][x] + (table->value[y][x + 1] - table->value[y][x]) * tx;
+	double v1 = table->value[y + 1][x] + (table->value[y + 1][x + 1] - table->value[y + 1][x]) * tx;
+
+	return v0 + (v1 - v0) * ty;
+}
+
+/**
+ * @brief Largest difference between two neighbour cells.
+ * @param table Map table.
+ * @return The difference.
+ */
+static int32_t MaxStep(const map_table_t *table){
+
+	int32_t max = 0;
+	uint32_t x, y;
+
+	for(y = 0; y < MAP_SIZE; y++){
+		for(x = 0; x < MAP_SIZE; x++){
+			if(x + 1 < MAP_SIZE && abs(table->value[y][x + 1] - table->value[y][x]) > max){
+				max = abs(table->value[y][x + 1] - table->value[y][x]);
+			}
+			if(y + 1 < MAP_SIZE && abs(table->value[y + 1][x] - table->value[y][x]) > max){
+				max = abs(table->value[y + 1][x] - table->value[y][x]);
+			}
+		}
+	}
+	return max;
+}
+
+/**
+ * @brief Compare a loaded map with the reference on a grid covering and exceeding its axes.
+ * @param map Map (MAP_ID).
+ * @param table Table loaded in the map.
+ * @param name Map name for the messages.
+ * @return The largest error.
+ */
+static double Compare(uint32_t map, const map_table_t *table, const char *name){
+
+	double bound = 3.0 + MaxStep(table) * 3.0 / 32768.0;
+	double error, maxError = 0;
+	uint32_t rpmStep = (table->rpm[MAP_SIZE - 1] - table->rpm[0]) / 150 + 1;
+	uint32_t loadStep = (table->load[MAP_SIZE - 1] - table->load[0]) / 150 + 1;
+	uint32_t rpmEnd = table->rpm[MAP_SIZE - 1] + 2 * rpmStep;
+	uint32_t loadEnd = table->load[MAP_SIZE - 1] + 2 * loadStep;
+	uint32_t rpm, load, i;
+
+	for(rpm = table->rpm[0] > rpmStep ? table->rpm[0] - rpmStep : 0; rpm <= rpmEnd; rpm += rpmStep){
+		for(load = table->load[0] > loadStep ? table->load[0] - loadStep : 0; load <= loadEnd; load += loadStep){
+			error = fabs(MAP_Evaluate(map, rpm, load) - Reference(table, rpm, load));
+			if(error > maxError){
+				maxError = error;
+			}
+		}
+	}
+
+	// The axis points, and one unit on each side
+	for(i = 0; i < MAP_SIZE; i++){
+		for(rpm = table->rpm[i] - 1; rpm <= table->rpm[i] + 1U; rpm++){
+			for(load = table->load[i] - 1; load <= table->load[i] + 1U; load++){
+				error = fabs(MAP_Evaluate(map, rpm, load) - Reference(table, rpm, load));
+				if(error > maxError){
+					maxError = error;
+				}
+			}
+		}
+	}
+
+	CHECK(maxError <= bound, "%s: error %.2f, bound %.2f", name, maxError, bound);
+	return maxError;
+}
+
+/**
+ * @brief Random map with random axis steps.
+ * @param table Table to fill.
+ * @param range Cells range, from -range to range - 1.
+ */
+static void RandomTable(map_table_t *table, uint32_t range){
+
+	uint32_t i, x, y;
+
+	table->rpm[0] = Random() % 2000;
+	table->load[0] = Random() % 4000;
+	for(i = 1; i < MAP_SIZE; i++){
+		table->rpm[i] = table->rpm[i - 1] + 1 + Random() % 1500;
+		table->load[i] = table->load[i - 1] + 1 + Random() % 3000;
+	}
+	for(y = 0; y < MAP_SIZE; y++){
+		for(x = 0; x < MAP_SIZE; x++){
+			table->value[y][x] = (int32_t)(Random() % (2 * range)) - (int32_t)range;
+		}
+	}
+}
+
+int main(void){
+
+	map_table_t table;
+	double maxError = 0;
+	char name[32];
+	uint32_t n, i;
+
+	MAP_Init();
+	for(i = 0; i < MAP_COUNT; i++){
+		CHECK(MAP_IsValid(i), "default map %u valid", i);
+	}
+
+	// Default maps: the dwell at 12 V is 2000 us, the advance at 3000 rpm is 20 degree
+	CHECK(MAP_Evaluate(MAP_DWELL, 3000, 12000) == 2000, "dwell %d us", MAP_Evaluate(MAP_DWELL, 3000, 12000));
+	CHECK(MAP_Evaluate(MAP_ADVANCE, 3000, 12000) == 2000, "advance %d", MAP_Evaluate(MAP_ADVANCE, 3000, 12000));
+
+	for(n = 0; n < RANDOM_MAPS; n++){
+		RandomTable(&table, n % 2 ? 32768 : 4000);
+		CHECK(MAP_Write(MAP_ADVANCE, 0, (const uint16_t *)&table, sizeof(table) / sizeof(uint16_t)) == kStatus_Success,
+				"random map %u loaded", n);
+		snprintf(name, sizeof(name), "random map %u", n);
+		maxError = fmax(maxError, Compare(MAP_ADVANCE, &table, name));
+	}
+	printf("test_maps: largest error %.2f over %u random maps\n", maxError, RANDOM_MAPS);
+
+	// Invalid axis: refused
+	table.rpm[3] = table.rpm[2];
+	CHECK(MAP_Write(MAP_ADVANCE, 0, (const uint16_t *)&table, sizeof(table) / sizeof(uint16_t)) ==
+			kStatus_InvalidArgument && !MAP_IsValid(MAP_ADVANCE), "flat axis refused");
+
+	return HOST_Report("test_maps");
+}
@@ -0,0 +1,225 @@
+/**
+ * @file test_multispark.c
+ *
+ * @brief Host test of the multi-spark waveform on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The strikes are sequenced by the SCTimer states only: the waveform is checked strike by strike
+ * with the event interrupts disabled. Each group must have the configured number of strikes, of
+ * the configured width and spacing, and the groups must start one period apart, also after the
+ * width and frequency updates. A switch to the single pulse mode after a release, halted mid-period,
+ * must restart the counter from 0: the first pulse comes one full period after the restart.
+ */
+
+#include "host.h"
+#include "sct_model.h"
+#include "ignition_pulse.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define EDGE_COUNT		1024U		///< Recorded edges.
+
+static uint64_t s_rises[EDGE_COUNT];	///< Times of the rising edges [tick].
+static uint64_t s_falls[EDGE_COUNT];	///< Times of the falling edges [tick].
+static uint32_t s_riseCount;
+static uint32_t s_fallCount;
+
+/**
+ * @brief Record the edges of the pulse output.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+	if(level && s_riseCount < EDGE_COUNT){
+		s_rises[s_riseCount++] = time;
+	}
+	else if(!level && s_riseCount && s_fallCount < s_riseCount){
+		s_falls[s_fallCount++] = time;
+	}
+}
+
+/**
+ * @brief Run the model while the firmware waits for the counter to halt.
+ */
+static void Idle(void){
+	SCTMODEL_Run(SCT_CLOCK_HZ / 1000U);
+}
+
+/**
+ * @brief Record the edges of a run.
+ * @param ticks Duration of the run [tick].
+ */
+static void Record(uint64_t ticks){
+
+	s_riseCount = 0;
+	s_fallCount = 0;
+	SCTMODEL_Run(ticks);
+}
+
+/**
+ * @brief Check the recorded waveform, from the first complete group of strikes.
+ * @param strikes Strikes per group.
+ * @param width Strike width [tick].
+ * @param gap Time between a strike end and the next strike start [tick].
+ * @param period Time between two group starts [tick].
+ * @param minGroups Minimum number of complete groups.
+ */
+static void CheckWaveform(uint32_t strikes, uint32_t width, uint32_t gap, uint32_t period, uint32_t minGroups){
+
+	uint32_t groups = 0;
+	uint32_t errors = 0;
+	uint32_t i = 1, k;
+
+	// A group starts after the long interval between the last strike and the next period
+	while(i < s_riseCount && s_rises[i] - s_rises[i - 1] == width + gap){
+		i++;
+	}
+
+	for(; i + strikes <= s_fallCount; i += strikes){
+
+		if(i + strikes < s_riseCount && s_rises[i + strikes] - s_rises[i] != period){
+			errors++;
+			CHECK(0, "group %u starts %llu ticks after the previous one, expected %u", groups,
+					(unsigned long long)(s_rises[i + strikes] - s_rises[i]), period);
+		}
+
+		for(k = 0; k < strikes; k++){
+			if(s_falls[i + k] - s_rises[i + k] != width + 1 ||
+					(k && s_rises[i + k] - s_rises[i + k - 1] != width + gap)){
+				errors++;
+				CHECK(0, "group %u strike %u: width %llu ticks, %llu ticks after the previous one", groups, k,
+						(unsigned long long)(s_falls[i + k] - s_rises[i + k]),
+						(unsigned long long)(s_rises[i + k] - s_rises[i + k - 1]));
+			}
+		}
+		groups++;
+		if(errors > 4){
+			break;
+		}
+	}
+
+	CHECK(groups >= minGroups, "%u complete groups of %u strikes", groups, strikes);
+}
+
+/**
+ * @brief Multi-spark pulse, then width and frequency updates.
+ * @param strikes Strikes per period.
+ * @param width_us Strike width [us].
+ * @param gap_us Gap between the strikes [us].
+ * @param freq_mHz Pulse frequency [mHz].
+ */
+static void TestMultiSpark(uint32_t strikes, uint32_t width_us, uint32_t gap_us, uint32_t freq_mHz){
+
+	sctimer_config_t config;
+	uint32_t event;
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t width = (uint64_t)width_us * SCT_CLOCK_HZ / 1000000U;
+	uint32_t gap = (uint64_t)gap_us * SCT_CLOCK_HZ / 1000000U;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+
+	CHECK(IPULSE_SetupMultiSpark(SCT0, width_us, gap_us, strikes, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event) ==
+			kStatus_Success, "%u strikes configured", strikes);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+
+	Record(20ULL * period);
+	CHECK(SCT0->EVEN == 0, "no interrupt per strike (EVEN 0x%X)", SCT0->EVEN);
+	CheckWaveform(strikes, width, gap, period, 18);
+
+	// The width changes the strikes span, the period is kept
+	width_us *= 2;
+	width *= 2;
+	CHECK(IPULSE_UpdatePulseWidth(SCT0, PULSE_OUTPUT, SCT_CLOCK_HZ, width_us, event) == kStatus_Success,
+			"%u strikes: width updated", strikes);
+	Record(20ULL * period);
+	CheckWaveform(strikes, width, gap, period, 18);
+
+	freq_mHz += freq_mHz / 2;
+	period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	CHECK(IPULSE_UpdatePulseFrequency(SCT0, PULSE_OUTPUT, SCT_CLOCK_HZ, freq_mHz, event) == kStatus_Success,
+			"%u strikes: frequency updated", strikes);
+	Record(20ULL * period);
+	CheckWaveform(strikes, width, gap, period, 18);
+
+	// The strikes must fit in the period
+	CHECK(IPULSE_UpdatePulseWidth(SCT0, PULSE_OUTPUT, SCT_CLOCK_HZ, 1000000000U / freq_mHz / strikes, event) ==
+			kStatus_InvalidArgument, "%u strikes: too wide strikes refused", strikes);
+
+	// Released on the end of a strike, another multi-spark pulse can then be configured
+	host_idle = Idle;
+	CHECK(IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event) == kStatus_Success, "%u strikes: released", strikes);
+	host_idle = NULL;
+	CHECK((SCT0->CTRL & SCT_CTRL_HALT_L_MASK) && !(SCT0->OUTPUT & (1U << PULSE_OUTPUT)),
+			"%u strikes: halted with the output low", strikes);
+}
+
+/**
+ * @brief Switch from a multi-spark pulse to a single pulse, as the mode switch of the main loop.
+ * @param freq_mHz Pulse frequency of both modes [mHz].
+ */
+static void TestModeSwitch(uint32_t freq_mHz){
+
+	sctimer_config_t config;
+	uint32_t event;
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint64_t restart;
+	uint32_t i, errors = 0;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+
+	IPULSE_SetupMultiSpark(SCT0, 500, 300, 3, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+	SCTMODEL_Run(5ULL * period);
+
+	// Halted at the end of a strike, mid-period
+	host_idle = Idle;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+	host_idle = NULL;
+	CHECK(SCT0->COUNT != 0, "mode switch: halted mid-period (count %u)", SCT0->COUNT);
+
+	CHECK(IPULSE_SetupPulse(SCT0, 1000, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event) == kStatus_Success,
+			"mode switch: single pulse configured");
+	restart = SCTMODEL_GetTime();
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+
+	Record(10ULL * period);
+	CHECK(s_riseCount >= 9 && s_rises[0] - restart >= period - 1 && s_rises[0] - restart <= period + 1,
+			"mode switch: first pulse %llu ticks after the restart, expected %u",
+			(unsigned long long)(s_rises[0] - restart), period);
+	for(i = 1; i < s_riseCount; i++){
+		if(s_rises[i] - s_rises[i - 1] != period){
+			errors++;
+		}
+	}
+	CHECK(errors == 0, "mode switch: %u periods of %u ticks", s_riseCount - 1, period);
+}
+
+int main(void){
+
+	// 600 rpm with 3 strikes, 300 rpm with 5 strikes, 3000 rpm with 2 strikes
+	TestMultiSpark(3, 500, 300, 10000);
+	TestMultiSpark(5, 300, 200, 5000);
+	TestMultiSpark(2, 1000, 150, 50000);
+	TestMultiSpark(FSL_FEATURE_SCT_NUMBER_OF_STATES, 100, 100, 10000);
+
+	CHECK(IPULSE_SetupMultiSpark(SCT0, 100, 100, 1, SCT_CLOCK_HZ, 10000, PULSE_OUTPUT, &(uint32_t){0}) ==
+			kStatus_InvalidArgument, "one strike refused");
+
+	TestModeSwitch(10000);
+	TestModeSwitch(50000);
+
+	return HOST_Report("test_multispark");
+}
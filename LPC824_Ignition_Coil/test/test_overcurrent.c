@@ -0,0 +1,173 @@
+/**
+ * @file test_overcurrent.c
+ *
+ * @brief Host test of the overcurrent protection on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The comparator output is driven on the SCTimer input by the test. A trip must cut the pulse
+ * within a few ticks and be counted once. While the input stays high across several periods, no
+ * pulse may be set: a protection on the rising edge only cuts the first one. Once the input is low
+ * again the pulses must come back at their full width, the multi-spark groups with all their
+ * strikes.
+ */
+
+#include "host.h"
+#include "sct_model.h"
+#include "ignition_pulse.h"
+#include "overcurrent.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define OCP_INPUT		kSCTIMER_Input_2
+#define EDGE_COUNT		256U		///< Recorded edges.
+
+static uint64_t s_rises[EDGE_COUNT];	///< Times of the rising edges [tick].
+static uint64_t s_falls[EDGE_COUNT];	///< Times of the falling edges [tick].
+static uint32_t s_riseCount;
+static uint32_t s_fallCount;
+
+/**
+ * @brief Record the edges of the pulse output.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+	if(level && s_riseCount < EDGE_COUNT){
+		s_rises[s_riseCount++] = time;
+	}
+	else if(!level && s_riseCount && s_fallCount < s_riseCount){
+		s_falls[s_fallCount++] = time;
+	}
+}
+
+/**
+ * @brief Run the model while the firmware waits for the counter to halt.
+ */
+static void Idle(void){
+	SCTMODEL_Run(SCT_CLOCK_HZ / 1000U);
+}
+
+/**
+ * @brief Record the edges of a run.
+ * @param ticks Duration of the run [tick].
+ */
+static void Record(uint64_t ticks){
+
+	s_riseCount = 0;
+	s_fallCount = 0;
+	SCTMODEL_Run(ticks);
+}
+
+/**
+ * @brief Run the model until the next rising edge of the pulse output.
+ */
+static void WaitRise(void){
+
+	s_riseCount = 0;
+	s_fallCount = 0;
+	while(s_riseCount == 0){
+		SCTMODEL_Run(1);
+	}
+}
+
+/**
+ * @brief Count the recorded pulses of a width.
+ * @param width Pulse width [tick].
+ * @return The number of complete pulses of this width.
+ */
+static uint32_t CountPulses(uint32_t width){
+
+	uint32_t count = 0;
+	uint32_t i;
+
+	for(i = 0; i < s_fallCount; i++){
+		if(s_falls[i] - s_rises[i] == width + 1){
+			count++;
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Trip in a pulse, then hold the comparator output high across several periods.
+ * @param strikes Strikes per period, '1' for the single pulse.
+ * @param freq_mHz Pulse frequency [mHz].
+ */
+static void TestTrip(uint32_t strikes, uint32_t freq_mHz){
+
+	sctimer_config_t config;
+	uint32_t event;
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t width = 500U * (SCT_CLOCK_HZ / 1000000U);
+	uint32_t trips;
+	uint64_t trip;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+
+	if(strikes > 1){
+		IPULSE_SetupMultiSpark(SCT0, 500, 300, strikes, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event);
+	}
+	else{
+		IPULSE_SetupPulse(SCT0, 500, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &event);
+	}
+	OCP_Init(OCP_INPUT, 1500);
+	CHECK(OCP_Start(SCT0, PULSE_OUTPUT) == kStatus_Success, "%u strikes: protection started", strikes);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+	trips = OCP_GetTrips();
+
+	// The groups start on the period limits, the records start mid-period
+	SCTMODEL_Run(period / 2);
+	Record(3ULL * period);
+	CHECK(CountPulses(width) == 3 * strikes, "%u strikes: %u full pulses before the trip, expected %u",
+			strikes, CountPulses(width), 3 * strikes);
+
+	// Trip in the middle of a pulse
+	WaitRise();
+	SCTMODEL_Run(width / 2);
+	trip = SCTMODEL_GetTime();
+	SCTMODEL_SetInput(OCP_INPUT, 1);
+	SCTMODEL_Run(10);
+	CHECK(s_fallCount == 1 && s_falls[0] - trip <= 2, "%u strikes: pulse cut %lld ticks after the trip",
+			strikes, s_fallCount ? (long long)(s_falls[0] - trip) : -1LL);
+	CHECK(OCP_GetTrips() == trips + 1, "%u strikes: %u trips counted, expected 1", strikes, OCP_GetTrips() - trips);
+
+	// The comparator output stays high: no pulse is set
+	Record(5ULL * period);
+	CHECK(s_riseCount == 0 && !(SCT0->OUTPUT & (1U << PULSE_OUTPUT)),
+			"%u strikes: %u pulses set with the comparator output high", strikes, s_riseCount);
+	CHECK(OCP_GetTrips() == trips + 1, "%u strikes: %u trips counted while held, expected 1",
+			strikes, OCP_GetTrips() - trips);
+
+	// Full pulses again once the current is below the threshold
+	SCTMODEL_SetInput(OCP_INPUT, 0);
+	WaitRise();
+	SCTMODEL_Run(period / 2);
+	Record(3ULL * period);
+	CHECK(CountPulses(width) == 3 * strikes && s_riseCount == 3 * strikes,
+			"%u strikes: %u full pulses of %u after the trip, expected %u", strikes, CountPulses(width),
+			s_riseCount, 3 * strikes);
+
+	// The events are released with the pulse
+	host_idle = Idle;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+	host_idle = NULL;
+	OCP_Stop(SCT0);
+	CHECK(SCT0->EVEN == 0 && SCT0->OUT[PULSE_OUTPUT].CLR == 0, "%u strikes: events released", strikes);
+}
+
+int main(void){
+
+	// 3000 rpm, single pulse and 3 strikes
+	TestTrip(1, 50000);
+	TestTrip(3, 50000);
+
+	return HOST_Report("test_overcurrent");
+}
@@ -0,0 +1,282 @@
+/**
+ * @file test_playback.c
+ *
+ * @brief Host test of the trace playback on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pulse is configured by 'IPULSE_SetupPulse()' and played by 'PLAYBACK_Start()', the period
+ * callback runs from the real interrupt handler. The test loop acts as the main loop: every
+ * millisecond it calls 'PLAYBACK_Process()' and, for the stream, uploads the next pairs with the
+ * telemetry 'D' command as the host tool does. Several minutes are played: the counter runs must
+ * follow the pairs in order, the first one included and played once, with the width of each pair,
+ * and no underrun may occur while the source keeps up.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+#include "sct_model.h"
+#include "usart_host.h"
+#include "ignition_pulse.h"
+#include "playback.h"
+#include "telemetry.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define TICKS_PER_US	(SCT_CLOCK_HZ / 1000000U)
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define PLAY_TIME_S		180U		///< Played time of each source [s].
+#define LOOP_TICKS		(SCT_CLOCK_HZ / 1000U)	///< Period of the simulated main loop [tick].
+#define EDGE_COUNT		32768U		///< Recorded edges.
+#define TRACE_SIZE		64U			///< Pairs of the flash trace.
+
+static uint64_t s_rises[EDGE_COUNT];	///< Times of the rising edges [tick].
+static uint64_t s_falls[EDGE_COUNT];	///< Times of the falling edges [tick].
+static uint32_t s_riseCount;
+static uint32_t s_fallCount;
+static uint64_t s_start;				///< Time of the counter start [tick].
+
+static playback_pair_t s_pairs[EDGE_COUNT];	///< Pairs uploaded in the stream.
+static uint32_t s_pairCount;
+
+static uint32_t s_random = 2463534242U;	///< State of the pair generator.
+
+/**
+ * @brief Record the edges of the pulse output.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+	if(level && s_riseCount < EDGE_COUNT){
+		s_rises[s_riseCount++] = time;
+	}
+	else if(!level && s_riseCount && s_fallCount < s_riseCount){
+		s_falls[s_fallCount++] = time;
+	}
+}
+
+/**
+ * @brief Next value of the pair generator (xorshift32).
+ * @return A pseudo random value.
+ */
+static uint32_t Random(void){
+
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+/**
+ * @brief Read a field of the playback statistics ('P' command).
+ * @param name Field name.
+ * @return The field value.
+ */
+static uint32_t Stat(const char *name){
+
+	char answer[128], key[24];
+	const char *field;
+
+	USARTHOST_Command("P", answer, sizeof(answer));
+	snprintf(key, sizeof(key), " %s=", name);
+	field = strstr(answer, key);
+	CHECK(field != NULL, "field '%s' in '%s'", name, answer);
+	return field ? strtoul(field + strlen(key), NULL, 10) : 0;
+}
+
+/**
+ * @brief Upload a command line of pairs.
+ * @param line Command line, "D" alone only reads the free room of the stream.
+ * @return The number of free pairs of the stream.
+ */
+static uint32_t Send(const char *line){
+
+	char answer[64];
+	const char *free;
+
+	USARTHOST_Command(line, answer, sizeof(answer));
+	free = strstr(answer, " free=");
+	CHECK(free != NULL, "'%s' answered '%s'", line, answer);
+	return free ? strtoul(free + 6, NULL, 10) : 0;
+}
+
+/**
+ * @brief Upload the next pairs while the stream has room, three pairs per command line.
+ */
+static void Upload(void){
+
+	char line[TELEMETRY_RX_LINE_SIZE];
+	uint32_t free = Send("D");
+	uint32_t n, length;
+
+	while(free >= 3 && s_pairCount + 3 <= EDGE_COUNT){
+		length = snprintf(line, sizeof(line), "D");
+		for(n = 0; n < 3; n++){
+			s_pairs[s_pairCount + n].period_us = 2000 + Random() % 28000;
+			s_pairs[s_pairCount + n].width_us = 100 + Random() % 1900;
+			length += snprintf(line + length, sizeof(line) - length, " %u %u",
+					s_pairs[s_pairCount + n].period_us, s_pairs[s_pairCount + n].width_us);
+		}
+		s_pairCount += 3;
+		n = free;
+		free = Send(line);
+		CHECK(free == n - 3, "three pairs queued, %u free pairs left", free);
+	}
+}
+
+/**
+ * @brief Configure the pulse and start the playback.
+ * @param source Source of the pairs (PLAYBACK_SOURCE).
+ * @return The pulse period event.
+ */
+static uint32_t Start(uint32_t source){
+
+	sctimer_config_t config;
+	uint32_t event;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	s_riseCount = 0;
+	s_fallCount = 0;
+
+	CHECK(IPULSE_SetupPulse(SCT0, 2000, SCT_CLOCK_HZ, 40000, PULSE_OUTPUT, &event) == kStatus_Success,
+			"pulse configured");
+	CHECK(PLAYBACK_Start(SCT0, SCT_CLOCK_HZ, event, source) == kStatus_Success, "source %u started", source);
+	s_start = SCTMODEL_GetTime();
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+	return event;
+}
+
+/**
+ * @brief Check a counter run against its pair.
+ * @param run Run number, '0' for the run started by the counter start.
+ * @param pair Pair expected in the run.
+ * @return '1' if the run matches.
+ */
+static uint8_t CheckRun(uint32_t run, const playback_pair_t *pair){
+
+	uint64_t begin = run ? s_rises[run - 1] : s_start;
+	uint64_t period = s_rises[run] - begin;
+
+	// The counter is enabled at 0: the first limit comes one tick earlier. The output starts low,
+	// the first pulse is the one of the second run.
+	if(period != (uint64_t)pair->period_us * TICKS_PER_US - (run == 0) ||
+			(run && s_falls[run - 1] - begin != (uint64_t)pair->width_us * TICKS_PER_US + 1)){
+		CHECK(0, "run %u: period %llu ticks, width %llu ticks, expected the pair %u us %u us", run,
+				(unsigned long long)period, run ? (unsigned long long)(s_falls[run - 1] - begin) : 0ULL,
+				pair->period_us, pair->width_us);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Play the flash trace: it is played in loop from its first pair.
+ */
+static void TestFlash(void){
+
+	const playback_pair_t first = {24000, 2000}, accel = {20647, 2000};
+	uint32_t event = Start(PLAYBACK_FLASH);
+	uint32_t errors = 0;
+	uint64_t end = s_start + (uint64_t)PLAY_TIME_S * SCT_CLOCK_HZ;
+	uint32_t run;
+
+	while(SCTMODEL_GetTime() < end){
+		SCTMODEL_Run(LOOP_TICKS);
+		PLAYBACK_Process();
+	}
+
+	CHECK(s_riseCount > 10 * TRACE_SIZE, "flash: %u runs", s_riseCount);
+
+	// 16 idle pairs then the acceleration: the first pair is not repeated
+	for(run = 0; run < 16; run++){
+		errors += !CheckRun(run, &first);
+	}
+	errors += !CheckRun(16, &accel);
+	errors += !CheckRun(TRACE_SIZE, &first);
+
+	// The same pairs in each loop of the trace
+	for(run = TRACE_SIZE + 1; run < s_riseCount && errors < 5; run++){
+		if(s_rises[run] - s_rises[run - 1] != s_rises[run - TRACE_SIZE] - s_rises[run - TRACE_SIZE - 1] ||
+				s_falls[run - 1] - s_rises[run - 1] != 2000 * TICKS_PER_US + 1){
+			errors++;
+			CHECK(0, "flash: run %u differs from the previous loop", run);
+		}
+	}
+
+	CHECK(Stat("underruns") == 0, "flash: no underrun");
+	CHECK(Stat("played") >= s_riseCount, "flash: %u pairs played", Stat("played"));
+
+	PLAYBACK_Stop();
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+}
+
+/**
+ * @brief Play a stream uploaded while it is played, then let it run dry.
+ */
+static void TestStream(void){
+
+	uint32_t event;
+	uint32_t errors = 0;
+	uint64_t end;
+	uint32_t run, runs;
+
+	s_pairCount = 0;
+	Upload();
+	event = Start(PLAYBACK_STREAM);
+	end = s_start + (uint64_t)PLAY_TIME_S * SCT_CLOCK_HZ;
+
+	while(SCTMODEL_GetTime() < end){
+		SCTMODEL_Run(LOOP_TICKS);
+		PLAYBACK_Process();
+		Upload();
+	}
+
+	runs = s_riseCount;
+	CHECK(runs > 5000, "stream: %u runs", runs);
+	CHECK(Stat("underruns") == 0, "stream: no underrun while uploaded");
+
+	for(run = 0; run < runs && errors < 5; run++){
+		errors += !CheckRun(run, &s_pairs[run]);
+	}
+
+	// Dry stream: the last pair is held and the underruns counted
+	PLAYBACK_Stop();
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+
+	s_pairCount = 0;
+	Upload();
+	event = Start(PLAYBACK_STREAM);
+	SCTMODEL_Run(10ULL * SCT_CLOCK_HZ);
+	CHECK(Stat("underruns") > 0, "stream: underruns counted");
+	for(run = 0; run < s_pairCount && errors < 5; run++){
+		errors += !CheckRun(run, &s_pairs[run]);
+	}
+	CHECK(s_riseCount > s_pairCount + 10 && CheckRun(s_riseCount - 1, &s_pairs[s_pairCount - 1]),
+			"stream: last pair held");
+
+	PLAYBACK_Stop();
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, event);
+}
+
+int main(void){
+
+	TELEMETRY_RegisterCommand('D', PLAYBACK_DataCommand);
+	TELEMETRY_RegisterCommand('P', PLAYBACK_PrintStats);
+
+	TestFlash();
+	TestStream();
+
+	return HOST_Report("test_playback");
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_settings.c
+ *
+ * @brief Host test of the settings store on the flash model, with power loss injection.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The power loss test replays the same sequence of saves once per flash write or erase of the
+ * sequence, the power being lost during this operation. After each loss the store is read back as
+ * after a reset: it must hold either the last completed save or the interrupted one, and the
+ * following saves must be written and read back normally.
+ */
+
+#include <setjmp.h>
+#include <string.h>
+
+#include "host.h"
+#include "flash_iap.h"
+#include "settings.h"
+
+#define SAVE_COUNT		40		///< Saves of the power loss sequence, enough to fill both sectors and wrap.
+#define PATTERN_COUNT	4		///< Patterns left by each interrupted operation.
+
+static jmp_buf s_reset;			///< Context restored on a power loss.
+
+/**
+ * @brief Telemetry stubs, the status command is not tested.
+ */
+void TELEMETRY_WriteString(const char *string){ (void)string; }
+void TELEMETRY_WriteField(const char *name, uint32_t value){ (void)name; (void)value; }
+void TELEMETRY_WriteHexField(const char *name, uint32_t value){ (void)name; (void)value; }
+void TELEMETRY_WriteEnd(void){}
+
+/**
+ * @brief Core clock used for the IAP timing parameter.
+ */
+uint32_t CLOCK_GetFreq(clock_name_t clock){ (void)clock; return 30000000U; }
+
+/**
+ * @brief Settings of a save number, different for each run.
+ * @param run Run number.
+ * @param n Save number.
+ * @return The settings.
+ */
+static settings_t MakeSettings(uint32_t run, uint32_t n){
+
+	settings_t settings = {1000 + run * 100 + n, 200 + n, run};
+	return settings;
+}
+
+/**
+ * @brief Compare two settings.
+ * @return '1' if they are equal.
+ */
+static int IsEqual(const settings_t *a, const settings_t *b){
+	return memcmp(a, b, sizeof(settings_t)) == 0;
+}
+
+/**
+ * @brief Save settings as the main loop does: update, wait for the write delay, process.
+ * @param settings Settings to save.
+ * @return '1' if the main loop ran, '0' if the power was lost.
+ */
+static int Save(const settings_t *settings){
+
+	int i;
+
+	if(setjmp(s_reset)){
+		host_primask = 0;
+		return 0;
+	}
+
+	SETTINGS_Set(settings);
+	host_ticks += SETTINGS_WRITE_DELAY_MS;
+
+	// Each call performs at most one flash operation
+	for(i = 0; i < 8; i++){
+		SETTINGS_Process(0);
+	}
+	return 1;
+}
+
+/**
+ * @brief Saves and reads back without power loss, over several sector wraps.
+ */
+static void TestSaveRestore(void){
+
+	settings_t restored, settings;
+	uint32_t n;
+
+	FLASHIAP_Reset();
+	CHECK(!SETTINGS_Init(&restored), "blank flash has no settings");
+
+	for(n = 0; n < 100; n++){
+		settings = MakeSettings(0, n);
+		Save(&settings);
+		CHECK(SETTINGS_Init(&restored) && IsEqual(&restored, &settings), "save %u restored", n);
+	}
+
+	// One write per save, each page written once per erase
+	CHECK(FLASHIAP_GetStats()->writes == 100, "%u writes", FLASHIAP_GetStats()->writes);
+	CHECK(FLASHIAP_GetStats()->rewrites == 0, "%u writes over programmed words", FLASHIAP_GetStats()->rewrites);
+	CHECK(FLASHIAP_GetStats()->errors == 0, "%u IAP errors", FLASHIAP_GetStats()->errors);
+	CHECK(FLASHIAP_GetStats()->unmasked == 0, "%u IAP calls with the interrupts enabled", FLASHIAP_GetStats()->unmasked);
+
+	// 16 pages per sector, the first sector is blank and each other one is erased once
+	CHECK(FLASHIAP_GetStats()->erases == 100 / 16 - 1, "%u erases", FLASHIAP_GetStats()->erases);
+}
+
+/**
+ * @brief Successive updates within the write delay are written once, nothing is written too early.
+ */
+static void TestCoalescing(void){
+
+	settings_t restored, settings;
+	uint32_t n;
+
+	FLASHIAP_Reset();
+	SETTINGS_Init(&restored);
+
+	for(n = 0; n < 10; n++){
+		settings = MakeSettings(1, n);
+		SETTINGS_Set(&settings);
+		host_ticks += SETTINGS_WRITE_DELAY_MS / 4;
+		SETTINGS_Process(0);
+	}
+	CHECK(FLASHIAP_GetStats()->writes == 0, "no write before the delay");
+
+	host_ticks += SETTINGS_WRITE_DELAY_MS;
+	SETTINGS_Process(0);
+	CHECK(FLASHIAP_GetStats()->writes == 1, "one write for the coalesced updates");
+	CHECK(SETTINGS_Init(&restored) && IsEqual(&restored, &settings), "last update restored");
+
+	// Setting the stored values again doesn't write
+	SETTINGS_Set(&settings);
+	host_ticks += SETTINGS_WRITE_DELAY_MS;
+	SETTINGS_Process(0);
+	CHECK(FLASHIAP_GetStats()->writes == 1, "no write without change");
+}
+
+/**
+ * @brief Nothing is written while the pulses are enabled.
+ */
+static void TestHeldByPulses(void){
+
+	settings_t restored, settings = MakeSettings(2, 0);
+	uint32_t i;
+
+	FLASHIAP_Reset();
+	SETTINGS_Init(&restored);
+
+	SETTINGS_Set(&settings);
+	for(i = 0; i < 100; i++){
+		host_ticks += SETTINGS_WRITE_DELAY_MS;
+		SETTINGS_Process(1);
+	}
+	CHECK(FLASHIAP_GetStats()->writes + FLASHIAP_GetStats()->erases + FLASHIAP_GetStats()->blankChecks == 0,
+			"no flash operation while the pulses are enabled");
+
+	SETTINGS_Process(0);
+	CHECK(FLASHIAP_GetStats()->writes == 1, "written once the pulses are disabled");
+	CHECK(SETTINGS_Init(&restored) && IsEqual(&restored, &settings), "held settings restored");
+}
+
+/**
+ * @brief Run the save sequence with the power lost during one flash operation.
+ * @param run Run number, the settings of each run are different.
+ * @param operation Write or erase interrupted.
+ * @param seed Seed of the pattern left by the interrupted operation.
+ * @return '1' if the power was lost, '0' if the sequence has less operations.
+ */
+static int RunPowerLoss(uint32_t run, uint32_t operation, uint32_t seed){
+
+	settings_t restored, settings, committed;
+	uint8_t hasCommitted = 0;
+	uint8_t lost = 0;
+	uint32_t n;
+
+	FLASHIAP_Reset();
+	SETTINGS_Init(&restored);
+	FLASHIAP_ArmPowerLoss(operation, &s_reset, seed);
+
+	for(n = 0; n < SAVE_COUNT; n++){
+		settings = MakeSettings(run, n);
+
+		if(Save(&settings)){
+			CHECK(SETTINGS_Init(&restored) && IsEqual(&restored, &settings),
+					"run %u: save %u restored (loss at operation %u)", run, n, operation);
+			committed = settings;
+			hasCommitted = 1;
+			continue;
+		}
+
+		// Reset: the interrupted save is either complete or ignored
+		lost = 1;
+		if(SETTINGS_Init(&restored)){
+			CHECK(IsEqual(&restored, &settings) || (hasCommitted && IsEqual(&restored, &committed)),
+					"run %u: loss during save %u (operation %u) restores rpm %u", run, n, operation, restored.rpm);
+		}
+		else{
+			CHECK(!hasCommitted, "run %u: loss during save %u (operation %u) lost the stored settings", run, n, operation);
+		}
+	}
+
+	CHECK(FLASHIAP_GetStats()->errors == 0, "run %u: %u IAP errors", run, FLASHIAP_GetStats()->errors);
+	CHECK(FLASHIAP_GetStats()->rewrites == 0, "run %u: %u writes over programmed words", run, FLASHIAP_GetStats()->rewrites);
+
+	FLASHIAP_ArmPowerLoss(0, NULL, 0);
+	return lost;
+}
+
+/**
+ * @brief Power loss during each write and erase of the save sequence.
+ */
+static void TestPowerLoss(void){
+
+	uint32_t operation, pattern;
+	uint32_t run = 10;
+	uint32_t losses = 0;
+
+	for(operation = 1; ; operation++){
+		for(pattern = 0; pattern < PATTERN_COUNT; pattern++){
+			if(!RunPowerLoss(run++, operation, operation * 7919U + pattern)){
+				CHECK(operation > SAVE_COUNT, "power loss injected in all the operations (%u)", operation);
+				CHECK(losses == (operation - 1) * PATTERN_COUNT, "%u power losses", losses);
+				return;
+			}
+			losses++;
+		}
+	}
+}
+
+int main(void){
+
+	FLASHIAP_Init();
+
+	TestSaveRestore();
+	TestCoalescing();
+	TestHeldByPulses();
+	TestPowerLoss();
+
+	return HOST_Report("test_settings");
+}
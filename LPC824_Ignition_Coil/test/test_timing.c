@@ -0,0 +1,70 @@
+/**
+ * @file test_timing.c
+ *
+ * @brief Host test of the clock planner and of the applied clock registers.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ */
+
+#include <string.h>
+
+#include "host.h"
+#include "usart_host.h"
+#include "timing.h"
+#include "telemetry.h"
+
+uint32_t SystemCoreClock;
+
+/**
+ * @brief Apply a plan and check the clock registers and the printed plan.
+ * @param plan Plan to apply.
+ * @param expected Expected answer of the 'C' command.
+ */
+static void CheckApply(const timing_plan_t *plan, const char *expected){
+
+	char answer[128];
+
+	HOST_ResetPeripherals();
+	HOST_SET(SYSCON->SYSPLLSTAT, SYSCON_SYSPLLSTAT_LOCK_MASK);
+	TIMING_Apply(plan);
+
+	CHECK(SYSCON->MAINCLKSEL == (plan->pllFreq_Hz ? 3U : 0U), "main clock source %u", SYSCON->MAINCLKSEL);
+	CHECK(SYSCON->SYSAHBCLKDIV == plan->sysDiv, "system clock divider %u", SYSCON->SYSAHBCLKDIV);
+	CHECK((FLASH_CTRL->FLASHCFG & FLASH_CTRL_FLASHCFG_FLASHTIM_MASK) == (plan->coreClock_Hz > TIMING_FLASH_1WS_CLOCK_HZ),
+			"flash access time 0x%X at %u Hz", FLASH_CTRL->FLASHCFG, plan->coreClock_Hz);
+	CHECK(SystemCoreClock == plan->coreClock_Hz, "SystemCoreClock %u", SystemCoreClock);
+
+	USARTHOST_Command("C", answer, sizeof(answer));
+	CHECK(strcmp(answer, expected) == 0, "plan printed as '%s'", answer);
+}
+
+int main(void){
+
+	timing_plan_t plan;
+
+	TELEMETRY_RegisterCommand('C', TIMING_PrintPlan);
+
+	// 40 Hz with 100 ns: the 30 MHz PLL clock without prescaler
+	CHECK(TIMING_Plan(40000, 100, &plan) == kStatus_Success, "40 Hz, 100 ns planned");
+	CHECK(plan.pllFreq_Hz == 60000000U && plan.sysDiv == 2 && plan.coreClock_Hz == 30000000U, "30 MHz from the PLL");
+	CHECK(plan.sctPrescaler == 0 && plan.sctClock_Hz == 30000000U && plan.tickPeriod_ps == 33333, "SCT at 30 MHz");
+	CHECK(plan.maxPeriodTicks == 750000, "40 Hz period %u ticks", plan.maxPeriodTicks);
+	CheckApply(&plan, "C pll=60000000 div=2 core=30000000 pre=0 sct=30000000 tick_ps=33333 maxTicks=750000\r\n");
+
+	// 1 mHz: the period doesn't fit in 32 bits without a prescaler
+	CHECK(TIMING_Plan(1, 1000, &plan) == kStatus_Success, "1 mHz, 1 us planned");
+	CHECK(plan.coreClock_Hz == 30000000U && plan.sctPrescaler == 6, "prescaler %u", plan.sctPrescaler);
+	CHECK(plan.maxPeriodTicks == 30000000000ULL / 7, "1 mHz period %u ticks", plan.maxPeriodTicks);
+
+	// 1 mHz with 100 ns: the prescaler of the fast clocks is too coarse, the IRC needs a prescaler too
+	CHECK(TIMING_Plan(1, 100, &plan) == kStatus_Fail, "1 mHz, 100 ns not possible");
+
+	// The IRC fallback is a valid plan
+	CHECK(TIMING_Plan(40000, 10, &plan) == kStatus_Fail, "10 ns not possible");
+	CHECK(plan.pllFreq_Hz == 0 && plan.sysDiv == 1 && plan.coreClock_Hz == 12000000U, "IRC fallback");
+	CHECK(plan.sctPrescaler == 0 && plan.sctClock_Hz == 12000000U && plan.tickPeriod_ps == 83333, "SCT at 12 MHz");
+	CHECK(plan.maxPeriodTicks == 300000, "40 Hz period %u ticks", plan.maxPeriodTicks);
+	CheckApply(&plan, "C pll=0 div=1 core=12000000 pre=0 sct=12000000 tick_ps=83333 maxTicks=300000\r\n");
+
+	return HOST_Report("test_timing");
+}
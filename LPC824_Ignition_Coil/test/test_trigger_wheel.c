@@ -0,0 +1,293 @@
+/**
+ * @file test_trigger_wheel.c
+ *
+ * @brief Host test of the trigger wheel generator on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The generator is configured by 'TWHEEL_Setup()' and its tooth callback runs from the real
+ * interrupt handler on each tooth period event. The wheel signal must have the teeth of the wheel,
+ * each one tooth period apart, with the missing teeth as one long tooth before the gap. The coil
+ * pulse must start on the wheel edge of the spark tooth of each revolution with the configured
+ * width, also when it spans the gap.\n
+ * A frequency or width update is pending until the callback prepares the spark tooth: the
+ * revolution in progress keeps its configuration and the new one starts on the spark tooth.\n
+ * 60-2 and 36-1 wheels are run from the lowest to the highest command frequency of the main loop.
+ */
+
+#include <stdio.h>
+
+#include "host.h"
+#include "sct_model.h"
+#include "trigger_wheel.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define COIL_OUTPUT		kSCTIMER_Out_0
+#define WHEEL_OUTPUT	kSCTIMER_Out_1
+#define MIN_FREQ_mHZ	70000U		///< Lowest command frequency of the main loop [mHz].
+#define MAX_FREQ_mHZ	300000U		///< Highest command frequency of the main loop [mHz].
+#define REVOLUTIONS		8U			///< Revolutions recorded per run.
+#define EDGE_COUNT		1024U		///< Recorded edges per output.
+
+/**
+ * @brief Edges of an output.
+ */
+typedef struct{
+	uint64_t rises[EDGE_COUNT];		///< Times of the rising edges [tick].
+	uint64_t falls[EDGE_COUNT];		///< Times of the falling edges [tick].
+	uint32_t riseCount;
+	uint32_t fallCount;
+} edges_t;
+
+static edges_t s_wheel;				///< Wheel signal.
+static edges_t s_coil;				///< Coil pulse.
+static int32_t s_toothOf[EDGE_COUNT];	///< Tooth of each wheel rising edge, '-1' before the first gap.
+static uint32_t s_event;			///< Tooth period event.
+static uint32_t s_toothEvents;		///< Ticks with the tooth period event.
+
+/**
+ * @brief Record the edges of the wheel and coil outputs.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	edges_t *e = output == WHEEL_OUTPUT ? &s_wheel : output == COIL_OUTPUT ? &s_coil : NULL;
+
+	if(e == NULL){
+		return;
+	}
+	if(level && e->riseCount < EDGE_COUNT){
+		e->rises[e->riseCount++] = time;
+	}
+	else if(!level && e->riseCount && e->fallCount < e->riseCount){
+		e->falls[e->fallCount++] = time;
+	}
+}
+
+/**
+ * @brief Count the tooth period events, each one runs the tooth callback.
+ */
+static void OnEvent(uint32_t events, uint64_t time){
+
+	if(events & (1U << s_event)){
+		s_toothEvents++;
+	}
+}
+
+/**
+ * @brief Run the model while the firmware waits for the counter to halt.
+ */
+static void Idle(void){
+	SCTMODEL_Run(SCT_CLOCK_HZ / 1000U);
+}
+
+/**
+ * @brief Start a new recording, the edges are recorded while the model runs.
+ */
+static void Clear(void){
+
+	s_wheel.riseCount = 0;
+	s_wheel.fallCount = 0;
+	s_coil.riseCount = 0;
+	s_coil.fallCount = 0;
+	s_toothEvents = 0;
+}
+
+/**
+ * @brief Period of a regular tooth, as computed by the generator.
+ * @param teeth Number of teeth, missing ones included.
+ * @param freq_mHz Wheel revolution frequency [mHz].
+ * @return The tooth period [tick].
+ */
+static uint32_t ToothTicks(uint32_t teeth, uint32_t freq_mHz){
+	return (uint64_t)SCT_CLOCK_HZ * 1000U / ((uint64_t)freq_mHz * teeth);
+}
+
+/**
+ * @brief Check the recorded wheel signal, a tooth period change is allowed once.
+ * @param name Name of the run.
+ * @param teeth Number of teeth, missing ones included.
+ * @param missing Number of missing teeth.
+ * @param sparkTooth Tooth on which the coil pulse starts.
+ * @param before Tooth period before the change [tick].
+ * @param after Tooth period after the change, 'before' if none [tick].
+ */
+static void CheckWheel(const char *name, uint32_t teeth, uint32_t missing, uint32_t sparkTooth, uint32_t before,
+		uint32_t after){
+
+	uint32_t period = before;
+	uint32_t present = teeth - missing;
+	uint32_t gaps = 0, errors = 0, changes = 0;
+	uint32_t i, interval;
+	int32_t tooth = -1;
+
+	s_toothOf[0] = -1;
+	for(i = 1; i < s_wheel.riseCount; i++){
+
+		interval = s_wheel.rises[i] - s_wheel.rises[i - 1];
+
+		// The new period starts on the spark tooth
+		if(period != after && (interval == after || interval == (missing + 1) * after)){
+			CHECK(tooth == (int32_t)sparkTooth, "%s: period changed on tooth %d, expected %u", name, tooth, sparkTooth);
+			period = after;
+			changes++;
+		}
+
+		if(interval == (missing + 1) * period){
+			CHECK(tooth < 0 || tooth == (int32_t)present - 1, "%s: gap after tooth %d, expected %u", name, tooth,
+					present - 1);
+			tooth = 0;
+			gaps++;
+		}
+		else if(interval == period){
+			tooth = tooth < 0 ? -1 : tooth + 1;
+		}
+		else if(errors++ < 4){
+			CHECK(0, "%s: tooth %d of %u ticks, expected %u or %u", name, tooth, interval, period,
+					(missing + 1) * period);
+		}
+		s_toothOf[i] = tooth;
+
+		// The wheel signal is cleared at half a regular tooth of the period of the previous tooth
+		if(s_wheel.falls[i - 1] - s_wheel.rises[i - 1] != period / 2 + 1 && errors++ < 4){
+			CHECK(0, "%s: tooth %d high %llu ticks, expected %u", name, s_toothOf[i - 1],
+					(unsigned long long)(s_wheel.falls[i - 1] - s_wheel.rises[i - 1]), period / 2 + 1);
+		}
+	}
+
+	CHECK(errors == 0, "%s: %u teeth of %u ticks", name, s_wheel.riseCount, period);
+	CHECK(gaps >= REVOLUTIONS - 1, "%s: %u gaps of %u missing teeth", name, gaps, missing);
+	CHECK(changes == (before != after), "%s: %u tooth period changes", name, changes);
+	CHECK(s_toothEvents == s_wheel.riseCount, "%s: one tooth interrupt per tooth (%u events, %u teeth)", name,
+			s_toothEvents, s_wheel.riseCount);
+}
+
+/**
+ * @brief Check the recorded coil pulses against the wheel, a width change is allowed once.
+ * @param name Name of the run.
+ * @param sparkTooth Tooth on which the coil pulse starts.
+ * @param before Coil pulse width before the change [tick].
+ * @param after Coil pulse width after the change, 'before' if none [tick].
+ */
+static void CheckCoil(const char *name, uint32_t sparkTooth, uint32_t before, uint32_t after){
+
+	uint32_t width = before;
+	uint32_t pulses = 0, errors = 0;
+	uint32_t i, j = 0, high;
+
+	for(i = 0; i < s_coil.fallCount; i++){
+
+		// Phase lock: the pulse starts with the wheel edge of the spark tooth
+		while(j < s_wheel.riseCount && s_wheel.rises[j] < s_coil.rises[i]){
+			j++;
+		}
+		if(j == s_wheel.riseCount || s_toothOf[j] < 0){
+			continue;
+		}
+		if((s_wheel.rises[j] != s_coil.rises[i] || s_toothOf[j] != (int32_t)sparkTooth) && errors++ < 4){
+			CHECK(0, "%s: pulse %u starts %lld ticks from tooth %d", name, i,
+					(long long)(s_coil.rises[i] - s_wheel.rises[j]), s_toothOf[j]);
+		}
+
+		high = s_coil.falls[i] - s_coil.rises[i];
+		if(high == after + 1){
+			width = after;
+		}
+		if(high != width + 1 && errors++ < 4){
+			CHECK(0, "%s: pulse %u of %u ticks, expected %u", name, i, high, width + 1);
+		}
+		pulses++;
+	}
+
+	CHECK(errors == 0 && pulses >= REVOLUTIONS - 2, "%s: %u pulses on tooth %u", name, pulses, sparkTooth);
+	CHECK(width == after, "%s: width of %u ticks applied", name, after);
+}
+
+/**
+ * @brief Run a wheel at a frequency, then at another, then with another coil pulse width.
+ * @param teeth Number of teeth, missing ones included.
+ * @param missing Number of missing teeth.
+ * @param sparkTooth Tooth on which the coil pulse starts.
+ * @param width_us Coil pulse width [us].
+ * @param freq_mHz Wheel revolution frequency [mHz].
+ * @param nextFreq_mHz Frequency of the update [mHz].
+ */
+static void TestWheel(uint32_t teeth, uint32_t missing, uint32_t sparkTooth, uint32_t width_us, uint32_t freq_mHz,
+		uint32_t nextFreq_mHz){
+
+	sctimer_config_t config;
+	char name[48];
+	uint32_t tooth = ToothTicks(teeth, freq_mHz);
+	uint32_t nextTooth = ToothTicks(teeth, nextFreq_mHz);
+	uint32_t width = (uint64_t)width_us * SCT_CLOCK_HZ / 1000000U;
+	uint64_t revolution = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint64_t nextRevolution = (uint64_t)SCT_CLOCK_HZ * 1000U / nextFreq_mHz;
+
+	snprintf(name, sizeof(name), "%u-%u %u mHz", teeth, missing, freq_mHz);
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, OnEvent);
+
+	CHECK(TWHEEL_Setup(SCT0, teeth, missing, sparkTooth, width_us, SCT_CLOCK_HZ, freq_mHz, COIL_OUTPUT, WHEEL_OUTPUT,
+			&s_event) == kStatus_Success, "%s: configured", name);
+	CHECK(SCT0->EVEN & (1U << s_event), "%s: tooth interrupt enabled", name);
+	SCTIMER_StartTimer(SCT0, kSCTIMER_Counter_L);
+
+	// The first tooth after the start is one tick short
+	SCTMODEL_Run(revolution);
+	Clear();
+	SCTMODEL_Run(REVOLUTIONS * revolution);
+	CheckWheel(name, teeth, missing, sparkTooth, tooth, tooth);
+	CheckCoil(name, sparkTooth, width, width);
+
+	// Updated in the middle of a revolution, the revolution in progress is completed
+	Clear();
+	SCTMODEL_Run(revolution + revolution / 3);
+	CHECK(TWHEEL_UpdateFrequency(SCT0, SCT_CLOCK_HZ, nextFreq_mHz, s_event) == kStatus_Success,
+			"%s: frequency updated", name);
+	SCTMODEL_Run(revolution + REVOLUTIONS * nextRevolution);
+	snprintf(name, sizeof(name), "%u-%u %u to %u mHz", teeth, missing, freq_mHz, nextFreq_mHz);
+	CheckWheel(name, teeth, missing, sparkTooth, tooth, nextTooth);
+	CheckCoil(name, sparkTooth, width, width);
+
+	Clear();
+	SCTMODEL_Run(nextRevolution + nextRevolution / 3);
+	CHECK(TWHEEL_UpdatePulseWidth(SCT0, SCT_CLOCK_HZ, width_us / 2, s_event) == kStatus_Success,
+			"%s: width updated", name);
+	SCTMODEL_Run(REVOLUTIONS * nextRevolution);
+	snprintf(name, sizeof(name), "%u-%u %u mHz half width", teeth, missing, nextFreq_mHz);
+	CheckWheel(name, teeth, missing, sparkTooth, nextTooth, nextTooth);
+	CheckCoil(name, sparkTooth, width, width / 2);
+
+	// A pulse longer than a revolution is refused, the running configuration is kept
+	CHECK(TWHEEL_UpdatePulseWidth(SCT0, SCT_CLOCK_HZ, 2U * 1000000000U / nextFreq_mHz, s_event) ==
+			kStatus_InvalidArgument, "%s: pulse longer than a revolution refused", name);
+
+	host_idle = Idle;
+	CHECK(TWHEEL_Release(SCT0, s_event) == kStatus_Success && !TWHEEL_IsActive(), "%s: released", name);
+	host_idle = NULL;
+	CHECK(!(SCT0->OUTPUT & (1U << COIL_OUTPUT)), "%s: coil output low after the release", name);
+}
+
+int main(void){
+
+	// 60-2 and 36-1 wheels, spark on the first tooth after the gap as in the main loop
+	TestWheel(60, 2, 0, 2000, MIN_FREQ_mHZ, MAX_FREQ_mHZ);
+	TestWheel(60, 2, 0, 1000, MAX_FREQ_mHZ, MIN_FREQ_mHZ);
+	TestWheel(36, 1, 0, 2000, MIN_FREQ_mHZ, MAX_FREQ_mHZ);
+	TestWheel(36, 1, 0, 1000, MAX_FREQ_mHZ, MIN_FREQ_mHZ);
+
+	// Pulse spanning the gap: it ends in the long tooth or after it
+	TestWheel(36, 1, 33, 1000, MAX_FREQ_mHZ, MAX_FREQ_mHZ / 2);
+	TestWheel(60, 2, 57, 500, MAX_FREQ_mHZ, MIN_FREQ_mHZ);
+
+	CHECK(TWHEEL_Setup(SCT0, 36, 36, 0, 1000, SCT_CLOCK_HZ, MAX_FREQ_mHZ, COIL_OUTPUT, WHEEL_OUTPUT, &s_event) ==
+			kStatus_InvalidArgument, "wheel without teeth refused");
+	CHECK(TWHEEL_Setup(SCT0, 36, 1, 35, 1000, SCT_CLOCK_HZ, MAX_FREQ_mHZ, COIL_OUTPUT, WHEEL_OUTPUT, &s_event) ==
+			kStatus_InvalidArgument, "spark on a missing tooth refused");
+
+	return HOST_Report("test_trigger_wheel");
+}
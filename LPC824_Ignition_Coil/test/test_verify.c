@@ -0,0 +1,327 @@
+/**
+ * @file test_verify.c
+ *
+ * @brief Host test of the pulse verification on the SCTimer model.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * The pulse output is looped back to the verified SCTimer input, as the coil output pin on the
+ * target, and the falling edge callback runs from the real interrupt handler. The measured width
+ * and period must be the ones of the output edges: for a pulse of a known width and period, for
+ * each period of a dithered pulse, and after an interrupt delayed past the next rising edge, whose
+ * captures of different periods are discarded. An error of 'VERIFY_ALARM_TICKS' must not raise
+ * the alarm, one more tick must.
+ */
+
+#include "host.h"
+#include "sct_model.h"
+#include "ignition_pulse.h"
+#include "verify.h"
+
+#define SCT_CLOCK_HZ	30000000U	///< SCTimer clock of the 30 MHz plan [Hz].
+#define PULSE_OUTPUT	kSCTIMER_Out_0
+#define VERIFY_INPUT	kSCTIMER_Input_1
+#define PULSE_WIDTH_US	1000U		///< Pulse width [us].
+
+static uint32_t s_event;			///< Pulse period event.
+static uint64_t s_rise;				///< Time of the last rising edge of the output [tick].
+static uint32_t s_period;			///< Last period of the output [tick].
+static uint32_t s_width;			///< Last width of the output [tick].
+static uint8_t s_loopback = 1;		///< The output is looped back to the verified input.
+
+/**
+ * @brief Loop the output back to the verified input and measure it.
+ */
+static void OnOutput(uint32_t output, uint8_t level, uint64_t time){
+
+	if(output != PULSE_OUTPUT){
+		return;
+	}
+
+	if(s_loopback){
+		SCTMODEL_SetInput(VERIFY_INPUT, level);
+	}
+	if(level){
+		s_period = s_rise ? time - s_rise : 0;
+		s_rise = time;
+	}
+	else{
+		s_width = time - s_rise;
+	}
+}
+
+/**
+ * @brief Configure a single pulse and its verification.
+ * @param freq_mHz Pulse frequency [mHz].
+ * @param dither '1' to enable the dithering.
+ */
+static void Start(uint32_t freq_mHz, uint8_t dither){
+
+	sctimer_config_t config;
+
+	HOST_ResetPeripherals();
+	SCTIMER_GetDefaultConfig(&config);
+	SCTIMER_Init(SCT0, &config);
+	SCTMGR_Init(SCT0);
+	SCTMODEL_Reset();
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	s_rise = 0;
+	s_loopback = 1;
+
+	CHECK(IPULSE_SetupPulse(SCT0, PULSE_WIDTH_US, SCT_CLOCK_HZ, freq_mHz, PULSE_OUTPUT, &s_event) == kStatus_Success,
+			"%u mHz pulse configured", freq_mHz);
+	IPULSE_EnableDithering(SCT0, SCT_CLOCK_HZ, freq_mHz, s_event, dither);
+	CHECK(VERIFY_Start(SCT0, VERIFY_INPUT, s_event) == kStatus_Success, "%u mHz: verification started", freq_mHz);
+	VERIFY_SetCommand(SCT_CLOCK_HZ, freq_mHz, PULSE_WIDTH_US);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 1);
+}
+
+/**
+ * @brief Stop the pulse and its verification.
+ */
+static void Stop(void){
+
+	VERIFY_Stop(SCT0);
+	IPULSE_EnableDithering(SCT0, SCT_CLOCK_HZ, 1000, s_event, 0);
+	IPULSE_EnablePulse(SCT0, PULSE_OUTPUT, 0);
+	SCT0->CTRL |= SCT_CTRL_HALT_L_MASK;
+	IPULSE_ReleasePulse(SCT0, PULSE_OUTPUT, s_event);
+}
+
+/**
+ * @brief Pulse of an exact period: each measure is the commanded width and period.
+ * @param freq_mHz Pulse frequency, a divider of the SCTimer clock [mHz].
+ */
+static void TestKnownPulse(uint32_t freq_mHz){
+
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t width = (uint64_t)PULSE_WIDTH_US * SCT_CLOCK_HZ / 1000000U;
+	verify_stats_t stats;
+
+	Start(freq_mHz, 0);
+	SCTMODEL_Run(20ULL * period);
+	VERIFY_GetStats(&stats);
+
+	CHECK(stats.count >= 19, "%u mHz: %u pulses measured", freq_mHz, stats.count);
+	CHECK(stats.width == s_width && stats.period == s_period, "%u mHz: width %u and period %u ticks, output %u and %u",
+			freq_mHz, stats.width, stats.period, s_width, s_period);
+	CHECK(s_period == period, "%u mHz: output period %u ticks, expected %u", freq_mHz, s_period, period);
+	CHECK(stats.width == width + 1, "%u mHz: width %u ticks, expected %u", freq_mHz, stats.width, width + 1);
+	CHECK(stats.periodErrorMax == 0 && stats.widthErrorMax == 1 && !stats.alarms && !VERIFY_GetAlarm(),
+			"%u mHz: errors %u/1000 and %u ticks, %u alarms", freq_mHz, stats.periodErrorMax, stats.widthErrorMax,
+			stats.alarms);
+
+	Stop();
+}
+
+/**
+ * @brief Run to the next rising edge of the output.
+ * @param period Pulse period [tick].
+ */
+static void RunToRise(uint32_t period){
+
+	uint64_t rise = s_rise;
+
+	while(s_rise == rise){
+		SCTMODEL_RunToEvent(period);
+	}
+}
+
+/**
+ * @brief Run to the measure of the next pulse.
+ * @param period Pulse period [tick].
+ * @param stats Pointer where the statistics are copied after the measure.
+ */
+static void RunToMeasure(uint32_t period, verify_stats_t *stats){
+
+	uint32_t count;
+
+	VERIFY_GetStats(stats);
+	count = stats->count;
+	while(stats->count == count){
+		SCTMODEL_RunToEvent(period);
+		VERIFY_GetStats(stats);
+	}
+}
+
+/**
+ * @brief Dithered pulse: each measured period is the period of the output, N or N+1 ticks.
+ * @param freq_mHz Pulse frequency, not a divider of the SCTimer clock [mHz].
+ */
+static void TestDitheredPulse(uint32_t freq_mHz){
+
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t errors = 0, longer = 0;
+	verify_stats_t stats;
+	uint32_t i;
+
+	Start(freq_mHz, 1);
+	RunToMeasure(period, &stats);
+	RunToMeasure(period, &stats);
+
+	for(i = 0; i < 200; i++){
+		RunToMeasure(period, &stats);
+		longer += stats.period == period + 1;
+		if((stats.period != s_period || stats.width != s_width || (stats.period != period && stats.period != period + 1))
+				&& errors++ < 4){
+			CHECK(0, "%u mHz: measured %u/%u ticks, output %u/%u", freq_mHz, stats.period, stats.width, s_period,
+					s_width);
+		}
+	}
+
+	CHECK(errors == 0 && longer > 0 && longer < i, "%u mHz: %u periods measured, %u of %u ticks", freq_mHz, i, longer,
+			period + 1);
+	CHECK(stats.periodErrorMax < 1000 && !stats.alarms && !VERIFY_GetAlarm(), "%u mHz: period error %u/1000 tick",
+			freq_mHz, stats.periodErrorMax);
+
+	Stop();
+}
+
+/**
+ * @brief Delayed falling edge interrupt.
+ * Delayed in its period, the measure is right. Delayed past the next rising edge, the captures of
+ * the falling edge and of the next rising edge are read: the pulse is measured once. A read back
+ * pulse across the counter limit has its edges captured in different periods, falling before
+ * rising: it is discarded and the next period isn't measured as its previous rising edge is unknown,
+ * the period of the last measured pulse must not be reused.
+ * @param freq_mHz Pulse frequency, a divider of the SCTimer clock [mHz].
+ */
+static void TestDelayedInterrupt(uint32_t freq_mHz){
+
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t width = (uint64_t)PULSE_WIDTH_US * SCT_CLOCK_HZ / 1000000U;
+	verify_stats_t stats, before;
+	uint32_t reg;
+
+	Start(freq_mHz, 0);
+	reg = SCT0->EVENT[s_event].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	RunToMeasure(period, &stats);
+	RunToMeasure(period, &stats);
+
+	// Interrupts disabled across the falling edge
+	RunToRise(period);
+	host_primask = 1;
+	SCTMODEL_Run(width + period / 4);
+	VERIFY_GetStats(&before);
+	host_primask = 0;
+	SCTMODEL_Run(1);
+	VERIFY_GetStats(&stats);
+	CHECK(stats.count == before.count + 1 && stats.width == width + 1 && stats.period == period,
+			"%u mHz: delayed in the period, width %u and period %u ticks", freq_mHz, stats.width, stats.period);
+
+	// Interrupts disabled until the next pulse
+	RunToRise(period);
+	host_primask = 1;
+	SCTMODEL_Run(period + width / 2);
+	VERIFY_GetStats(&before);
+	host_primask = 0;
+	SCTMODEL_Run(1);
+	VERIFY_GetStats(&stats);
+	CHECK(stats.count == before.count + 1 && stats.width == width + 1 && stats.period == period,
+			"%u mHz: delayed past the next pulse, measured once, width %u and period %u ticks", freq_mHz, stats.width,
+			stats.period);
+
+	// Last measured pulse in a period longer by 2 ticks, then a read back pulse from 100 ticks before the limit
+	RunToMeasure(period, &stats);
+	SCT0->SCTMATCHREL[reg] += 2;
+	RunToMeasure(period, &stats);
+	SCT0->SCTMATCHREL[reg] -= 2;
+	s_loopback = 0;
+	RunToRise(period);
+	SCTMODEL_Run(period - 100);
+	SCTMODEL_SetInput(VERIFY_INPUT, 1);
+	SCTMODEL_Run(width);
+	SCTMODEL_SetInput(VERIFY_INPUT, 0);
+	VERIFY_GetStats(&before);
+	SCTMODEL_Run(period / 2);
+	VERIFY_GetStats(&stats);
+	CHECK(stats.count == before.count && stats.width == before.width && stats.period == before.period &&
+			!stats.alarms, "%u mHz: edges in different periods discarded", freq_mHz);
+
+	// The next rising edge has no known previous one
+	s_loopback = 1;
+	SCTMODEL_SetObservers(OnOutput, NULL);
+	RunToMeasure(period, &stats);
+	CHECK(stats.count == before.count + 1 && stats.period == before.period, "%u mHz: no period after a discard",
+			freq_mHz);
+	RunToMeasure(period, &stats);
+	CHECK(stats.period == period && stats.width == width + 1 && !stats.alarms && !VERIFY_GetAlarm(),
+			"%u mHz: measured again, width %u and period %u ticks", freq_mHz, stats.width, stats.period);
+
+	Stop();
+}
+
+/**
+ * @brief Offset the width or period match of the pulse for 3 pulses, as a faulty output would.
+ * The statistics are cleared first.
+ * @param match '0' for the period, '1' for the width.
+ * @param offset Offset of the match [tick].
+ * @param freq_mHz Pulse frequency, a divider of the SCTimer clock [mHz].
+ * @return The number of alarms.
+ */
+static uint32_t Offset(uint32_t match, int32_t offset, uint32_t freq_mHz){
+
+	uint32_t period = (uint64_t)SCT_CLOCK_HZ * 1000U / freq_mHz;
+	uint32_t reg = SCT0->EVENT[s_event + match].CTRL & SCT_EVENT_CTRL_MATCHSEL_MASK;
+	verify_stats_t stats;
+	uint32_t i;
+
+	VERIFY_SetCommand(SCT_CLOCK_HZ, freq_mHz, PULSE_WIDTH_US);
+	SCT0->SCTMATCHREL[reg] += offset;
+	for(i = 0; i < 3; i++){
+		RunToMeasure(period, &stats);
+	}
+	SCT0->SCTMATCHREL[reg] -= offset;
+	for(i = 0; i < 3; i++){
+		RunToMeasure(period, &stats);
+	}
+
+	return stats.alarms;
+}
+
+/**
+ * @brief Alarm threshold, the measured width includes the tick of the clear action.
+ * @param freq_mHz Pulse frequency, a divider of the SCTimer clock [mHz].
+ */
+static void TestAlarm(uint32_t freq_mHz){
+
+	verify_stats_t stats;
+
+	Start(freq_mHz, 0);
+
+	CHECK(Offset(1, VERIFY_ALARM_TICKS - 1, freq_mHz) == 0 && !VERIFY_GetAlarm(),
+			"%u mHz: width error of %u ticks allowed", freq_mHz, VERIFY_ALARM_TICKS);
+	CHECK(Offset(1, VERIFY_ALARM_TICKS, freq_mHz) == 3 && VERIFY_GetAlarm() && !VERIFY_GetAlarm(),
+			"%u mHz: width error of %u ticks raises the alarm", freq_mHz, VERIFY_ALARM_TICKS + 1);
+	CHECK(Offset(1, -VERIFY_ALARM_TICKS - 1, freq_mHz) == 0 && !VERIFY_GetAlarm(),
+			"%u mHz: width shorter by %u ticks allowed", freq_mHz, VERIFY_ALARM_TICKS);
+	CHECK(Offset(1, -VERIFY_ALARM_TICKS - 2, freq_mHz) == 3 && VERIFY_GetAlarm(),
+			"%u mHz: width shorter by %u ticks raises the alarm", freq_mHz, VERIFY_ALARM_TICKS + 1);
+
+	CHECK(Offset(0, VERIFY_ALARM_TICKS, freq_mHz) == 0 && !VERIFY_GetAlarm(),
+			"%u mHz: period error of %u ticks allowed", freq_mHz, VERIFY_ALARM_TICKS);
+	CHECK(Offset(0, VERIFY_ALARM_TICKS + 1, freq_mHz) == 3 && VERIFY_GetAlarm(),
+			"%u mHz: period error of %u ticks raises the alarm", freq_mHz, VERIFY_ALARM_TICKS + 1);
+	CHECK(Offset(0, -VERIFY_ALARM_TICKS - 1, freq_mHz) == 3 && VERIFY_GetAlarm(),
+			"%u mHz: period shorter by %u ticks raises the alarm", freq_mHz, VERIFY_ALARM_TICKS + 1);
+
+	VERIFY_SetCommand(SCT_CLOCK_HZ, freq_mHz, PULSE_WIDTH_US);
+	VERIFY_GetStats(&stats);
+	CHECK(stats.count == 0 && stats.alarms == 0 && !VERIFY_GetAlarm(), "%u mHz: statistics cleared by the command",
+			freq_mHz);
+
+	Stop();
+}
+
+int main(void){
+
+	TestKnownPulse(100000);
+	TestKnownPulse(250000);
+	TestDitheredPulse(226667);
+	TestDitheredPulse(70001);
+	TestDelayedInterrupt(100000);
+	TestDelayedInterrupt(300000);
+	TestAlarm(100000);
+
+	return HOST_Report("test_verify");
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+@file font_gen.py
+
+@brief Generate the scaled fonts of the LCD from the 8x8 font of Font.c.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The glyphs of 'Font_TAB' are scaled by pixel replication and written as 'lcd_font_t' descriptors:
+one 32-bit word per glyph column (bit 0 is the top pixel, page 'n' is byte 'n'), with the offset
+and width tables of the glyphs, so the firmware neither scales nor computes glyph positions.
+
+Usage: python3 tools/font_gen.py [source/Font.c] [source/font_digits]
+"""
+
+import re
+import sys
+
+FONT_FIRST = 24             # First character of 'Font_TAB'.
+GLYPH_SIZE = 8              # Bytes of a 'Font_TAB' glyph: the width then 7 columns.
+SPACING = 2                 # Blank columns after a scaled glyph [px].
+
+# Generated fonts: name, scale factor, characters (a contiguous range)
+FONTS = [
+    ("FONT_Digits2x", 2, "0123456789"),
+    ("FONT_Digits3x", 3, "0123456789"),
+]
+
+
+def read_font(path):
+    """Return the bytes of 'Font_TAB' from the C source."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    start = text.index("Font_TAB[] =")
+    body = text[text.index("{", start) + 1:text.index("};", start)]
+    body = re.sub(r"//[^\n]*", "", body)
+    return [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+
+
+def scale_glyph(font, char, scale):
+    """Return the column words of a character scaled by 'scale'."""
+    index = (ord(char) - FONT_FIRST) * GLYPH_SIZE
+    width = font[index]
+    columns = []
+
+    for byte in font[index + 1:index + 1 + width]:
+        word = 0
+        for bit in range(8):
+            if byte & (1 << bit):
+                word |= ((1 << scale) - 1) << (bit * scale)
+        columns += [word] * scale
+
+    return columns
+
+
+def generate(font, name, scale, chars):
+    """Return the C definitions of a scaled font and its 'extern' declaration."""
+    words, offsets, widths = [], [], []
+
+    for char in chars:
+        columns = scale_glyph(font, char, scale)
+        offsets.append(len(words))
+        widths.append(len(columns))
+        words += columns
+
+    prefix = name.replace("FONT_", "")
+    prefix = "s_" + prefix[0].lower() + prefix[1:]
+    cell = max(widths) + SPACING
+
+    c = []
+    c.append("// Characters '%s' to '%s' scaled by %d" % (chars[0], chars[-1], scale))
+    c.append("static const uint32_t %sColumns[%d] =\n{" % (prefix, len(words)))
+    for i, char in enumerate(chars):
+        glyph = words[offsets[i]:offsets[i] + widths[i]]
+        c.append("\t" + ",".join("0x%08X" % w for w in glyph) + ",\t// [%s]" % char)
+    c[-1] = c[-1].replace(",\t//", " \t//")
+    c.append("};")
+    c.append("static const uint16_t %sOffsets[%d] = {%s};" % (prefix, len(chars), ",".join(str(o) for o in offsets)))
+    c.append("static const uint8_t %sWidths[%d] = {%s};" % (prefix, len(chars), ",".join(str(w) for w in widths)))
+    c.append("const lcd_font_t %s = {.columns = %sColumns, .offsets = %sOffsets, .widths = %sWidths,"
+             % (name, prefix, prefix, prefix))
+    c.append("\t.first = '%s', .count = %d, .pages = %d, .spacing = %d, .cellWidth = %d};"
+             % (chars[0], len(chars), scale, SPACING, cell))
+
+    h = "extern const lcd_font_t %s;\t\t///< Characters '%s' to '%s' scaled by %d, %d pages high." % (
+        name, chars[0], chars[-1], scale, scale)
+
+    return "\n".join(c), h
+
+
+HEADER = """/**
+ * @file font_digits.%s
+ *
+ * @brief Scaled digit fonts, generated by 'tools/font_gen.py' from the 8x8 font. Do not edit.
+ * @date 18 oct. 2026
+ * @author Alec Guerin
+ *
+ * Each glyph column is a 32-bit word, bit 0 is the top pixel and page 'n' is byte 'n'. The offset and
+ * width of each glyph are stored in tables so the renderer only reads them.
+ */
+"""
+
+
+def main():
+    source = sys.argv[1] if len(sys.argv) > 1 else "source/Font.c"
+    output = sys.argv[2] if len(sys.argv) > 2 else "source/font_digits"
+
+    font = read_font(source)
+    defs, decls = [], []
+    for name, scale, chars in FONTS:
+        d, h = generate(font, name, scale, chars)
+        defs.append(d)
+        decls.append(h)
+
+    with open(output + ".h", "w", newline="\n") as f:
+        f.write(HEADER % "h")
+        f.write("\n#ifndef FONT_DIGITS_H_\n#define FONT_DIGITS_H_\n\n#include \"lcd.h\"\n\n")
+        f.write("\n".join(decls))
+        f.write("\n\n#endif /* FONT_DIGITS_H_ */\n")
+
+    with open(output + ".c", "w", newline="\n") as f:
+        f.write(HEADER % "c")
+        f.write("\n#include \"font_digits.h\"\n\n")
+        f.write("\n\n".join(defs))
+        f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+@file img2c.py
+
+@brief Convert a PBM or PNG picture to a constant 'T_picture' for Font.c.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The picture is cut in pages of 8 rows: one byte per column and per page, bit 0 is the top pixel.
+A dark pixel is a set bit. The pages can be compressed in (count, byte) pairs as read by
+'LCD_DisplayCompressPicture()'. The array and its descriptor are printed as constants, so the
+picture stays in flash and is passed by pointer.
+
+Usage: python3 tools/img2c.py picture.pbm name [--compress] [--invert]
+PNG pictures need Pillow, the pixels darker than mid-grey are set.
+"""
+
+import argparse
+import sys
+
+PAGE_HEIGHT = 8             # Rows of a page [px].
+MAX_RUN = 255               # Longest run of a compressed pair.
+
+
+def read_pbm(path):
+    """Return the rows of a P1 or P4 picture, '1' for a dark pixel."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    # Header fields separated by whitespace, comments start with '#'
+    fields, pos = [], 0
+    while len(fields) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos].decode())
+
+    magic, width, height = fields[0], int(fields[1]), int(fields[2])
+    if magic == "P4":
+        pos += 1
+        stride = (width + 7) // 8
+        return [[(data[pos + y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    if magic == "P1":
+        bits = [int(c) for c in data[pos:].decode() if c in "01"]
+        return [bits[y * width:(y + 1) * width] for y in range(height)]
+
+    raise ValueError("%s: unsupported format %s" % (path, magic))
+
+
+def read_png(path):
+    from PIL import Image
+
+    image = Image.open(path).convert("L")
+    width, height = image.size
+    pixels = image.load()
+    return [[int(pixels[x, y] < 128) for x in range(width)] for y in range(height)]
+
+
+def to_pages(rows):
+    """Return the page bytes, page by page, the last page is padded with blank rows."""
+    width = len(rows[0])
+    pages = (len(rows) + PAGE_HEIGHT - 1) // PAGE_HEIGHT
+    data = []
+
+    for page in range(pages):
+        for x in range(width):
+            byte = 0
+            for bit in range(PAGE_HEIGHT):
+                y = page * PAGE_HEIGHT + bit
+                if y < len(rows) and rows[y][x]:
+                    byte |= 1 << bit
+            data.append(byte)
+
+    return data, width, pages
+
+
+def compress(data):
+    """Return the (count, byte) pairs of the data."""
+    pairs = []
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < MAX_RUN:
+            run += 1
+        pairs += [run, data[i]]
+        i += run
+    return pairs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a PBM or PNG picture to a constant T_picture.")
+    parser.add_argument("picture", help="PBM (P1/P4) or PNG picture")
+    parser.add_argument("name", help="picture name, the descriptor is 'IMG_<name>' ('IMG_<name>_c' if compressed)")
+    parser.add_argument("--compress", action="store_true", help="compress in (count, byte) pairs")
+    parser.add_argument("--invert", action="store_true", help="invert the pixels")
+    args = parser.parse_args()
+
+    rows = read_png(args.picture) if args.picture.lower().endswith(".png") else read_pbm(args.picture)
+    if args.invert:
+        rows = [[1 - p for p in row] for row in rows]
+
+    data, width, pages = to_pages(rows)
+    raw_size = len(data)
+    suffix = "_c" if args.compress else ""
+    if args.compress:
+        data = compress(data)
+
+    values = ",".join("0x%02X" % b for b in data)
+    print("// Data of the %s picture, %dx%d px%s" % (args.name, width, pages * PAGE_HEIGHT,
+          ", compressed from %d bytes" % raw_size if args.compress else ""))
+    print("const uint8_t IMG_%sData%s[%d] = {%s};" % (args.name, suffix, len(data), values))
+    print("const T_picture IMG_%s%s = {.HEIGHT = %d, .WIDTH = %d, .DATA = IMG_%sData%s, .DATA_LENGTH = %d};"
+          % (args.name, suffix, pages, width, args.name, suffix, len(data) if args.compress else 0))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
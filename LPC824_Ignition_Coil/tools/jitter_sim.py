@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+@file jitter_sim.py
+
+@brief Host simulator of the stochastic RPM stress mode: applied periods and their statistics.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The steps of 'jitter.h' are run with the inverse cumulative distribution tables read from
+'jitter.c': xorshift32 generator, table index, first order filter and reload value. The center
+period and the applied amplitude are computed as 'JITTER_SetCenter()' does, from the SCTimer clock,
+the pulse frequency and width. The sequence of reload values is the one loaded by the target for
+the same seed, as long as the center frequency isn't changed during the run.\n
+The statistics of the sequence are printed (mean, standard deviation, lag-1 autocorrelation,
+histogram) with the expected answer of the 'J' telemetry command after the simulated periods.
+'--compare' checks an answer of the target: the exit status is '1' when it differs.
+
+Usage: python3 tools/jitter_sim.py dist amplitude_us shift seed [--freq-mhz F] [--width-us W]
+       [--sct-clock HZ] [--count N] [--periods] [--compare "J on=1 center=..."]
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+TABLE_BITS = 7              # JITTER_TABLE_BITS.
+MIN_GAP = 16                # JITTER_MIN_GAP: time between the pulse end and the period end [tick].
+HISTOGRAM_BINS = 16         # Bins of the printed histogram.
+
+
+def read_tables(path):
+    """Return the inverse cumulative distribution tables of 'jitter.c', in distribution order."""
+    with open(path) as f:
+        text = f.read()
+
+    start = text.index("s_tables[")
+    body = text[text.index("=", start) + 1:text.index("};", start)]
+    body = re.sub(r"//[^\n]*", "", body)
+    tables = []
+    for block in re.findall(r"\{([^{}]*)\}", body):
+        values = [int(v) for v in re.findall(r"-?\d+", block)]
+        if len(values) != 1 << TABLE_BITS:
+            raise ValueError("table of %d values in %s" % (len(values), path))
+        tables.append(values)
+    return tables
+
+
+def c_int32(value):
+    """Wrap a value as a C 32-bit signed integer."""
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def setup(sct_clock, freq_mhz, width_us, amplitude_us):
+    """Return the center reload value and the applied amplitude [tick], as 'JITTER_SetCenter()'."""
+    center = sct_clock * 1000 // freq_mhz - 1
+    width = width_us * sct_clock // 1000000
+    amplitude = amplitude_us * sct_clock // 1000000
+    limit = center - width - MIN_GAP if center > width + MIN_GAP else 0
+    return center, min(amplitude, limit, 0xFFFF)
+
+
+def simulate(table, shift, seed, center, amplitude, count):
+    """Return the reload values of 'count' periods and the final generator state."""
+    state = seed
+    filtered = 0
+    periods = []
+    for _ in range(count):
+        state ^= (state << 13) & 0xFFFFFFFF
+        state ^= state >> 17
+        state ^= (state << 5) & 0xFFFFFFFF
+        filtered += (table[state >> (32 - TABLE_BITS)] - filtered) >> shift
+        periods.append((center + (c_int32(filtered * amplitude) >> 15)) & 0xFFFFFFFF)
+    return periods, state
+
+
+def statistics(periods):
+    """Return the mean, the standard deviation and the lag-1 autocorrelation of a sequence."""
+    n = len(periods)
+    mean = sum(periods) / n
+    var = sum((p - mean) ** 2 for p in periods) / n
+    cov = sum((periods[i] - mean) * (periods[i - 1] - mean) for i in range(1, n)) / (n - 1)
+    return mean, math.sqrt(var), cov / var if var else 0.0
+
+
+def parse_answer(line):
+    """Return the fields of a 'J' answer."""
+    return {k: int(v, 0) for k, v in re.findall(r"(\w+)=(0x[0-9A-Fa-f]+|\d+)", line)}
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Simulate the periods of the stochastic RPM stress mode.")
+    parser.add_argument("dist", type=int, help="distribution: 1 uniform, 2 normal")
+    parser.add_argument("amplitude_us", type=int, help="amplitude of the perturbation [us]")
+    parser.add_argument("shift", type=int, help="filter shift, 0 for a white perturbation")
+    parser.add_argument("seed", type=int, help="seed of the generator, not 0")
+    parser.add_argument("--freq-mhz", type=int, default=100000, help="center pulse frequency [mHz] (default: 6000 rpm)")
+    parser.add_argument("--width-us", type=int, default=2000, help="pulse width [us] (default: 2000)")
+    parser.add_argument("--sct-clock", type=int, default=30000000, help="SCTimer counter clock [Hz] (default: 30 MHz)")
+    parser.add_argument("--count", type=int, default=100000, help="number of simulated periods (default: 100000)")
+    parser.add_argument("--periods", action="store_true", help="print the reload value of each period")
+    parser.add_argument("--compare", metavar="ANSWER", help="'J' answer of the target after 'count' periods")
+    parser.add_argument("--source", default=os.path.join(here, "..", "source", "jitter.c"),
+                        help="jitter.c to read the tables from")
+    args = parser.parse_args()
+
+    tables = read_tables(args.source)
+    if not 1 <= args.dist <= len(tables) or args.seed == 0 or args.freq_mhz <= 0 or args.count <= 0:
+        parser.error("invalid distribution, seed, frequency or count")
+
+    center, amplitude = setup(args.sct_clock, args.freq_mhz, args.width_us, args.amplitude_us)
+    periods, state = simulate(tables[args.dist - 1], args.shift, args.seed, center, amplitude, args.count)
+    expected = {"center": center, "amplitude": amplitude, "count": args.count,
+                "min": min(periods), "max": max(periods), "state": state}
+
+    if args.periods:
+        for p in periods:
+            print(p)
+        return 0
+
+    mean, deviation, correlation = statistics(periods)
+    print("center %d ticks, amplitude %d ticks, %d periods" % (center, amplitude, args.count))
+    print("mean %+.2f ticks, deviation %.2f ticks (%.4f of the amplitude), lag-1 correlation %.4f"
+          % (mean - center, deviation, deviation / amplitude if amplitude else 0.0, correlation))
+    print("min %+d, max %+d ticks" % (expected["min"] - center, expected["max"] - center))
+
+    low, high = expected["min"], expected["max"] + 1
+    bins = [0] * HISTOGRAM_BINS
+    for p in periods:
+        bins[(p - low) * HISTOGRAM_BINS // (high - low)] += 1
+    for i, n in enumerate(bins):
+        print("%+8d %7d %s" % (low + i * (high - low) // HISTOGRAM_BINS - center, n,
+                               "#" * (n * 60 // max(bins))))
+
+    print("J on=1 center=%d amplitude=%d count=%d min=%d max=%d state=0x%08X"
+          % (center, amplitude, args.count, expected["min"], expected["max"], state))
+
+    if args.compare:
+        answer = parse_answer(args.compare)
+        diff = ["%s %s, expected %d" % (k, answer.get(k), v) for k, v in expected.items() if answer.get(k) != v]
+        for d in diff:
+            print("differs: " + d)
+        return 1 if diff else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+@file la2trace.py
+
+@brief Convert a logic analyzer capture of the LCD SPI link to a trace of 'tools/lcd_emu.py'.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The input is the raw CSV export of the digital channels: a header line with the channel names,
+then one line per change with the time and the level of each channel, as exported by Saleae
+Logic or sigrok. The SPI is decoded in mode 0, MSB first, as set by 'LCD_InitStart()': MOSI is
+sampled on the rising edges of SCLK while SSEL is low, and the command/data level of a byte is the
+one of its last rising edge. A transaction ends when SSEL is released or when the command/data
+level changes: the DMA queue keeps SSEL low across its segments.\n
+The channels are found by name ('SCLK', 'MOSI', 'SSEL' and 'CD' by default) or by column number.
+
+Usage: python3 tools/la2trace.py capture.csv [-o trace.txt] [--sclk NAME] [--mosi NAME]
+       [--ssel NAME] [--cd NAME]
+"""
+
+import argparse
+import csv
+import sys
+
+
+def column(header, name):
+    """Return the column of a channel, from its name or its number."""
+    names = [h.strip() for h in header]
+    if name in names:
+        return names.index(name)
+    if name.isdigit() and 0 < int(name) < len(names):
+        return int(name)
+    raise ValueError("channel '%s' not in the header %s" % (name, ", ".join(names)))
+
+
+def decode(rows, sclk, mosi, ssel, cd):
+    """Return the transactions (cd, bytes) of the rows, and the number of dropped partial bytes."""
+    transactions = []
+    current = None
+    byte = bits = 0
+    dropped = 0
+    previous = None
+
+    def close():
+        nonlocal current, byte, bits, dropped
+        if bits:
+            dropped += 1
+        if current and current[1]:
+            transactions.append(current)
+        current = None
+        byte = bits = 0
+
+    for row in rows:
+        levels = [int(v) for v in (row[sclk], row[mosi], row[ssel], row[cd])]
+        if previous is None:
+            previous = levels
+            continue
+
+        if levels[2] and not previous[2]:
+            close()
+        elif not levels[2] and levels[0] and not previous[0]:
+            byte = (byte << 1) | levels[1]
+            bits += 1
+            if bits == 8:
+                value = byte
+                byte = bits = 0
+                if current is None or current[0] != levels[3]:
+                    close()
+                    current = (levels[3], [])
+                current[1].append(value)
+        previous = levels
+
+    close()
+    return transactions, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a logic analyzer CSV export to an LCD SPI trace.")
+    parser.add_argument("capture", help="raw CSV export of the digital channels")
+    parser.add_argument("-o", "--output", help="trace to write (default: standard output)")
+    parser.add_argument("--sclk", default="SCLK", help="SPI clock channel (default: SCLK)")
+    parser.add_argument("--mosi", default="MOSI", help="SPI data channel (default: MOSI)")
+    parser.add_argument("--ssel", default="SSEL", help="SPI chip select channel (default: SSEL)")
+    parser.add_argument("--cd", default="CD", help="LCD command/data channel (default: CD)")
+    args = parser.parse_args()
+
+    with open(args.capture, newline="") as f:
+        reader = csv.reader(f)
+        header = next(reader)
+        try:
+            channels = [column(header, n) for n in (args.sclk, args.mosi, args.ssel, args.cd)]
+        except ValueError as e:
+            parser.error(str(e))
+        transactions, dropped = decode(reader, *channels)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    for level, payload in transactions:
+        out.write("%s %s\n" % ("D" if level else "C", " ".join("%02x" % b for b in payload)))
+    if args.output:
+        out.close()
+
+    if dropped:
+        print("warning: %d partial bytes dropped" % dropped, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""
+@file lcd_emu.py
+
+@brief Host emulator of the UC1701 LCD controller driven by 'lcd.c', fed with captured SPI traces.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The SPI0 bytes are replayed with the level of the command/data line: the commands are decoded, the
+data bytes are written in an emulated display RAM with the column auto-increment and wrap settings
+of the controller, and the visible 128x64 frame is rendered as a PBM picture. The bytes and SPI
+transactions are counted per operation, so an optimization of the driver can be checked for an
+identical frame after each operation and its traffic savings measured.
+
+Trace format, one SPI transaction per line, captured with a logic analyzer on SCLK, MOSI, SSEL
+and the command/data pin:
+    # label         Start of an operation, the following transactions are counted in it.
+    C b0 00 10      Command bytes (command/data pin low).
+    D 7c fe b2      Data bytes (command/data pin high).
+Empty lines and text after a second '#' are ignored.
+
+The reference traces of the screens are in 'test/lcd', with their expected frame: 'make -C test'
+replays them against the traces of the current 'lcd.c' and 'ui.c'. 'tools/la2trace.py' converts a
+logic analyzer capture to this format.
+
+Usage:
+    python3 tools/lcd_emu.py trace.txt [--pbm frame.pbm] [--frames dir] [--expect frame.pbm]
+    python3 tools/lcd_emu.py before.txt --compare after.txt
+"""
+
+import argparse
+import os
+import re
+import sys
+
+RAM_COLUMNS = 132           # Columns of the display RAM.
+RAM_PAGES = 9               # Pages of the display RAM, the last one is the icon row.
+SCREEN_WIDTH = 128          # Visible columns [px].
+SCREEN_HEIGHT = 64          # Visible rows [px].
+
+# Commands followed by a parameter byte
+DOUBLE_COMMANDS = {
+    0x81: "electronic volume",
+    0xAC: "static indicator off",
+    0xAD: "static indicator on",
+    0xF8: "booster ratio",
+    0xFA: "advanced program control",
+}
+
+
+class Controller:
+    """Display RAM and registers of the controller."""
+
+    def __init__(self):
+        self.reset()
+
+    def reset(self):
+        self.ram = [[0] * RAM_COLUMNS for _ in range(RAM_PAGES)]
+        self.column = 0
+        self.page = 0
+        self.scroll = 0
+        self.mirror_x = False
+        self.mirror_y = False
+        self.inverse = False
+        self.all_on = False
+        self.enabled = False
+        self.wrap_column = False
+        self.wrap_page = False
+        self.pending = None
+        self.warnings = []
+
+    def command(self, byte):
+        """Decode one command byte."""
+        if self.pending is not None:
+            if self.pending == 0xFA:
+                self.wrap_column = bool(byte & 0x02)
+                self.wrap_page = bool(byte & 0x01)
+            self.pending = None
+        elif byte in DOUBLE_COMMANDS:
+            self.pending = byte
+        elif byte <= 0x0F:
+            self.column = (self.column & 0xF0) | byte
+        elif byte <= 0x1F:
+            self.column = (self.column & 0x0F) | ((byte & 0x0F) << 4)
+        elif byte <= 0x2F:
+            pass                                    # Resistor ratio and power control
+        elif 0x40 <= byte <= 0x7F:
+            self.scroll = byte & 0x3F
+        elif byte in (0xA0, 0xA1):
+            self.mirror_x = bool(byte & 1)
+        elif byte in (0xA2, 0xA3):
+            pass                                    # Bias ratio
+        elif byte in (0xA4, 0xA5):
+            self.all_on = bool(byte & 1)
+        elif byte in (0xA6, 0xA7):
+            self.inverse = bool(byte & 1)
+        elif byte in (0xAE, 0xAF):
+            self.enabled = bool(byte & 1)
+        elif 0xB0 <= byte <= 0xB8:
+            self.page = byte & 0x0F
+        elif 0xC0 <= byte <= 0xCF:
+            self.mirror_y = bool(byte & 0x08)
+        elif byte == 0xE2:
+            self.reset()
+        elif byte in (0xE0, 0xE3, 0xEE):
+            pass                                    # Cursor update mode and NOP
+        else:
+            self.warnings.append("unknown command 0x%02X" % byte)
+
+    def data(self, byte):
+        """Write one data byte at the cursor and advance it."""
+        if self.pending is not None:
+            self.warnings.append("data byte 0x%02X while a command parameter is expected" % byte)
+            self.pending = None
+        if self.column >= RAM_COLUMNS or self.page >= RAM_PAGES:
+            self.warnings.append("data byte out of the RAM (page %d, column %d)" % (self.page, self.column))
+            return False
+
+        changed = self.ram[self.page][self.column] != byte
+        self.ram[self.page][self.column] = byte
+
+        # Without wrap the column address stops at the last column
+        if self.column < RAM_COLUMNS - 1:
+            self.column += 1
+        elif self.wrap_column:
+            self.column = 0
+            if self.wrap_page:
+                self.page = (self.page + 1) % RAM_PAGES
+        return changed
+
+    def pixel(self, x, y):
+        """Visible pixel, the module shows page 0 at the top with SEG normal and COM reverse."""
+        if not self.enabled:
+            return 0
+        if self.all_on:
+            return 1
+
+        column = (RAM_COLUMNS - 1 - x) if self.mirror_x else x
+        line = y if self.mirror_y else SCREEN_HEIGHT - 1 - y
+        line = (line + self.scroll) % SCREEN_HEIGHT
+        bit = (self.ram[line // 8][column] >> (line % 8)) & 1
+        return bit ^ int(self.inverse)
+
+    def frame(self):
+        return [[self.pixel(x, y) for x in range(SCREEN_WIDTH)] for y in range(SCREEN_HEIGHT)]
+
+
+class Operation:
+    """Traffic of a labelled operation."""
+
+    def __init__(self, label):
+        self.label = label
+        self.transactions = 0
+        self.command_bytes = 0
+        self.data_bytes = 0
+        self.changed_bytes = 0
+
+
+def parse(path):
+    """Return the transactions of a trace: (label, None) or (cd, bytes)."""
+    items = []
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            if line.startswith("#"):
+                items.append((line[1:].split("#")[0].strip() or "line %d" % number, None))
+                continue
+
+            fields = line.split("#")[0].split()
+            if fields[0].upper() not in ("C", "D") or not all(re.fullmatch(r"(0x)?[0-9a-fA-F]{1,2}", v) for v in fields[1:]):
+                raise ValueError("%s:%d: invalid transaction '%s'" % (path, number, line))
+            items.append((fields[0].upper() == "D", [int(v, 16) for v in fields[1:]]))
+    return items
+
+
+def write_pbm(path, frame):
+    """Write a binary PBM, a set bit is a dark pixel."""
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (SCREEN_WIDTH, SCREEN_HEIGHT))
+        for row in frame:
+            for x in range(0, SCREEN_WIDTH, 8):
+                byte = 0
+                for bit in range(8):
+                    byte |= row[x + bit] << (7 - bit)
+                f.write(bytes([byte]))
+
+
+def read_pbm(path):
+    """Read a binary PBM written by 'write_pbm()'."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    fields = re.match(rb"P4\s+(\d+)\s+(\d+)\s", data)
+    if not fields or (int(fields.group(1)), int(fields.group(2))) != (SCREEN_WIDTH, SCREEN_HEIGHT):
+        raise ValueError("%s: not a %dx%d binary PBM" % (path, SCREEN_WIDTH, SCREEN_HEIGHT))
+    pixels = data[fields.end():]
+    row_bytes = SCREEN_WIDTH // 8
+    return [[(pixels[y * row_bytes + x // 8] >> (7 - x % 8)) & 1 for x in range(SCREEN_WIDTH)]
+            for y in range(SCREEN_HEIGHT)]
+
+
+def frame_diff(a, b):
+    """Return the number of different pixels of two frames."""
+    return sum(a[y][x] != b[y][x] for y in range(SCREEN_HEIGHT) for x in range(SCREEN_WIDTH))
+
+
+def run(path, frames_dir=None):
+    """Replay a trace, return the controller, the operations and the frame after each operation."""
+    lcd = Controller()
+    operations = [Operation("(start)")]
+    frames = []
+
+    for cd, payload in parse(path):
+        if payload is None:
+            end_operation(operations, frames, lcd, frames_dir)
+            operations.append(Operation(cd))
+            continue
+
+        op = operations[-1]
+        op.transactions += 1
+        for byte in payload:
+            if cd:
+                op.data_bytes += 1
+                op.changed_bytes += lcd.data(byte)
+            else:
+                op.command_bytes += 1
+                lcd.command(byte)
+
+    end_operation(operations, frames, lcd, frames_dir)
+
+    kept = [i for i, op in enumerate(operations) if op.transactions or op.label != "(start)"]
+    return lcd, [operations[i] for i in kept], [frames[i] for i in kept]
+
+
+def end_operation(operations, frames, lcd, frames_dir):
+    """Keep the frame at the end of the last operation."""
+    frames.append(lcd.frame())
+    if frames_dir:
+        save_frame(frames_dir, len(operations) - 1, operations[-1].label, frames[-1])
+
+
+def save_frame(directory, index, label, frame):
+    os.makedirs(directory, exist_ok=True)
+    name = re.sub(r"[^A-Za-z0-9_-]+", "_", label).strip("_") or "frame"
+    write_pbm(os.path.join(directory, "%03d_%s.pbm" % (index, name)), frame)
+
+
+def report(path, lcd, operations):
+    print("%s" % path)
+    print("  %-28s %6s %8s %8s %8s" % ("operation", "trans", "command", "data", "changed"))
+    total = Operation("total")
+    for op in operations + [total]:
+        print("  %-28s %6d %8d %8d %8d" % (op.label[:28], op.transactions, op.command_bytes, op.data_bytes, op.changed_bytes))
+        if op is not total:
+            total.transactions += op.transactions
+            total.command_bytes += op.command_bytes
+            total.data_bytes += op.data_bytes
+            total.changed_bytes += op.changed_bytes
+    for warning in sorted(set(lcd.warnings)):
+        print("  warning: %s" % warning)
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay an LCD SPI trace on an emulated UC1701 controller.")
+    parser.add_argument("trace", help="SPI trace to replay")
+    parser.add_argument("--pbm", help="write the final frame to this PBM file")
+    parser.add_argument("--frames", help="write the frame after each operation in this directory")
+    parser.add_argument("--expect", metavar="PBM", help="check the final frame against this PBM file")
+    parser.add_argument("--compare", metavar="TRACE", help="replay a second trace and compare the frames")
+    args = parser.parse_args()
+
+    lcd, operations, frames = run(args.trace, args.frames)
+    total = report(args.trace, lcd, operations)
+    if args.pbm:
+        write_pbm(args.pbm, frames[-1])
+
+    status = 0
+    if args.expect:
+        diff = frame_diff(frames[-1], read_pbm(args.expect))
+        print("expected frame %s: %s" % (args.expect, "identical" if diff == 0 else "%d different pixels" % diff))
+        status |= diff != 0
+
+    if not args.compare:
+        return status
+
+    other, other_operations, other_frames = run(args.compare)
+    other_total = report(args.compare, other, other_operations)
+
+    # With the same operations the frame is compared after each of them, the final one otherwise
+    labels = [op.label for op in operations]
+    if labels == [op.label for op in other_operations]:
+        pairs = list(zip(labels, frames, other_frames))
+    else:
+        print("operations differ, only the final frames are compared")
+        pairs = [("(end)", frames[-1], other_frames[-1])]
+
+    different = 0
+    for label, a, b in pairs:
+        diff = frame_diff(a, b)
+        if diff:
+            print("after '%s': %d different pixels" % (label, diff))
+            different += 1
+    print("frames: %s" % ("identical" if different == 0 else "%d of %d differ" % (different, len(pairs))))
+    print("bytes: %d -> %d, transactions: %d -> %d" % (
+        total.command_bytes + total.data_bytes, other_total.command_bytes + other_total.data_bytes,
+        total.transactions, other_total.transactions))
+
+    return status | (different != 0)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""
+@file size_report.py
+
+@brief Flash and RAM use per source file and per subsystem, checked against budgets.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The linker map is parsed: each input section is counted for its object file, in flash for the code
+and constants, in RAM for the zero initialized data and in both for the initialized data (copied
+from flash at startup). The files are grouped in subsystems and compared with the budgets of
+'size_budget.ini'. The largest symbols of the ELF are listed when 'arm-none-eabi-nm' is available.
+The budgets are ceilings. The regression gate compares each subsystem and the totals with the
+baseline of the build configuration, the sizes of the last accepted build: a growth over the margin
+of 'size_budget.ini' fails the build. A missing baseline also fails it, the baseline is only written
+by '--write-baseline', run by hand on the first target build and after an intended growth. It is
+committed with the change.
+The exit status is '1' when a budget or the margin is exceeded or the baseline is missing, so the
+post-build step fails the build.
+
+Usage: python3 tools/size_report.py project.map [--budget tools/size_budget.ini] [--elf project.axf]
+       [--baseline tools/size_baseline_Debug.ini [--write-baseline]]
+"""
+
+import argparse
+import configparser
+import os
+import re
+import subprocess
+import sys
+
+SECTION_ONE_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+SECTION_NAME = re.compile(r"^ (\S+)$")
+SECTION_VALUES = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+FILL = re.compile(r"^ \*fill\*\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUTPUT_SECTION = re.compile(r"^(\.\S+)")
+MEMORY = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S+")
+
+
+def memory_type(output):
+    """Return the memories used by an output section: 'flash', 'ram', 'both' or None."""
+    if output.startswith(".data"):
+        return "both"
+    if output.startswith((".bss", ".noinit", ".heap", ".stack")):
+        return "ram"
+    if output.startswith((".text", ".rodata", ".ARM.extab", ".ARM.exidx", ".isr_vector")):
+        return "flash"
+    return None
+
+
+def module_name(path):
+    """Return the source name of an object: 'source/lcd.c', 'lib/libcr_c.a(printf.o)'."""
+    path = path.strip().replace("\\", "/")
+    archive = re.match(r"^(.*?)([^/]+\.a)\((.+)\)$", path)
+    if archive:
+        return "lib/%s(%s)" % (archive.group(2), archive.group(3))
+    if path.startswith("./"):
+        path = path[2:]
+    if path.endswith(".o"):
+        path = path[:-2] + ".c"
+    return path
+
+
+def parse_map(path):
+    """Return the flash and RAM sizes per module and the memory regions of the map."""
+    modules = {}
+    regions = {}
+    output = None
+    pending = None
+    in_memory = False
+    in_map = False
+
+    def add(module, size, kind):
+        flash, ram = modules.get(module, (0, 0))
+        if kind in ("flash", "both"):
+            flash += size
+        if kind in ("ram", "both"):
+            ram += size
+        modules[module] = (flash, ram)
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+
+            if line.startswith("Memory Configuration"):
+                in_memory = True
+                continue
+            if line.startswith("Linker script and memory map"):
+                in_memory = False
+                in_map = True
+                continue
+            if in_memory:
+                m = MEMORY.match(line)
+                if m and m.group(1) != "Name" and m.group(1) != "*default*":
+                    regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+                continue
+            if not in_map:
+                continue
+
+            m = OUTPUT_SECTION.match(line)
+            if m:
+                output = m.group(1)
+                pending = None
+                continue
+
+            kind = memory_type(output) if output else None
+            if kind is None:
+                continue
+
+            m = FILL.match(line)
+            if m:
+                add("(fill)", int(m.group(2), 16), kind)
+                continue
+
+            if pending:
+                m = SECTION_VALUES.match(line)
+                pending = None
+                if m:
+                    add(module_name(m.group(3)), int(m.group(2), 16), kind)
+                    continue
+
+            m = SECTION_ONE_LINE.match(line)
+            if m:
+                add(module_name(m.group(4)), int(m.group(3), 16), kind)
+                continue
+
+            m = SECTION_NAME.match(line)
+            if m:
+                pending = m.group(1)
+
+    return modules, regions
+
+
+def read_sizes(config):
+    """Return the flash and RAM sections of a configuration as sizes per name."""
+    sizes = {}
+    for memory in ("flash", "ram"):
+        if config.has_section(memory):
+            sizes[memory] = {name: int(value, 0) for name, value in config.items(memory)}
+        else:
+            sizes[memory] = {}
+    return sizes
+
+
+def read_budget(path):
+    """Return the subsystem patterns, the flash and RAM budgets and the baseline margin."""
+    config = configparser.ConfigParser(inline_comment_prefixes=(";",))
+    config.optionxform = str
+    config.read(path)
+
+    subsystems = [(name, value.split()) for name, value in config.items("subsystems")] if config.has_section("subsystems") else []
+    margin = (config.getint("baseline", "margin_percent", fallback=0), config.getint("baseline", "margin_bytes", fallback=0))
+    return subsystems, read_sizes(config), margin
+
+
+def read_baseline(path):
+    """Return the sizes of the baseline, or None if it doesn't exist."""
+    if not os.path.exists(path):
+        return None
+    config = configparser.ConfigParser(inline_comment_prefixes=(";",))
+    config.optionxform = str
+    config.read(path)
+    return read_sizes(config)
+
+
+def write_baseline(path, map_path, sizes):
+    """Write the sizes of the subsystems and the totals as the baseline."""
+    with open(path, "w", newline="\n") as f:
+        f.write("; Baseline of the size report (tools/size_report.py) [byte].\n")
+        f.write("; Sizes of the last accepted build, from %s. Written by '--write-baseline',\n"
+                % os.path.basename(map_path))
+        f.write("; the build fails when a size grows over the margin of size_budget.ini.\n")
+        for memory in ("flash", "ram"):
+            f.write("\n[%s]\n" % memory)
+            for name, used in sorted(sizes[memory].items()):
+                f.write("%s = %d\n" % (name, used))
+
+
+def subsystem_of(module, subsystems):
+    for name, patterns in subsystems:
+        if any(module.startswith(p) for p in patterns):
+            return name
+    return "other"
+
+
+def largest_symbols(elf, count):
+    """Return the largest symbols of the ELF (size, type, name), or None without 'arm-none-eabi-nm'."""
+    try:
+        out = subprocess.run(["arm-none-eabi-nm", "--size-sort", "-S", "-t", "d", elf],
+                             capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+    symbols = []
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            symbols.append((int(fields[1]), fields[2], fields[3]))
+    return sorted(symbols, reverse=True)[:count]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report the flash and RAM use per module and check the budgets.")
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("--budget", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "size_budget.ini"),
+                        help="budget file (default: size_budget.ini next to this script)")
+    parser.add_argument("--elf", help="ELF file, its largest symbols are listed")
+    parser.add_argument("--files", type=int, default=15, help="number of files listed (default 15)")
+    parser.add_argument("--baseline", help="baseline of the build configuration, the build fails if it doesn't exist")
+    parser.add_argument("--write-baseline", action="store_true", help="write this build as the baseline")
+    args = parser.parse_args()
+    if args.write_baseline and not args.baseline:
+        parser.error("--write-baseline needs --baseline")
+
+    modules, regions = parse_map(args.map)
+    if not modules:
+        print("size_report: no allocated section found in %s" % args.map)
+        return 1
+
+    subsystems, budgets, margin = read_budget(args.budget)
+    groups = {}
+    for module, (flash, ram) in modules.items():
+        name = subsystem_of(module, subsystems)
+        g_flash, g_ram = groups.get(name, (0, 0))
+        groups[name] = (g_flash + flash, g_ram + ram)
+
+    total_flash = sum(f for f, _ in modules.values())
+    total_ram = sum(r for _, r in modules.values())
+    failures = []
+
+    def check(memory, name, used):
+        budget = budgets[memory].get(name)
+        if budget is None:
+            return ""
+        if used > budget:
+            failures.append("budget exceeded, %s %s: %d > %d bytes" % (name, memory, used, budget))
+            return "  OVER %d" % budget
+        return "  %3d%% of %d" % (used * 100 // budget, budget) if budget else "  none allowed"
+
+    print("Memory regions:")
+    for name, (origin, length) in regions.items():
+        print("  %-16s 0x%08X %7d" % (name, origin, length))
+
+    print("Subsystems:                flash                         ram")
+    for name, (flash, ram) in sorted(groups.items(), key=lambda g: -g[1][0]):
+        print("  %-14s %7d%-20s %7d%s" % (name, flash, check("flash", name, flash), ram, check("ram", name, ram)))
+    print("  %-14s %7d%-20s %7d%s" % ("total", total_flash, check("flash", "total", total_flash),
+                                       total_ram, check("ram", "total", total_ram)))
+
+    # The files with a budget are listed even if they are not the largest ones
+    listed = sorted(modules.items(), key=lambda m: -(m[1][0] + m[1][1]))[:args.files]
+    listed += [(m, modules[m]) for m in sorted(set(budgets["flash"]) | set(budgets["ram"]))
+               if m in modules and m not in dict(listed)]
+
+    print("Largest files:                     flash     ram")
+    for module, (flash, ram) in listed:
+        print("  %-32s %7d %7d%s%s" % (module[-32:], flash, ram, check("flash", module, flash), check("ram", module, ram)))
+
+    if args.elf:
+        symbols = largest_symbols(args.elf, 10)
+        if symbols is None:
+            print("Largest symbols: arm-none-eabi-nm not found")
+        else:
+            print("Largest symbols:")
+            for size, kind, name in symbols:
+                print("  %7d %s %s" % (size, kind, name))
+
+    if args.baseline:
+        sizes = {"flash": {name: flash for name, (flash, _) in groups.items()},
+                 "ram": {name: ram for name, (_, ram) in groups.items()}}
+        sizes["flash"]["total"] = total_flash
+        sizes["ram"]["total"] = total_ram
+        failures += check_baseline(args.baseline, args.map, sizes, margin, args.write_baseline)
+
+    for failure in failures:
+        print("size_report: %s" % failure)
+
+    return 1 if failures else 0
+
+
+def check_baseline(path, map_path, sizes, margin, write):
+    """Compare the sizes with the baseline, return the growths over the margin or the missing baseline."""
+    if write:
+        write_baseline(path, map_path, sizes)
+        print("Baseline: written to %s, commit it with the change" % path)
+        return []
+
+    # Without a baseline nothing would be compared, it is only written on request
+    baseline = read_baseline(path)
+    if baseline is None:
+        return ["baseline %s not found, check this build and write it with --write-baseline" % path]
+
+    percent, minimum = margin
+    failures = []
+    print("Baseline %s, margin %d%% (at least %d bytes):" % (path, percent, minimum))
+    for memory in ("flash", "ram"):
+        for name, used in sorted(sizes[memory].items()):
+            reference = baseline[memory].get(name)
+            if reference is None:
+                print("  %-14s %-5s %7d  not in the baseline" % (name, memory, used))
+                continue
+            allowed = max(reference * percent // 100, minimum)
+            if used - reference > allowed:
+                failures.append("%s %s grew from %d to %d bytes, over the %d bytes margin "
+                                "(--write-baseline if intended)" % (name, memory, reference, used, allowed))
+            if used != reference:
+                print("  %-14s %-5s %7d -> %7d  %+d" % (name, memory, reference, used, used - reference))
+    return failures
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""
+@file stack_report.py
+
+@brief Worst case stack depth of the thread and of each interrupt, from the call graph.
+@date 18 oct. 2026
+@author Alec Guerin
+
+The frame of each function is read from the '.su' files written by GCC with '-fstack-usage', the
+calls from the disassembly of the ELF ('bl' and tail 'b' to a function). The calls through a
+pointer (SCTimer and pin interrupt callbacks, telemetry commands) are not visible in the code and
+are listed in 'stack_config.ini' with the enabled interrupts and their priority.\n
+The depth of an interrupt includes the exception frame pushed by the core. An interrupt can only
+preempt a lower priority one, so the worst case is the thread depth plus the deepest interrupt of
+each priority level. The exit status is '1' when it exceeds the stack, so the post-build step fails
+the build.
+
+Usage: python3 tools/stack_report.py build_dir --elf project.axf [--config tools/stack_config.ini]
+"""
+
+import argparse
+import configparser
+import os
+import re
+import subprocess
+import sys
+
+EXCEPTION_FRAME = 8 * 4 + 4     # R0-R3, R12, LR, PC, xPSR and the 8 bytes alignment [byte].
+THREAD_ENTRY = "ResetISR"       # Entry point of the thread mode.
+
+FUNCTION = re.compile(r"^([0-9a-f]+) <([^>]+)>:$")
+CALL = re.compile(r"\tbl\s+[0-9a-f]+ <([^>+]+)>")
+BRANCH = re.compile(r"\tb(?:\.n|\.w)?\s+[0-9a-f]+ <([^>+]+)>")
+INDIRECT = re.compile(r"\tblx\s+r\d+")
+
+
+def read_su(directory):
+    """Return the frame size and qualifier of each function of the '.su' files of a directory."""
+    frames = {}
+    for root, _, files in os.walk(directory):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name)) as f:
+                for line in f:
+                    fields = line.rstrip("\n").split("\t")
+                    if len(fields) != 3:
+                        continue
+                    function = fields[0].rsplit(":", 1)[-1]
+                    size = int(fields[1])
+                    # Static functions of different files can have the same name, keep the largest
+                    if function not in frames or frames[function][0] < size:
+                        frames[function] = (size, fields[2])
+    return frames
+
+
+def read_calls(elf):
+    """Return the direct callees of each function and the functions calling through a pointer."""
+    out = subprocess.run(["arm-none-eabi-objdump", "-d", "--no-show-raw-insn", elf],
+                         capture_output=True, text=True, check=True).stdout
+
+    calls = {}
+    indirect = set()
+    function = None
+    for line in out.splitlines():
+        m = FUNCTION.match(line)
+        if m:
+            function = m.group(2)
+            calls.setdefault(function, set())
+            continue
+        if function is None:
+            continue
+
+        m = CALL.search(line) or BRANCH.search(line)
+        if m and m.group(1) != function:
+            calls[function].add(m.group(1))
+        elif INDIRECT.search(line):
+            indirect.add(function)
+    return calls, indirect
+
+
+def read_symbol(elf, name):
+    """Return the address of a symbol of the ELF, or None."""
+    out = subprocess.run(["arm-none-eabi-nm", elf], capture_output=True, text=True, check=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == name:
+            return int(fields[0], 16)
+    return None
+
+
+def read_config(path):
+    config = configparser.ConfigParser(inline_comment_prefixes=(";",))
+    config.optionxform = str
+    config.read(path)
+
+    def section(name, convert):
+        return {k: convert(v) for k, v in config.items(name)} if config.has_section(name) else {}
+
+    return (section("interrupts", lambda v: int(v, 0)), section("calls", str.split),
+            section("frames", lambda v: int(v, 0)))
+
+
+class Graph:
+    """Call graph with the frame of each function."""
+
+    def __init__(self, frames, calls, indirect, extra_calls, extra_frames):
+        self.frames = frames
+        self.calls = calls
+        self.indirect = indirect
+        self.extra_calls = extra_calls
+        self.extra_frames = extra_frames
+        self.depths = {}
+        self.unknown = set()
+        self.dynamic = set()
+        self.unresolved = set()
+        self.recursive = set()
+
+    def frame(self, function):
+        if function in self.extra_frames:
+            return self.extra_frames[function]
+        if function not in self.frames:
+            self.unknown.add(function)
+            return 0
+        size, qualifier = self.frames[function]
+        if qualifier == "dynamic":
+            self.dynamic.add(function)
+        return size
+
+    def callees(self, function):
+        if function in self.indirect and function not in self.extra_calls:
+            self.unresolved.add(function)
+        return self.calls.get(function, set()) | set(self.extra_calls.get(function, []))
+
+    def depth(self, function, path=()):
+        """Return the deepest stack use below a function and the call path."""
+        if function in self.depths:
+            return self.depths[function]
+        if function in path:
+            self.recursive.add(function)
+            return 0, []
+
+        deepest, deepest_path = 0, []
+        for callee in sorted(self.callees(function)):
+            d, p = self.depth(callee, path + (function,))
+            if d > deepest:
+                deepest, deepest_path = d, p
+
+        result = (self.frame(function) + deepest, [function] + deepest_path)
+        self.depths[function] = result
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compute the worst case stack depth from the call graph.")
+    parser.add_argument("build", help="build directory, its '.su' files are read")
+    parser.add_argument("--elf", required=True, help="ELF file, disassembled for the calls")
+    parser.add_argument("--config", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "stack_config.ini"),
+                        help="interrupts and indirect calls (default: stack_config.ini next to this script)")
+    parser.add_argument("--limit", type=int, help="stack size [byte] (default: end of the heap to the top of the stack)")
+    args = parser.parse_args()
+
+    frames = read_su(args.build)
+    if not frames:
+        print("stack_report: no .su file in %s, enable -fstack-usage" % args.build)
+        return 1
+
+    try:
+        calls, indirect = read_calls(args.elf)
+        limit = args.limit
+        if limit is None:
+            top, bottom = read_symbol(args.elf, "_vStackTop"), read_symbol(args.elf, "_pvHeapLimit")
+            limit = top - bottom if top is not None and bottom is not None else None
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("stack_report: can't read %s (%s)" % (args.elf, e))
+        return 1
+
+    interrupts, extra_calls, extra_frames = read_config(args.config)
+    graph = Graph(frames, calls, indirect, extra_calls, extra_frames)
+
+    thread, thread_path = graph.depth(THREAD_ENTRY)
+    print("Thread:")
+    print("  %-28s %6d  %s" % (THREAD_ENTRY, thread, " > ".join(thread_path)))
+
+    # Deepest interrupt of each priority level
+    levels = {}
+    print("Interrupts:              priority  depth")
+    for name, priority in sorted(interrupts.items(), key=lambda i: (i[1], i[0])):
+        if name not in calls:
+            print("  %-28s %3d      not in the ELF" % (name, priority))
+            continue
+        d, path = graph.depth(name)
+        d += EXCEPTION_FRAME
+        print("  %-28s %3d %6d  %s" % (name, priority, d, " > ".join(path)))
+        if d > levels.get(priority, (0, None))[0]:
+            levels[priority] = (d, name)
+
+    worst = thread + sum(d for d, _ in levels.values())
+    print("Worst case: %d bytes (thread %d%s)" % (worst, thread, "".join(
+        " + %s %d" % (name, d) for _, (d, name) in sorted(levels.items(), reverse=True))))
+
+    if graph.unknown:
+        print("warning: no frame size for %d functions, counted as 0: %s" % (len(graph.unknown), " ".join(sorted(graph.unknown))))
+    if graph.dynamic:
+        print("warning: unbounded dynamic allocation in %s" % " ".join(sorted(graph.dynamic)))
+    if graph.unresolved:
+        print("warning: calls through a pointer not listed in [calls]: %s" % " ".join(sorted(graph.unresolved)))
+    if graph.recursive:
+        print("warning: recursion through %s, counted once" % " ".join(sorted(graph.recursive)))
+
+    if limit is None:
+        print("stack_report: stack size unknown, use --limit")
+        return 0
+    print("Stack: %d bytes, %d free in the worst case" % (limit, limit - worst))
+    if worst > limit:
+        print("stack_report: worst case stack depth %d exceeds the stack size %d" % (worst, limit))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())